@@ -3,6 +3,7 @@ TARGET	 = qsparqlendpoint
 HEADERS		= ../../../sparql/drivers/endpoint/qsparql_endpoint_p.h
 SOURCES		= main.cpp \
 		  ../../../sparql/drivers/endpoint/qsparql_endpoint.cpp
+OTHER_FILES	= endpoint.json
 
 unix: {
     LIBS *= $$QT_LFLAGS_ENDPOINT
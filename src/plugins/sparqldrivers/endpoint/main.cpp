@@ -47,7 +47,7 @@ class QSPARQL_ENDPOINTDriverPlugin : public QSparqlDriverPlugin
 {
     Q_OBJECT
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
-    Q_PLUGIN_METADATA(IID "org.nemomobile.QtSparql.EndpointDriverInterface")
+    Q_PLUGIN_METADATA(IID "org.nemomobile.QtSparql.EndpointDriverInterface" FILE "endpoint.json")
 #endif
 
 public:
@@ -47,7 +47,7 @@ class QTrackerDriverPlugin : public QSparqlDriverPlugin
 {
     Q_OBJECT
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
-    Q_PLUGIN_METADATA(IID "org.nemomobile.QtSparql.TrackerDriverInterface")
+    Q_PLUGIN_METADATA(IID "org.nemomobile.QtSparql.TrackerDriverInterface" FILE "tracker.json")
 #endif
 
 public:
@@ -4,6 +4,7 @@ HEADERS		= ../../../sparql/drivers/tracker/qsparql_tracker_p.h
 
 SOURCES		= main.cpp \
 		  ../../../sparql/drivers/tracker/qsparql_tracker.cpp
+OTHER_FILES	= tracker.json
 
 unix: {
     LIBS *= $$QT_LFLAGS_TRACKER
@@ -47,7 +47,7 @@ class QTrackerDirectDriverPlugin : public QSparqlDriverPlugin
 {
     Q_OBJECT
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
-    Q_PLUGIN_METADATA(IID "org.nemomobile.QtSparql.TrackerDirectDriverInterface")
+    Q_PLUGIN_METADATA(IID "org.nemomobile.QtSparql.TrackerDirectDriverInterface" FILE "tracker_direct.json")
 #endif
 
 public:
@@ -13,6 +13,7 @@ SOURCES         = main.cpp \
                   ../../../sparql/drivers/tracker_direct/qsparql_tracker_direct_select_result_p.cpp \
                   ../../../sparql/drivers/tracker_direct/qsparql_tracker_direct_sync_result_p.cpp \
                   ../../../sparql/drivers/tracker_direct/qsparql_tracker_direct_update_result_p.cpp
+OTHER_FILES     = tracker_direct.json
 
 unix: {
     CONFIG += link_pkgconfig
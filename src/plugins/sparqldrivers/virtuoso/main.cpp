@@ -47,7 +47,7 @@ class QVirtuosoDriverPlugin : public QSparqlDriverPlugin
 {
     Q_OBJECT
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
-    Q_PLUGIN_METADATA(IID "org.nemomobile.QtSparql.VirtuosoDriverInterface")
+    Q_PLUGIN_METADATA(IID "org.nemomobile.QtSparql.VirtuosoDriverInterface" FILE "virtuoso.json")
 #endif
 
 public:
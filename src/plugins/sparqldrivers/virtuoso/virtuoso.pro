@@ -5,6 +5,7 @@ CONFIG += debug_and_release
 HEADERS		= ../../../sparql/drivers/virtuoso/qsparql_virtuoso_p.h
 SOURCES		= main.cpp \
 		  ../../../sparql/drivers/virtuoso/qsparql_virtuoso.cpp
+OTHER_FILES	= virtuoso.json
 
 unix {
     CONFIG += link_pkgconfig
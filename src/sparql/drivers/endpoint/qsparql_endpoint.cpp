@@ -47,7 +47,12 @@
 #include <qsparqlquery.h>
 #include <qsparqlqueryoptions.h>
 #include <qsparqlresultrow.h>
+#include <private/qsparqliripool_p.h>
 #include <private/qsparqlntriples_p.h>
+#include <private/qsparqlturtle_p.h>
+#include <private/qsparqltracer_p.h>
+#include <private/qsparqlmemoryusage_p.h>
+#include <private/qsparqlbinding_p.h>
 
 #include <qstringlist.h>
 #include <qtextcodec.h>
@@ -126,12 +131,22 @@ public:
     bool fatalError(const QXmlParseException &exception);
     QString errorString() const;
 
+    // The row being parsed and the pooled IRIs and labels
+    void addMemoryUsage(QSparqlMemoryUsage* usage) const
+    {
+        usage->add(currentText);
+        usage->add(resultRow);
+        iris.addMemoryUsage(usage);
+    }
+
 private:
     QString currentText;
     QString errorStr;
     QXmlAttributes lattrs;
     QSparqlBinding binding;
     QSparqlResultRow resultRow;
+    // Shares the repeated IRIs, blank node labels and variable names
+    QSparqlIriPool iris;
     EndpointResultPrivate * d;
 };
 
@@ -139,8 +154,9 @@ class EndpointResultPrivate  : public QObject {
     Q_OBJECT
 public:
     EndpointResultPrivate(EndpointResult *result, EndpointDriverPrivate *dpp)
-    : reply(0), xml(0), parser(0), reader(0),
-        isFinished(false), noResults(false), loop(0), q(result), driverPrivate(dpp)
+    : reply(0), xml(0), parser(0), reader(0), turtle(0),
+        isFinished(false), noResults(false), dataRead(false), requestStart(-1),
+        loop(0), q(result), driverPrivate(dpp)
     {
     }
 
@@ -149,6 +165,7 @@ public:
         delete xml;
         delete parser;
         delete reader;
+        delete turtle;
     }
 
     void setBoolValue(bool v)
@@ -161,9 +178,17 @@ public:
     XmlInputSource *xml;
     XmlResultsParser *parser;
     QXmlSimpleReader *reader;
+    // Parses Turtle and N-Quads graphs while they are being received
+    QSparqlTurtle *turtle;
     QVector<QSparqlResultRow> results;
+    // The variables of the head of a SELECT result; the rows leave out the
+    // variables they don't bind
+    QStringList variables;
     bool isFinished;
     bool noResults;
+    bool dataRead;
+    // When the request was sent, for tracing
+    qint64 requestStart;
     QEventLoop *loop;
     EndpointResult *q;
     EndpointDriverPrivate *driverPrivate;
@@ -174,6 +199,9 @@ public Q_SLOTS:
     void handleError(QNetworkReply::NetworkError code);
     void terminate();
     void parseResults();
+
+private:
+    bool parseData();
 };
 
 
@@ -190,12 +218,13 @@ bool XmlResultsParser::startElement(const QString & namespaceURI,
     if (qName == QLatin1String("sparql")) {
     } else if (qName == QLatin1String("head")) {
     } else if (qName == QLatin1String("variable")) {
+        d->variables.append(iris.label(attributes.value(QString::fromLatin1("name"))));
     } else if (qName == QLatin1String("results")) {
     } else if (qName == QLatin1String("result")) {
         resultRow = QSparqlResultRow();
     } else if (qName == QLatin1String("binding")) {
         binding = QSparqlBinding();
-        binding.setName(attributes.value(QString::fromLatin1("name")));
+        binding.setName(iris.label(attributes.value(QString::fromLatin1("name"))));
     } else if (qName == QLatin1String("bnode")) {
     } else if (qName == QLatin1String("uri")) {
     } else if (qName == QLatin1String("literal")) {
@@ -231,18 +260,20 @@ bool XmlResultsParser::endElement(const QString & namespaceURI,
         } else if (qName == QLatin1String("bnode")) {
             currentText.replace(QRegExp(QString::fromLatin1("^nodeID://")), QString::fromLatin1(""));
             currentText.replace(QRegExp(QString::fromLatin1("^_:")), QString::fromLatin1(""));
-            binding.setBlankNodeLabel(currentText);
+            binding.setBlankNodeLabel(iris.label(currentText));
         } else if (qName == QLatin1String("uri")) {
-            QUrl url(currentText);
-            binding.setValue(QVariant(url));
+            binding.setValue(QVariant(iris.fromString(currentText)));
         } else if (qName == QLatin1String("literal")) {
             if (lattrs.index(QString::fromLatin1("datatype")) != -1) {
-                if (lattrs.index(QString::fromLatin1("xsi:type")) != -1) {
-                    // TODO: How should we treat xsi:types here?
-                    binding.setValue(currentText, QUrl(lattrs.value(QString::fromLatin1("datatype"))));
-                } else {
-                    binding.setValue(currentText, QUrl(lattrs.value(QString::fromLatin1("datatype"))));
-                }
+                // TODO: How should we treat xsi:types here?
+                // The well-known types are looked up once, and only the
+                // others are parsed into a QUrl
+                const QString dataType = lattrs.value(QString::fromLatin1("datatype"));
+                const XSD::TypeId id = XSD::typeId(dataType);
+                if (id != XSD::UnknownType)
+                    QSparqlTypedLiteral::setValue(&binding, currentText, id);
+                else
+                    binding.setValue(currentText, QUrl(dataType));
             } else if (lattrs.index(QString::fromLatin1("xml:lang")) != -1) {
                 binding.setValue(QVariant(currentText));
                 binding.setLanguageTag(lattrs.value(QString::fromLatin1("xml:lang")));
@@ -296,6 +327,10 @@ void EndpointResultPrivate::terminate()
         return;
 
     isFinished = true;
+    q->markFetchFinished();
+    if (requestStart >= 0 && QSparqlTracer::isEnabled())
+        QSparqlTracer::complete("network request", requestStart, QSparqlTracer::now(),
+                                q->query());
     q->Q_EMIT finished();
     
     if (loop != 0)
@@ -309,11 +344,62 @@ void EndpointResultPrivate::readData()
         return;
     }
 
+    // The first data marks the end of the execution on the endpoint; the
+    // parsing below reads everything available
+    if (!dataRead) {
+        dataRead = true;
+        q->markExecutionFinished();
+    }
+    const qint64 bytes = reply->bytesAvailable();
+    q->addBytesReceived(bytes);
+    QSparqlTraceSpan span("network read");
+    // The detail is only formatted when it is recorded
+    if (QSparqlTracer::isEnabled())
+        span.setDetail(QString::number(bytes));
+
+    const int oldCount = results.count();
+    const qint64 decodeStart = q->elapsedTime();
+    const bool parsed = parseData();
+    q->addDecodeTime(q->elapsedTime() - decodeStart);
+    q->addFetchedRows(results.count() - oldCount);
+    if (parsed) {
+        QSparqlTraceSpan dataReadySpan("dataReady");
+        q->Q_EMIT dataReady(results.count());
+    }
+}
+
+bool EndpointResultPrivate::parseData()
+{
     if (q->isGraph()) {
-        buffer += reply->readAll();
-        return;
+        if (turtle == 0 && buffer.isEmpty()) {
+            const QString contentType = reply->header(QNetworkRequest::ContentTypeHeader).toString();
+            if (contentType.contains(QLatin1String("turtle"), Qt::CaseInsensitive))
+                turtle = new QSparqlTurtle(QSparqlTurtle::Turtle);
+            else if (contentType.contains(QLatin1String("n-quads"), Qt::CaseInsensitive)
+                     || contentType.contains(QLatin1String("nquads"), Qt::CaseInsensitive))
+                turtle = new QSparqlTurtle(QSparqlTurtle::NQuads);
+            if (turtle)
+                turtle->setBaseUri(reply->url());
+        }
+
+        if (turtle == 0) {
+            // N-Triples are parsed in parallel once they have all arrived
+            buffer += reply->readAll();
+            return false;
+        }
+
+        QSparqlTraceSpan span("Turtle parsing");
+        turtle->addData(reply->readAll());
+        if (turtle->hasError()) {
+            q->setLastError(QSparqlError(turtle->errorString(), QSparqlError::StatementError));
+            terminate();
+            return false;
+        }
+        results += turtle->takeResults();
+        return true;
     }
 
+    QSparqlTraceSpan span("XML parsing");
     if (reader == 0) {
         parser = new XmlResultsParser(this);
         reader = new QXmlSimpleReader();
@@ -324,7 +410,7 @@ void EndpointResultPrivate::readData()
             q->setLastError(QSparqlError(xml->data(), QSparqlError::StatementError));
             terminate();
             qWarning() << "QEndpoint:" << q->lastError() << q->query();
-            return;
+            return false;
         }
     }
 
@@ -333,11 +419,11 @@ void EndpointResultPrivate::readData()
             q->setLastError(QSparqlError(xml->data(), QSparqlError::StatementError));
             terminate();
             qWarning() << "QEndpoint:" << q->lastError() << q->query();
-            return;
+            return false;
         }
     }
 
-    q->Q_EMIT dataReady(results.count());
+    return true;
 }
 
 void EndpointResultPrivate::parseResults()
@@ -345,9 +431,27 @@ void EndpointResultPrivate::parseResults()
     if (isFinished)
         return;
 
+    if (!dataRead) {
+        dataRead = true;
+        q->markExecutionFinished();
+    }
+
     if (q->isGraph()) {
-        QSparqlNTriples parser(buffer);
-        results = parser.parse();
+        const int oldCount = results.count();
+        const qint64 decodeStart = q->elapsedTime();
+        QSparqlTraceSpan span(turtle ? "Turtle parsing" : "N-Triples parsing");
+        if (turtle) {
+            turtle->finish();
+            if (turtle->hasError())
+                q->setLastError(QSparqlError(turtle->errorString(), QSparqlError::StatementError));
+            else
+                results += turtle->takeResults();
+        } else {
+            QSparqlNTriples parser(buffer);
+            results = parser.parseParallel();
+        }
+        q->addDecodeTime(q->elapsedTime() - decodeStart);
+        q->addFetchedRows(results.count() - oldCount);
     }
 
     terminate();    
@@ -357,6 +461,7 @@ void EndpointResultPrivate::parseResults()
 EndpointResult::EndpointResult(EndpointDriverPrivate* p)
 {
     d = new EndpointResultPrivate(this, p);
+    setResultExtension(this);
 }
 
 EndpointResult::~EndpointResult()
@@ -457,18 +562,23 @@ bool EndpointResult::exec(const QString& query, QSparqlQuery::StatementType type
     // qDebug() << "Real url to run.... " << queryUrl.toString();
 
     d->buffer.clear();
+    delete d->turtle;
+    d->turtle = 0;
     QNetworkRequest request(queryUrl);
 
     if (isGraph())
-        // A Virtuoso protocol extension for CONSTRUCT or DESCRIBE queries.
-        // With DBPedia, 'text/plain' returns triples, but it isn't documented
-        // in the Virtuoso manual
-        request.setRawHeader("Accept", "text/plain");
+        // Turtle and N-Quads are parsed while they arrive. 'text/plain' is a
+        // Virtuoso protocol extension for CONSTRUCT or DESCRIBE queries; with
+        // DBPedia it returns triples, but it isn't documented in the Virtuoso
+        // manual
+        request.setRawHeader("Accept", "text/turtle, application/n-quads;q=0.9, text/plain;q=0.5");
     else
         request.setRawHeader("Accept", "application/sparql-results+xml");
 
     request.setRawHeader("charset", "utf-8");
 
+    markExecutionStarted();
+    d->requestStart = QSparqlTracer::isEnabled() ? QSparqlTracer::now() : -1;
     d->reply = d->driverPrivate->manager->get(request);
 
     if (!isGraph())
@@ -525,6 +635,26 @@ QSparqlResultRow EndpointResult::current() const
     return d->results[pos()];
 }
 
+int EndpointResult::fetchRowBlock(int maxRows, QSparqlRowBlock *block)
+{
+    return fetchBlockFromRows(d->results, d->variables, maxRows, block);
+}
+
+qint64 EndpointResult::resultMemoryUsage() const
+{
+    QSparqlMemoryUsage usage;
+    usage.add(d->results);
+    usage.add(d->variables);
+    // N-Triples are buffered until the reply has finished
+    usage.add(d->buffer);
+    if (d->parser)
+        d->parser->addMemoryUsage(&usage);
+    // The reply is deleted with the network manager when the driver closes
+    if (d->reply && d->driverPrivate)
+        usage.addBytes(d->reply->bytesAvailable());
+    return usage.total();
+}
+
 EndpointDriver::EndpointDriver(QObject * parent)
     : QSparqlDriver(parent)
 {
@@ -42,6 +42,7 @@
 
 #include <private/qsparqldriver_p.h>
 #include <qsparqlresult.h>
+#include <private/qsparqlresultextension_p.h>
 
 #if defined (Q_OS_WIN32)
 #include <QtCore/qt_windows.h>
@@ -61,7 +62,7 @@ class EndpointDriverPrivate;
 class EndpointResultPrivate;
 class EndpointDriver;
 
-class EndpointResult : public QSparqlResult
+class EndpointResult : public QSparqlResult, public QSparqlResultExtension
 {
     Q_OBJECT
     friend class EndpointResultPrivate;
@@ -77,9 +78,11 @@ public:
     QVariant value(int field) const;
     int size() const;
     QSparqlResultRow current() const;
+    int fetchRowBlock(int maxRows, QSparqlRowBlock *block);
 
     void waitForFinished();
     bool isFinished() const;
+    qint64 resultMemoryUsage() const;
 
 protected:
     void cleanup();
@@ -45,6 +45,9 @@
 #include <qsparqlquery.h>
 #include <qsparqlqueryoptions.h>
 #include <qsparqlresultrow.h>
+#include <qsparqlrowblock.h>
+#include <private/qsparqltracer_p.h>
+#include <private/qsparqlmemoryusage_p.h>
 
 #include <qcoreapplication.h>
 #include <qvariant.h>
@@ -219,6 +222,8 @@ QSparqlError::ErrorType QTrackerResultPrivate::errorCodeToType(TrackerSparqlErro
 
 void QTrackerResultPrivate::onDBusCallFinished()
 {
+    // The reply carries all the rows, so the round trip is the execution
+    q->markExecutionFinished();
     if (watcher->isError()) {
         QSparqlError error(watcher->error().message());
         if (watcher->error().type() == QDBusError::Other) {
@@ -233,6 +238,7 @@ void QTrackerResultPrivate::onDBusCallFinished()
 
         q->setLastError(error);
         qWarning() << "QTrackerResult:" << q->lastError() << q->query();
+        q->markFetchFinished();
         Q_EMIT q->finished();
         return;
     }
@@ -241,8 +247,11 @@ void QTrackerResultPrivate::onDBusCallFinished()
     case QSparqlQuery::AskStatement:
     case QSparqlQuery::SelectStatement:
     {
+        const qint64 decodeStart = q->elapsedTime();
         QDBusPendingReply<QVector<QStringList> > reply = *watcher;
         data = reply.argumentAt<0>();
+        q->addDecodeTime(q->elapsedTime() - decodeStart);
+        q->addFetchedRows(data.size());
 
         if (q->statementType() == QSparqlQuery::AskStatement && data.count() == 1 && data[0].count() == 1)
         {
@@ -250,6 +259,7 @@ void QTrackerResultPrivate::onDBusCallFinished()
             q->setBoolValue(boolValue.toBool());
         }
 
+        QSparqlTraceSpan span("dataReady");
         Q_EMIT q->dataReady(data.size());
         break;
     }
@@ -257,11 +267,13 @@ void QTrackerResultPrivate::onDBusCallFinished()
         // TODO: handle update results here
         break;
     }
+    q->markFetchFinished();
     Q_EMIT q->finished();
 }
 
 QTrackerResult::QTrackerResult(const QString& query, QSparqlQuery::StatementType tp, QTrackerDriver* driver)
 {
+    setResultExtension(this);
     setQuery(query);
     setStatementType(tp);
     d = new QTrackerResultPrivate(this, driver->d);
@@ -335,15 +347,48 @@ QSparqlResultRow QTrackerResult::current() const
 
     QStringList resultStrings = d->data[pos()];
     Q_FOREACH (const QString& str, resultStrings) {
-        // This only creates a binding with the values but with empty column
+        // This only stores the values; their bindings have empty column
         // names.
         // TODO: how to add column names?
-        QSparqlBinding b(QString(), str);
-        info.append(b);
+        info.appendValue(str);
     }
     return info;
 }
 
+int QTrackerResult::fetchRowBlock(int maxRows, QSparqlRowBlock *block)
+{
+    if (!block)
+        return 0;
+
+    block->setVariableNames(QStringList());
+    if (maxRows <= 0 || pos() == QSparql::AfterLastRow)
+        return 0;
+
+    const int first = (pos() == QSparql::BeforeFirstRow) ? 0 : pos() + 1;
+    const int fetched = qMin(maxRows, qMax(0, d->data.count() - first));
+
+    if (fetched > 0) {
+        // Like current(), the rows coming from D-Bus don't carry column names
+        QStringList names;
+        for (int i = 0; i < d->data[first].count(); ++i)
+            names.append(QString());
+        block->setVariableNames(names);
+        block->reserve(fetched);
+
+        QVector<QVariant> values;
+        for (int r = first; r < first + fetched; ++r) {
+            const QStringList& row = d->data[r];
+            values.resize(row.count());
+            for (int i = 0; i < row.count(); ++i)
+                values[i] = row[i];
+            block->appendRow(values.constData(), values.count());
+        }
+    }
+
+    updatePos(fetched < maxRows ? int(QSparql::AfterLastRow) : first + fetched - 1);
+    return fetched;
+}
+
 bool QTrackerResult::hasFeature(QSparqlResult::Feature feature) const
 {
     switch (feature) {
@@ -357,6 +402,15 @@ bool QTrackerResult::hasFeature(QSparqlResult::Feature feature) const
     }
 }
 
+qint64 QTrackerResult::resultMemoryUsage() const
+{
+    QSparqlMemoryUsage usage;
+    usage.addArray(d->data);
+    Q_FOREACH (const QStringList& row, d->data)
+        usage.add(row);
+    return usage.total();
+}
+
 void QTrackerResult::exec(const QSparqlQueryOptions& options)
 {
     QString funcToCall;
@@ -392,6 +446,7 @@ void QTrackerResult::exec(const QSparqlQueryOptions& options)
         qWarning() << "QTrackerResult:" << lastError() << query();
         return;
     }
+    markExecutionStarted();
     QDBusPendingCall call = d->driverPrivate->iface->asyncCall(funcToCall,
                                                 QVariant(query()));
     // if it's an insert or delete, and fireAndForget was set to true, don't
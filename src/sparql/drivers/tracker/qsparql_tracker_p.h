@@ -42,6 +42,7 @@
 
 #include <private/qsparqldriver_p.h>
 #include <qsparqlresult.h>
+#include <private/qsparqlresultextension_p.h>
 #include <qsparqlquery.h>
 
 #include <QtDBus/QtDBus>
@@ -64,7 +65,7 @@ class QTrackerDriverPrivate;
 class QTrackerResultPrivate;
 class QTrackerDriver;
 
-class Q_EXPORT_SPARQLDRIVER_TRACKER QTrackerResult : public QSparqlResult
+class Q_EXPORT_SPARQLDRIVER_TRACKER QTrackerResult : public QSparqlResult, public QSparqlResultExtension
 {
     Q_OBJECT
     friend class QTrackerResultPrivate; // for emitting signals
@@ -79,7 +80,9 @@ public:
     virtual QSparqlResultRow current() const;
     virtual QSparqlBinding binding(int i) const;
     virtual QVariant value(int i) const;
+    virtual int fetchRowBlock(int maxRows, QSparqlRowBlock *block);
     virtual bool hasFeature(QSparqlResult::Feature feature) const;
+    virtual qint64 resultMemoryUsage() const;
 
 public:
     void exec(const QSparqlQueryOptions& options);
@@ -58,7 +58,7 @@ QT_BEGIN_NAMESPACE
 
 namespace {
 
-QVariant makeVariant(TrackerSparqlValueType type, TrackerSparqlCursor* cursor, int col)
+QVariant makeVariant(TrackerSparqlValueType type, TrackerSparqlCursor* cursor, int col, QSparqlIriPool* iris)
 {
     glong strLen = 0;
     const gchar* strData = 0;
@@ -79,6 +79,8 @@ QVariant makeVariant(TrackerSparqlValueType type, TrackerSparqlCursor* cursor, i
         break;
     case TRACKER_SPARQL_VALUE_TYPE_URI:
     {
+        if (iris)
+            return QVariant(iris->fromEncoded(strData, strLen));
         const QByteArray ba(strData, strLen);
         return QVariant(QUrl::fromEncoded(ba));
     }
@@ -122,11 +124,11 @@ QVariant makeVariant(TrackerSparqlValueType type, TrackerSparqlCursor* cursor, i
 
 }  // namespace
 
-QVariant readVariant(TrackerSparqlCursor* cursor, int col)
+QVariant readVariant(TrackerSparqlCursor* cursor, int col, QSparqlIriPool* iris)
 {
     const TrackerSparqlValueType type =
         tracker_sparql_cursor_get_value_type(cursor, col);
-    return makeVariant(type, cursor, col);
+    return makeVariant(type, cursor, col, iris);
 }
 
 QSparqlError::ErrorType errorCodeToType(gint code)
@@ -442,6 +444,22 @@ QSparqlResult* QTrackerDirectDriver::exec(const QString &query, QSparqlQuery::St
     return result;
 }
 
+QList<QSparqlResult*> QTrackerDirectDriver::execMany(const QStringList& queries,
+                                                    QSparqlQuery::StatementType type,
+                                                    const QSparqlQueryOptions& options)
+{
+    if ((type != QSparqlQuery::InsertStatement && type != QSparqlQuery::DeleteStatement)
+            || queries.count() < 2)
+        return QSparqlDriver::execMany(queries, type, options);
+
+    // Tracker accepts several update operations in one update request, so
+    // the whole batch costs a single round trip to the store.
+    const QString request = joinUpdates(queries);
+    if (request.isEmpty())
+        return QSparqlDriver::execMany(queries, type, options);
+    return splitBatchResult(exec(request, type, options), queries, type);
+}
+
 QSparqlResult* QTrackerDirectDriver::asyncExec(const QString &query, QSparqlQuery::StatementType type, const QSparqlQueryOptions& options)
 {
     QTrackerDirectResult *result = 0;
@@ -57,6 +57,7 @@ class QTrackerDirectDriver;
 class QTrackerDirectSelectResult;
 class QTrackerDirectResult;
 class QTrackerDirectDriverConnectionOpen;
+class QSparqlIriPool;
 
 class QTrackerDirectDriverPrivate : public QObject
 {
@@ -95,7 +96,7 @@ private:
     QTrackerDirectDriverConnectionOpen *connectionOpener;
 };
 
-QVariant readVariant(TrackerSparqlCursor* cursor, int col);
+QVariant readVariant(TrackerSparqlCursor* cursor, int col, QSparqlIriPool* iris = 0);
 QSparqlError::ErrorType errorCodeToType(gint code);
 gint qSparqlPriorityToGlib(QSparqlQueryOptions::Priority priority);
 
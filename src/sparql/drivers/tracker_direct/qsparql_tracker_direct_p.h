@@ -69,6 +69,9 @@ public:
     QSparqlResult* exec(const QString& query,
                          QSparqlQuery::StatementType type,
                          const QSparqlQueryOptions& options);
+    QList<QSparqlResult*> execMany(const QStringList& queries,
+                                   QSparqlQuery::StatementType type,
+                                   const QSparqlQueryOptions& options);
 
 Q_SIGNALS:
     void opened();
@@ -41,13 +41,14 @@
 #include "atomic_int_operations_p.h"
 
 #include <qsparqlerror.h>
+#include <private/qsparqltracer_p.h>
 #include <QtCore/qdebug.h>
 
 using namespace AtomicIntOperations;
 
 // Query Runner Implementation
 QTrackerDirectQueryRunner::QTrackerDirectQueryRunner(QTrackerDirectResult *result)
-  : result(result), runFinished(0), runSemaphore(1), started(false)
+  : result(result), runFinished(0), runSemaphore(1), started(false), queuedAt(-1)
 {
     setAutoDelete(false);
 }
@@ -66,11 +67,13 @@ void QTrackerDirectQueryRunner::runOrWait()
 
 void QTrackerDirectQueryRunner::queue(QThreadPool& threadPool)
 {
+    QSparqlTraceSpan span("enqueue");
     if(acquireRunSemaphore()) {
         // QSparqlQueryPriority's are the wrong way round for
         // the thread pool, so just * -1 to get the correct
         // number
         int priority = result->options.priority() * -1;
+        queuedAt = QSparqlTracer::isEnabled() ? QSparqlTracer::now() : -1;
         threadPool.start(this, priority);
     }
 }
@@ -85,6 +88,12 @@ void QTrackerDirectQueryRunner::wait()
 
 void QTrackerDirectQueryRunner::run()
 {
+    // The wait for a thread of the pool is drawn on the thread which then
+    // runs the query
+    if (queuedAt >= 0 && QSparqlTracer::isEnabled())
+        QSparqlTracer::complete("queue wait", queuedAt, QSparqlTracer::now());
+    queuedAt = -1;
+    QSparqlTraceSpan span("QTrackerDirectQueryRunner::run", result->query());
     if (getValue(runFinished) == 0) {
         result->run();
     }
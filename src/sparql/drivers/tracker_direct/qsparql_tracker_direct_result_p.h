@@ -87,6 +87,8 @@ public:
     QAtomicInt runFinished;
     QSemaphore runSemaphore;
     bool started;
+    // When the runner was queued, for tracing the wait for a thread
+    qint64 queuedAt;
 
     QTrackerDirectQueryRunner(QTrackerDirectResult *result);
     void runOrWait();
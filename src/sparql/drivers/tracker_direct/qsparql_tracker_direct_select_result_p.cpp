@@ -46,8 +46,10 @@
 #include <qsparqlbinding.h>
 #include <qsparqlquery.h>
 #include <qsparqlresultrow.h>
-#define XSD_INTEGER
-#include "../../kernel/qsparqlxsd_p.h"
+#include <qsparqlrowblock.h>
+#include <private/qsparqltracer_p.h>
+#include <private/qsparqlmemoryusage_p.h>
+#include <private/qsparqlbinding_p.h>
 
 #include <QtCore/qvector.h>
 #include <QtCore/qvariant.h>
@@ -65,6 +67,7 @@ QTrackerDirectSelectResult::QTrackerDirectSelectResult(QTrackerDirectDriverPriva
                                            const QSparqlQueryOptions& options)
   : QTrackerDirectResult(options), cursor(0), resultMutex(QMutex::Recursive)
 {
+    setResultExtension(this);
     setQuery(query);
     setStatementType(type);
     driverPrivate = p;
@@ -95,7 +98,7 @@ void QTrackerDirectSelectResult::exec()
 
 void QTrackerDirectSelectResult::startFetcher()
 {
-    QMutexLocker resultLocker(&resultMutex);
+    QSparqlTracedMutexLocker resultLocker(&resultMutex, "result lock wait");
     if (queryRunner && !queryRunner->started && !isFinished()) {
         queryRunner->started = true;
         //first attempt to acquire the semaphore, if we can, then add the
@@ -109,6 +112,7 @@ void QTrackerDirectSelectResult::run()
 {
     if(runQuery()) {
         if (isTable()) {
+            QSparqlTraceSpan span("cursor iteration");
             while (!isFinished() && fetchNextResult()) {
                 ;
             }
@@ -125,7 +129,10 @@ bool QTrackerDirectSelectResult::runQuery()
     if (isFinished())
         return false;
 
-    QMutexLocker connectionLocker(&(driverPrivate->connectionMutex));
+    markExecutionStarted();
+    QSparqlTraceSpan span("tracker query");
+    QSparqlTracedMutexLocker connectionLocker(&(driverPrivate->connectionMutex),
+                                              "connection lock wait");
 
     GError * error = 0;
     cursor = tracker_sparql_connection_query(    driverPrivate->connection,
@@ -133,7 +140,7 @@ bool QTrackerDirectSelectResult::runQuery()
                                                     0,
                                                     &error );
     if (error || !cursor) {
-        QMutexLocker resultLocker(&resultMutex);
+        QSparqlTracedMutexLocker resultLocker(&resultMutex, "result lock wait");
         setLastError(QSparqlError(QString::fromUtf8(error ? error->message : "unknown error"),
                         error ? errorCodeToType(error->code) : QSparqlError::StatementError,
                         error ? error->code : -1));
@@ -144,12 +151,14 @@ bool QTrackerDirectSelectResult::runQuery()
         return false;
     }
 
+    markExecutionFinished();
     return true;
 }
 
 bool QTrackerDirectSelectResult::fetchNextResult()
 {
-    QMutexLocker connectionLocker(&(driverPrivate->connectionMutex));
+    QSparqlTracedMutexLocker connectionLocker(&(driverPrivate->connectionMutex),
+                                              "connection lock wait");
     GError * error = 0;
     gboolean active = tracker_sparql_cursor_next(cursor, 0, &error);
 
@@ -168,21 +177,28 @@ bool QTrackerDirectSelectResult::fetchNextResult()
         return false;
     }
 
-    QMutexLocker resultLocker(&resultMutex);
+    QSparqlTracedMutexLocker resultLocker(&resultMutex, "result lock wait");
 
     const gint n_columns = tracker_sparql_cursor_get_n_columns(cursor);
 
     if (columnNames.empty()) {
         for (int i = 0; i < n_columns; i++) {
             columnNames.append(QString::fromUtf8(tracker_sparql_cursor_get_variable_name(cursor, i)));
+            schema.append(columnNames.last());
         }
     }
 
+    const bool sampled = rowCounter.isSampled();
+    const qint64 decodeStart = sampled ? elapsedTime() : 0;
     QVector<QVariant> resultRow;
     resultRow.reserve(n_columns);
     for (int i = 0; i < n_columns; i++) {
-        resultRow.append(readVariant(cursor, i));
+        resultRow.append(readVariant(cursor, i, &iris));
     }
+    if (sampled)
+        rowCounter.addSampledRow(decodeStart, elapsedTime());
+    else
+        rowCounter.addRow();
 
     results.append(resultRow);
     if (results.count() % driverPrivate->dataReadyInterval == 0) {
@@ -212,7 +228,7 @@ bool QTrackerDirectSelectResult::fetchBoolResult()
 
 QSparqlBinding QTrackerDirectSelectResult::binding(int field) const
 {
-    QMutexLocker resultLocker(&resultMutex);
+    QSparqlTracedMutexLocker resultLocker(&resultMutex, "result lock wait");
 
     if (!isValid()) {
         return QSparqlBinding();
@@ -227,7 +243,7 @@ QSparqlBinding QTrackerDirectSelectResult::binding(int field) const
     QSparqlBinding b;
     const QVariant& value = results[pos()][field];
     if (value.type() == QVariant::LongLong) {
-        b.setValue(value.toString(), *XSD::Integer());
+        QSparqlTypedLiteral::setValue(&b, value.toString(), XSD::IntegerType);
     }
     else {
         b.setValue(value);
@@ -241,7 +257,7 @@ QSparqlBinding QTrackerDirectSelectResult::binding(int field) const
 
 QVariant QTrackerDirectSelectResult::value(int field) const
 {
-    QMutexLocker resultLocker(&resultMutex);
+    QSparqlTracedMutexLocker resultLocker(&resultMutex, "result lock wait");
 
     if (!isValid()) {
         return QVariant();
@@ -279,13 +295,14 @@ void QTrackerDirectSelectResult::waitForFinished()
 void QTrackerDirectSelectResult::terminate()
 {
 
-    QMutexLocker resultLocker(&resultMutex);
+    QSparqlTracedMutexLocker resultLocker(&resultMutex, "result lock wait");
 
     if (results.count() % driverPrivate->dataReadyInterval != 0) {
         emitDataReady(results.count());
     }
 
     if (getValue(resultFinished) == 0) {
+        markFetchFinished();
         setValue(resultFinished, 1);
         Q_EMIT finished();
     }
@@ -313,14 +330,14 @@ void QTrackerDirectSelectResult::stopAndWait()
 
 int QTrackerDirectSelectResult::size() const
 {
-    QMutexLocker resultLocker(&resultMutex);
+    QSparqlTracedMutexLocker resultLocker(&resultMutex, "result lock wait");
     return results.size();
 }
 
 QSparqlResultRow QTrackerDirectSelectResult::current() const
 {
 
-    QMutexLocker resultLocker(&resultMutex);
+    QSparqlTracedMutexLocker resultLocker(&resultMutex, "result lock wait");
 
     if (!isValid()) {
         return QSparqlResultRow();
@@ -329,16 +346,45 @@ QSparqlResultRow QTrackerDirectSelectResult::current() const
     if (columnNames.size() != results[pos()].size())
         return QSparqlResultRow();
 
-    QSparqlResultRow resultRow;
-    for (int i = 0; i < results[pos()].size(); ++i) {
-        QSparqlBinding b(columnNames[i], results[pos()][i]);
-        resultRow.append(b);
-    }
+    // The rows share the schema and hold only the values
+    QSparqlResultRow resultRow(schema);
+    const QVector<QVariant>& row = results[pos()];
+    for (int i = 0; i < row.size(); ++i)
+        resultRow.appendValue(row[i]);
     return resultRow;
 }
 
+int QTrackerDirectSelectResult::fetchRowBlock(int maxRows, QSparqlRowBlock *block)
+{
+    if (!block)
+        return 0;
+
+    QSparqlTraceSpan span("fetchBlock");
+    // Take the lock once for the whole block instead of once per value
+    QSparqlTracedMutexLocker resultLocker(&resultMutex, "result lock wait");
+
+    block->setVariableNames(columnNames.toList());
+    if (maxRows <= 0 || pos() == QSparql::AfterLastRow)
+        return 0;
+
+    const int first = (pos() == QSparql::BeforeFirstRow) ? 0 : pos() + 1;
+    const int fetched = qMin(maxRows, qMax(0, results.size() - first));
+
+    block->reserve(fetched);
+    for (int r = first; r < first + fetched; ++r) {
+        const QVector<QVariant>& row = results[r];
+        block->appendRow(row.constData(), row.count());
+    }
+
+    updatePos(fetched < maxRows ? int(QSparql::AfterLastRow) : first + fetched - 1);
+    return fetched;
+}
+
 void QTrackerDirectSelectResult::emitDataReady(int totalCount)
 {
+    // The statistics are updated once per batch of rows
+    recordRows(&rowCounter);
+    QSparqlTraceSpan span("dataReady");
     Q_EMIT dataReady(totalCount);
 }
 
@@ -355,4 +401,22 @@ bool QTrackerDirectSelectResult::hasFeature(QSparqlResult::Feature feature) cons
     }
 }
 
+qint64 QTrackerDirectSelectResult::resultMemoryUsage() const
+{
+    QSparqlMemoryUsage usage;
+    QMutexLocker resultLocker(&resultMutex);
+    usage.addArray(columnNames);
+    Q_FOREACH (const QString& name, columnNames)
+        usage.add(name);
+    usage.add(schema);
+    iris.addMemoryUsage(&usage);
+    usage.addArray(results);
+    Q_FOREACH (const QVector<QVariant>& row, results) {
+        usage.addArray(row);
+        Q_FOREACH (const QVariant& value, row)
+            usage.add(value);
+    }
+    return usage.total();
+}
+
 QT_END_NAMESPACE
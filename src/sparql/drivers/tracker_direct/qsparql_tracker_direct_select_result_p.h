@@ -41,9 +41,13 @@
 #define QSPARQL_TRACKER_DIRECT_SELECT_RESULT_P_H
 
 #include "qsparql_tracker_direct_result_p.h"
+#include <private/qsparqlresultextension_p.h>
 #include <QtCore/qvector.h>
 #include <QtCore/qstring.h>
 #include <QtCore/qmutex.h>
+#include <qsparqlresultschema.h>
+#include <private/qsparqliripool_p.h>
+#include <private/qsparqlrowcounter_p.h>
 
 #include <tracker-sparql.h>
 
@@ -53,7 +57,7 @@ QT_BEGIN_NAMESPACE
 
 class QTrackerDirectDriverPrivate;
 
-class QTrackerDirectSelectResult : public QTrackerDirectResult
+class QTrackerDirectSelectResult : public QTrackerDirectResult, public QSparqlResultExtension
 {
     Q_OBJECT
 public:
@@ -74,7 +78,9 @@ public:
     virtual QSparqlBinding binding(int i) const;
     virtual QVariant value(int i) const;
     virtual int size() const;
+    virtual int fetchRowBlock(int maxRows, QSparqlRowBlock *block);
     virtual bool hasFeature(QSparqlResult::Feature feature) const;
+    virtual qint64 resultMemoryUsage() const;
 
 public Q_SLOTS:
     virtual void exec();
@@ -92,6 +98,9 @@ private:
     TrackerSparqlCursor* cursor;
     mutable QMutex resultMutex;
     QVector<QString> columnNames;
+    QSparqlResultSchema schema; // shared by the rows returned by current()
+    QSparqlIriPool iris; // protected by resultMutex
+    QSparqlRowCounter rowCounter; // protected by resultMutex
     QList<QVector<QVariant> > results;
 };
 
@@ -47,10 +47,14 @@
 #include <qsparqlquery.h>
 #include <qsparqlqueryoptions.h>
 #include <qsparqlresultrow.h>
-#define XSD_INTEGER
-#include "../../kernel/qsparqlxsd_p.h"
+#include <qsparqlresultschema.h>
+#include <qsparqlrowblock.h>
+#include <private/qsparqltracer_p.h>
+#include <private/qsparqlmemoryusage_p.h>
+#include <private/qsparqlbinding_p.h>
 
 #include <QtCore/qvariant.h>
+#include <QtCore/qvarlengtharray.h>
 #include <QtCore/qdebug.h>
 
 using namespace AtomicIntOperations;
@@ -63,6 +67,7 @@ QTrackerDirectSyncResult::QTrackerDirectSyncResult(QTrackerDirectDriverPrivate*
                                                    const QSparqlQueryOptions& options)
     : QTrackerDirectResult(options), cursor(0), n_columns(-1), isAsync(false)
 {
+    setResultExtension(this);
     setQuery(query);
     setStatementType(type);
     driverPrivate = p;
@@ -114,11 +119,14 @@ void QTrackerDirectSyncResult::exec()
 
 void QTrackerDirectSyncResult::runQuery()
 {
+    markExecutionStarted();
+    QSparqlTraceSpan span("tracker query");
     if (statementType() == QSparqlQuery::AskStatement || statementType() == QSparqlQuery::SelectStatement) {
         selectQuery();
     } else if (statementType() == QSparqlQuery::InsertStatement || statementType() == QSparqlQuery::DeleteStatement) {
         updateQuery();
     }
+    markExecutionFinished();
 }
 
 void QTrackerDirectSyncResult::selectQuery()
@@ -191,6 +199,7 @@ bool QTrackerDirectSyncResult::next()
         qWarning() << "QTrackerDirectSyncResult:" << lastError() << query();
         g_object_unref(cursor);
         cursor = 0;
+        recordRows(&rowCounter);
         return false;
     }
 
@@ -198,8 +207,13 @@ bool QTrackerDirectSyncResult::next()
         g_object_unref(cursor);
         cursor = 0;
         updatePos(QSparql::AfterLastRow);
+        recordRows(&rowCounter);
+        markFetchFinished();
         return false;
     }
+    rowCounter.addRow();
+    if (rowCounter.isBatchFull())
+        recordRows(&rowCounter);
     const int oldPos = pos();
     if (oldPos == QSparql::BeforeFirstRow)
         updatePos(0);
@@ -208,19 +222,41 @@ bool QTrackerDirectSyncResult::next()
     return true;
 }
 
+// Creates a binding without a name for a value read from the cursor
+static QSparqlBinding makeBinding(const QVariant& value)
+{
+    // A special case: we store TRACKER_SPARQL_VALUE_TYPE_INTEGER as longlong,
+    // but its data type uri should be xsd:integer. Set it manually here.
+    QSparqlBinding b;
+    if (value.type() == QVariant::LongLong) {
+        QSparqlTypedLiteral::setValue(&b, value.toString(), XSD::IntegerType);
+    }
+    else {
+        b.setValue(value);
+    }
+    return b;
+}
+
 QSparqlResultRow QTrackerDirectSyncResult::current() const
 {
     // Note: this function reads and constructs the data again every time it's called.
     if (!cursor || pos() == QSparql::BeforeFirstRow || pos() == QSparql::AfterLastRow)
         return QSparqlResultRow();
 
-    QSparqlResultRow resultRow;
     // get the no. of columns only once; it won't change between rows
     if (n_columns < 0)
         n_columns = tracker_sparql_cursor_get_n_columns(cursor);
 
+    // Likewise the variable names, which the rows share through the schema
+    if (schema.count() != n_columns) {
+        schema.clear();
+        for (int i = 0; i < n_columns; i++)
+            schema.append(QString::fromUtf8(tracker_sparql_cursor_get_variable_name(cursor, i)));
+    }
+
+    QSparqlResultRow resultRow(schema);
     for (int i = 0; i < n_columns; i++) {
-        resultRow.append(binding(i));
+        resultRow.append(makeBinding(readVariant(cursor, i, &iris)));
     }
     return resultRow;
 }
@@ -239,18 +275,8 @@ QSparqlBinding QTrackerDirectSyncResult::binding(int i) const
         return QSparqlBinding();
 
     const gchar* name = tracker_sparql_cursor_get_variable_name(cursor, i);
-    const QVariant& value = readVariant(cursor, i);
-
-    // A special case: we store TRACKER_SPARQL_VALUE_TYPE_INTEGER as longlong,
-    // but its data type uri should be xsd:integer. Set it manually here.
-    QSparqlBinding b;
+    QSparqlBinding b = makeBinding(readVariant(cursor, i, &iris));
     b.setName(QString::fromUtf8(name));
-    if (value.type() == QVariant::LongLong) {
-        b.setValue(value.toString(), *XSD::Integer());
-    }
-    else {
-        b.setValue(value);
-    }
     return b;
 }
 
@@ -267,7 +293,7 @@ QVariant QTrackerDirectSyncResult::value(int i) const
     if (i < 0 || i >= n_columns)
         return QVariant();
 
-    return readVariant(cursor, i);
+    return readVariant(cursor, i, &iris);
 }
 
 QString QTrackerDirectSyncResult::stringValue(int i) const
@@ -285,6 +311,47 @@ QString QTrackerDirectSyncResult::stringValue(int i) const
     return QString::fromUtf8(tracker_sparql_cursor_get_string(cursor, i, 0));
 }
 
+int QTrackerDirectSyncResult::fetchRowBlock(int maxRows, QSparqlRowBlock *block)
+{
+    if (!block)
+        return 0;
+
+    QSparqlTraceSpan span("cursor iteration");
+    block->setVariableNames(QStringList());
+
+    QVarLengthArray<QVariant, 16> values;
+    int fetched = 0;
+    // Only the decoding of one row out of SampleInterval is timed
+    int sampledRows = 0;
+    qint64 sampledTime = 0;
+    // next() releases the cursor after the last row, so the column names
+    // are read while positioned on the first row of the block.
+    while (fetched < maxRows && next()) {
+        if (fetched == 0) {
+            if (n_columns < 0)
+                n_columns = tracker_sparql_cursor_get_n_columns(cursor);
+            QStringList names;
+            for (int i = 0; i < n_columns; ++i)
+                names.append(QString::fromUtf8(tracker_sparql_cursor_get_variable_name(cursor, i)));
+            block->setVariableNames(names);
+            values.resize(n_columns);
+        }
+        const bool sampled = fetched % QSparqlRowCounter::SampleInterval == 0;
+        const qint64 decodeStart = sampled ? elapsedTime() : 0;
+        for (int i = 0; i < n_columns; ++i)
+            values[i] = readVariant(cursor, i, &iris);
+        if (sampled) {
+            sampledTime += elapsedTime() - decodeStart;
+            ++sampledRows;
+        }
+        block->appendRow(values.constData(), values.count());
+        ++fetched;
+    }
+    if (sampledRows > 0)
+        addDecodeTime(sampledTime * fetched / sampledRows);
+    return fetched;
+}
+
 void QTrackerDirectSyncResult::stopAndWait()
 {
     if (queryRunner) {
@@ -324,6 +391,16 @@ bool QTrackerDirectSyncResult::hasFeature(QSparqlResult::Feature feature) const
     }
 }
 
+qint64 QTrackerDirectSyncResult::resultMemoryUsage() const
+{
+    // Only the current row is kept, in the cursor of libtracker-sparql,
+    // which isn't counted
+    QSparqlMemoryUsage usage;
+    usage.add(schema);
+    iris.addMemoryUsage(&usage);
+    return usage.total();
+}
+
 void QTrackerDirectSyncResult::waitForFinished()
 {
     if (queryRunner && isAsync) {
@@ -42,6 +42,10 @@
 
 #include <tracker-sparql.h>
 #include "qsparql_tracker_direct_result_p.h"
+#include <private/qsparqlresultextension_p.h>
+#include <qsparqlresultschema.h>
+#include <private/qsparqliripool_p.h>
+#include <private/qsparqlrowcounter_p.h>
 
 QT_BEGIN_HEADER
 
@@ -52,7 +56,7 @@ class QSparqlQueryOptions;
 
 // A sync and forward-only Result class. The instance of this class is retreved
 // with QTrackerDirectDriver::syncExec().
-class QTrackerDirectSyncResult : public QTrackerDirectResult
+class QTrackerDirectSyncResult : public QTrackerDirectResult, public QSparqlResultExtension
 {
     Q_OBJECT
 public:
@@ -69,9 +73,11 @@ public:
     virtual QSparqlBinding binding(int i) const;
     virtual QVariant value(int i) const;
     virtual QString stringValue(int i) const;
+    virtual int fetchRowBlock(int maxRows, QSparqlRowBlock *block);
 
     virtual bool isFinished() const;
     virtual bool hasFeature(QSparqlResult::Feature feature) const;
+    virtual qint64 resultMemoryUsage() const;
     virtual void waitForFinished();
 
 public Q_SLOTS:
@@ -80,6 +86,9 @@ public Q_SLOTS:
 private:
     TrackerSparqlCursor* cursor;
     mutable int n_columns;
+    mutable QSparqlResultSchema schema;
+    mutable QSparqlIriPool iris;
+    QSparqlRowCounter rowCounter;
     bool isAsync;
 
     Q_INVOKABLE void startFetcher();
@@ -45,6 +45,7 @@
 #include <qsparqlbinding.h>
 #include <qsparqlquery.h>
 #include <qsparqlresultrow.h>
+#include <private/qsparqltracer_p.h>
 
 #include <QtCore/qvariant.h>
 #include <QtCore/qdebug.h>
@@ -88,6 +89,8 @@ void QTrackerDirectUpdateResult::exec()
 void QTrackerDirectUpdateResult::run()
 {
     if (driverPrivate) {
+        markExecutionStarted();
+        QSparqlTraceSpan span("tracker update");
         GError * error = 0;
         tracker_sparql_connection_update(driverPrivate->connection,
                                          query().toUtf8().constData(),
@@ -102,6 +105,7 @@ void QTrackerDirectUpdateResult::run()
             g_error_free(error);
             qWarning() << "QTrackerDirectUpdateResult:" << lastError() << query();
         }
+        markExecutionFinished();
         QMetaObject::invokeMethod(this, "terminate", Qt::QueuedConnection);
     }
 
@@ -140,6 +144,7 @@ void QTrackerDirectUpdateResult::waitForFinished()
 void QTrackerDirectUpdateResult::terminate()
 {
     if (getValue(resultFinished) == 0) {
+        markFetchFinished();
         setValue(resultFinished, 1);
         Q_EMIT finished();
     }
@@ -60,11 +60,15 @@
 #include <QtSparql/qsparqlerror.h>
 #include <QtSparql/qsparqlbinding.h>
 #include <QtSparql/qsparqlresultrow.h>
+#include <QtSparql/qsparqlresultschema.h>
+#include <QtSparql/qsparqlrowblock.h>
 #include <QtSparql/qsparqlquery.h>
 #include <QtSparql/qsparqlqueryoptions.h>
+#include <QtSparql/private/qsparqliripool_p.h>
 #include <QtSparql/private/qsparqlntriples_p.h>
-#define XSD_DATE
-#include "../../kernel/qsparqlxsd_p.h"
+#include <QtSparql/private/qsparqlmemoryusage_p.h>
+#include <QtSparql/private/qsparqlrowcounter_p.h>
+#include <QtSparql/private/qsparqlbinding_p.h>
 
 #include <QDebug>
 
@@ -143,7 +147,7 @@ public:
 
     inline void clearValues()
     {
-        QSparqlResultRow resultRow;
+        QSparqlResultRow resultRow(schema);
         results.append(resultRow);
         resultColIdx = 0;
     }
@@ -155,7 +159,11 @@ public:
 
     QByteArray query;
     QStringList bindingNames;
+    QSparqlResultSchema schema; // the same names, shared by the rows
+    mutable QSparqlIriPool iris; // only used by the thread fetching the rows
 	QVector<QSparqlResultRow> results;
+    // Protected by the mutex of asynchronous results
+    QSparqlRowCounter rowCounter;
     int resultColIdx;
     int disconnectCount;
     QVirtuosoDriverPrivate *driverPrivate;
@@ -327,6 +335,8 @@ bool QVirtuosoAsyncResult::runQuery()
 
 bool QVirtuosoResult::runQuery()
 {
+    markExecutionStarted();
+
     // Always reallocate the statement handle - the statement attributes
     // are not reset if SQLFreeStmt() is called which causes some problems.
     SQLRETURN r;
@@ -349,6 +359,7 @@ bool QVirtuosoResult::runQuery()
     d->updateStmtHandleState();
 
     r = SQLExecDirect(d->hstmt, (UCHAR*) d->query.data(), d->query.length());
+    markExecutionFinished();
     if (r != SQL_SUCCESS && r != SQL_SUCCESS_WITH_INFO && r!= SQL_NO_DATA) {
         setLastError(qMakeError(QCoreApplication::translate("QVirtuosoResult", "Unable to execute statement"),
                                 QSparqlError::StatementError,
@@ -380,6 +391,7 @@ bool QVirtuosoResult::runQuery()
             }
 
             d->bindingNames.append(QString::fromLatin1((const char*) colName));
+            d->schema.append(d->bindingNames.last());
         }
     }
 
@@ -404,10 +416,12 @@ void QVirtuosoAsyncResult::terminate()
 {
     QMutexLocker resultLocker(&(da->mutex));
 
+    recordRows(&d->rowCounter);
     if (d->results.count() % d->driverPrivate->dataReadyInterval != 0) {
         emit dataReady(d->results.count());
     }
 
+    markFetchFinished();
     d->isFinished = 1;
     emit finished();
 }
@@ -440,13 +454,13 @@ static QSparqlBinding qMakeBinding(const QVirtuosoResultPrivate* p, int colNum)
             SQLGetDescField(p->hdesc, colNum, SQL_DESC_COL_DT_DT_TYPE, &dv_dt_type, SQL_IS_INTEGER, NULL);
             switch (dv_dt_type) {
             case VIRTUOSO_DT_TYPE_DATETIME:
-                b.setValue(QString::fromUtf8(buffer.constData()), *XSD::DateTime());
+                QSparqlTypedLiteral::setValue(&b, QString::fromUtf8(buffer.constData()), XSD::DateTimeType);
                 break;
             case VIRTUOSO_DT_TYPE_DATE:
-                b.setValue(QString::fromUtf8(buffer.constData()), *XSD::Date());
+                QSparqlTypedLiteral::setValue(&b, QString::fromUtf8(buffer.constData()), XSD::DateType);
                 break;
             case VIRTUOSO_DT_TYPE_TIME:
-                b.setValue(QString::fromUtf8(buffer.constData()), *XSD::Time());
+                QSparqlTypedLiteral::setValue(&b, QString::fromUtf8(buffer.constData()), XSD::TimeType);
                 break;
             default:
                 break;
@@ -463,7 +477,7 @@ static QSparqlBinding qMakeBinding(const QVirtuosoResultPrivate* p, int colNum)
         break;
     case VIRTUOSO_DV_NUMERIC:
         b.setValue(QString::fromUtf8(buffer.constData()).toDouble());
-        b.setDataTypeUri(*XSD::Decimal());
+        QSparqlTypedLiteral::setDataType(&b, XSD::DecimalType);
         break;
     case VIRTUOSO_DV_RDF:
         {
@@ -474,7 +488,7 @@ static QSparqlBinding qMakeBinding(const QVirtuosoResultPrivate* p, int colNum)
             SQLGetDescField(p->hdesc, colNum, SQL_DESC_COL_LITERAL_LANG, langBuf, sizeof(langBuf), &langBufLen);
             SQLGetDescField(p->hdesc, colNum, SQL_DESC_COL_LITERAL_TYPE, typeBuf, sizeof(typeBuf), &typeBufLen);
             b.setValue(QString::fromUtf8(buffer.constData()),
-                       QUrl::fromEncoded(QByteArray::fromRawData(reinterpret_cast<const char*>(typeBuf), typeBufLen)));
+                       p->iris.fromEncoded(reinterpret_cast<const char*>(typeBuf), typeBufLen));
 
             if (langBufLen > 0)
                 b.setLanguageTag(QString::fromLatin1(reinterpret_cast<const char*>(langBuf), langBufLen));
@@ -490,13 +504,13 @@ static QSparqlBinding qMakeBinding(const QVirtuosoResultPrivate* p, int colNum)
 
             if ((boxFlags & VIRTUOSO_BF_IRI) != 0) {
                 if (qstrncmp(buffer.constData(), "nodeID://", 9) == 0) {
-                    b.setBlankNodeLabel(QString::fromUtf8(buffer.constData() + 9));
+                    b.setBlankNodeLabel(p->iris.label(QString::fromUtf8(buffer.constData() + 9)));
                 } else {
-                    b.setValue(QUrl(QString::fromUtf8(buffer.constData())));
+                    b.setValue(p->iris.fromString(QString::fromUtf8(buffer.constData())));
                 }
             } else {
                 if (qstrncmp(buffer.constData(), "_:", 2) == 0) {
-                    b.setBlankNodeLabel(QString::fromUtf8(buffer.constData() + 2));
+                    b.setBlankNodeLabel(p->iris.label(QString::fromUtf8(buffer.constData() + 2)));
                 } else if ((boxFlags & VIRTUOSO_BF_UTF8) != 0) {
                     b.setValue(QString::fromUtf8(buffer.constData()));
                 } else {
@@ -529,11 +543,19 @@ bool QVirtuosoAsyncResult::fetchNextResult()
     QMutexLocker resultLocker(&(da->mutex));
     d->clearValues();
 
+    const bool sampled = d->rowCounter.isSampled();
+    const qint64 decodeStart = sampled ? elapsedTime() : 0;
     for (d->resultColIdx = 1; d->resultColIdx <= d->numResultCols; ++(d->resultColIdx)) {
         d->results[d->results.count() - 1].append(qMakeBinding(d, d->resultColIdx));
     }
+    if (sampled)
+        d->rowCounter.addSampledRow(decodeStart, elapsedTime());
+    else
+        d->rowCounter.addRow();
 
     if (d->results.count() % d->driverPrivate->dataReadyInterval == 0) {
+        // The statistics are updated once per batch of rows
+        recordRows(&d->rowCounter);
         emit dataReady(d->results.count());
     }
     return true;
@@ -580,9 +602,12 @@ bool QVirtuosoAsyncResult::fetchGraphResult()
     QSparqlBinding retval = qMakeBinding(d, 1);
 
     if (retval.name().toUpper() == QLatin1String("FMTAGGRET-NT")) {
+        const qint64 decodeStart = elapsedTime();
         QByteArray buffer = retval.value().toString().toLatin1();
         QSparqlNTriples parser(buffer);
-        d->results = parser.parse();
+        d->results = parser.parseParallel();
+        addDecodeTime(elapsedTime() - decodeStart);
+        addFetchedRows(d->results.count());
     }
 
     terminate();
@@ -645,11 +670,28 @@ QSparqlResultRow QVirtuosoAsyncResult::current() const
     return d->results[pos()];
 }
 
+int QVirtuosoAsyncResult::fetchRowBlock(int maxRows, QSparqlRowBlock *block)
+{
+    QMutexLocker resultLocker(&(da->mutex));
+    return fetchBlockFromRows(d->results, d->bindingNames, maxRows, block);
+}
+
 bool QVirtuosoAsyncResult::hasFeature(QSparqlResult::Feature /*feature*/) const
 {
     return false;
 }
 
+qint64 QVirtuosoAsyncResult::resultMemoryUsage() const
+{
+    // The IRI pool is only used by the fetcher thread, so it isn't counted
+    QMutexLocker resultLocker(&(da->mutex));
+    QSparqlMemoryUsage usage;
+    usage.add(d->query);
+    usage.add(d->bindingNames);
+    usage.add(d->results);
+    return usage.total();
+}
+
 QVariant QVirtuosoResult::handle() const
 {
     return QVariant(qRegisterMetaType<SQLHANDLE>("SQLHANDLE"), &d->hstmt);
@@ -660,6 +702,7 @@ QVirtuosoResult::QVirtuosoResult(const QVirtuosoDriver * db, QVirtuosoDriverPriv
                                 const QString& prefixes)
 : QSparqlResult()
 {
+    setResultExtension(this);
     setQuery(query);
     setStatementType(type);
     d = new QVirtuosoResultPrivate(db, p);
@@ -676,6 +719,7 @@ QVirtuosoResult::QVirtuosoResult(const QVirtuosoDriver * db, QVirtuosoDriverPriv
 
     setPos(QSparql::BeforeFirstRow);
     d->bindingNames.clear();
+    d->schema.clear();
 }
 
 QVirtuosoResult::~QVirtuosoResult()
@@ -699,15 +743,20 @@ bool QVirtuosoResult::next()
         if (r != SQL_NO_DATA)
             setLastError(qMakeError(QCoreApplication::translate("QVirtuosoResult",
                 "Unable to fetch next"), QSparqlError::BackendError, d));
+        recordRows(&d->rowCounter);
+        markFetchFinished();
         return false;
     }
 
+    d->rowCounter.addRow();
+    if (d->rowCounter.isBatchFull())
+        recordRows(&d->rowCounter);
     return true;
 }
 
 QSparqlResultRow QVirtuosoResult::current() const
 {
-    QSparqlResultRow resultRow;
+    QSparqlResultRow resultRow(d->schema);
 
     for (int i = 1; i <= d->numResultCols; ++i) {
         resultRow.append(qMakeBinding(d, i));
@@ -716,6 +765,24 @@ QSparqlResultRow QVirtuosoResult::current() const
     return resultRow;
 }
 
+int QVirtuosoResult::fetchRowBlock(int maxRows, QSparqlRowBlock *block)
+{
+    if (!block)
+        return 0;
+
+    block->setVariableNames(d->bindingNames);
+
+    QVarLengthArray<QVariant, 16> values(d->numResultCols);
+    int fetched = 0;
+    while (fetched < maxRows && QVirtuosoResult::next()) {
+        for (int i = 1; i <= d->numResultCols; ++i)
+            values[i - 1] = qMakeBinding(d, i).value();
+        block->appendRow(values.constData(), values.count());
+        ++fetched;
+    }
+    return fetched;
+}
+
 QSparqlBinding QVirtuosoResult::binding(int i) const
 {
     return qMakeBinding(d, i);
@@ -744,6 +811,17 @@ bool QVirtuosoResult::hasFeature(QSparqlResult::Feature feature) const
     }
 }
 
+qint64 QVirtuosoResult::resultMemoryUsage() const
+{
+    QSparqlMemoryUsage usage;
+    usage.add(d->query);
+    usage.add(d->bindingNames);
+    usage.add(d->schema);
+    d->iris.addMemoryUsage(&usage);
+    usage.add(d->results);
+    return usage.total();
+}
+
 ////////////////////////////////////////
 
 
@@ -42,6 +42,7 @@
 
 #include <QtSparql/private/qsparqldriver_p.h>
 #include <QtSparql/qsparqlresult.h>
+#include <QtSparql/private/qsparqlresultextension_p.h>
 
 #if defined (Q_OS_WIN32)
 #include <QtCore/qt_windows.h>
@@ -81,7 +82,7 @@ class QVirtuosoAsyncResultPrivate;
 class QVirtuosoDriverPrivate;
 class QVirtuosoDriver;
 
-class QVirtuosoResult : public QSparqlResult
+class QVirtuosoResult : public QSparqlResult, public QSparqlResultExtension
 {
     Q_OBJECT
 public:
@@ -97,10 +98,12 @@ public:
     QSparqlBinding binding(int field) const;
     QVariant value(int field) const;
     QSparqlResultRow current() const;
+    int fetchRowBlock(int maxRows, QSparqlRowBlock *block);
 
     bool isFinished() const;
 
     bool hasFeature(QSparqlResult::Feature feature) const;
+    qint64 resultMemoryUsage() const;
     virtual void terminate() {}
 protected:
     QVirtuosoResultPrivate *d;
@@ -123,12 +126,14 @@ public:
     QSparqlBinding binding(int field) const;
     QVariant value(int field) const;
     QSparqlResultRow current() const;
+    int fetchRowBlock(int maxRows, QSparqlRowBlock *block);
     int size() const;
 
     void waitForFinished();
     bool isFinished() const;
 
     bool hasFeature(QSparqlResult::Feature feature) const;
+    qint64 resultMemoryUsage() const;
     void terminate();
 private:
     bool fetchNextResult();
@@ -243,12 +243,40 @@
     - password (QString)
     - databaseName (QString)
 
+    QSPARQL_CACHE driver caches the results of SELECT, ASK, CONSTRUCT and
+    DESCRIBE queries executed with another driver, and passes its connection
+    options on to it. It supports the following connection options:
+    - custom: "cacheDriver" (QString), the driver executing the queries
+    - custom: "cacheSize" (int, default 4194304), the memory budget of the
+      cache in bytes; the least recently used results are dropped first
+    - custom: "cacheTimeToLive" (int, default 10000), the time in milliseconds
+      for which a result is served from the cache, or 0 for no limit
+
+    The updates executed through a QSPARQL_CACHE connection drop the cached
+    results they may change; see QSparqlQueryOptions::setCacheTags().
+
     For setting custom options, use QSparqlConnectionOptions::setOption() and
     give the option name as a string, followed by the value.
 
     Other options can be set using QSparqlConnectionOptions::setOption(), however
     it is preferable to use the type-safe convinence functions in QSparqlConnectionOptions.
 
+    All the drivers support the custom option "traceFile" (QString), see
+    \ref tracing.
+
+    \section tracing Tracing query execution
+
+    Setting the environment variable QSPARQL_TRACE, or the "traceFile"
+    connection option, to a file name makes QtSparql write a trace of the
+    queries into that file, in the Chrome trace event format. The trace can be
+    opened in chrome://tracing or another trace viewer.
+
+    The trace shows, for each thread, when the queries were executed and
+    queued, how long the store and the network took, the parsing of the
+    results, the emission of dataReady(), and the time the application spent
+    waiting for the locks of the results. There is one trace per process,
+    started by the first connection asking for it.
+
     \section connectionfeatures Connection features
 
     The following table describes the QSparclConnection::Feature support of each
@@ -5,12 +5,26 @@ HEADERS +=      kernel/qsparql.h \
                 kernel/qsparqlconnectionoptions.h \
                 kernel/qsparqlqueryoptions.h \
                 kernel/qsparqlbinding.h \
+                kernel/qsparqlbinding_p.h \
                 kernel/qsparqlresultrow.h \
+                kernel/qsparqlresultschema.h \
+                kernel/qsparqlresultstatistics.h \
+                kernel/qsparqltracer_p.h \
+                kernel/qsparqlrowblock.h \
                 kernel/qsparqldriver_p.h \
                 kernel/qsparqlnulldriver_p.h \
                 kernel/qsparqldriverplugin_p.h \
                 kernel/qsparqlerror.h \
                 kernel/qsparqlntriples_p.h \
+                kernel/qsparqliripool_p.h \
+                kernel/qsparqlmemoryusage_p.h \
+                kernel/qsparqlturtle_p.h \
+                kernel/qsparqlcachedriver_p.h \
+                kernel/qsparqlquerytemplate_p.h \
+                kernel/qsparqllexer_p.h \
+                kernel/qsparqlbatchresult_p.h \
+                kernel/qsparqlresultextension_p.h \
+                kernel/qsparqlrowcounter_p.h \
                 kernel/qsparqlresult.h 
 
 SOURCES +=      kernel/qsparqlquery.cpp \
@@ -19,9 +33,21 @@ SOURCES +=      kernel/qsparqlquery.cpp \
                 kernel/qsparqlqueryoptions.cpp \
                 kernel/qsparqlbinding.cpp \
                 kernel/qsparqlresultrow.cpp \
+                kernel/qsparqlresultschema.cpp \
+                kernel/qsparqlresultstatistics.cpp \
+                kernel/qsparqltracer.cpp \
+                kernel/qsparqlrowblock.cpp \
                 kernel/qsparqldriver.cpp \
                 kernel/qsparqldriverplugin.cpp \
                 kernel/qsparqlerror.cpp \
                 kernel/qsparqlntriples.cpp \
+                kernel/qsparqliripool.cpp \
+                kernel/qsparqlmemoryusage.cpp \
+                kernel/qsparqlturtle.cpp \
+                kernel/qsparqlcachedriver.cpp \
+                kernel/qsparqlquerytemplate.cpp \
+                kernel/qsparqllexer.cpp \
+                kernel/qsparqlbatchresult.cpp \
+                kernel/qsparqlxsd.cpp \
                 kernel/qsparqlresult.cpp 
 
@@ -0,0 +1,120 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsparqlbatchresult_p.h"
+
+#include "qsparqlerror.h"
+#include "qsparqlbinding.h"
+#include "qsparqlresultrow.h"
+
+QT_BEGIN_NAMESPACE
+
+QSparqlBatchItemResult::QSparqlBatchItemResult(const QSharedPointer<QSparqlResult>& b,
+                                               const QString& query,
+                                               QSparqlQuery::StatementType type)
+    : batch(b), done(false)
+{
+    setQuery(query);
+    setStatementType(type);
+    if (batch->isFinished()) {
+        // Synchronously executed batch; there is no finished() signal to wait
+        // for
+        if (batch->hasError())
+            setLastError(batch->lastError());
+        done = true;
+    } else {
+        connect(batch.data(), SIGNAL(finished()), this, SLOT(batchFinished()));
+    }
+}
+
+QSparqlBatchItemResult::~QSparqlBatchItemResult()
+{
+}
+
+QSparqlResultRow QSparqlBatchItemResult::current() const
+{
+    return QSparqlResultRow();
+}
+
+QSparqlBinding QSparqlBatchItemResult::binding(int) const
+{
+    return QSparqlBinding();
+}
+
+QVariant QSparqlBatchItemResult::value(int) const
+{
+    return QVariant();
+}
+
+int QSparqlBatchItemResult::size() const
+{
+    return 0;
+}
+
+void QSparqlBatchItemResult::waitForFinished()
+{
+    if (done)
+        return;
+    batch->waitForFinished();
+    // The batch result normally emits finished() from waitForFinished(), but
+    // don't rely on it
+    batchFinished();
+}
+
+bool QSparqlBatchItemResult::isFinished() const
+{
+    return done;
+}
+
+bool QSparqlBatchItemResult::hasFeature(QSparqlResult::Feature feature) const
+{
+    return batch->hasFeature(feature);
+}
+
+void QSparqlBatchItemResult::batchFinished()
+{
+    if (done)
+        return;
+    if (batch->hasError())
+        setLastError(batch->lastError());
+    done = true;
+    Q_EMIT finished();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSPARQLBATCHRESULT_P_H
+#define QSPARQLBATCHRESULT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  This header file may
+// change from version to version without notice, or even be
+// removed.
+//
+// We mean it.
+//
+
+#include <qsparqlresult.h>
+
+#include <QtCore/qsharedpointer.h>
+
+QT_BEGIN_HEADER
+
+QT_BEGIN_NAMESPACE
+
+QT_MODULE(Sparql)
+
+// The result of one query of a batch which the driver executed as a single
+// request (see QSparqlDriver::execMany()). All the items of the batch share
+// the underlying result, and report its completion and error.
+class Q_SPARQL_EXPORT QSparqlBatchItemResult : public QSparqlResult
+{
+    Q_OBJECT
+public:
+    QSparqlBatchItemResult(const QSharedPointer<QSparqlResult>& batch,
+                           const QString& query,
+                           QSparqlQuery::StatementType type);
+    ~QSparqlBatchItemResult();
+
+    QSparqlResultRow current() const;
+    QSparqlBinding binding(int i) const;
+    QVariant value(int i) const;
+    int size() const;
+
+    void waitForFinished();
+    bool isFinished() const;
+    bool hasFeature(QSparqlResult::Feature feature) const;
+
+private Q_SLOTS:
+    void batchFinished();
+
+private:
+    QSharedPointer<QSparqlResult> batch;
+    bool done;
+};
+
+QT_END_NAMESPACE
+
+QT_END_HEADER
+
+#endif // QSPARQLBATCHRESULT_P_H
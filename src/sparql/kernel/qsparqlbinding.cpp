@@ -44,8 +44,15 @@
 #include <QtCore/qdatetime.h>
 #include <QtCore/qregexp.h>
 
-#define XSD_ALL
+#include "qsparqlbinding_p.h"
 #include "qsparqlxsd_p.h"
+#include "qsparqlmemoryusage_p.h"
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#  include <arm_neon.h>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -55,13 +62,15 @@ public:
     enum NodeType { Invalid, Uri, Literal, Blank };
 
     QSparqlBindingPrivate(const QString &name) :
-        ref(1), nm(name), nodetype(QSparqlBindingPrivate::Invalid)
+        ref(1), nm(name), dataTypeId(XSD::UnknownType),
+        nodetype(QSparqlBindingPrivate::Invalid)
     {
     }
 
     QSparqlBindingPrivate(const QSparqlBindingPrivate &other)
         : ref(1),
           nm(other.nm),
+          dataTypeId(other.dataTypeId),
           dataType(other.dataType),
           lang(other.lang),
           nodetype(other.nodetype)
@@ -70,12 +79,27 @@ public:
     bool operator==(const QSparqlBindingPrivate& other) const
     {
         return (nodetype == other.nodetype
+                && dataTypeId == other.dataTypeId
                 && dataType == other.dataType
                 && lang == other.lang);
     }
 
+    bool hasDataType() const
+    {
+        return dataTypeId != XSD::UnknownType || !dataType.isEmpty();
+    }
+
+    void setDataType(XSD::TypeId id)
+    {
+        dataTypeId = id;
+        dataType = QUrl();
+    }
+
     QAtomicInt ref;
     QString nm;
+    // Well-known XSD data types are stored as an ID, and converted into a
+    // QUrl only in dataTypeUri(). dataType holds any other data type.
+    XSD::TypeId dataTypeId;
     QUrl dataType;
     QString lang;
     NodeType nodetype;
@@ -188,7 +212,9 @@ QSparqlBinding::~QSparqlBinding()
 void QSparqlBinding::setDataTypeUri(const QUrl &dataType)
 {
     detach();
-    d->dataType = dataType;
+    const XSD::TypeId id = XSD::typeId(dataType);
+    d->dataTypeId = id;
+    d->dataType = (id == XSD::UnknownType) ? dataType : QUrl();
 }
 
 /*!
@@ -216,214 +242,375 @@ static int extractTimezone(QString& str)
     return 0;
 }
 
-/*!
-    Sets the binding's value and the URI of its data type
-
-    \sa dataTypeUri() setDataTypeUri()
-*/
-void QSparqlBinding::setValue(const QString& value, const QUrl& dataTypeUri)
+// Converts value into the type of the data type id; returns false if value
+// isn't valid for the type
+static bool setLiteralValue(QSparqlBinding* binding, const QString& value, XSD::TypeId id)
 {
-    d->nodetype = QSparqlBindingPrivate::Literal;
-    QByteArray s = dataTypeUri.toString().toLatin1();
     bool ok = true;
 
-    if (s == "http://www.w3.org/2001/XMLSchema#int") {
-        d->dataType = *XSD::Int();
-        setValue(value.toInt(&ok));
-    } else if (s == "http://www.w3.org/2001/XMLSchema#integer") {
-        d->dataType = *XSD::Integer();
-        setValue(value.toLongLong(&ok));
-    } else if (s == "http://www.w3.org/2001/XMLSchema#nonNegativeInteger") {
-        d->dataType = *XSD::NonNegativeInteger();
-        setValue(value.toULongLong(&ok));
-    } else if (s == "http://www.w3.org/2001/XMLSchema#unsignedInt") {
-        d->dataType = *XSD::UnsignedInt();
-        setValue(value.toUInt(&ok));
-    } else if (s == "http://www.w3.org/2001/XMLSchema#decimal") {
-        d->dataType = *XSD::Decimal();
-        setValue(value.toDouble(&ok));
-    } else if (s == "http://www.w3.org/2001/XMLSchema#short") {
-        d->dataType = *XSD::Short();
-        setValue(value.toInt(&ok));
-    } else if (s == "http://www.w3.org/2001/XMLSchema#long") {
-        d->dataType = *XSD::Long();
-        setValue(value.toLongLong(&ok));
-    } else if (s == "http://www.w3.org/2001/XMLSchema#unsignedLong") {
-        d->dataType = *XSD::UnsignedLong();
-        setValue(value.toULongLong(&ok));
-    } else if (s == "http://www.w3.org/2001/XMLSchema#boolean") {
-        d->dataType = *XSD::Boolean();
-        setValue(value.toLower() == QLatin1String("true") || value.toLower() == QLatin1String("yes") || value.toInt() != 0);
-    } else if (s == "http://www.w3.org/2001/XMLSchema#double") {
-        d->dataType = *XSD::Double();
-        setValue(value.toDouble(&ok));
-    } else if (s == "http://www.w3.org/2001/XMLSchema#float") {
-        d->dataType = *XSD::Float();
-        setValue(value.toDouble(&ok));
-    } else if (s == "http://www.w3.org/2001/XMLSchema#string") {
-        d->dataType = *XSD::String();
-        setValue(value);
-    } else if (s == "http://www.w3.org/2001/XMLSchema#date") {
-        d->dataType = *XSD::Date();
+    switch (id) {
+    case XSD::IntType:
+    case XSD::ShortType:
+        binding->setValue(value.toInt(&ok));
+        break;
+    case XSD::IntegerType:
+    case XSD::LongType:
+        binding->setValue(value.toLongLong(&ok));
+        break;
+    case XSD::NonNegativeIntegerType:
+    case XSD::UnsignedLongType:
+        binding->setValue(value.toULongLong(&ok));
+        break;
+    case XSD::UnsignedIntType:
+        binding->setValue(value.toUInt(&ok));
+        break;
+    case XSD::DecimalType:
+    case XSD::DoubleType:
+    case XSD::FloatType:
+        binding->setValue(value.toDouble(&ok));
+        break;
+    case XSD::BooleanType:
+        binding->setValue(value.toLower() == QLatin1String("true") || value.toLower() == QLatin1String("yes") || value.toInt() != 0);
+        break;
+    case XSD::DateType:
+    {
         // xsd:dates can have timezones which aren't supported by QDate,
         // so convert to UTC time and use the derived date
         QString v(value);
         int adjustment = extractTimezone(v);
         QDateTime dt = QDateTime::fromString(v, Qt::ISODate);
         dt = dt.addSecs(adjustment);
-        setValue(dt.date());
-    } else if (s == "http://www.w3.org/2001/XMLSchema#time") {
-        d->dataType = *XSD::Time();
+        binding->setValue(dt.date());
+        break;
+    }
+    case XSD::TimeType:
+    {
         // xsd:times can have timezones which aren't supported by QTime,
         // so convert to UTC time and use that
         QString v(value);
         int adjustment = extractTimezone(v);
-        setValue(QTime::fromString(v, Qt::ISODate).addSecs(adjustment));
-    } else if (s == "http://www.w3.org/2001/XMLSchema#dateTime") {
-        d->dataType = *XSD::DateTime();
-        setValue(QDateTime::fromString(value, Qt::ISODate));
-    } else if (s == "http://www.w3.org/2001/XMLSchema#base64Binary") {
-        d->dataType = *XSD::Base64Binary();
-        setValue(QByteArray::fromBase64(value.toLatin1()));
-    } else {
+        binding->setValue(QTime::fromString(v, Qt::ISODate).addSecs(adjustment));
+        break;
+    }
+    case XSD::DateTimeType:
+        binding->setValue(QDateTime::fromString(value, Qt::ISODate));
+        break;
+    case XSD::Base64BinaryType:
+        binding->setValue(QByteArray::fromBase64(value.toLatin1()));
+        break;
+    default:
+        // xsd:string, or a data type we don't convert
+        binding->setValue(value);
+        break;
+    }
+    return ok;
+}
+
+/*!
+    Sets the binding's value and the URI of its data type
+
+    \sa dataTypeUri() setDataTypeUri()
+*/
+void QSparqlBinding::setValue(const QString& value, const QUrl& dataTypeUri)
+{
+    d->nodetype = QSparqlBindingPrivate::Literal;
+    const XSD::TypeId id = XSD::typeId(dataTypeUri);
+    const bool ok = setLiteralValue(this, value, id);
+
+    if (id == XSD::UnknownType) {
+        d->dataTypeId = XSD::UnknownType;
         d->dataType = dataTypeUri;
-        setValue(value);
+    } else {
+        d->setDataType(id);
     }
 
     if (!ok)
-        qWarning() << "QSparqlBinding::setValue(): Conversion error:" << value << "type:" << d->dataType.toString();
+        qWarning() << "QSparqlBinding::setValue(): Conversion error:" << value << "type:" << dataTypeUri.toString();
+}
+
+void QSparqlTypedLiteral::setValue(QSparqlBinding* binding, const QString& value, XSD::TypeId id)
+{
+    binding->d->nodetype = QSparqlBindingPrivate::Literal;
+    const bool ok = setLiteralValue(binding, value, id);
+    binding->d->setDataType(id);
+
+    if (!ok)
+        qWarning() << "QSparqlBinding::setValue(): Conversion error:" << value << "type:" << XSD::typeUri(id).toString();
+}
+
+void QSparqlTypedLiteral::setDataType(QSparqlBinding* binding, XSD::TypeId id)
+{
+    binding->detach();
+    binding->d->setDataType(id);
 }
 
 /*!
     Returns a string representation of the node in a form suitable for
     using in a SPARQL query.
+
+    \sa appendTo()
 */
 
 QString QSparqlBinding::toString() const
 {
-    if (d->nodetype == QSparqlBindingPrivate::Uri)
-        return QLatin1Char('<') + QString::fromLatin1(val.toUrl().toEncoded()) + QLatin1Char('>');
-
-    if (d->nodetype == QSparqlBindingPrivate::Blank)
-        return QLatin1String("_:") + val.toString();
-
-    if (d->nodetype == QSparqlBindingPrivate::Literal) {
-        QString literal;
-
-        bool quoted = false;
-        switch (val.type()) {
-        case QVariant::Int:
-        case QVariant::LongLong:
-        case QVariant::UInt:
-        case QVariant::ULongLong:
-            literal = val.toString();
-            break;
-        case QVariant::Bool:
-            literal = val.toBool() ? QLatin1String("true") : QLatin1String("false");
-            break;
-        case QVariant::Double:
-            if (dataTypeUri() == QUrl::fromEncoded("http://www.w3.org/2001/XMLSchema#decimal")) {
-                literal = QString::number(val.toDouble(), 'f', 10);
-                literal.replace(QRegExp(QString::fromLatin1("0+$")), QString::fromLatin1(""));
-            } else {
-                literal = QString::number(val.toDouble(), 'e', 10);
-            }
-            break;
-        case QVariant::String:
-        {
-            quoted = true;
-            literal.append(QLatin1Char('\"'));
-            Q_FOREACH (const QChar ch, val.toString()) {
-                if (ch == QLatin1Char('\t'))
-                    literal.append(QLatin1String("\\t"));
-                else if (ch == QLatin1Char('\n'))
-                    literal.append(QLatin1String("\\n"));
-                else if (ch == QLatin1Char('\r'))
-                    literal.append(QLatin1String("\\r"));
-                else if (ch == QLatin1Char('\b'))
-                    literal.append(QLatin1String("\\b"));
-                else if (ch == QLatin1Char('\f'))
-                    literal.append(QLatin1String("\\f"));
-                else if (ch == QLatin1Char('\"'))
-                    literal.append(QLatin1String("\\\""));
-                else if (ch == QLatin1Char('\''))
-                    literal.append(QLatin1String("\\\'"));
-                else if (ch == QLatin1Char('\\'))
-                    literal.append(QLatin1String("\\\\"));
-                else
-                    literal.append(ch);
-            }
-            literal.append(QLatin1Char('\"'));
-            break;
-        }
-        case QVariant::Date:
-        {
-            quoted = true;
-            QDate dt = val.toDate();
-            // Date format has to be "yyyy-MM-dd", with leading zeroes if month or day < 10
-            literal = QLatin1Char('\"') + QString::number(dt.year()) + QLatin1Char('-') +
-                QString::number(dt.month()).rightJustified(2, QLatin1Char('0'), true) +
-                QLatin1Char('-') +
-                QString::number(dt.day()).rightJustified(2, QLatin1Char('0'), true) + QLatin1Char('\"');
-            break;
-        }
-        case QVariant::Time:
-        {
-            quoted = true;
-            QTime tm = val.toTime();
-            // Time format has to be "hh:mm:ss"
-            literal = QLatin1Char('\"') + tm.toString() + QLatin1Char('\"');
-            break;
-        }
-        case QVariant::DateTime:
-        {
-            quoted = true;
-            QDateTime dt = val.toDateTime();
-            int offset = dt.utcOffset();
-            QDate date = val.toDateTime().date();
-            QTime time = val.toDateTime().time();
-            // DateTime format has to be "yyyy-MM-ddThh:mm:ss", with leading zeroes if month or day < 10
-            literal = QLatin1Char('\"') + QString::number(date.year()) + QLatin1Char('-') +
-                QString::number(date.month()).rightJustified(2, QLatin1Char('0'), true) +
-                QLatin1Char('-') +
-                QString::number(date.day()).rightJustified(2, QLatin1Char('0'), true) +
-                QLatin1Char('T') +
-                time.toString();
-
-            if (offset != 0) {
-                QTime zone(0, 0, 0);
-                zone.addSecs(offset);
-                if (offset > 0)
-                    literal.append(zone.toString(QLatin1String("+HH:mm")));
-                else
-                    literal.append(zone.toString(QLatin1String("-HH:mm")));
-            }
-
-            literal.append(QLatin1Char('\"'));
-            break;
+    QString str;
+    appendTo(&str);
+    return str;
+}
+
+// Escaping literals: only the characters below 0x80 listed in
+// escapeSequence() need to be escaped. The scan for them looks at eight
+// UTF-16 code units at a time where SSE2 or NEON is available; the clean
+// runs between the hits are appended with a single copy.
+
+static inline bool isEscapeCandidate(ushort c)
+{
+    // All control characters up to '\r' are candidates, which keeps the
+    // vector comparison to one unsigned range check plus three equalities.
+    return c <= '\r' || c == '\"' || c == '\'' || c == '\\';
+}
+
+static inline const char* escapeSequence(ushort c)
+{
+    switch (c) {
+    case '\t': return "\\t";
+    case '\n': return "\\n";
+    case '\r': return "\\r";
+    case '\b': return "\\b";
+    case '\f': return "\\f";
+    case '\"': return "\\\"";
+    case '\'': return "\\\'";
+    case '\\': return "\\\\";
+    default: return 0;
+    }
+}
+
+// Returns the index of the first character at or after \a from which may
+// need escaping, or \a len if there is none.
+static int findEscapeCandidate(const ushort* s, int from, int len)
+{
+    int i = from;
+#if defined(__SSE2__)
+    const __m128i controls = _mm_set1_epi16('\r');
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i dquote = _mm_set1_epi16('\"');
+    const __m128i squote = _mm_set1_epi16('\'');
+    const __m128i backslash = _mm_set1_epi16('\\');
+    for (; i + 8 <= len; i += 8) {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        // c <= '\r' as an unsigned comparison: the saturated subtraction is 0
+        __m128i hits = _mm_cmpeq_epi16(_mm_subs_epu16(c, controls), zero);
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi16(c, dquote));
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi16(c, squote));
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi16(c, backslash));
+        const int mask = _mm_movemask_epi8(hits);
+        if (mask)
+            return i + (__builtin_ctz(mask) >> 1);
+    }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    const uint16x8_t controls = vdupq_n_u16('\r');
+    const uint16x8_t dquote = vdupq_n_u16('\"');
+    const uint16x8_t squote = vdupq_n_u16('\'');
+    const uint16x8_t backslash = vdupq_n_u16('\\');
+    for (; i + 8 <= len; i += 8) {
+        const uint16x8_t c = vld1q_u16(s + i);
+        uint16x8_t hits = vcleq_u16(c, controls);
+        hits = vorrq_u16(hits, vceqq_u16(c, dquote));
+        hits = vorrq_u16(hits, vceqq_u16(c, squote));
+        hits = vorrq_u16(hits, vceqq_u16(c, backslash));
+        // Narrow each 16 bit lane into one byte of a 64 bit mask
+        const quint64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(hits, 4)), 0);
+        if (mask)
+            return i + (__builtin_ctzll(mask) >> 3);
+    }
+#endif
+    for (; i < len; ++i) {
+        if (isEscapeCandidate(s[i]))
+            return i;
+    }
+    return len;
+}
+
+static void appendEscaped(QString& out, const QString& str)
+{
+    const ushort* s = reinterpret_cast<const ushort*>(str.constData());
+    const int len = str.size();
+    int run = 0;
+    for (int i = findEscapeCandidate(s, 0, len); i < len; i = findEscapeCandidate(s, i + 1, len)) {
+        const char* escaped = escapeSequence(s[i]);
+        if (!escaped)
+            continue;
+        if (i > run)
+            out.append(QStringRef(&str, run, i - run));
+        out.append(QLatin1String(escaped));
+        run = i + 1;
+    }
+    if (run == 0)
+        out.append(str);
+    else if (run < len)
+        out.append(QStringRef(&str, run, len - run));
+}
+
+static void appendTwoDigits(QString& out, int n)
+{
+    out.append(QLatin1Char('0' + (n / 10) % 10));
+    out.append(QLatin1Char('0' + n % 10));
+}
+
+/*!
+    Appends the string representation of the node, as returned by
+    toString(), to \a target.
+
+    Serializing many bindings into one buffer this way, for example when
+    generating a large \c{INSERT DATA} update, avoids creating a temporary
+    string for each of them.
+
+    \sa toString()
+*/
+
+void QSparqlBinding::appendTo(QString* target) const
+{
+    QString& out = *target;
+
+    if (d->nodetype == QSparqlBindingPrivate::Uri) {
+        out.append(QLatin1Char('<'));
+        out.append(QString::fromLatin1(val.toUrl().toEncoded()));
+        out.append(QLatin1Char('>'));
+        return;
+    }
+
+    if (d->nodetype == QSparqlBindingPrivate::Blank) {
+        out.append(QLatin1String("_:"));
+        out.append(val.toString());
+        return;
+    }
+
+    if (d->nodetype != QSparqlBindingPrivate::Literal)
+        return;
+
+    bool quoted = false;
+    switch (val.type()) {
+    case QVariant::String:
+    case QVariant::Date:
+    case QVariant::Time:
+    case QVariant::DateTime:
+    case QVariant::ByteArray:
+        quoted = true;
+        break;
+    default:
+        break;
+    }
+
+    // Unquoted literals are quoted when a data type follows them
+    const bool addQuotes = !quoted && d->hasDataType();
+    if (addQuotes)
+        out.append(QLatin1Char('\"'));
+
+    switch (val.type()) {
+    case QVariant::Int:
+    case QVariant::LongLong:
+    case QVariant::UInt:
+    case QVariant::ULongLong:
+        out.append(val.toString());
+        break;
+    case QVariant::Bool:
+        out.append(val.toBool() ? QLatin1String("true") : QLatin1String("false"));
+        break;
+    case QVariant::Double:
+        if (d->dataTypeId == XSD::DecimalType) {
+            QString number = QString::number(val.toDouble(), 'f', 10);
+            int length = number.size();
+            while (length > 0 && number.at(length - 1) == QLatin1Char('0'))
+                --length;
+            out.append(QStringRef(&number, 0, length));
+        } else {
+            out.append(QString::number(val.toDouble(), 'e', 10));
         }
-        case QVariant::ByteArray:
-            quoted = true;
-            literal = QLatin1Char('\"') + QString::fromLatin1(val.toByteArray().toBase64()) + QLatin1Char('\"');
-            break;
-        default:
-            break;
+        break;
+    case QVariant::String:
+    {
+        const QString str = val.toString();
+        // Growing a caller's buffer is left to QString, reserving an exact
+        // size for each binding would defeat its geometric growth.
+        if (out.isEmpty())
+            out.reserve(str.size() + 2);
+        out.append(QLatin1Char('\"'));
+        appendEscaped(out, str);
+        out.append(QLatin1Char('\"'));
+        break;
+    }
+    case QVariant::Date:
+    {
+        QDate dt = val.toDate();
+        // Date format has to be "yyyy-MM-dd", with leading zeroes if month or day < 10
+        out.append(QLatin1Char('\"'));
+        out.append(QString::number(dt.year()));
+        out.append(QLatin1Char('-'));
+        appendTwoDigits(out, dt.month());
+        out.append(QLatin1Char('-'));
+        appendTwoDigits(out, dt.day());
+        out.append(QLatin1Char('\"'));
+        break;
+    }
+    case QVariant::Time:
+    {
+        QTime tm = val.toTime();
+        // Time format has to be "hh:mm:ss"
+        out.append(QLatin1Char('\"'));
+        out.append(tm.toString());
+        out.append(QLatin1Char('\"'));
+        break;
+    }
+    case QVariant::DateTime:
+    {
+        QDateTime dt = val.toDateTime();
+        int offset = dt.utcOffset();
+        QDate date = dt.date();
+        QTime time = dt.time();
+        // DateTime format has to be "yyyy-MM-ddThh:mm:ss", with leading zeroes if month or day < 10
+        out.append(QLatin1Char('\"'));
+        out.append(QString::number(date.year()));
+        out.append(QLatin1Char('-'));
+        appendTwoDigits(out, date.month());
+        out.append(QLatin1Char('-'));
+        appendTwoDigits(out, date.day());
+        out.append(QLatin1Char('T'));
+        out.append(time.toString());
+
+        if (offset != 0) {
+            QTime zone(0, 0, 0);
+            zone.addSecs(offset);
+            if (offset > 0)
+                out.append(zone.toString(QLatin1String("+HH:mm")));
+            else
+                out.append(zone.toString(QLatin1String("-HH:mm")));
         }
 
-        if (!d->lang.isEmpty())
-            literal.append(QLatin1Char('@') + d->lang);
+        out.append(QLatin1Char('\"'));
+        break;
+    }
+    case QVariant::ByteArray:
+        out.append(QLatin1Char('\"'));
+        out.append(QString::fromLatin1(val.toByteArray().toBase64()));
+        out.append(QLatin1Char('\"'));
+        break;
+    default:
+        break;
+    }
 
-        if (!d->dataType.isEmpty()) {
-            if (!quoted) {
-                literal.prepend(QLatin1String("\""));
-                literal.append(QLatin1String("\""));
-            }
-            literal.append(QLatin1String("^^<") + QString::fromLatin1(dataTypeUri().toEncoded()) + QLatin1Char('>'));
-        }
-        return literal;
+    if (!d->lang.isEmpty()) {
+        out.append(QLatin1Char('@'));
+        out.append(d->lang);
     }
 
-    return QString();
+    if (addQuotes)
+        out.append(QLatin1Char('\"'));
+
+    if (d->hasDataType()) {
+        out.append(QLatin1String("^^<"));
+        out.append(QString::fromLatin1(dataTypeUri().toEncoded()));
+        out.append(QLatin1Char('>'));
+    }
 }
 
 /*!
@@ -474,7 +661,7 @@ void QSparqlBinding::clear()
 {
     val = QVariant();
     d->nodetype = QSparqlBindingPrivate::Invalid;
-    d->dataType = QUrl();
+    d->setDataType(XSD::UnknownType);
     d->lang = QString();
 }
 
@@ -520,33 +707,36 @@ QUrl QSparqlBinding::dataTypeUri() const
     if (d->nodetype != QSparqlBindingPrivate::Literal)
         return QUrl();
 
+    if (d->dataTypeId != XSD::UnknownType)
+        return XSD::typeUri(d->dataTypeId);
+
     if (!d->dataType.isEmpty()) {
         return d->dataType;
     }
 
     switch (val.type()) {
     case QVariant::Int:
-        return *XSD::Int();
+        return XSD::typeUri(XSD::IntType);
     case QVariant::LongLong:
-        return *XSD::Long();
+        return XSD::typeUri(XSD::LongType);
     case QVariant::UInt:
-        return *XSD::UnsignedInt();
+        return XSD::typeUri(XSD::UnsignedIntType);
     case QVariant::ULongLong:
-        return *XSD::UnsignedLong();
+        return XSD::typeUri(XSD::UnsignedLongType);
     case QVariant::Bool:
-        return *XSD::Boolean();
+        return XSD::typeUri(XSD::BooleanType);
     case QVariant::Double:
-        return *XSD::Double();
+        return XSD::typeUri(XSD::DoubleType);
     case QVariant::String:
-        return *XSD::String();
+        return XSD::typeUri(XSD::StringType);
     case QVariant::Date:
-        return *XSD::Date();
+        return XSD::typeUri(XSD::DateType);
     case QVariant::Time:
-        return *XSD::Time();
+        return XSD::typeUri(XSD::TimeType);
     case QVariant::DateTime:
-        return *XSD::DateTime();
+        return XSD::typeUri(XSD::DateTimeType);
     case QVariant::ByteArray:
-        return *XSD::Base64Binary();
+        return XSD::typeUri(XSD::Base64BinaryType);
     default:
         return QUrl();
     }
@@ -627,4 +817,16 @@ QDebug operator<<(QDebug dbg, const QSparqlBinding &f)
 // LCOV_EXCL_STOP
 #endif
 
+// Defined here for the access to QSparqlBindingPrivate
+void QSparqlMemoryUsage::add(const QSparqlBinding& binding)
+{
+    add(binding.val);
+    if (binding.d && isFirstSeen(binding.d)) {
+        addAllocation(sizeof(QSparqlBindingPrivate));
+        add(binding.d->nm);
+        add(binding.d->dataType);
+        add(binding.d->lang);
+    }
+}
+
 QT_END_NAMESPACE
@@ -83,6 +83,7 @@ public:
     void clear();
     QUrl dataTypeUri() const;
     QString toString() const;
+    void appendTo(QString* target) const;
 
     void setDataTypeUri(const QUrl& datatype);
     void setLanguageTag(const QString& lang);
@@ -91,6 +92,8 @@ public:
     bool isValid() const;
 
 private:
+    friend class QSparqlMemoryUsage;
+    friend class QSparqlTypedLiteral;
     void detach();
     QVariant val;
     QSparqlBindingPrivate* d;
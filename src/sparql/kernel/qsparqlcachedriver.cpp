@@ -0,0 +1,440 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsparqlcachedriver_p.h"
+#include "qsparqlconnection_p.h"
+#include "qsparqlmemoryusage_p.h"
+
+#include <qsparqlbinding.h>
+#include <qsparqlerror.h>
+#include <qsparqlqueryoptions.h>
+#include <qsparqlresultrow.h>
+
+#include <QtCore/qdebug.h>
+#include <QtCore/qmetaobject.h>
+#include <QtCore/qurl.h>
+
+#include <limits.h>
+
+QT_BEGIN_NAMESPACE
+
+// The memory taken by an entry, used as its cost in the cache
+static int estimateCost(const QSparqlCacheEntry& entry)
+{
+    QSparqlMemoryUsage usage;
+    usage.addAllocation(sizeof(QSparqlCacheEntry));
+    usage.add(entry.rows);
+    usage.add(entry.tags);
+    return int(qMin(usage.total(), qint64(INT_MAX)));
+}
+
+static bool isCachedStatement(QSparqlQuery::StatementType type)
+{
+    switch (type) {
+    case QSparqlQuery::SelectStatement:
+    case QSparqlQuery::AskStatement:
+    case QSparqlQuery::ConstructStatement:
+    case QSparqlQuery::DescribeStatement:
+        return true;
+    default:
+        return false;
+    }
+}
+
+QSparqlCacheResult::QSparqlCacheResult(const QSparqlCacheEntry& entry, const QString& query,
+                                       QSparqlQuery::StatementType type, bool sync)
+    : inner(0), generation(0), rows(entry.rows), done(false)
+{
+    setResultExtension(this);
+    setQuery(query);
+    setStatementType(type);
+    setBoolValue(entry.boolValue);
+    // A hit doesn't execute anything
+    markExecutionStarted();
+    markExecutionFinished();
+    if (sync) {
+        done = true;
+        addFetchedRows(rows.count());
+        markFetchFinished();
+    } else {
+        // Asynchronous results report their rows from the event loop, like
+        // the results of any other driver
+        QMetaObject::invokeMethod(this, "deliver", Qt::QueuedConnection);
+    }
+}
+
+QSparqlCacheResult::QSparqlCacheResult(QSparqlCacheDriver* d, QSparqlResult* result,
+                                       const QString& k, const QStringList& t,
+                                       QSparqlQuery::StatementType type)
+    : driver(d), inner(result), key(k), tags(t), generation(d->generation), done(false)
+{
+    setResultExtension(this);
+    setQuery(inner->query());
+    setStatementType(type);
+    inner->setParent(this);
+    markExecutionStarted();
+
+    if (inner->isFinished() || inner->hasFeature(QSparqlResult::Sync)) {
+        // Natively synchronous results are read to the end right away; it
+        // costs the same as iterating through them later
+        innerFinished();
+    } else {
+        connect(inner, SIGNAL(dataReady(int)), this, SLOT(innerDataReady()));
+        connect(inner, SIGNAL(finished()), this, SLOT(innerFinished()));
+    }
+}
+
+QSparqlCacheResult::~QSparqlCacheResult()
+{
+}
+
+QSparqlResultRow QSparqlCacheResult::current() const
+{
+    if (!isValid() || pos() >= rows.count())
+        return QSparqlResultRow();
+    return rows[pos()];
+}
+
+QSparqlBinding QSparqlCacheResult::binding(int i) const
+{
+    if (!isValid() || pos() >= rows.count())
+        return QSparqlBinding();
+    return rows[pos()].binding(i);
+}
+
+QVariant QSparqlCacheResult::value(int i) const
+{
+    if (!isValid() || pos() >= rows.count())
+        return QVariant();
+    return rows[pos()].value(i);
+}
+
+int QSparqlCacheResult::size() const
+{
+    return rows.count();
+}
+
+int QSparqlCacheResult::fetchRowBlock(int maxRows, QSparqlRowBlock *block)
+{
+    return fetchBlockFromRows(rows, QStringList(), maxRows, block);
+}
+
+void QSparqlCacheResult::waitForFinished()
+{
+    if (done)
+        return;
+    if (inner)
+        inner->waitForFinished();
+    // Don't rely on the inner result emitting finished() from
+    // waitForFinished()
+    if (inner)
+        innerFinished();
+    else
+        deliver();
+}
+
+bool QSparqlCacheResult::isFinished() const
+{
+    return done;
+}
+
+bool QSparqlCacheResult::hasFeature(QSparqlResult::Feature feature) const
+{
+    // All the rows are kept, whatever the inner result does
+    return feature == QSparqlResult::QuerySize;
+}
+
+qint64 QSparqlCacheResult::resultMemoryUsage() const
+{
+    // The rows are shared with the cache entry, if there is one
+    QSparqlMemoryUsage usage;
+    usage.add(rows);
+    usage.add(tags);
+    usage.add(key);
+    qint64 total = usage.total();
+    if (inner)
+        total += inner->memoryUsage();
+    return total;
+}
+
+void QSparqlCacheResult::innerDataReady()
+{
+    const int oldCount = rows.count();
+    copyRows();
+    if (oldCount == 0)
+        markExecutionFinished();
+    addFetchedRows(rows.count() - oldCount);
+    Q_EMIT dataReady(rows.count());
+}
+
+void QSparqlCacheResult::innerFinished()
+{
+    if (done)
+        return;
+
+    const int oldCount = rows.count();
+    copyRows();
+    if (inner->hasFeature(QSparqlResult::ForwardOnly)) {
+        while (inner->next())
+            rows.append(inner->current());
+    }
+    if (oldCount == 0)
+        markExecutionFinished();
+    addFetchedRows(rows.count() - oldCount);
+    markFetchFinished();
+    if (inner->hasError())
+        setLastError(inner->lastError());
+    else
+        setBoolValue(inner->boolValue());
+    done = true;
+
+    // A result which an update may have overtaken is not stored
+    if (driver && !hasError() && generation == driver->generation)
+        driver->insert(key, rows, boolValue(), tags);
+
+    // This may be called from a signal of the inner result
+    inner->deleteLater();
+    inner = 0;
+
+    Q_EMIT dataReady(rows.count());
+    Q_EMIT finished();
+}
+
+void QSparqlCacheResult::deliver()
+{
+    if (done)
+        return;
+    done = true;
+    addFetchedRows(rows.count());
+    markFetchFinished();
+    Q_EMIT dataReady(rows.count());
+    Q_EMIT finished();
+}
+
+void QSparqlCacheResult::copyRows()
+{
+    // Forward only results are read once they have finished
+    if (inner->hasFeature(QSparqlResult::ForwardOnly))
+        return;
+    const int count = inner->size();
+    for (int i = rows.count(); i < count && inner->setPos(i); ++i)
+        rows.append(inner->current());
+}
+
+QSparqlCacheDriver::QSparqlCacheDriver(QObject* parent)
+    : QSparqlDriver(parent), inner(0), timeToLive(0), generation(0)
+{
+}
+
+QSparqlCacheDriver::~QSparqlCacheDriver()
+{
+    close();
+}
+
+bool QSparqlCacheDriver::hasFeature(QSparqlConnection::Feature f) const
+{
+    return inner && inner->hasFeature(f);
+}
+
+bool QSparqlCacheDriver::isOpen() const
+{
+    return inner && inner->isOpen();
+}
+
+bool QSparqlCacheDriver::hasError() const
+{
+    return !inner || inner->hasError();
+}
+
+/*
+    Opens the inner driver named by the "cacheDriver" option with the same
+    options. "cacheSize" sets the memory budget of the cache in bytes, and
+    "cacheTimeToLive" the time in milliseconds for which a result is served
+    from the cache, or 0 for no limit.
+*/
+bool QSparqlCacheDriver::open(const QSparqlConnectionOptions& options)
+{
+    close();
+
+    const QString innerType = options.option(QLatin1String("cacheDriver")).toString();
+    if (innerType.isEmpty() || innerType == QLatin1String("QSPARQL_CACHE")) {
+        setLastError(QSparqlError(QLatin1String("The cacheDriver option must name another driver"),
+                                  QSparqlError::ConnectionError));
+        setOpenError(true);
+        return false;
+    }
+
+    inner = qSparqlCreateDriver(innerType);
+    if (!inner) {
+        setLastError(QSparqlError(QString::fromLatin1("Driver %1 not loaded").arg(innerType),
+                                  QSparqlError::ConnectionError));
+        setOpenError(true);
+        return false;
+    }
+    inner->setParent(this);
+
+    const QVariant size = options.option(QLatin1String("cacheSize"));
+    cache.setMaxCost(size.isValid() ? size.toInt() : 4 * 1024 * 1024);
+    const QVariant ttl = options.option(QLatin1String("cacheTimeToLive"));
+    timeToLive = ttl.isValid() ? ttl.toInt() : 10000;
+
+    if (!inner->open(options)) {
+        setLastError(inner->lastError());
+        setOpenError(true);
+        return false;
+    }
+    setOpen(true);
+    setOpenError(false);
+    return true;
+}
+
+void QSparqlCacheDriver::close()
+{
+    invalidate();
+    pendingUpdates.clear();
+    if (inner) {
+        inner->close();
+        delete inner;
+        inner = 0;
+    }
+    setOpen(false);
+}
+
+bool QSparqlCacheDriver::beginTransaction()
+{
+    return inner && inner->beginTransaction();
+}
+
+bool QSparqlCacheDriver::commitTransaction()
+{
+    invalidate();
+    return inner && inner->commitTransaction();
+}
+
+bool QSparqlCacheDriver::rollbackTransaction()
+{
+    invalidate();
+    return inner && inner->rollbackTransaction();
+}
+
+QSparqlResult* QSparqlCacheDriver::exec(const QString& query, QSparqlQuery::StatementType type,
+                                        const QSparqlQueryOptions& options)
+{
+    // The prefixes are part of the query as far as the cache is concerned
+    const QString fullQuery = prefixes() + query;
+
+    if (!isCachedStatement(type)) {
+        // Drop the results the update may change now, and again once it has
+        // finished, since queries executed meanwhile may see the old data
+        const QStringList tags = options.cacheTags();
+        invalidate(tags);
+        QSparqlResult* result = inner->exec(fullQuery, type, options);
+        if (!result->isFinished()) {
+            pendingUpdates.insert(result, tags);
+            connect(result, SIGNAL(finished()), this, SLOT(updateFinished()));
+            connect(result, SIGNAL(destroyed()), this, SLOT(updateFinished()));
+        }
+        return result;
+    }
+
+    if (QSparqlCacheEntry* entry = cache.object(fullQuery)) {
+        if (timeToLive <= 0 || entry->age.elapsed() <= timeToLive)
+            return new QSparqlCacheResult(*entry, fullQuery, type,
+                                          options.executionMethod() == QSparqlQueryOptions::SyncExec);
+        cache.remove(fullQuery);
+        entryTags.remove(fullQuery);
+    }
+
+    return new QSparqlCacheResult(this, inner->exec(fullQuery, type, options),
+                                  fullQuery, options.cacheTags(), type);
+}
+
+/*
+    Removes the cached results with any of \a tags, and the results without
+    tags. Removes all the cached results if \a tags is empty.
+*/
+void QSparqlCacheDriver::invalidate(const QStringList& tags)
+{
+    ++generation;
+
+    if (tags.isEmpty()) {
+        cache.clear();
+        entryTags.clear();
+        return;
+    }
+
+    QHash<QString, QStringList>::iterator it = entryTags.begin();
+    while (it != entryTags.end()) {
+        bool remove = !cache.contains(it.key()) || it->isEmpty();
+        for (int i = 0; !remove && i < tags.count(); ++i)
+            remove = it->contains(tags[i]);
+        if (remove) {
+            cache.remove(it.key());
+            it = entryTags.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void QSparqlCacheDriver::updateFinished()
+{
+    QHash<QObject*, QStringList>::iterator it = pendingUpdates.find(sender());
+    if (it == pendingUpdates.end())
+        return;
+    const QStringList tags = it.value();
+    pendingUpdates.erase(it);
+    invalidate(tags);
+}
+
+void QSparqlCacheDriver::insert(const QString& key, const QVector<QSparqlResultRow>& rows,
+                                bool boolValue, const QStringList& tags)
+{
+    QSparqlCacheEntry* entry = new QSparqlCacheEntry;
+    entry->rows = rows;
+    entry->boolValue = boolValue;
+    entry->tags = tags;
+    entry->age.start();
+    // QCache deletes the entry if it doesn't fit at all
+    const int cost = estimateCost(*entry);
+    if (cache.insert(key, entry, cost))
+        entryTags.insert(key, tags);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,175 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSPARQLCACHEDRIVER_P_H
+#define QSPARQLCACHEDRIVER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  This header file may
+// change from version to version without notice, or even be
+// removed.
+//
+// We mean it.
+//
+
+#include <private/qsparqldriver_p.h>
+#include <private/qsparqlresultextension_p.h>
+#include <qsparqlresult.h>
+
+#include <QtCore/qcache.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_HEADER
+
+QT_BEGIN_NAMESPACE
+
+QT_MODULE(Sparql)
+
+class QSparqlCacheDriver;
+
+// The rows of a query result kept by QSparqlCacheDriver
+struct QSparqlCacheEntry
+{
+    QSparqlCacheEntry() : boolValue(false) {}
+
+    QVector<QSparqlResultRow> rows;
+    bool boolValue;
+    QStringList tags;
+    QElapsedTimer age;
+};
+
+// The result of a query executed through QSparqlCacheDriver. A result served
+// from the cache has its rows from the start; otherwise the rows are copied
+// from the result of the inner driver as they arrive, and stored in the cache
+// once it has finished.
+class Q_SPARQL_EXPORT QSparqlCacheResult : public QSparqlResult, public QSparqlResultExtension
+{
+    Q_OBJECT
+public:
+    QSparqlCacheResult(const QSparqlCacheEntry& entry, const QString& query,
+                       QSparqlQuery::StatementType type, bool sync);
+    QSparqlCacheResult(QSparqlCacheDriver* driver, QSparqlResult* inner,
+                       const QString& key, const QStringList& tags,
+                       QSparqlQuery::StatementType type);
+    ~QSparqlCacheResult();
+
+    QSparqlResultRow current() const;
+    QSparqlBinding binding(int i) const;
+    QVariant value(int i) const;
+    int size() const;
+    int fetchRowBlock(int maxRows, QSparqlRowBlock *block);
+
+    void waitForFinished();
+    bool isFinished() const;
+    bool hasFeature(QSparqlResult::Feature feature) const;
+    qint64 resultMemoryUsage() const;
+
+private Q_SLOTS:
+    void innerDataReady();
+    void innerFinished();
+    void deliver();
+
+private:
+    void copyRows();
+
+    QPointer<QSparqlCacheDriver> driver;
+    QSparqlResult* inner;
+    QString key;
+    QStringList tags;
+    int generation;
+    QVector<QSparqlResultRow> rows;
+    bool done;
+};
+
+// A driver which serves SELECT, ASK, CONSTRUCT and DESCRIBE queries from a
+// cache, and executes everything else with an inner driver. The updates
+// executed through it invalidate the cached results with a tag in common,
+// or all of them if the update has no tags.
+class Q_SPARQL_EXPORT QSparqlCacheDriver : public QSparqlDriver
+{
+    Q_OBJECT
+    friend class QSparqlCacheResult;
+public:
+    explicit QSparqlCacheDriver(QObject* parent = 0);
+    ~QSparqlCacheDriver();
+
+    bool hasFeature(QSparqlConnection::Feature f) const;
+    bool isOpen() const;
+    bool hasError() const;
+    bool open(const QSparqlConnectionOptions& options = QSparqlConnectionOptions());
+    void close();
+
+    bool beginTransaction();
+    bool commitTransaction();
+    bool rollbackTransaction();
+
+    QSparqlResult* exec(const QString& query, QSparqlQuery::StatementType type,
+                        const QSparqlQueryOptions& options);
+
+    void invalidate(const QStringList& tags = QStringList());
+
+private Q_SLOTS:
+    void updateFinished();
+
+private:
+    void insert(const QString& key, const QVector<QSparqlResultRow>& rows,
+                bool boolValue, const QStringList& tags);
+
+    QSparqlDriver* inner;
+    QCache<QString, QSparqlCacheEntry> cache;
+    // The tags of the cached results, kept aside since looking at the
+    // entries would reorder the cache
+    QHash<QString, QStringList> entryTags;
+    QHash<QObject*, QStringList> pendingUpdates;
+    int timeToLive;
+    int generation;
+};
+
+QT_END_NAMESPACE
+
+QT_END_HEADER
+
+#endif // QSPARQLCACHEDRIVER_P_H
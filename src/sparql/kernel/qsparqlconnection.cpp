@@ -72,10 +72,25 @@
 # include "qpluginloader.h"
 #endif
 #include "qsparqlnulldriver_p.h"
+#include "qsparqlcachedriver_p.h"
+#include "qsparqltracer_p.h"
 
+#include <QtCore/qatomic.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
 #include <QtCore/qhash.h>
+#include <QtCore/qtextstream.h>
 #include <QtCore/quuid.h>
 #include <QtCore/qmutex.h>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+# include <QtCore/qjsonarray.h>
+# include <QtCore/qjsonobject.h>
+# include <QtCore/qsavefile.h>
+#else
+# include <QtCore/qtemporaryfile.h>
+# include <stdio.h>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -100,6 +115,7 @@ public:
         drvName(name),
         options(opts)
     {
+        QSparqlTracer::initialize(options);
     }
     ~QSparqlConnectionPrivate();
 
@@ -113,10 +129,15 @@ public:
 
     static QSparqlConnectionPrivate* shared_null();
     QSparqlResult* checkErrors(const QString& queryText) const;
+    bool supportsStatement(QSparqlQuery::StatementType type) const;
 
+    // allKeys and pluginFiles are written once by initKeys(), and only read
+    // after keysRead is set
     static QStringList allKeys;
+    static QHash<QString, QString> pluginFiles;
+    static QAtomicInt keysRead;
     static QHash<QString, QSparqlDriverPlugin*> plugins;
-    static QMutex pluginMutex; // protexts allKeys, plugins and driverDict
+    static QMutex pluginMutex; // protects plugins, driverDict and initKeys()
 
     QSparqlDriver* driver;
     QString drvName;
@@ -153,6 +174,8 @@ DriverDict &QSparqlConnectionPrivate::driverDict()
     if (!qDriverDictInit) {
         qDriverDictInit = true;
         qAddPostRoutine(cleanDriverDict);
+        // Drivers which work on top of the others
+        dict.insert(QLatin1String("QSPARQL_CACHE"), new QSparqlDriverCreator<QSparqlCacheDriver>);
     }
     return dict;
 }
@@ -164,15 +187,14 @@ DriverDict &QSparqlConnectionPrivate::driverDict()
 
 QSparqlDriver* QSparqlConnectionPrivate::findDriver(const QString &type)
 {
-    QMutexLocker locker(&pluginMutex);
     // separately defined drivers (e.g., for tests)
     QSparqlDriver * driver = 0;
-    DriverDict dict = QSparqlConnectionPrivate::driverDict();
-    for (DriverDict::const_iterator it = dict.constBegin();
-         it != dict.constEnd() && !driver; ++it) {
-        if (type == it.key()) {
-            driver = ((QSparqlDriverCreatorBase*)(*it))->createObject();
-        }
+    {
+        QMutexLocker locker(&pluginMutex);
+        const DriverDict& dict = QSparqlConnectionPrivate::driverDict();
+        DriverDict::const_iterator it = dict.constFind(type);
+        if (it != dict.constEnd())
+            driver = (*it)->createObject();
     }
     if (driver)
         return driver;
@@ -232,61 +254,229 @@ QSparqlDriver* QSparqlConnectionPrivate::findDriverWithFactoryLoader(const QStri
 }
 
 QStringList QSparqlConnectionPrivate::allKeys;
+QHash<QString, QString> QSparqlConnectionPrivate::pluginFiles;
+QAtomicInt QSparqlConnectionPrivate::keysRead;
 QHash<QString, QSparqlDriverPlugin*> QSparqlConnectionPrivate::plugins;
 QMutex QSparqlConnectionPrivate::pluginMutex(QMutex::Recursive);
 
+#if !WE_ARE_QT
+
+// The plugin index caches the keys of each file in the sparqldrivers
+// directories, so that only the plugin of the driver being created gets
+// loaded. An entry is used while the file keeps its size and modification
+// time; the index is rewritten when a directory has changed.
+struct QSparqlPluginIndexEntry
+{
+    QSparqlPluginIndexEntry() : modified(0), size(0) {}
+
+    uint modified;
+    qint64 size;
+    QStringList keys; // empty for files which are not driver plugins
+};
+
+typedef QHash<QString, QSparqlPluginIndexEntry> QSparqlPluginIndex;
+
+static const char pluginIndexHeader[] = "# QtSparql plugin index 1";
+
+static QString pluginIndexFileName()
+{
+    const QByteArray fileName = qgetenv("QSPARQL_PLUGIN_INDEX");
+    if (!fileName.isEmpty())
+        return QFile::decodeName(fileName);
+
+    QString cache = QFile::decodeName(qgetenv("XDG_CACHE_HOME"));
+    if (cache.isEmpty())
+        cache = QDir::homePath() + QLatin1String("/.cache");
+    return cache + QLatin1String("/QtSparql/sparqldrivers.index");
+}
+
+// Each line is "modified <tab> size <tab> key,key... <tab> file name"
+static QSparqlPluginIndex readPluginIndex(const QString& fileName)
+{
+    QSparqlPluginIndex index;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return index;
+
+    QTextStream stream(&file);
+    stream.setCodec("UTF-8");
+    if (stream.readLine() != QLatin1String(pluginIndexHeader))
+        return index;
+
+    while (!stream.atEnd()) {
+        const QStringList fields = stream.readLine().split(QLatin1Char('\t'));
+        if (fields.count() != 4)
+            continue;
+        QSparqlPluginIndexEntry entry;
+        entry.modified = fields[0].toUInt();
+        entry.size = fields[1].toLongLong();
+        entry.keys = fields[2].split(QLatin1Char(','), QString::SkipEmptyParts);
+        index.insert(fields[3], entry);
+    }
+    return index;
+}
+
+static void writePluginIndex(QIODevice* device, const QSparqlPluginIndex& index)
+{
+    QTextStream stream(device);
+    stream.setCodec("UTF-8");
+    stream << pluginIndexHeader << '\n';
+    for (QSparqlPluginIndex::const_iterator it = index.constBegin(); it != index.constEnd(); ++it) {
+        stream << it->modified << '\t' << it->size << '\t'
+               << it->keys.join(QLatin1String(",")) << '\t' << it.key() << '\n';
+    }
+}
+
+static void writePluginIndex(const QString& fileName, const QSparqlPluginIndex& index)
+{
+    // Written aside and renamed over the old index in one step, so that
+    // other processes never read half of an index
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return;
+    writePluginIndex(&file, index);
+    file.commit();
+#else
+    // The temporary file is unique, so that processes writing the index at
+    // the same time don't write into the same file
+    QTemporaryFile file(fileName + QLatin1String(".XXXXXX"));
+    if (!file.open())
+        return;
+    writePluginIndex(&file, index);
+    file.close();
+    if (file.error() == QFile::NoError
+        && ::rename(QFile::encodeName(file.fileName()).constData(),
+                    QFile::encodeName(fileName).constData()) == 0)
+        file.setAutoRemove(false);
+#endif
+}
+
+// Reads the keys declared in the plugin metadata, which Qt 5 can do without
+// loading the library. Returns an empty list if the plugin declares none.
+static QStringList pluginMetaDataKeys(const QPluginLoader& loader)
+{
+    QStringList keys;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    const QJsonArray array = loader.metaData().value(QLatin1String("MetaData")).toObject()
+        .value(QLatin1String("Keys")).toArray();
+    for (int i = 0; i < array.size(); ++i)
+        keys << array.at(i).toString();
+#else
+    Q_UNUSED(loader)
+#endif
+    return keys;
+}
+
+static QSparqlDriverPlugin* loadDriverPlugin(QPluginLoader& loader)
+{
+    QObject* instance = loader.instance();
+    QFactoryInterface *factory = qobject_cast<QFactoryInterface*>(instance);
+    return dynamic_cast<QSparqlDriverPlugin*>(factory);
+}
+
+#endif // !WE_ARE_QT
+
 void QSparqlConnectionPrivate::initKeys()
 {
-    static bool keysRead = false;
+#if !WE_ARE_QT
+    if (keysRead.testAndSetAcquire(1, 1))
+        return;
 
-    if (keysRead)
+    QMutexLocker locker(&pluginMutex);
+    if (keysRead.testAndSetAcquire(1, 1))
         return;
 
     int debugLevel = QString::fromLatin1(getenv("QT_DEBUG_PLUGINS")).toInt();
 
+    const QString indexFileName = pluginIndexFileName();
+    QSparqlPluginIndex index = readPluginIndex(indexFileName);
+    bool indexChanged = false;
+
     QStringList paths = QCoreApplication::libraryPaths();
     Q_FOREACH(const QString& path, paths) {
-        QString realPath = path + QLatin1String("/sparqldrivers");
-        QStringList pluginNames = QDir(realPath).entryList(QDir::Files);
+        // The files are indexed by the canonical path of their directory,
+        // so that a directory reached through several library paths has
+        // one set of entries
+        const QString realPath = QDir(path + QLatin1String("/sparqldrivers")).canonicalPath();
+        if (realPath.isEmpty())
+            continue;
+        const QDir dir(realPath);
+        QStringList pluginNames = dir.entryList(QDir::Files);
+        QStringList fileNames;
         for (int j = 0; j < pluginNames.count(); ++j) {
-            QString fileName = QDir::cleanPath(realPath +
-                                                QLatin1Char('/') +
-                                                pluginNames.at(j));
+            const QString fileName = dir.absoluteFilePath(pluginNames.at(j));
+            fileNames << fileName;
             if (debugLevel) {
                 qDebug() << "QSparqlConnection looking at" << fileName;
             }
 
-            QPluginLoader loader(fileName);
-            QObject* instance = loader.instance();
-            QFactoryInterface *factory = qobject_cast<QFactoryInterface*>(instance);
-            QSparqlDriverPlugin* driPlu = dynamic_cast<QSparqlDriverPlugin*>(factory);
-            if (instance && factory && driPlu) {
-                QStringList keys = factory->keys();
-                for (int k = 0; k < keys.size(); ++k) {
-                    // Don't override values in plugins; this prefers plugins
-                    // that are found first.  E.g.,
-                    // QCoreApplication::addLibraryPath() prepends a path to the
-                    // list of library paths, and this say custom plugins are
-                    // found first.
-                    if (!plugins.contains(keys[k]))
-                        plugins[keys[k]] = driPlu;
-                }
-                allKeys.append(keys);
-                if (debugLevel) {
-                    qDebug() << "keys" << keys;
+            const QFileInfo info(fileName);
+            QSparqlPluginIndex::iterator entry = index.find(fileName);
+            if (entry == index.end() || entry->modified != info.lastModified().toTime_t()
+                || entry->size != info.size()) {
+                QSparqlPluginIndexEntry newEntry;
+                newEntry.modified = info.lastModified().toTime_t();
+                newEntry.size = info.size();
+
+                QPluginLoader loader(fileName);
+                newEntry.keys = pluginMetaDataKeys(loader);
+                if (newEntry.keys.isEmpty()) {
+                    // The keys can only be had from the plugin itself; keep
+                    // it since it is loaded now
+                    if (QSparqlDriverPlugin* driPlu = loadDriverPlugin(loader)) {
+                        newEntry.keys = driPlu->keys();
+                        Q_FOREACH(const QString& key, newEntry.keys) {
+                            if (!plugins.contains(key))
+                                plugins[key] = driPlu;
+                        }
+                    }
                 }
+                entry = index.insert(fileName, newEntry);
+                indexChanged = true;
             }
-            else {
+
+            const QStringList& keys = entry->keys;
+            if (keys.isEmpty()) {
                 if (debugLevel) {
                     qDebug() << "not a plugin";
                 }
+                continue;
+            }
+            for (int k = 0; k < keys.size(); ++k) {
+                // Don't override values in plugins; this prefers plugins
+                // that are found first.  E.g.,
+                // QCoreApplication::addLibraryPath() prepends a path to the
+                // list of library paths, and this say custom plugins are
+                // found first.
+                if (!pluginFiles.contains(keys[k]))
+                    pluginFiles[keys[k]] = fileName;
+            }
+            allKeys.append(keys);
+            if (debugLevel) {
+                qDebug() << "keys" << keys;
             }
+        }
 
+        // Forget the plugins which have been removed from this directory
+        const QString dirPrefix = realPath + QLatin1Char('/');
+        QSparqlPluginIndex::iterator it = index.begin();
+        while (it != index.end()) {
+            if (it.key().startsWith(dirPrefix) && !fileNames.contains(it.key())) {
+                it = index.erase(it);
+                indexChanged = true;
+            } else {
+                ++it;
+            }
         }
     }
 
-    keysRead = true;
-    return;
+    if (indexChanged)
+        writePluginIndex(indexFileName, index);
+
+    keysRead.fetchAndStoreRelease(1);
+#endif // !WE_ARE_QT
 }
 
 QSparqlDriver* QSparqlConnectionPrivate::findDriverWithPluginLoader(const QString &type)
@@ -296,9 +486,34 @@ QSparqlDriver* QSparqlConnectionPrivate::findDriverWithPluginLoader(const QStrin
 #else
     initKeys();
 
-    if (plugins.contains(type))
-        return plugins[type]->create(type);
-    return QSparqlConnectionPrivate::shared_null()->driver;
+    // The index is complete now and read without locking; only loading the
+    // plugin needs the lock
+    const QHash<QString, QString>::const_iterator file = pluginFiles.constFind(type);
+    if (file == pluginFiles.constEnd())
+        return QSparqlConnectionPrivate::shared_null()->driver;
+
+    QSparqlDriverPlugin* driPlu = 0;
+    {
+        QMutexLocker locker(&pluginMutex);
+        driPlu = plugins.value(type);
+        if (!driPlu) {
+            QPluginLoader loader(file.value());
+            driPlu = loadDriverPlugin(loader);
+            if (!driPlu) {
+                qWarning("QSparqlConnection: cannot load the %s driver: %s",
+                         type.toLatin1().data(), loader.errorString().toLatin1().data());
+                return QSparqlConnectionPrivate::shared_null()->driver;
+            }
+            Q_FOREACH(const QString& key, driPlu->keys()) {
+                if (!plugins.contains(key) && pluginFiles.value(key) == file.value())
+                    plugins[key] = driPlu;
+            }
+            // The index may be older than the file
+            if (!plugins.contains(type))
+                return QSparqlConnectionPrivate::shared_null()->driver;
+        }
+    }
+    return driPlu->create(type);
 #endif
 }
 
@@ -309,6 +524,14 @@ void qSparqlRegisterConnectionCreator(const QString& type,
     QSparqlConnectionPrivate::registerConnectionCreator(type, creator);
 }
 
+QSparqlDriver* qSparqlCreateDriver(const QString& type)
+{
+    QSparqlDriver* driver = QSparqlConnectionPrivate::findDriver(type);
+    if (driver == QSparqlConnectionPrivate::shared_null()->driver)
+        return 0;
+    return driver;
+}
+
 void QSparqlConnectionPrivate::registerConnectionCreator(const QString& name,
                                                          QSparqlDriverCreatorBase* creator)
 {
@@ -419,6 +642,22 @@ QSparqlResult* QSparqlConnectionPrivate::checkErrors(const QString& queryText) c
     return result;
 }
 
+/// Returns false if the driver cannot execute queries of type \a type.
+bool QSparqlConnectionPrivate::supportsStatement(QSparqlQuery::StatementType type) const
+{
+    switch (type) {
+    case QSparqlQuery::AskStatement:
+        return driver->hasFeature(QSparqlConnection::AskQueries);
+    case QSparqlQuery::InsertStatement:
+    case QSparqlQuery::DeleteStatement:
+        return driver->hasFeature(QSparqlConnection::UpdateQueries);
+    case QSparqlQuery::ConstructStatement:
+        return driver->hasFeature(QSparqlConnection::ConstructQueries);
+    default:
+        return true;
+    }
+}
+
 // TODO: isn't it quite bad that the user must check the error
 // state of the result? Or should the "error result" emit the
 // finished() signal when the main loop is entered the next time,
@@ -478,15 +717,12 @@ QSparqlResult* QSparqlConnection::exec(const QSparqlQuery& query)
 QSparqlResult* QSparqlConnection::exec(const  QSparqlQuery& query, const QSparqlQueryOptions& options)
 {
     QString queryText = query.preparedQueryText();
+    QSparqlTraceSpan span("QSparqlConnection::exec", queryText);
     QSparqlResult* result = d->checkErrors(queryText);
     if (!result) {
         // No error. FIXME: it's evil to return a 0 pointer to indicate "no
         // error".
-        if (    (query.type() == QSparqlQuery::AskStatement && !d->driver->hasFeature(AskQueries))
-                || (query.type() == QSparqlQuery::InsertStatement && !d->driver->hasFeature(UpdateQueries))
-                || (query.type() == QSparqlQuery::DeleteStatement && !d->driver->hasFeature(UpdateQueries))
-                || (query.type() == QSparqlQuery::ConstructStatement && !d->driver->hasFeature(ConstructQueries)) )
-        {
+        if (!d->supportsStatement(query.type())) {
             result = new QSparqlNullResult();
             result->setLastError(QSparqlError(
                                     QLatin1String("Unsupported statement type"),
@@ -535,6 +771,75 @@ QSparqlResult* QSparqlConnection::syncExec(const QSparqlQuery& query)
     return exec(query, options);
 }
 
+/*!
+    Executes \a query once for each row of \a parameterRows, with the
+    placeholders of \a query bound to the values of the row (see
+    QSparqlQuery::bindValues()), and returns one QSparqlResult per row, in
+    the same order.
+
+    This is equivalent to binding and calling exec() for each row, but the
+    query text is parsed only once, and the driver gets all the queries at
+    the same time: a driver may execute them as a single request to the
+    store. For example, the tracker direct driver executes a batch of
+    updates with one update call. In that case the results of all the rows
+    finish together and share the error, if any.
+
+    The results are owned as described for exec().
+
+    \sa exec(), QSparqlQuery::bindValues()
+*/
+QList<QSparqlResult*> QSparqlConnection::execMany(const QSparqlQuery& query,
+                                                  const QVector<QSparqlResultRow>& parameterRows)
+{
+    return execMany(query, parameterRows, QSparqlQueryOptions());
+}
+
+/*!
+    \overload
+
+    The query execution is controlled by \a options.
+*/
+QList<QSparqlResult*> QSparqlConnection::execMany(const QSparqlQuery& query,
+                                                  const QVector<QSparqlResultRow>& parameterRows,
+                                                  const QSparqlQueryOptions& options)
+{
+    QList<QSparqlResult*> results;
+    if (parameterRows.isEmpty())
+        return results;
+    // The template, as the parameters are only bound in the row queries
+    QSparqlTraceSpan span("QSparqlConnection::execMany", query.query());
+
+    bool valid = !d->driver->isOpenError() && d->driver->isOpen()
+                 && d->supportsStatement(query.type())
+                 && (d->driver->hasFeature(QSparqlConnection::SyncExec)
+                     || options.executionMethod() != QSparqlQueryOptions::SyncExec);
+
+    QStringList queryTexts;
+    for (int i = 0; valid && i < parameterRows.count(); ++i) {
+        // The copies share the parsed query text
+        QSparqlQuery rowQuery(query);
+        rowQuery.bindValues(parameterRows.at(i));
+        const QString queryText = rowQuery.preparedQueryText();
+        valid = !queryText.isEmpty();
+        queryTexts.append(queryText);
+    }
+
+    if (valid) {
+        results = d->driver->execMany(queryTexts, query.type(), options);
+        Q_FOREACH (QSparqlResult* result, results)
+            result->setParent(this);
+    } else {
+        // Let exec() report the errors, and emulate synchronous execution if
+        // needed, the usual way
+        for (int i = 0; i < parameterRows.count(); ++i) {
+            QSparqlQuery rowQuery(query);
+            rowQuery.bindValues(parameterRows.at(i));
+            results.append(exec(rowQuery, options));
+        }
+    }
+    return results;
+}
+
 /*!
     Returns the connection's driver name.
 */
@@ -673,10 +978,15 @@ QSparqlBinding QSparqlConnection::createUrn(const QString& name) const
 /*!
      Returns the list of available drivers.  The list contains driver names
      which can be passed to QSparqlConnection constructor.
+
+     The driver names of the plugins are kept in an index, by default
+     \c $XDG_CACHE_HOME/QtSparql/sparqldrivers.index, so that only the plugin
+     of the driver being used is loaded. The index is updated when plugins are
+     added, removed or modified. The QSPARQL_PLUGIN_INDEX environment variable
+     sets another location for it.
 */
 QStringList QSparqlConnection::drivers()
 {
-    QMutexLocker locker(&(QSparqlConnectionPrivate::pluginMutex));
     QStringList list;
 
 #ifdef QT_SPARQL_VIRTUOSO
@@ -712,7 +1022,8 @@ QStringList QSparqlConnection::drivers()
     }
 #endif
 
-    DriverDict dict = QSparqlConnectionPrivate::driverDict();
+    QMutexLocker locker(&(QSparqlConnectionPrivate::pluginMutex));
+    const DriverDict& dict = QSparqlConnectionPrivate::driverDict();
     for (DriverDict::const_iterator i = dict.constBegin(); i != dict.constEnd(); ++i) {
         if (!list.contains(i.key()))
             list << i.key();
@@ -49,7 +49,9 @@
 #include <qsparqlconnectionoptions.h>
 #include <qsparqlbinding.h>
 
+#include <QtCore/qlist.h>
 #include <QtCore/qstring.h>
+#include <QtCore/qvector.h>
 #include <QDebug>
 QT_BEGIN_HEADER
 
@@ -60,6 +62,7 @@ QT_MODULE(Sparql)
 class QSparqlError;
 class QSparqlQuery;
 class QSparqlResult;
+class QSparqlResultRow;
 class QSparqlConnectionPrivate;
 class QSparqlQueryOptions;
 class SparqlConnection;
@@ -82,6 +85,11 @@ public:
     QSparqlResult* exec(const QSparqlQuery& query);
     QSparqlResult* exec(const  QSparqlQuery& query, const QSparqlQueryOptions& options);
     QSparqlResult* syncExec(const QSparqlQuery& query);
+    QList<QSparqlResult*> execMany(const QSparqlQuery& query,
+                                   const QVector<QSparqlResultRow>& parameterRows);
+    QList<QSparqlResult*> execMany(const QSparqlQuery& query,
+                                   const QVector<QSparqlResultRow>& parameterRows,
+                                   const QSparqlQueryOptions& options);
 
     bool isValid() const;
     QString driverName() const;
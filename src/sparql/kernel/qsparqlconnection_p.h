@@ -64,5 +64,9 @@ public:
 Q_SPARQL_EXPORT void qSparqlRegisterConnectionCreator(const QString& type,
                                                QSparqlDriverCreatorBase* creator);
 
+// Creates a driver of \a type the way QSparqlConnection does, for drivers
+// which wrap another one. Returns 0 if there is no such driver.
+Q_SPARQL_EXPORT QSparqlDriver* qSparqlCreateDriver(const QString& type);
+
 QT_END_NAMESPACE
 #endif
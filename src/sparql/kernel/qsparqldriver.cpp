@@ -39,11 +39,14 @@
 
 #include "qsparqldriver_p.h"
 
+#include <QtCore/qhash.h>
 #include <QtCore/qmap.h>
 #include <QtCore/qdatetime.h>
 
 #include "qsparqlerror.h"
 #include "qsparqlbinding.h"
+#include "qsparqlbatchresult_p.h"
+#include "qsparqllexer_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -248,6 +251,109 @@ QSparqlError QSparqlDriver::lastError() const
     return d->error;
 }
 
+/*!
+    Executes the \a queries, which all have the statement type \a type, and
+    returns one result per query, in the same order. This is called by
+    QSparqlConnection::execMany() with the already prepared query texts.
+
+    The default implementation calls exec() for each query. Drivers which can
+    send several queries to the store in a single request should reimplement
+    this, and can use splitBatchResult() to give each query its own result.
+*/
+
+QList<QSparqlResult*> QSparqlDriver::execMany(const QStringList& queries,
+                                              QSparqlQuery::StatementType type,
+                                              const QSparqlQueryOptions& options)
+{
+    QList<QSparqlResult*> results;
+    results.reserve(queries.count());
+    Q_FOREACH (const QString& query, queries)
+        results.append(exec(query, type, options));
+    return results;
+}
+
+/*!
+    Returns one result for each of the \a queries, all of them tracking the
+    result \a batch of executing the queries together in one request. The
+    results are finished when \a batch is, and have its error. \a batch is
+    deleted together with the last of the results.
+
+    \sa execMany()
+*/
+
+QList<QSparqlResult*> QSparqlDriver::splitBatchResult(QSparqlResult* batch,
+                                                      const QStringList& queries,
+                                                      QSparqlQuery::StatementType type)
+{
+    QSharedPointer<QSparqlResult> shared(batch);
+    QList<QSparqlResult*> results;
+    results.reserve(queries.count());
+    Q_FOREACH (const QString& query, queries)
+        results.append(new QSparqlBatchItemResult(shared, query, type));
+    return results;
+}
+
+/*!
+    Returns the update operations \a queries joined into a single SPARQL 1.1
+    Update request, for drivers reimplementing execMany(). The operations
+    are separated with semicolons, and their PREFIX and BASE declarations
+    are moved to the prologue of the request, each declaration once.
+
+    Returns an empty string if the queries declare a prefix or the base IRI
+    differently; such queries have to be executed one by one.
+*/
+
+QString QSparqlDriver::joinUpdates(const QStringList& queries)
+{
+    QString base;
+    QStringList prefixNames;
+    QHash<QString, QString> prefixIris;
+    QStringList operations;
+    Q_FOREACH (const QString& query, queries) {
+        QSparqlLexer lexer(query);
+        int operationStart = 0;
+        for (QSparqlLexer::Token token = lexer.next(); ; token = lexer.next()) {
+            if (lexer.isKeyword(token, "BASE")) {
+                const QSparqlLexer::Token iri = lexer.next();
+                if (iri.type != QSparqlLexer::Iri
+                    || (!base.isEmpty() && base != lexer.text(iri)))
+                    return QString();
+                base = lexer.text(iri);
+                operationStart = iri.pos + iri.length;
+            } else if (lexer.isKeyword(token, "PREFIX")) {
+                const QSparqlLexer::Token name = lexer.next();
+                const QSparqlLexer::Token iri = lexer.next();
+                if (name.type != QSparqlLexer::Name || iri.type != QSparqlLexer::Iri)
+                    return QString();
+                const QString prefix = lexer.text(name);
+                if (!prefixIris.contains(prefix))
+                    prefixNames.append(prefix);
+                else if (prefixIris.value(prefix) != lexer.text(iri))
+                    return QString();
+                prefixIris.insert(prefix, lexer.text(iri));
+                operationStart = iri.pos + iri.length;
+            } else {
+                break;
+            }
+        }
+
+        QString operation = query.mid(operationStart).trimmed();
+        if (operation.endsWith(QLatin1Char(';')))
+            operation = operation.left(operation.length() - 1).trimmed();
+        if (!operation.isEmpty())
+            operations.append(operation);
+    }
+
+    QString request;
+    if (!base.isEmpty())
+        request += QLatin1String("BASE ") + base + QLatin1Char('\n');
+    Q_FOREACH (const QString& prefix, prefixNames)
+        request += QLatin1String("PREFIX ") + prefix + QLatin1Char(' ')
+                   + prefixIris.value(prefix) + QLatin1Char('\n');
+    request += operations.join(QLatin1String(";\n"));
+    return request;
+}
+
 /*!
     Returns the low-level database handle wrapped in a QVariant or an
     invalid variant if there is no handle.
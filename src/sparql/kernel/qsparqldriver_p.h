@@ -46,6 +46,7 @@
 #include <qsparqlquery.h>
 
 #include <QtCore/qurl.h>
+#include <QtCore/qlist.h>
 #include <QtCore/qobject.h>
 #include <QtCore/qstring.h>
 #include <QtCore/qstringlist.h>
@@ -84,6 +85,7 @@ public:
     virtual bool hasError() const = 0;
     virtual void close() = 0;
     virtual QSparqlResult* exec(const QString& query, QSparqlQuery::StatementType type, const QSparqlQueryOptions& options) = 0;
+    virtual QList<QSparqlResult*> execMany(const QStringList& queries, QSparqlQuery::StatementType type, const QSparqlQueryOptions& options);
 
     virtual bool open(const QSparqlConnectionOptions& options = QSparqlConnectionOptions()) = 0;
 
@@ -95,6 +97,10 @@ protected:
     virtual void setOpen(bool o);
     virtual void setOpenError(bool e);
     virtual void setLastError(const QSparqlError& e);
+    QList<QSparqlResult*> splitBatchResult(QSparqlResult* batch,
+                                           const QStringList& queries,
+                                           QSparqlQuery::StatementType type);
+    static QString joinUpdates(const QStringList& queries);
 
 private:
     Q_DISABLE_COPY(QSparqlDriver)
@@ -0,0 +1,140 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsparqliripool_p.h"
+#include "qsparqlmemoryusage_p.h"
+
+QT_BEGIN_NAMESPACE
+
+QSparqlIriPool::QSparqlIriPool(int maxEntries)
+    : maxEntries(maxEntries)
+{
+}
+
+bool QSparqlIriPool::isFull() const
+{
+    return count() >= maxEntries;
+}
+
+QUrl QSparqlIriPool::fromEncoded(const char* data, int size)
+{
+    // The raw data key is only used for the lookup, the stored key is a copy
+    const QHash<QByteArray, QUrl>::const_iterator it =
+        encodedIris.constFind(QByteArray::fromRawData(data, size));
+    if (it != encodedIris.constEnd())
+        return it.value();
+
+    const QByteArray key(data, size);
+    const QUrl iri = QUrl::fromEncoded(key);
+    if (!isFull())
+        encodedIris.insert(key, iri);
+    return iri;
+}
+
+QUrl QSparqlIriPool::fromString(const QString& iri)
+{
+    const QHash<QString, QUrl>::const_iterator it = iris.constFind(iri);
+    if (it != iris.constEnd())
+        return it.value();
+
+    const QUrl url(iri);
+    if (!isFull())
+        iris.insert(iri, url);
+    return url;
+}
+
+QString QSparqlIriPool::label(const char* data, int size)
+{
+    const QHash<QByteArray, QString>::const_iterator it =
+        latin1Labels.constFind(QByteArray::fromRawData(data, size));
+    if (it != latin1Labels.constEnd())
+        return it.value();
+
+    const QString str = QString::fromLatin1(data, size);
+    if (!isFull())
+        latin1Labels.insert(QByteArray(data, size), str);
+    return str;
+}
+
+QString QSparqlIriPool::label(const QString& label)
+{
+    const QHash<QString, QString>::const_iterator it = labels.constFind(label);
+    if (it != labels.constEnd())
+        return it.value();
+
+    if (!isFull())
+        labels.insert(label, label);
+    return label;
+}
+
+int QSparqlIriPool::count() const
+{
+    return encodedIris.count() + iris.count() + latin1Labels.count() + labels.count();
+}
+
+void QSparqlIriPool::clear()
+{
+    encodedIris.clear();
+    iris.clear();
+    latin1Labels.clear();
+    labels.clear();
+}
+
+template <typename Key, typename T>
+static void addHashMemoryUsage(QSparqlMemoryUsage* usage, const QHash<Key, T>& hash)
+{
+    if (hash.capacity() > 0)
+        usage->addAllocation(qint64(hash.capacity()) * sizeof(void*));
+    typename QHash<Key, T>::const_iterator it;
+    for (it = hash.constBegin(); it != hash.constEnd(); ++it) {
+        usage->addAllocation(2 * sizeof(void*) + sizeof(uint) + sizeof(Key) + sizeof(T));
+        usage->add(it.key());
+        usage->add(it.value());
+    }
+}
+
+void QSparqlIriPool::addMemoryUsage(QSparqlMemoryUsage* usage) const
+{
+    addHashMemoryUsage(usage, encodedIris);
+    addHashMemoryUsage(usage, iris);
+    addHashMemoryUsage(usage, latin1Labels);
+    addHashMemoryUsage(usage, labels);
+}
+
+QT_END_NAMESPACE
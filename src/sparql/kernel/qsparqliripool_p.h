@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSPARQLIRIPOOL_P_H
+#define QSPARQLIRIPOOL_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  This header file may
+// change from version to version without notice, or even be
+// removed.
+//
+// We mean it.
+//
+
+#include <qsparql.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qurl.h>
+
+QT_BEGIN_NAMESPACE
+
+QT_MODULE(Sparql)
+
+class QSparqlMemoryUsage;
+
+// Interns the IRIs and blank node labels decoded while reading a result, so
+// that repeated ones (predicates, rdf:type and class IRIs) share one
+// implicitly shared QUrl or QString and are only parsed once. A pool is not
+// thread safe; each result or parser owns its own.
+//
+// The pool stops growing after maxEntries IRIs and labels. The terms that
+// repeat most are usually seen early, and unique subjects would otherwise
+// keep a copy of their key for the lifetime of the pool.
+class Q_SPARQL_EXPORT QSparqlIriPool
+{
+public:
+    enum { DefaultMaxEntries = 8192 };
+
+    explicit QSparqlIriPool(int maxEntries = DefaultMaxEntries);
+
+    // Same as QUrl::fromEncoded(QByteArray(data, size))
+    QUrl fromEncoded(const char* data, int size);
+    // Same as QUrl(iri)
+    QUrl fromString(const QString& iri);
+    // Same as QString::fromLatin1(data, size) and a copy of label
+    QString label(const char* data, int size);
+    QString label(const QString& label);
+
+    int count() const;
+    void clear();
+    // Adds the entries of the pool and the IRIs and labels they hold
+    void addMemoryUsage(QSparqlMemoryUsage* usage) const;
+
+private:
+    bool isFull() const;
+
+    int maxEntries;
+    QHash<QByteArray, QUrl> encodedIris;
+    QHash<QString, QUrl> iris;
+    QHash<QByteArray, QString> latin1Labels;
+    QHash<QString, QString> labels;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSPARQLIRIPOOL_P_H
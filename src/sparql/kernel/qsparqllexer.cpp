@@ -0,0 +1,291 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsparqllexer_p.h"
+
+#include <QtCore/qbytearray.h>
+
+QT_BEGIN_NAMESPACE
+
+static inline bool qIsDigit(ushort c)
+{
+    return ushort(c - '0') < 10;
+}
+
+static inline bool qIsNameStart(ushort c)
+{
+    return ushort(c - 'a') < 26 || ushort(c - 'A') < 26 || c == '_' || c >= 0x80;
+}
+
+static inline bool qIsVariableChar(ushort c)
+{
+    return qIsNameStart(c) || qIsDigit(c);
+}
+
+// Prefixed names and keywords: nco:nameGiven, fn:string-join, _:b, SELECT
+static inline bool qIsNameChar(ushort c)
+{
+    return qIsVariableChar(c) || c == '-' || c == '.' || c == ':';
+}
+
+static inline bool qIsIriChar(ushort c)
+{
+    return c > ' ' && c != '<' && c != '>' && c != '"' && c != '{' && c != '}'
+        && c != '|' && c != '^' && c != '`' && c != '\\';
+}
+
+/*!
+    \class QSparqlLexer
+    \internal
+
+    \brief The QSparqlLexer class splits a SPARQL query text into tokens.
+
+    Each call to next() returns the next token; the text is read once, from
+    the beginning to the end. A '<' which doesn't start an IRI is returned as
+    punctuation, so that comparisons are tokenized too.
+*/
+
+QSparqlLexer::QSparqlLexer(const QString& text)
+    : input(text), s(input.utf16()), n(input.size()), i(0)
+{
+}
+
+/*!
+    Returns the next token, or a token of type End at the end of the text.
+*/
+QSparqlLexer::Token QSparqlLexer::next()
+{
+    while (i < n) {
+        if (s[i] == '#') {
+            while (i < n && s[i] != '\n')
+                ++i;
+        } else if (s[i] <= ' ') {
+            ++i;
+        } else {
+            break;
+        }
+    }
+
+    Token token;
+    token.pos = i;
+    token.type = Punctuation;
+    if (i >= n) {
+        token.type = End;
+        token.length = 0;
+        return token;
+    }
+
+    const ushort c = s[i];
+    int end = i + 1;
+    if (c == '?' || c == '$') {
+        if (end < n && s[end] == ':') {
+            end = i + 2;
+            while (end < n && qIsVariableChar(s[end]))
+                ++end;
+            token.type = Placeholder;
+        } else if (end < n && qIsVariableChar(s[end])) {
+            while (end < n && qIsVariableChar(s[end]))
+                ++end;
+            token.type = Variable;
+        }
+    } else if (c == '"' || c == '\'') {
+        const bool longString = i + 2 < n && s[i + 1] == c && s[i + 2] == c;
+        end = i + (longString ? 3 : 1);
+        while (end < n) {
+            if (s[end] == '\\') {
+                end += 2;
+                continue;
+            }
+            if (s[end] == c) {
+                if (!longString) {
+                    ++end;
+                    break;
+                }
+                if (end + 2 < n && s[end + 1] == c && s[end + 2] == c) {
+                    end += 3;
+                    break;
+                }
+            }
+            ++end;
+        }
+        end = qMin(end, n);
+        token.type = String;
+    } else if (c == '<') {
+        int close = end;
+        while (close < n && qIsIriChar(s[close]))
+            ++close;
+        if (close < n && s[close] == '>') {
+            end = close + 1;
+            token.type = Iri;
+        }
+    } else if (qIsDigit(c) || (c == '.' && end < n && qIsDigit(s[end]))) {
+        // A dot is only part of a number if digits follow it, otherwise it
+        // ends a triple
+        end = i;
+        while (end < n && (qIsDigit(s[end]) || (s[end] == '.' && end + 1 < n && qIsDigit(s[end + 1]))))
+            ++end;
+        if (end < n && (s[end] == 'e' || s[end] == 'E')) {
+            int exponent = end + 1;
+            if (exponent < n && (s[exponent] == '+' || s[exponent] == '-'))
+                ++exponent;
+            if (exponent < n && qIsDigit(s[exponent])) {
+                end = exponent;
+                while (end < n && qIsDigit(s[end]))
+                    ++end;
+            }
+        }
+        token.type = Number;
+    } else if (qIsNameStart(c) || c == ':') {
+        while (end < n && qIsNameChar(s[end]))
+            ++end;
+        // Nor does a name end with a dot
+        while (end > i + 1 && s[end - 1] == '.')
+            --end;
+        token.type = Name;
+    }
+
+    token.length = end - i;
+    i = end;
+    return token;
+}
+
+/*!
+    Returns the text of \a token.
+*/
+QString QSparqlLexer::text(const Token& token) const
+{
+    return input.mid(token.pos, token.length);
+}
+
+bool QSparqlLexer::isKeyword(const Token& token, const char* keyword) const
+{
+    return token.type == Name && token.length == int(qstrlen(keyword))
+        && input.midRef(token.pos, token.length).compare(QLatin1String(keyword), Qt::CaseInsensitive) == 0;
+}
+
+bool QSparqlLexer::isPunctuation(const Token& token, char ch) const
+{
+    return token.type == Punctuation && s[token.pos] == ushort(ch);
+}
+
+// Reads the tokens up to the parenthesis which closes one just read, and
+// returns the variable after an AS directly inside them
+QString QSparqlLexer::skipParentheses()
+{
+    QString alias;
+    int depth = 1;
+    bool afterAs = false;
+    while (depth > 0) {
+        const Token token = next();
+        if (token.type == End)
+            break;
+        if (isPunctuation(token, '('))
+            ++depth;
+        else if (isPunctuation(token, ')'))
+            --depth;
+        else if (afterAs && token.type == Variable)
+            alias = text(token).mid(1);
+        afterAs = depth == 1 && isKeyword(token, "AS");
+    }
+    return alias;
+}
+
+/*!
+    Returns the names of the variables projected by the SELECT \a query, in
+    the order of the columns of its result. Expressions with AS give the name
+    of their variable, and other expressions an empty name. Returns an empty
+    list if \a query isn't a SELECT query or projects all variables with
+    \c *.
+
+    Tracker's function calls without the parentheses, as in
+    \c{SELECT ?u fn:concat(?a, ?b) AS ?c}, are recognized too.
+*/
+QStringList QSparqlLexer::projection(const QString& query)
+{
+    QSparqlLexer lexer(query);
+    Token token = lexer.next();
+
+    // The prologue: BASE <iri> and PREFIX name: <iri>
+    while (lexer.isKeyword(token, "BASE") || lexer.isKeyword(token, "PREFIX")) {
+        do {
+            token = lexer.next();
+        } while (token.type != Iri && token.type != End);
+        token = lexer.next();
+    }
+
+    QStringList names;
+    if (!lexer.isKeyword(token, "SELECT"))
+        return names;
+    token = lexer.next();
+    if (lexer.isKeyword(token, "DISTINCT") || lexer.isKeyword(token, "REDUCED"))
+        token = lexer.next();
+
+    // Up to WHERE, FROM, the '{' of the WHERE clause, or '*'
+    for (;;) {
+        if (token.type == Variable) {
+            names.append(lexer.text(token).mid(1));
+            token = lexer.next();
+        } else if (token.type == Placeholder) {
+            names.append(QString());
+            token = lexer.next();
+        } else if (lexer.isPunctuation(token, '(')) {
+            names.append(lexer.skipParentheses());
+            token = lexer.next();
+        } else if (token.type == Name || token.type == Iri) {
+            if (!lexer.isPunctuation(lexer.next(), '('))
+                break;
+            lexer.skipParentheses();
+            QString alias;
+            token = lexer.next();
+            if (lexer.isKeyword(token, "AS")) {
+                token = lexer.next();
+                if (token.type == Variable) {
+                    alias = lexer.text(token).mid(1);
+                    token = lexer.next();
+                }
+            }
+            names.append(alias);
+        } else {
+            break;
+        }
+    }
+    return names;
+}
+
+QT_END_NAMESPACE
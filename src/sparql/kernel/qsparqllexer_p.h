@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSPARQLLEXER_P_H
+#define QSPARQLLEXER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  This header file may
+// change from version to version without notice, or even be
+// removed.
+//
+// We mean it.
+//
+
+#include <qsparql.h>
+
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+
+QT_BEGIN_NAMESPACE
+
+QT_MODULE(Sparql)
+
+// Splits a query text into tokens in one pass, skipping whitespace and
+// comments. It knows enough of the SPARQL grammar to tell where a token ends
+// (so that brackets in strings and IRIs aren't taken for brackets of the
+// query), but not whether the query is valid.
+class Q_SPARQL_EXPORT QSparqlLexer
+{
+public:
+    enum TokenType { End, Variable, Placeholder, Name, Iri, String, Number, Punctuation };
+
+    struct Token
+    {
+        TokenType type;
+        int pos;
+        int length;
+    };
+
+    explicit QSparqlLexer(const QString& text);
+
+    Token next();
+    QString text(const Token& token) const;
+    // True if token is a Name which equals keyword, ignoring case
+    bool isKeyword(const Token& token, const char* keyword) const;
+    bool isPunctuation(const Token& token, char ch) const;
+
+    // The names of the variables a SELECT query projects, in column order,
+    // without the ? or $. A column of an expression without AS has an empty
+    // name. Returns an empty list for other queries and for SELECT *. Only
+    // the text before the WHERE clause is read.
+    static QStringList projection(const QString& query);
+
+private:
+    QString skipParentheses();
+
+    QString input;
+    const ushort* s;
+    int n;
+    int i;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSPARQLLEXER_P_H
@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsparqlmemoryusage_p.h"
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qurl.h>
+#include <QtCore/qvariant.h>
+
+#include "qsparqlresultrow.h"
+
+QT_BEGIN_NAMESPACE
+
+QSparqlMemoryUsage::QSparqlMemoryUsage()
+    : bytes(0)
+{
+}
+
+void QSparqlMemoryUsage::add(const QString& string)
+{
+    if (string.capacity() > 0 && isFirstSeen(string.constData()))
+        addAllocation(arrayHeaderSize + (qint64(string.capacity()) + 1) * sizeof(QChar));
+}
+
+void QSparqlMemoryUsage::add(const QByteArray& data)
+{
+    if (data.capacity() > 0 && isFirstSeen(data.constData()))
+        addAllocation(arrayHeaderSize + qint64(data.capacity()) + 1);
+}
+
+void QSparqlMemoryUsage::add(const QStringList& strings)
+{
+    addArray(static_cast<const QList<QString>&>(strings));
+    Q_FOREACH (const QString& string, strings)
+        add(string);
+}
+
+void QSparqlMemoryUsage::add(const QUrl& url)
+{
+    if (url.isEmpty() || !isFirstSeen(const_cast<QUrl&>(url).data_ptr()))
+        return;
+
+    // QUrlPrivate keeps the components of the URL in separate strings; this
+    // counts it as a fixed size and two copies of the URL
+    const qint64 size = arrayHeaderSize + qint64(url.toString().size()) * sizeof(QChar);
+    addAllocation(16 * sizeof(void*));
+    addAllocation(size);
+    addAllocation(size);
+}
+
+void QSparqlMemoryUsage::add(const QVariant& value)
+{
+    // The other types used by the drivers are stored in the QVariant itself
+    switch (value.type()) {
+    case QVariant::String:
+        add(value.toString());
+        break;
+    case QVariant::ByteArray:
+        add(value.toByteArray());
+        break;
+    case QVariant::StringList:
+        add(value.toStringList());
+        break;
+    case QVariant::Url:
+        add(value.toUrl());
+        break;
+    case QVariant::DateTime:
+        addAllocation(6 * sizeof(void*));
+        break;
+    default:
+        break;
+    }
+}
+
+void QSparqlMemoryUsage::add(const QVector<QSparqlResultRow>& rows)
+{
+    addArray(rows);
+    Q_FOREACH (const QSparqlResultRow& row, rows)
+        add(row);
+}
+
+void QSparqlMemoryUsage::addAllocation(qint64 size)
+{
+    bytes += allocationSize(size);
+}
+
+void QSparqlMemoryUsage::addBytes(qint64 size)
+{
+    bytes += size;
+}
+
+bool QSparqlMemoryUsage::isFirstSeen(const void* data)
+{
+    if (seen.contains(data))
+        return false;
+    seen.insert(data);
+    return true;
+}
+
+qint64 QSparqlMemoryUsage::total() const
+{
+    return bytes;
+}
+
+qint64 QSparqlMemoryUsage::allocationSize(qint64 size)
+{
+    // malloc adds a size word to each chunk, aligns chunks to two words,
+    // and never allocates less than four words
+    const qint64 alignment = 2 * sizeof(void*);
+    const qint64 chunk = (size + qint64(sizeof(void*)) + alignment - 1) & ~(alignment - 1);
+    return qMax(chunk, qint64(4 * sizeof(void*)));
+}
+
+QT_END_NAMESPACE
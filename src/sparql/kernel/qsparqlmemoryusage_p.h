@@ -0,0 +1,127 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSPARQLMEMORYUSAGE_P_H
+#define QSPARQLMEMORYUSAGE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  This header file may
+// change from version to version without notice, or even be
+// removed.
+//
+// We mean it.
+//
+
+#include <qsparql.h>
+
+#include <QtCore/qset.h>
+#include <QtCore/qvector.h>
+#include <QtCore/qlist.h>
+
+QT_BEGIN_NAMESPACE
+
+QT_MODULE(Sparql)
+
+class QByteArray;
+class QString;
+class QStringList;
+class QUrl;
+class QVariant;
+class QSparqlBinding;
+class QSparqlResultRow;
+class QSparqlResultSchema;
+
+// Estimates the heap memory held by result data, for the implementations of
+// QSparqlResult::memoryUsage(). Implicitly shared data is counted only once
+// per estimate, so rows sharing a schema or IRIs from a QSparqlIriPool
+// aren't counted many times over. Every allocation is rounded up the way
+// glibc malloc does it.
+class Q_SPARQL_EXPORT QSparqlMemoryUsage
+{
+public:
+    QSparqlMemoryUsage();
+
+    void add(const QString& string);
+    void add(const QByteArray& data);
+    void add(const QStringList& strings);
+    void add(const QUrl& url);
+    void add(const QVariant& value);
+    void add(const QSparqlBinding& binding);
+    void add(const QSparqlResultRow& row);
+    void add(const QSparqlResultSchema& schema);
+    void add(const QVector<QSparqlResultRow>& rows);
+
+    // The array of a container, not the data its items point to
+    template <typename T> void addArray(const QVector<T>& vector)
+    {
+        if (vector.capacity() > 0 && isFirstSeen(vector.constData()))
+            addAllocation(qint64(vector.capacity()) * sizeof(T) + arrayHeaderSize);
+    }
+    template <typename T> void addArray(const QList<T>& list)
+    {
+        if (!list.isEmpty() && isFirstSeen(&list.first()))
+            addAllocation(qint64(list.count()) * sizeof(void*) + arrayHeaderSize);
+    }
+
+    // An allocation of size bytes, or size bytes of allocations whose count
+    // isn't known
+    void addAllocation(qint64 size);
+    void addBytes(qint64 size);
+    // Marks shared data, returns false if it has been counted already
+    bool isFirstSeen(const void* data);
+
+    qint64 total() const;
+
+    static qint64 allocationSize(qint64 size);
+
+private:
+    // The reference count, size and capacity before the items of QString,
+    // QByteArray, QVector and QList
+    enum { arrayHeaderSize = 3 * sizeof(int) + sizeof(void*) };
+
+    QSet<const void*> seen;
+    qint64 bytes;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSPARQLMEMORYUSAGE_P_H
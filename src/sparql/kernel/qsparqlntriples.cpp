@@ -40,299 +40,626 @@
 #include "qsparqlntriples_p.h"
 
 #include <QtCore/qdebug.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
 #include <QtCore/qurl.h>
+#include <QtCore/qwaitcondition.h>
 
-/*  From the raptor ntriples parser                        
-    These are for 7-bit ASCII and not locale-specific 
+#include <string.h>
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#  include <arm_neon.h>
+#endif
+
+/*  From the raptor ntriples parser
+    These are for 7-bit ASCII and not locale-specific
  */
 #define IS_ASCII_ALPHA(c) (((c)>0x40 && (c)<0x5B) || ((c)>0x60 && (c)<0x7B))
 #define IS_ASCII_UPPER(c) ((c)>0x40 && (c)<0x5B)
 #define IS_ASCII_DIGIT(c) ((c)>0x2F && (c)<0x3A)
 #define IS_ASCII_PRINT(c) ((c)>0x1F && (c)<0x7F)
 #define TO_ASCII_LOWER(c) ((c)+0x20)
-                        
+
 
 QT_BEGIN_NAMESPACE
 
-void QSparqlNTriples::parseError(QString message) 
+// Returns the first '"' or '\\' in [p, end), or end. Sets *nonAscii if any
+// byte skipped over on the way has its high bit set.
+static const char* findLiteralDelimiter(const char* p, const char* end, bool* nonAscii)
 {
-    QString context;
-    
-    while (i < buffer.size()) {
-        context.append(QLatin1Char(buffer[i]));
-        if (buffer[i] == '\n' || buffer[i] == '\r')
-            break;
-            
-        i++;
+#if defined(__SSE2__)
+    const __m128i dquote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for (; end - p >= 16; p += 16) {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const int hits = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(c, dquote),
+                                                        _mm_cmpeq_epi8(c, backslash)));
+        // The high bits of the bytes themselves flag the non-ASCII ones
+        int high = _mm_movemask_epi8(c);
+        if (hits) {
+            const int offset = __builtin_ctz(hits);
+            high &= (1 << offset) - 1;
+            if (high)
+                *nonAscii = true;
+            return p + offset;
+        }
+        if (high)
+            *nonAscii = true;
+    }
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    const uint8x16_t dquote = vdupq_n_u8('"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    for (; end - p >= 16; p += 16) {
+        const uint8x16_t c = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        const uint8x16_t hits = vorrq_u8(vceqq_u8(c, dquote), vceqq_u8(c, backslash));
+        // Narrow each byte into four bits of a 64 bit mask
+        const quint64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits), 4)), 0);
+        const quint64 high = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(vcgeq_u8(c, vdupq_n_u8(0x80))), 4)), 0);
+        if (mask) {
+            const int offset = __builtin_ctzll(mask) >> 2;
+            if (high & ((Q_UINT64_C(1) << (offset * 4)) - 1))
+                *nonAscii = true;
+            return p + offset;
+        }
+        if (high)
+            *nonAscii = true;
+    }
+#endif
+    for (; p < end; ++p) {
+        if (*p == '"' || *p == '\\')
+            return p;
+        if (static_cast<uchar>(*p) > 0x7f)
+            *nonAscii = true;
     }
-    
-    qWarning() << "ERROR in line " << lineNumber << ":" << message << ": '" << context << "'";        
+    return end;
 }
 
-void QSparqlNTriples::skipWhiteSpace() 
+static bool isAscii(const char* p, int len)
 {
-    while (i < buffer.size()) {
-        if (buffer[i] != ' ' && buffer[i] != '\t')
-            break;
-            
-        i++;
+    const char* end = p + len;
+#if defined(__SSE2__)
+    for (; end - p >= 16; p += 16) {
+        if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))))
+            return false;
+    }
+#endif
+    for (; p < end; ++p) {
+        if (static_cast<uchar>(*p) > 0x7f)
+            return false;
+    }
+    return true;
+}
+
+// Returns the first '\n' or '\r' at or after from, or size
+static int findLineEnd(const char* data, int from, int size)
+{
+    if (from >= size)
+        return size;
+    const char* lf = static_cast<const char*>(memchr(data + from, '\n', size - from));
+    const int end = lf ? lf - data : size;
+    const char* cr = static_cast<const char*>(memchr(data + from, '\r', end - from));
+    return cr ? cr - data : end;
+}
+
+static bool parseHex(const char* p, const char* end, int digits, uint* value)
+{
+    if (end - p < digits)
+        return false;
+    uint result = 0;
+    for (int n = 0; n < digits; ++n) {
+        const char c = p[n];
+        result <<= 4;
+        if (c >= '0' && c <= '9')
+            result |= c - '0';
+        else if (c >= 'a' && c <= 'f')
+            result |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            result |= c - 'A' + 10;
+        else
+            return false;
+    }
+    *value = result;
+    return true;
+}
+
+static void appendUtf8(QByteArray& out, uint ucs4)
+{
+    if (ucs4 < 0x80) {
+        out.append(char(ucs4));
+    } else if (ucs4 < 0x800) {
+        out.append(char(0xc0 | (ucs4 >> 6)));
+        out.append(char(0x80 | (ucs4 & 0x3f)));
+    } else if (ucs4 < 0x10000) {
+        out.append(char(0xe0 | (ucs4 >> 12)));
+        out.append(char(0x80 | ((ucs4 >> 6) & 0x3f)));
+        out.append(char(0x80 | (ucs4 & 0x3f)));
+    } else {
+        out.append(char(0xf0 | (ucs4 >> 18)));
+        out.append(char(0x80 | ((ucs4 >> 12) & 0x3f)));
+        out.append(char(0x80 | ((ucs4 >> 6) & 0x3f)));
+        out.append(char(0x80 | (ucs4 & 0x3f)));
+    }
+}
+
+QSparqlNTriples::QSparqlNTriples(const QByteArray &b)
+    : buffer(b), data(buffer.constData()), size(buffer.size()), i(0), lineNumber(1),
+      truncated(false), deferErrors(false)
+{
+    schema.append(QLatin1String("s"));
+    schema.append(QLatin1String("p"));
+    schema.append(QLatin1String("o"));
+}
+
+static void printError(int lineNumber, const QString& message, const QString& context)
+{
+    qWarning() << "ERROR in line " << lineNumber << ":" << message << ": '" << context << "'";
+}
+
+void QSparqlNTriples::parseError(const QString& message)
+{
+    const int start = i;
+    i = findLineEnd(data, i, size);
+    // The context includes the line terminator, if there is one
+    const QString context = QString::fromLatin1(data + start, qMin(i + 1, size) - start);
+
+    if (deferErrors) {
+        Error error = { lineNumber, message, context };
+        errors.append(error);
+    } else {
+        printError(lineNumber, message, context);
     }
 }
 
-void QSparqlNTriples::skipComment() 
+void QSparqlNTriples::skipWhiteSpace()
 {
-    while (i < buffer.size()) {
-        if (buffer[i] == '\n' || buffer[i] == '\r')
+    while (i < size) {
+        if (data[i] != ' ' && data[i] != '\t')
             break;
-            
+
         i++;
     }
 }
 
-void QSparqlNTriples::skipEoln() 
+void QSparqlNTriples::skipComment()
+{
+    i = findLineEnd(data, i, size);
+}
+
+void QSparqlNTriples::skipEoln()
 {
-    if (buffer[i] == '\n') {
+    if (i < size && data[i] == '\n') {
         i++;
-    } else if (buffer[i] == '\r') {
+    } else if (i < size && data[i] == '\r') {
         i++;
-        if (i < buffer.size() && buffer[i] == '\n') {
+        if (i < size && data[i] == '\n') {
             i++;
         }
     }
-    
+
     lineNumber++;
 }
 
-QUrl QSparqlNTriples::parseUri() 
+QUrl QSparqlNTriples::parseUri()
 {
-    QByteArray uri;
-    bool isUtf8 = false;
-    
-    if (i < buffer.size() && buffer[i] == '<') {
-        i++;
-        while (i < buffer.size()) {
-            if (buffer[i] == '>') {
-                i++;
-                break;
-            }
-            
-            if (static_cast<uchar>(buffer.at(i)) > 0x7f)
-                isUtf8 = true;
-            
-            uri.append(buffer[i]);
-            i++;
-        }
-    }
-    
-    if (isUtf8)
-        return QUrl(QString::fromUtf8(uri));
+    if (i >= size || data[i] != '<')
+        return QUrl();
+
+    const int start = ++i;
+    const char* gt = static_cast<const char*>(memchr(data + start, '>', size - start));
+    const int end = gt ? gt - data : size;
+    i = gt ? end + 1 : size;
+    if (!gt)
+        truncated = true;
+
+    if (isAscii(data + start, end - start))
+        return iris.fromEncoded(data + start, end - start);
     else
-        return QUrl::fromEncoded(uri);
+        return iris.fromString(QString::fromUtf8(data + start, end - start));
 }
 
-QSparqlBinding QSparqlNTriples::parseNamedNode(QString name) 
+QSparqlBinding QSparqlNTriples::parseNamedNode()
 {
-    QString nodeName;
-    QSparqlBinding binding(name);
-    
+    QSparqlBinding binding;
+
     i++;
-    if (i >= buffer.size() || buffer[i] != ':') {
+    if (i >= size || data[i] != ':') {
         parseError(QLatin1String("Expected named node '_:xxxx'"));
     }
-    
+
     i++;
-    if (i < buffer.size() && IS_ASCII_ALPHA((uchar) buffer[i])) {
-        while (i < buffer.size()) {
-            if (!IS_ASCII_ALPHA((uchar) buffer[i]) && !IS_ASCII_DIGIT((uchar) buffer[i]))
+    const int start = i;
+    if (i < size && IS_ASCII_ALPHA((uchar) data[i])) {
+        while (i < size) {
+            if (!IS_ASCII_ALPHA((uchar) data[i]) && !IS_ASCII_DIGIT((uchar) data[i]))
                 break;
-            
-            nodeName.append(QLatin1Char(buffer[i]));
+
             i++;
         }
     }
-    
-    binding.setBlankNodeLabel(nodeName);
+
+    binding.setBlankNodeLabel(iris.label(data + start, i - start));
     return binding;
 }
 
-QString QSparqlNTriples::parseLanguageTag() 
+QString QSparqlNTriples::parseLanguageTag()
 {
-    QString languageTag;
-    
-    if (i < buffer.size() && buffer[i] == '@') {
+    if (i >= size || data[i] != '@')
+        return QString();
+
+    const int start = ++i;
+    while (i < size) {
+        if (!IS_ASCII_ALPHA((uchar) data[i]))
+            break;
+
         i++;
-        while (i < buffer.size()) {
-            if (!IS_ASCII_ALPHA((uchar) buffer[i]))
-                break;
-            
-            languageTag.append(QLatin1Char(buffer[i]));
-            i++;
-        }
     }
-    
-    return languageTag;
+
+    return QString::fromLatin1(data + start, i - start);
 }
 
-QSparqlBinding QSparqlNTriples::parseLiteral(QString name) 
+/*
+    Parses the literal at the current position and appends it to
+    \a resultRow. A literal without escapes is converted straight from the
+    input buffer, the bytes are only copied when an escape sequence has to
+    be replaced.
+*/
+void QSparqlNTriples::parseLiteral(QSparqlResultRow* resultRow)
 {
-    QByteArray literal;
+    QByteArray unescaped;
+    bool hasEscapes = false;
+    bool isUtf8 = false;
     QString languageTag;
     QUrl dataTypeUri;
-    QSparqlBinding binding(name);
-    bool isUtf8 = false;
-    
-    if (buffer[i] == '"') {
+    int start = i + 1;
+    int end = start;
+    bool closed = false;
+
+    if (i < size && data[i] == '"') {
         i++;
-        while (i < buffer.size()) {
-            if (buffer[i] == '"') {
+        while (i < size) {
+            i = findLiteralDelimiter(data + i, data + size, &isUtf8) - data;
+            if (i >= size) {
+                end = size;
+                break;
+            }
+
+            if (data[i] == '"') {
+                closed = true;
+                end = i;
                 i++;
-                if (i < buffer.size() && buffer[i] == '^') {
+                if (i < size && data[i] == '^') {
                     i++;
-                    if (i < buffer.size() && buffer[i] == '^') {
+                    if (i < size && data[i] == '^') {
                         i++;
                         dataTypeUri = parseUri();
                     }
-                } else if (i < buffer.size() && buffer[i] == '@') {
+                } else if (i < size && data[i] == '@') {
                     languageTag = parseLanguageTag();
                 }
-                
+
                 break;
             }
-            
-            if (static_cast<uchar>(buffer.at(i)) > 0x7f)
-                isUtf8 = true;
 
-            if (buffer[i] != '\\') {
-                literal.append(buffer[i]);
-            } else {
-                i++;
-                if (i < buffer.size()) {
-                    if (buffer[i] == '"' || buffer[i] == 'n' || buffer[i] == 'r' || buffer[i] == 't' || buffer[i] == '\\') {
-                        literal.append(buffer[i - 1]);
-                        literal.append(buffer[i]);
-                    } else if (buffer[i] == 'u') {
-                        // Unicode escape \uxxxx
-                        isUtf8 = true;
-                        QString str = QString::fromLatin1(buffer.mid(i + 1, 4));
-                        bool ok = false;
-                        ushort unicode = str.toUShort(&ok, 16);
-                        if (ok) {
-                            literal.append(QString::fromUtf16(&unicode, 1).toUtf8());
-                            i += 4;
-                        } else {
-                            parseError(QLatin1String("Invalid unicode escape sequence"));
-                        }
-                    } else if (buffer[i] == 'U') {
-                        // Unicode escape \Uxxxxxxxx
-                        isUtf8 = true;
-                        QString str = QString::fromLatin1(buffer.mid(i + 1, 8));
-                        bool ok = false;
-                        uint unicode = str.toUInt(&ok, 16);
-                        if (ok) {
-                            literal.append(QString::fromUcs4(&unicode, 1).toUtf8());
-                            i += 8;
-                        } else {
-                            parseError(QLatin1String("Invalid unicode escape sequence"));
+            // A backslash: copy the run before it, then the escape
+            hasEscapes = true;
+            unescaped.append(data + start, i - start);
+            i++;
+            if (i < size) {
+                const char c = data[i];
+                if (c == '"' || c == 'n' || c == 'r' || c == 't' || c == '\\') {
+                    unescaped.append('\\');
+                    unescaped.append(c);
+                } else if (c == 'u' || c == 'U') {
+                    // Unicode escape \uxxxx or \Uxxxxxxxx
+                    isUtf8 = true;
+                    const int digits = c == 'u' ? 4 : 8;
+                    uint unicode = 0;
+                    if (parseHex(data + i + 1, data + size, digits, &unicode)) {
+                        i += digits;
+                        uint low = 0;
+                        // A surrogate pair written as two \u escapes
+                        if (QChar::isHighSurrogate(unicode)
+                            && i + 6 < size && data[i + 1] == '\\' && data[i + 2] == 'u'
+                            && parseHex(data + i + 3, data + size, 4, &low)
+                            && QChar::isLowSurrogate(low)) {
+                            unicode = QChar::surrogateToUcs4(unicode, low);
+                            i += 6;
                         }
+                        appendUtf8(unescaped, unicode);
                     } else {
-                        parseError(QLatin1String("Invalid literal escape sequence"));
+                        parseError(QLatin1String("Invalid unicode escape sequence"));
                     }
+                } else {
+                    parseError(QLatin1String("Invalid literal escape sequence"));
                 }
             }
-            
+
             i++;
+            start = i;
         }
     }
-            
+
+    if (!closed) {
+        truncated = true;
+        end = size;
+    }
+
+    if (hasEscapes && end > start)
+        unescaped.append(data + start, end - start);
+
     QString value;
-    if (isUtf8) 
-        value = QString::fromUtf8(literal);
+    if (hasEscapes)
+        value = isUtf8 ? QString::fromUtf8(unescaped) : QString::fromLatin1(unescaped);
+    else if (end > start)
+        value = isUtf8 ? QString::fromUtf8(data + start, end - start) : QString::fromLatin1(data + start, end - start);
     else
-        value = QString::fromLatin1(literal);
-        
+        value = QLatin1String("");
+
     if (!languageTag.isEmpty()) {
+        QSparqlBinding binding;
         binding.setValue(value);
         binding.setLanguageTag(languageTag);
+        resultRow->append(binding);
     } else if (!dataTypeUri.isEmpty()) {
+        QSparqlBinding binding;
         binding.setValue(value, dataTypeUri);
+        resultRow->append(binding);
     } else {
-        binding.setValue(value);
+        // A plain literal needs no binding of its own
+        resultRow->appendValue(value);
     }
-    
-    return binding;
 }
 
-QSparqlResultRow QSparqlNTriples::parseStatement() 
+QSparqlResultRow QSparqlNTriples::parseStatement()
 {
-    QSparqlResultRow resultRow;
-    
+    // The rows store URIs and plain literals as values, only blank nodes and
+    // literals with a data type or language tag need a QSparqlBinding.
+    QSparqlResultRow resultRow(schema);
+
     skipWhiteSpace();
-    if (i >= buffer.size())
+    if (i >= size)
         return resultRow;
-    
-    if (buffer[i] == '_') {
-        resultRow.append(parseNamedNode(QLatin1String("s")));
-    } else if (buffer[i] == '<') {
-        resultRow.append(QSparqlBinding(QLatin1String("s"), parseUri()));
+
+    if (data[i] == '_') {
+        resultRow.append(parseNamedNode());
+    } else if (data[i] == '<') {
+        resultRow.appendValue(parseUri());
     } else {
         parseError(QLatin1String("Expected subject node"));
     }
-    
+
     skipWhiteSpace();
-    if (i >= buffer.size())
+    if (i >= size)
         return resultRow;
 
-    if (buffer[i] == '<') {
-        resultRow.append(QSparqlBinding(QLatin1String("p"), parseUri()));
+    if (data[i] == '<') {
+        resultRow.appendValue(parseUri());
     } else {
         parseError(QLatin1String("Expected predicate node"));
     }
-    
+
     skipWhiteSpace();
-    if (i >= buffer.size())
+    if (i >= size)
         return resultRow;
 
-    if (buffer[i] == '<') {
-        resultRow.append(QSparqlBinding(QLatin1String("o"), parseUri()));
-    } else if (buffer[i] == '"') {
-        resultRow.append(parseLiteral(QLatin1String("o")));
-    } else if (buffer[i] == '_') {
-        resultRow.append(parseNamedNode(QLatin1String("o")));
+    if (data[i] == '<') {
+        resultRow.appendValue(parseUri());
+    } else if (data[i] == '"') {
+        parseLiteral(&resultRow);
+    } else if (data[i] == '_') {
+        resultRow.append(parseNamedNode());
     } else {
         parseError(QLatin1String("Expected object node"));
     }
-    
+
     skipWhiteSpace();
-    if (i >= buffer.size())
+    if (i >= size)
         return resultRow;
 
-    if (i >= buffer.size() || buffer[i] == '.') {
+    if (data[i] == '.') {
         i++;
     } else {
         parseError(QLatin1String("Expected '.' as statement terminator"));
     }
-    
-    skipWhiteSpace();        
+
+    skipWhiteSpace();
     return resultRow;
 }
 
-QVector<QSparqlResultRow> QSparqlNTriples::parse()
+void QSparqlNTriples::parseLine()
 {
     skipWhiteSpace();
-    
-    while (i < buffer.size()) {
-        if (buffer[i] == '#') {
-            skipComment();
-        } else if (buffer[i] == '\n' || buffer[i] == '\r') {
-            ; // Blank line
-        } else {
-            results.append(parseStatement());
+    if (i >= size)
+        return;
+
+    if (data[i] == '#') {
+        skipComment();
+    } else if (data[i] == '\n' || data[i] == '\r') {
+        ; // Blank line
+    } else {
+        results.append(parseStatement());
+    }
+
+    skipEoln();
+}
+
+QVector<QSparqlResultRow> QSparqlNTriples::parse()
+{
+    while (i < size)
+        parseLine();
+
+    return results;
+}
+
+namespace {
+
+// Chunks smaller than this are not worth handing to another thread
+const int MinChunkSize = 256 * 1024;
+
+struct ParallelParse
+{
+    QByteArray buffer;
+    QSparqlResultSchema schema;
+    // The start of each chunk, followed by the end of the last one
+    QVector<int> starts;
+    QVector<QSparqlNTriples*> chunks;
+    QAtomicInt nextChunk;
+    QMutex mutex;
+    QWaitCondition chunkFinished;
+    int finishedCount;
+
+    ParallelParse() : nextChunk(0), finishedCount(0) {}
+
+    ~ParallelParse()
+    {
+        qDeleteAll(chunks);
+    }
+
+    int count() const
+    {
+        return starts.count() - 1;
+    }
+
+    // Parses chunks until there are none left. Both the pool threads and the
+    // calling thread run this, so the parse completes even when the pool has
+    // no free threads.
+    void run()
+    {
+        int k;
+        while ((k = nextChunk.fetchAndAddOrdered(1)) < count()) {
+            QSparqlNTriples* parser = new QSparqlNTriples(buffer);
+            parser->schema = schema;
+            parser->i = starts[k];
+            parser->size = starts[k + 1];
+            parser->deferErrors = true;
+            parser->parse();
+
+            QMutexLocker locker(&mutex);
+            chunks[k] = parser;
+            ++finishedCount;
+            chunkFinished.wakeAll();
+        }
+    }
+};
+
+class ChunkRunnable : public QRunnable
+{
+public:
+    ChunkRunnable(const QSharedPointer<ParallelParse>& p) : parse(p) {}
+
+    void run()
+    {
+        parse->run();
+    }
+
+    // The calling thread may return before a queued runnable starts, the
+    // shared pointer keeps the chunks alive until then
+    QSharedPointer<ParallelParse> parse;
+};
+
+}
+
+/*
+    Parses the rest of the buffer like parse(), using up to \a maxThreads
+    threads (QThread::idealThreadCount() if \a maxThreads is 0). The buffer
+    is split into chunks at newlines, which are parsed on the global
+    QThreadPool; the rows of the chunks are then concatenated in order.
+
+    A newline inside a literal or URI can't be told from a statement
+    boundary without parsing up to it. A chunk which ends inside a term is
+    therefore parsed again on the calling thread, continuing into the next
+    chunks until a statement ends exactly at the start of a chunk. The parse
+    errors are collected per chunk and printed in order, with the line
+    numbers parse() would have given.
+*/
+QVector<QSparqlResultRow> QSparqlNTriples::parseParallel(int maxThreads)
+{
+    if (maxThreads <= 0)
+        maxThreads = QThread::idealThreadCount();
+
+    const int chunkCount = qMin(maxThreads * 4, (size - i) / MinChunkSize);
+    if (maxThreads < 2 || chunkCount < 2)
+        return parse();
+
+    QSharedPointer<ParallelParse> p(new ParallelParse);
+    p->buffer = buffer;
+    p->schema = schema;
+    p->starts.append(i);
+    for (int k = 1; k < chunkCount; ++k) {
+        const int from = i + int(qint64(size - i) * k / chunkCount);
+        if (from <= p->starts.last())
+            continue;
+        const char* lf = static_cast<const char*>(memchr(data + from, '\n', size - from));
+        if (!lf)
+            break;
+        const int start = lf - data + 1;
+        if (start < size && start > p->starts.last())
+            p->starts.append(start);
+    }
+    p->starts.append(size);
+
+    const int count = p->count();
+    if (count < 2)
+        return parse();
+
+    p->chunks.fill(0, count);
+    const int threads = qMin(maxThreads, count) - 1;
+    for (int t = 0; t < threads; ++t)
+        QThreadPool::globalInstance()->start(new ChunkRunnable(p));
+    p->run();
+
+    {
+        QMutexLocker locker(&p->mutex);
+        while (p->finishedCount < count)
+            p->chunkFinished.wait(&p->mutex);
+    }
+
+    int rowCount = results.count();
+    for (int k = 0; k < count; ++k)
+        rowCount += p->chunks[k]->results.count();
+    results.reserve(rowCount);
+
+    int k = 0;
+    while (k < count) {
+        QSparqlNTriples* chunk = p->chunks[k];
+        if (!chunk->truncated || k == count - 1) {
+            Q_FOREACH (const Error& error, chunk->errors) {
+                const int line = error.lineNumber + lineNumber - 1;
+                if (deferErrors) {
+                    Error shifted = { line, error.message, error.context };
+                    errors.append(shifted);
+                } else {
+                    printError(line, error.message, error.context);
+                }
+            }
+            results += chunk->results;
+            lineNumber += chunk->lineNumber - 1;
+            truncated = chunk->truncated;
+            ++k;
+            continue;
         }
-        
-        skipEoln();
-        skipWhiteSpace();
+
+        // The chunk was split inside a term: parse from its start until
+        // reaching the start of a later chunk, which is then known to be a
+        // statement boundary.
+        i = p->starts[k];
+        int next = k + 1;
+        while (i < size) {
+            parseLine();
+            while (next < count && p->starts[next] < i)
+                ++next;
+            if (next < count && p->starts[next] == i)
+                break;
+        }
+        k = i < size ? next : count;
     }
-    
+
+    i = size;
     return results;
 }
 
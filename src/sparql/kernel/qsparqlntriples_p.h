@@ -52,7 +52,9 @@
 //
 
 #include <qsparqlbinding.h>
+#include <private/qsparqliripool_p.h>
 #include <qsparqlresultrow.h>
+#include <qsparqlresultschema.h>
 
 #include <QtCore/qbytearray.h>
 #include <QtCore/qstring.h>
@@ -64,23 +66,44 @@ QT_MODULE(Sparql)
 
 class Q_SPARQL_EXPORT QSparqlNTriples {
 public:
-    QSparqlNTriples(QByteArray &b) : buffer(b), i(0), lineNumber(1) {}
-    
-    void parseError(QString message);
+    struct Error {
+        int lineNumber;
+        QString message;
+        QString context;
+    };
+
+    QSparqlNTriples(const QByteArray &b);
+
+    void parseError(const QString& message);
     void skipWhiteSpace();
-    void skipComment(); 
+    void skipComment();
     void skipEoln();
-    QUrl parseUri();    
-    QSparqlBinding parseNamedNode(QString name); 
+    QUrl parseUri();
+    QSparqlBinding parseNamedNode();
     QString parseLanguageTag();
-    QSparqlBinding parseLiteral(QString name); 
+    void parseLiteral(QSparqlResultRow* resultRow);
     QSparqlResultRow parseStatement();
+    void parseLine();
     QVector<QSparqlResultRow> parse();
+    QVector<QSparqlResultRow> parseParallel(int maxThreads = 0);
 
+    // The terms are sliced directly out of data, which points into buffer
     QByteArray buffer;
+    const char* data;
+    int size;
     int i;
     int lineNumber;
+    // The "s", "p" and "o" names, shared by all the rows
+    QSparqlResultSchema schema;
+    // Predicates and other repeated IRIs share one QUrl
+    QSparqlIriPool iris;
     QVector<QSparqlResultRow> results;
+    // Set when a term runs into the end of the buffer before its closing
+    // delimiter, parseParallel() then knows that a chunk was split inside it
+    bool truncated;
+    // When set, parse errors are collected in errors instead of printed
+    bool deferErrors;
+    QVector<Error> errors;
 };
 
 QT_END_NAMESPACE
@@ -41,6 +41,7 @@
 
 #include "qsparqlresultrow.h"
 #include "qsparqlbinding.h"
+#include "qsparqlquerytemplate_p.h"
 
 //#define QT_DEBUG_SQL
 
@@ -51,52 +52,27 @@
 
 QT_BEGIN_NAMESPACE
 
-// This struct stores a "placholder name" - "its position in the query string"
-// pair.  If the same placeholder occurs multiple times, multiple QHolders are
-// created for it.
-struct QHolder {
-    QHolder(const QString& hldr = QString(), int index = -1):
-        holderName(hldr), holderPos(index) {}
-    bool operator==(const QHolder& h) const
-        { return h.holderPos == holderPos && h.holderName == holderName; }
-    bool operator!=(const QHolder& h) const
-        { return h.holderPos != holderPos || h.holderName != holderName; }
-
-    QString holderName;
-    int holderPos;
-};
-
 class QSparqlQueryPrivate : public QSharedData
 {
 public:
     QSparqlQueryPrivate(const QString& q,
                         QSparqlQuery::StatementType t)
-        : query(q), type(t)
+        : compiled(q), type(t)
     {
-        findPlaceholders();
     }
 
     ~QSparqlQueryPrivate();
 
-    void findPlaceholders();
-
-    QString query;
+    // The query text, parsed into literal segments and placeholder slots.
+    // Copies of the query share it until the text is changed.
+    QSparqlQueryTemplate compiled;
     QSparqlQuery::StatementType type;
 
     QVector<QSparqlBinding> values; // bound values
     typedef QHash<QString, int> IndexMap;
     IndexMap indexes; // placeholder names -> indexes in the 'values' vector
-    typedef QVector<QHolder> QHolderVector;
-    QHolderVector holders;
 };
 
-static bool qIsAlnum(QChar ch)
-{
-    uint u = uint(ch.unicode());
-    // matches [a-zA-Z0-9_]
-    return u - 'a' < 26 || u - 'A' < 26 || u - '0' < 10 || u == '_';
-}
-
 /*!
 \internal
 */
@@ -230,7 +206,7 @@ void QSparqlQuery::setType(StatementType type)
 */
 QString QSparqlQuery::query() const
 {
-    return d->query;
+    return d->compiled.text();
 }
 
 /*!
@@ -238,46 +214,8 @@ QString QSparqlQuery::query() const
 */
 void QSparqlQuery::setQuery(const QString& query)
 {
-    d->query = query;
-    d->findPlaceholders();
-}
-
-/*!
-    Finds the placeholders from the query, creates holders for them and inserts
-    them into d->holders.
-*/
-
-void QSparqlQueryPrivate::findPlaceholders()
-{
-    holders.clear();
-    int n = query.size();
-
-    QChar quoteChar = QChar::Null;
-    int i = 0;
-
-    while (i < n) {
-        QChar ch = query.at(i);
-        QChar prev = (i > 0 ? query.at(i - 1) : QLatin1Char(' '));
-        if (ch == QLatin1Char(':') && (prev == QLatin1Char('?') || prev == QLatin1Char('$')) && quoteChar == QChar::Null
-                && (i < n - 1 && qIsAlnum(query.at(i + 1)))) {
-            int pos = i + 2;
-            while (pos < n && qIsAlnum(query.at(pos)))
-                ++pos;
-
-            holders.append(QHolder(query.mid(i + 1, pos - i - 1), i - 1));
-            i = pos;
-        } else {
-            if (ch == QLatin1Char('\'') || ch == QLatin1Char('"')) {
-                if (quoteChar == QChar::Null) {
-                    quoteChar = ch;
-                } else if (quoteChar == ch) {
-                    quoteChar = QChar::Null;
-                }
-            }
-
-            ++i;
-        }
-    }
+    if (query != d->compiled.text())
+        d->compiled = QSparqlQueryTemplate(query);
 }
 
 /*!
@@ -287,27 +225,35 @@ void QSparqlQueryPrivate::findPlaceholders()
 
 QString QSparqlQuery::preparedQueryText() const
 {
-    QString result(d->query);
-    int i;
-    QString holder;
-    int ix;
-    // The holders are stored in order and iterated in the reverse order; this
-    // way the indices of the earlier holder remain valid when we replace a
-    // holder in the string.
-    for (i = d->holders.count() - 1; i >= 0; --i) {
-        holder = d->holders.at(i).holderName;
-        ix = d->indexes.value(holder, -1);
+    const QSparqlQueryTemplate& compiled = d->compiled;
+    if (compiled.placeholderCount() == 0)
+        return compiled.text();
+
+    // Each distinct placeholder is looked up and escaped once, however many
+    // times it occurs in the query.
+    QVector<QString> replacements(compiled.slotCount());
+    for (int slot = 0; slot < replacements.count(); ++slot) {
+        const QString holder = compiled.slotName(slot);
+        const int ix = d->indexes.value(holder, -1);
         if (ix == -1) {
             qWarning() << "QSparql: Placeholder" << holder << "not replaced";
             continue;
         }
         // Recycling the value through QSparqlBinding will do the
         // escaping.
-        QSparqlBinding binding = d->values.value(ix);
-        result = result.replace(d->holders.at(i).holderPos,
-                                holder.length() + 2, binding.toString());
+        QString value = d->values.value(ix).toString();
+        if (value.isNull())
+            value = QLatin1String("");
+        replacements[slot] = value;
     }
-    return result;
+    return compiled.render(replacements);
+}
+
+// The models read the projection of the compiled query, instead of parsing
+// the prepared text each time a query is set
+QStringList qt_sparqlQueryProjection(const QSparqlQuery& query)
+{
+    return query.d->compiled.projection();
 }
 
 /*!
@@ -60,6 +60,7 @@ template <class Key, class T> class QMap;
 class QSparqlResultRow;
 class QSparqlBinding;
 class QSparqlQueryPrivate;
+class QStringList;
 
 class Q_SPARQL_EXPORT QSparqlQuery
 {
@@ -89,6 +90,7 @@ public:
     QString preparedQueryText() const;
 
 private:
+    friend Q_SPARQL_EXPORT QStringList qt_sparqlQueryProjection(const QSparqlQuery& query);
     QSharedDataPointer<QSparqlQueryPrivate> d;
 };
 
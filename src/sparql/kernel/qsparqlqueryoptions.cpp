@@ -53,6 +53,7 @@ public:
     QSparqlQueryOptions::Priority priority;
     bool forwardOnly;
     bool fireAndForget;
+    QStringList cacheTags;
 };
 
 QSparqlQueryOptionsPrivate::QSparqlQueryOptionsPrivate()
@@ -67,7 +68,8 @@ QSparqlQueryOptionsPrivate::QSparqlQueryOptionsPrivate()
 bool QSparqlQueryOptionsPrivate::operator==(const QSparqlQueryOptionsPrivate& other) const
 {
     return (executionMethod == other.executionMethod &&
-            priority == other.priority);
+            priority == other.priority &&
+            cacheTags == other.cacheTags);
 }
 
 /*!
@@ -207,4 +209,27 @@ QSparqlQueryOptions::Priority QSparqlQueryOptions::priority() const
     return d->priority;
 }
 
+/*!
+    Sets the tags of the query for the QSPARQL_CACHE driver. A cached result
+    of a SELECT, ASK, CONSTRUCT or DESCRIBE query is tagged with the
+    \a tags it was executed with, for instance the graphs or the classes it
+    reads. An update invalidates the cached results which have one of its
+    tags, and the results without tags. An update without tags invalidates
+    all of them.
+
+    Other drivers ignore this option.
+    \sa cacheTags
+*/
+void QSparqlQueryOptions::setCacheTags(const QStringList& tags)
+{
+    d->cacheTags = tags;
+}
+
+/// Returns the tags of the query for the QSPARQL_CACHE driver.
+/// \sa setCacheTags
+QStringList QSparqlQueryOptions::cacheTags() const
+{
+    return d->cacheTags;
+}
+
 QT_END_NAMESPACE
@@ -48,6 +48,7 @@
 #include <qsparql.h>
 
 #include <QtCore/qshareddata.h>
+#include <QtCore/qstringlist.h>
 
 QT_BEGIN_HEADER
 
@@ -88,6 +89,9 @@ public:
     void setPriority(Priority p);
     Priority priority() const;
 
+    void setCacheTags(const QStringList& tags);
+    QStringList cacheTags() const;
+
 private:
     QSharedDataPointer<QSparqlQueryOptionsPrivate> d;
 };
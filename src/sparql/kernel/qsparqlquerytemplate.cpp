@@ -0,0 +1,278 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsparqlquerytemplate_p.h"
+#include "qsparqllexer_p.h"
+
+#include <QtCore/qhash.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+// A piece of the query text: either literal text, or a placeholder
+// (including its ?: or $: mark) which refers to a slot.
+struct QSparqlQuerySegment {
+    QSparqlQuerySegment(int p = 0, int len = 0, int s = -1)
+        : pos(p), length(len), slot(s) {}
+
+    int pos;
+    int length;
+    int slot; // -1 for literal text
+};
+
+class QSparqlQueryTemplatePrivate : public QSharedData
+{
+public:
+    QSparqlQueryTemplatePrivate() : placeholders(0) {}
+
+    void compile();
+    void appendLiteral(int from, int to);
+
+    QString text;
+    QVector<QSparqlQuerySegment> segments;
+    QVector<QString> slotNames;
+    QHash<QString, int> slotIndexes;
+    int placeholders;
+    QStringList projection;
+};
+
+static inline bool qIsAlnum(ushort u)
+{
+    // matches [a-zA-Z0-9_]
+    return ushort(u - 'a') < 26 || ushort(u - 'A') < 26 || ushort(u - '0') < 10 || u == '_';
+}
+
+void QSparqlQueryTemplatePrivate::appendLiteral(int from, int to)
+{
+    if (to > from)
+        segments.append(QSparqlQuerySegment(from, to - from));
+}
+
+// Finds the placeholders (?:name or $:name outside quotes) in one pass over
+// the text and splits it into segments.
+void QSparqlQueryTemplatePrivate::compile()
+{
+    segments.clear();
+    slotNames.clear();
+    slotIndexes.clear();
+    placeholders = 0;
+
+    const ushort* s = text.utf16();
+    const int n = text.size();
+    ushort quoteChar = 0;
+    int literalStart = 0;
+    int i = 0;
+
+    while (i < n) {
+        const ushort ch = s[i];
+        if (ch == ':' && i > 0 && (s[i - 1] == '?' || s[i - 1] == '$') && quoteChar == 0
+                && i < n - 1 && qIsAlnum(s[i + 1])) {
+            int end = i + 2;
+            while (end < n && qIsAlnum(s[end]))
+                ++end;
+
+            const QString name = text.mid(i + 1, end - i - 1);
+            QHash<QString, int>::const_iterator it = slotIndexes.constFind(name);
+            int slot;
+            if (it == slotIndexes.constEnd()) {
+                slot = slotNames.count();
+                slotNames.append(name);
+                slotIndexes.insert(name, slot);
+            } else {
+                slot = it.value();
+            }
+
+            appendLiteral(literalStart, i - 1);
+            segments.append(QSparqlQuerySegment(i - 1, end - i + 1, slot));
+            ++placeholders;
+            literalStart = end;
+            i = end;
+        } else {
+            if (ch == '\'' || ch == '"') {
+                if (quoteChar == 0)
+                    quoteChar = ch;
+                else if (quoteChar == ch)
+                    quoteChar = 0;
+            }
+            ++i;
+        }
+    }
+    appendLiteral(literalStart, n);
+
+    // Only the text before the WHERE clause is lexed, so this doesn't
+    // depend on the size of the query body
+    projection = QSparqlLexer::projection(text);
+}
+
+/*!
+    \class QSparqlQueryTemplate
+    \internal
+
+    \brief The QSparqlQueryTemplate class is a query text which has been
+    parsed into literal text and placeholder slots.
+
+    The text is scanned for placeholders only once, when the template is
+    constructed. Rendering then copies the literal segments and the slot
+    values into a buffer which is allocated once with the final size, so the
+    cost doesn't depend on the number of placeholders being replaced.
+
+    QSparqlQueryTemplate is implicitly shared.
+*/
+
+QSparqlQueryTemplate::QSparqlQueryTemplate()
+    : d(new QSparqlQueryTemplatePrivate())
+{
+}
+
+QSparqlQueryTemplate::QSparqlQueryTemplate(const QString& text)
+    : d(new QSparqlQueryTemplatePrivate())
+{
+    d->text = text;
+    d->compile();
+}
+
+QSparqlQueryTemplate::QSparqlQueryTemplate(const QSparqlQueryTemplate& other)
+    : d(other.d)
+{
+}
+
+QSparqlQueryTemplate& QSparqlQueryTemplate::operator=(const QSparqlQueryTemplate& other)
+{
+    d = other.d;
+    return *this;
+}
+
+QSparqlQueryTemplate::~QSparqlQueryTemplate()
+{
+}
+
+/*!
+    Returns the original query text.
+*/
+QString QSparqlQueryTemplate::text() const
+{
+    return d->text;
+}
+
+/*!
+    Returns the number of distinct placeholder names in the text.
+*/
+int QSparqlQueryTemplate::slotCount() const
+{
+    return d->slotNames.count();
+}
+
+/*!
+    Returns the placeholder name of slot \a slot, without the placeholder
+    mark.
+*/
+QString QSparqlQueryTemplate::slotName(int slot) const
+{
+    return d->slotNames.value(slot);
+}
+
+/*!
+    Returns the slot of the placeholder \a name, or -1 if the text contains
+    no such placeholder.
+*/
+int QSparqlQueryTemplate::slotIndex(const QString& name) const
+{
+    return d->slotIndexes.value(name, -1);
+}
+
+/*!
+    Returns the number of placeholders in the text, counting each occurrence.
+*/
+int QSparqlQueryTemplate::placeholderCount() const
+{
+    return d->placeholders;
+}
+
+/*!
+    Returns the names of the variables projected by a SELECT query, as
+    QSparqlLexer::projection() returns them. They are found when the template
+    is constructed.
+*/
+QStringList QSparqlQueryTemplate::projection() const
+{
+    return d->projection;
+}
+
+/*!
+    Returns the text with every placeholder replaced by the value of its slot
+    in \a values. Placeholders whose value is a null QString are left as they
+    are.
+*/
+QString QSparqlQueryTemplate::render(const QVector<QString>& values) const
+{
+    if (d->placeholders == 0)
+        return d->text;
+
+    const QSparqlQuerySegment* segs = d->segments.constData();
+    const int count = d->segments.count();
+
+    int size = 0;
+    for (int i = 0; i < count; ++i) {
+        const int slot = segs[i].slot;
+        if (slot >= 0 && slot < values.count() && !values.at(slot).isNull())
+            size += values.at(slot).size();
+        else
+            size += segs[i].length;
+    }
+
+    QString result;
+    result.resize(size);
+    QChar* out = result.data();
+    const QChar* in = d->text.constData();
+    for (int i = 0; i < count; ++i) {
+        const int slot = segs[i].slot;
+        if (slot >= 0 && slot < values.count() && !values.at(slot).isNull()) {
+            const QString& value = values.at(slot);
+            memcpy(out, value.constData(), value.size() * sizeof(QChar));
+            out += value.size();
+        } else {
+            memcpy(out, in + segs[i].pos, segs[i].length * sizeof(QChar));
+            out += segs[i].length;
+        }
+    }
+    return result;
+}
+
+QT_END_NAMESPACE
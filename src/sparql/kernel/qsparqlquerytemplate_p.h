@@ -0,0 +1,103 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSPARQLQUERYTEMPLATE_P_H
+#define QSPARQLQUERYTEMPLATE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  This header file may
+// change from version to version without notice, or even be
+// removed.
+//
+// We mean it.
+//
+
+#include <qsparql.h>
+
+#include <QtCore/qshareddata.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+QT_MODULE(Sparql)
+
+class QSparqlQuery;
+class QSparqlQueryTemplatePrivate;
+
+// A query text split once into literal segments and placeholder slots. Each
+// distinct placeholder name gets one slot, and rendering takes one value per
+// slot, so the text is never rescanned. Copies share the parsed data.
+class Q_SPARQL_EXPORT QSparqlQueryTemplate
+{
+public:
+    QSparqlQueryTemplate();
+    explicit QSparqlQueryTemplate(const QString& text);
+    QSparqlQueryTemplate(const QSparqlQueryTemplate& other);
+    QSparqlQueryTemplate& operator=(const QSparqlQueryTemplate& other);
+    ~QSparqlQueryTemplate();
+
+    QString text() const;
+
+    int slotCount() const;
+    QString slotName(int slot) const;
+    int slotIndex(const QString& name) const;
+    int placeholderCount() const;
+
+    // values[slot] replaces every occurrence of the slot; a null QString (or
+    // a missing entry) leaves the placeholder text as it is.
+    QString render(const QVector<QString>& values) const;
+
+    // The variables projected by a SELECT query; see QSparqlLexer
+    QStringList projection() const;
+
+private:
+    QSharedDataPointer<QSparqlQueryTemplatePrivate> d;
+};
+
+// The projection of the template of query, which its copies share
+Q_SPARQL_EXPORT QStringList qt_sparqlQueryProjection(const QSparqlQuery& query);
+
+QT_END_NAMESPACE
+
+#endif // QSPARQLQUERYTEMPLATE_P_H
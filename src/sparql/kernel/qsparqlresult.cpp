@@ -44,9 +44,19 @@
 #include "qsparqlbinding.h"
 #include "qsparqlresultrow.h"
 #include "qsparqlresult.h"
+#include "qsparqlrowblock.h"
+#include "qstringlist.h"
 #include "qvector.h"
+#include "qvarlengtharray.h"
+#include "qsparqlresultstatistics.h"
 #include "qsparqldriver_p.h"
+#include "qsparqltracer_p.h"
+#include "qsparqlmemoryusage_p.h"
+#include "qsparqlresultextension_p.h"
+#include "qsparqlrowcounter_p.h"
 #include <QDebug>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qmutex.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -55,8 +65,20 @@ class QSparqlResultPrivate
 public:
     QSparqlResultPrivate()
     : idx(QSparql::BeforeFirstRow), statementType(QSparqlQuery::SelectStatement),
-      boolValue(false)
-    {}
+      boolValue(false), extension(0), executionStarted(-1), executionFinished(-1)
+    {
+        timer.start();
+    }
+
+    // Microseconds since the result was created
+    qint64 elapsed() const
+    {
+#if QT_VERSION >= 0x040800
+        return timer.nsecsElapsed() / 1000;
+#else
+        return timer.elapsed() * 1000;
+#endif
+    }
 
 public:
     int idx;
@@ -64,8 +86,44 @@ public:
     QSparqlQuery::StatementType statementType;
     QSparqlError error;
     bool boolValue;
+    QSparqlResultExtension* extension;
+
+    // The statistics are recorded by the driver, possibly from another
+    // thread than the one reading them
+    mutable QMutex statisticsMutex;
+    QElapsedTimer timer;
+    QSparqlResultStatistics statistics;
+    qint64 executionStarted;
+    qint64 executionFinished;
 };
 
+// Whether row has the variables of names, in the same order
+static bool hasVariablesInOrder(const QSparqlResultRow& row, const QStringList& names)
+{
+    if (row.count() != names.count())
+        return false;
+    for (int i = 0; i < names.count(); ++i) {
+        if (row.variableName(i) != names[i])
+            return false;
+    }
+    return true;
+}
+
+// Stores the values of row in the order of names; the variables which the
+// row doesn't bind are null, like the unbound variables of a SPARQL result
+static void rowValues(const QSparqlResultRow& row, const QStringList& names, QVariant* values)
+{
+    if (hasVariablesInOrder(row, names)) {
+        for (int i = 0; i < names.count(); ++i)
+            values[i] = row.value(i);
+        return;
+    }
+    for (int i = 0; i < names.count(); ++i) {
+        const int column = row.indexOf(names[i]);
+        values[i] = column < 0 ? QVariant() : row.value(column);
+    }
+}
+
 /*!
     \class QSparqlResult
     \brief The QSparqlResult class provides an abstract interface for
@@ -547,6 +605,124 @@ QString QSparqlResult::stringValue(int i) const
     return value(i).toString();
 }
 
+/*!
+    Retrieves up to \a maxRows rows following the current row and stores
+    their values into \a block, replacing its previous contents. Returns the
+    number of rows stored.
+
+    Calling this function is equivalent to calling next() up to \a maxRows
+    times and reading the values of every row: afterwards the result is
+    positioned on the last row stored, or after the last row if fewer than \a
+    maxRows rows were available. The difference is that the drivers can copy
+    the rows in one go, instead of going through a virtual call (and possibly
+    a lock) for each row and each value.
+
+    The columns of \a block are the variables of the result, when the driver
+    knows them, and otherwise the variables of the first row retrieved. The
+    values are placed by variable name, so a variable which a row doesn't
+    bind is a null QVariant in that row.
+
+    \sa next() value() QSparqlRowBlock
+*/
+
+int QSparqlResult::fetchBlock(int maxRows, QSparqlRowBlock *block)
+{
+    if (!block)
+        return 0;
+    if (d->extension)
+        return d->extension->fetchRowBlock(maxRows, block);
+
+    // Generic implementation on top of next() and current()
+    QSparqlTraceSpan span("fetchBlock");
+    block->setVariableNames(QStringList());
+    QStringList names;
+    QVarLengthArray<QVariant, 16> values;
+    int fetched = 0;
+    while (fetched < maxRows && next()) {
+        const QSparqlResultRow row = current();
+        if (fetched == 0) {
+            for (int i = 0; i < row.count(); ++i)
+                names.append(row.variableName(i));
+            block->setVariableNames(names);
+            values.resize(names.count());
+        }
+        rowValues(row, names, values.data());
+        block->appendRow(values.constData(), values.count());
+        ++fetched;
+    }
+    return fetched;
+}
+
+/*!
+    Makes fetchBlock() call the implementation of \a extension instead of
+    the generic one, which goes through next() and current(), and makes
+    memoryUsage() add the memory which \a extension reports. Drivers
+    storing the rows themselves implement QSparqlResultExtension and pass
+    the result itself.
+*/
+
+void QSparqlResult::setResultExtension(QSparqlResultExtension* extension)
+{
+    d->extension = extension;
+}
+
+/*!
+    Helper for drivers implementing fetchBlock() on top of \a rows, a
+    vector of rows which the driver stores itself. Copies up to \a maxRows
+    rows following the current row into \a block and updates the position
+    the same way fetchBlock() does. Returns the number of rows copied.
+
+    The columns of \a block are \a variableNames, the variables of the
+    result, and the values of each row are placed by variable name. If \a
+    variableNames is empty, the columns are the variables bound by the rows
+    copied, in the order they first appear.
+
+    The caller is responsible for holding any lock protecting \a rows.
+*/
+
+int QSparqlResult::fetchBlockFromRows(const QVector<QSparqlResultRow>& rows,
+                                      const QStringList& variableNames,
+                                      int maxRows, QSparqlRowBlock *block)
+{
+    if (!block)
+        return 0;
+
+    block->setVariableNames(QStringList());
+    if (maxRows <= 0 || pos() == QSparql::AfterLastRow)
+        return 0;
+
+    const int first = (pos() == QSparql::BeforeFirstRow) ? 0 : pos() + 1;
+    const int available = qMax(0, rows.count() - first);
+    const int fetched = qMin(maxRows, available);
+
+    if (fetched > 0) {
+        QStringList names = variableNames;
+        if (names.isEmpty()) {
+            for (int r = first; r < first + fetched; ++r) {
+                const QSparqlResultRow& row = rows.at(r);
+                if (r > first && hasVariablesInOrder(row, names))
+                    continue;
+                for (int i = 0; i < row.count(); ++i) {
+                    const QString name = row.variableName(i);
+                    if (r == first || !names.contains(name))
+                        names.append(name);
+                }
+            }
+        }
+        block->setVariableNames(names);
+        block->reserve(fetched);
+
+        QVarLengthArray<QVariant, 16> values(names.count());
+        for (int r = first; r < first + fetched; ++r) {
+            rowValues(rows.at(r), names, values.data());
+            block->appendRow(values.constData(), values.count());
+        }
+    }
+
+    updatePos(fetched < maxRows ? int(QSparql::AfterLastRow) : first + fetched - 1);
+    return fetched;
+}
+
 /*!
     This function is provided for derived classes which handle position
     tracking themselves, allowing them to record the current position in the 
@@ -608,6 +784,153 @@ QSparqlError QSparqlResult::lastError() const
     return d->error;
 }
 
+/*!
+    Returns the execution statistics of this result: how long the query
+    waited before being executed, how long the execution and fetching the
+    rows took, and how many rows and bytes were received. The statistics are
+    updated while the query is being executed; they are complete when the
+    result is finished.
+
+    \sa QSparqlResultStatistics
+*/
+
+QSparqlResultStatistics QSparqlResult::statistics() const
+{
+    QMutexLocker locker(&d->statisticsMutex);
+    return d->statistics;
+}
+
+/*!
+    Returns an estimate of the heap memory, in bytes, held by this result:
+    the rows it has fetched and stored, and the buffers of the driver. Data
+    shared with other objects, such as IRIs shared between rows, is counted
+    once. The estimate grows while the rows arrive.
+
+    The estimate depends on the driver; for example, a forward only result
+    only holds the current row. For a driver which doesn't report the data
+    it holds, only the data of QSparqlResult itself is counted.
+*/
+
+qint64 QSparqlResult::memoryUsage() const
+{
+    QSparqlMemoryUsage usage;
+    usage.addAllocation(sizeof(QSparqlResultPrivate));
+    usage.add(d->sparql);
+    usage.add(d->error.message());
+    qint64 total = usage.total();
+    if (d->extension)
+        total += d->extension->resultMemoryUsage();
+    return total;
+}
+
+/*!
+    Returns the number of microseconds since this result was created. Drivers
+    can use this for measuring the time they spend decoding the data (see
+    addDecodeTime()).
+*/
+
+qint64 QSparqlResult::elapsedTime() const
+{
+    return d->elapsed();
+}
+
+/*!
+    Called by the driver when it starts executing the query; the time since
+    the result was created is the queue time of the statistics.
+*/
+
+void QSparqlResult::markExecutionStarted()
+{
+    QMutexLocker locker(&d->statisticsMutex);
+    d->executionStarted = d->elapsed();
+    d->statistics.setQueueTime(d->executionStarted);
+}
+
+/*!
+    Called by the driver when the backend has executed the query and the
+    results start to be available.
+*/
+
+void QSparqlResult::markExecutionFinished()
+{
+    QMutexLocker locker(&d->statisticsMutex);
+    d->executionFinished = d->elapsed();
+    d->statistics.setExecuteTime(d->executionFinished
+                                 - qMax(Q_INT64_C(0), d->executionStarted));
+}
+
+/*!
+    Called by the driver when it has fetched \a count more rows. The first
+    call sets the time to the first row.
+*/
+
+void QSparqlResult::addFetchedRows(int count)
+{
+    if (count <= 0)
+        return;
+    QMutexLocker locker(&d->statisticsMutex);
+    if (d->statistics.timeToFirstRow() < 0)
+        d->statistics.setTimeToFirstRow(d->elapsed());
+    d->statistics.setRowCount(d->statistics.rowCount() + count);
+}
+
+/*!
+    Called by the driver to add the rows counted by \a counter, and their
+    decode time, to the statistics in one go. The counter is cleared.
+*/
+
+void QSparqlResult::recordRows(QSparqlRowCounter* counter)
+{
+    if (counter->rowCount() <= 0)
+        return;
+    QMutexLocker locker(&d->statisticsMutex);
+    if (d->statistics.timeToFirstRow() < 0) {
+        const qint64 firstRow = counter->firstRowDecoded();
+        d->statistics.setTimeToFirstRow(firstRow >= 0 ? firstRow : d->elapsed());
+    }
+    d->statistics.setRowCount(d->statistics.rowCount() + counter->rowCount());
+    if (counter->decodeTime() >= 0) {
+        d->statistics.setDecodeTime(qMax(Q_INT64_C(0), d->statistics.decodeTime())
+                                    + counter->decodeTime());
+    }
+    counter->clear();
+}
+
+/*!
+    Called by the driver when it has fetched all the rows.
+*/
+
+void QSparqlResult::markFetchFinished()
+{
+    QMutexLocker locker(&d->statisticsMutex);
+    const qint64 start = d->executionFinished >= 0
+                         ? d->executionFinished
+                         : qMax(Q_INT64_C(0), d->executionStarted);
+    d->statistics.setFetchTime(d->elapsed() - start);
+}
+
+/*!
+    Called by the driver when it has received \a bytes more bytes from the
+    network.
+*/
+
+void QSparqlResult::addBytesReceived(qint64 bytes)
+{
+    QMutexLocker locker(&d->statisticsMutex);
+    d->statistics.setBytesReceived(qMax(Q_INT64_C(0), d->statistics.bytesReceived()) + bytes);
+}
+
+/*!
+    Called by the driver when it has spent \a usecs more microseconds
+    decoding the data of the backend into rows.
+*/
+
+void QSparqlResult::addDecodeTime(qint64 usecs)
+{
+    QMutexLocker locker(&d->statisticsMutex);
+    d->statistics.setDecodeTime(qMax(Q_INT64_C(0), d->statistics.decodeTime()) + usecs);
+}
+
 /*!
     \enum QSparqlResult::Feature
 
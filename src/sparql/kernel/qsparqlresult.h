@@ -46,9 +46,12 @@
 #define QSPARQLRESULT_H
 
 #include <qsparqlresultrow.h>
+#include <qsparqlrowblock.h>
 #include <qsparqlquery.h>
+#include <qsparqlresultstatistics.h>
 
 #include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
 #include <QtCore/qobject.h>
 
 QT_BEGIN_HEADER
@@ -60,6 +63,8 @@ QT_MODULE(Sparql)
 class QString;
 class QSparqlError;
 class QSparqlResultPrivate;
+class QSparqlResultExtension;
+class QSparqlRowCounter;
 
 class Q_SPARQL_EXPORT QSparqlResult : public QObject
 {
@@ -91,6 +96,8 @@ public:
     virtual QSparqlBinding binding(int i) const = 0;
     virtual QVariant value(int i) const = 0;
     virtual QString stringValue(int i) const;
+    // Retrieving several rows at once
+    int fetchBlock(int maxRows, QSparqlRowBlock *block);
 
     // For ASK results
     bool boolValue() const;
@@ -111,6 +118,9 @@ public:
 
     virtual bool hasFeature(QSparqlResult::Feature feature) const;
 
+    QSparqlResultStatistics statistics() const;
+    qint64 memoryUsage() const;
+
 Q_SIGNALS:
     void dataReady(int totalCount);
     void finished();
@@ -124,6 +134,20 @@ protected:
     void setBoolValue(bool v);
 
     void updatePos(int pos); // used by subclasses for managing the position
+    void setResultExtension(QSparqlResultExtension* extension);
+    int fetchBlockFromRows(const QVector<QSparqlResultRow>& rows, const QStringList& variableNames,
+                           int maxRows, QSparqlRowBlock *block);
+
+    // Used by subclasses for recording the statistics
+    qint64 elapsedTime() const;
+    void markExecutionStarted();
+    void markExecutionFinished();
+    void addFetchedRows(int count);
+    void recordRows(QSparqlRowCounter* counter);
+    void markFetchFinished();
+    void addBytesReceived(qint64 bytes);
+    void addDecodeTime(qint64 usecs);
+
 private:
     QSparqlResultPrivate* d;
 
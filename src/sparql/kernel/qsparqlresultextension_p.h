@@ -0,0 +1,82 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSPARQLRESULTEXTENSION_P_H
+#define QSPARQLRESULTEXTENSION_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  This header file may
+// change from version to version without notice, or even be
+// removed.
+//
+// We mean it.
+//
+
+#include <qsparql.h>
+
+QT_BEGIN_NAMESPACE
+
+QT_MODULE(Sparql)
+
+class QSparqlRowBlock;
+
+// Functions which results can implement without adding virtual functions
+// to QSparqlResult. A result implementing them inherits this class too and
+// passes itself to QSparqlResult::setResultExtension() in its constructor;
+// QSparqlResult calls them when an extension is set, and uses its generic
+// implementation otherwise.
+class QSparqlResultExtension
+{
+public:
+    virtual ~QSparqlResultExtension() {}
+
+    // The implementation of QSparqlResult::fetchBlock(); block is not 0
+    virtual int fetchRowBlock(int maxRows, QSparqlRowBlock *block) = 0;
+
+    // The memory held by the driver, which QSparqlResult::memoryUsage()
+    // adds to what QSparqlResult itself holds
+    virtual qint64 resultMemoryUsage() const { return 0; }
+};
+
+QT_END_NAMESPACE
+
+#endif // QSPARQLRESULTEXTENSION_P_H
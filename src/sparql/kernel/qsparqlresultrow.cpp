@@ -43,8 +43,10 @@
 #include "qstringlist.h"
 #include "qatomic.h"
 #include "qsparqlbinding.h"
+#include "qsparqlresultschema.h"
 #include "qstring.h"
 #include "qvector.h"
+#include "qsparqlmemoryusage_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -54,22 +56,63 @@ public:
     QSparqlResultRowPrivate();
     QSparqlResultRowPrivate(const QSparqlResultRowPrivate &other);
 
-    inline bool contains(int index) { return index >= 0 && index < bindings.count(); }
+    inline bool contains(int index) { return index >= 0 && index < count(); }
+    inline int count() const { return bindings.count() + values.count(); }
 
+    QString name(int index) const;
+    QSparqlBinding binding(int index) const;
+    void valuesToBindings();
+
+    // A row holds either bindings, or only the values when it was filled
+    // with appendValue(); the names then come from the schema.
     QVector<QSparqlBinding> bindings;
+    QVector<QVariant> values;
+    QSparqlResultSchema schema;
+    bool hasSchema;
     QAtomicInt ref;
 };
 
 QSparqlResultRowPrivate::QSparqlResultRowPrivate()
+    : hasSchema(false)
 {
     ref = 1;
 }
 
-QSparqlResultRowPrivate::QSparqlResultRowPrivate(const QSparqlResultRowPrivate &other): bindings(other.bindings)
+QSparqlResultRowPrivate::QSparqlResultRowPrivate(const QSparqlResultRowPrivate &other)
+    : bindings(other.bindings),
+      values(other.values),
+      schema(other.schema),
+      hasSchema(other.hasSchema)
 {
     ref = 1;
 }
 
+QString QSparqlResultRowPrivate::name(int index) const
+{
+    if (hasSchema && index < schema.count())
+        return schema.variableName(index);
+    return bindings.value(index).name();
+}
+
+QSparqlBinding QSparqlResultRowPrivate::binding(int index) const
+{
+    if (!values.isEmpty())
+        return QSparqlBinding(name(index), values.at(index));
+
+    QSparqlBinding b = bindings.at(index);
+    if (hasSchema && b.name().isEmpty() && index < schema.count())
+        b.setName(schema.variableName(index));
+    return b;
+}
+
+void QSparqlResultRowPrivate::valuesToBindings()
+{
+    bindings.reserve(values.count());
+    for (int i = 0; i < values.count(); ++i)
+        bindings.append(binding(i));
+    values.clear();
+}
+
 /*!
     \class QSparqlResultRow
 
@@ -110,6 +153,25 @@ QSparqlResultRow::QSparqlResultRow()
     d = new QSparqlResultRowPrivate();
 }
 
+/*!
+    Constructs an empty result row whose bindings are described by \a
+    schema: the binding at position \e i has the variable name of column
+    \e i of \a schema. The bindings appended to the row don't need to have
+    names, and indexOf() uses the schema to find a binding by name.
+
+    Rows filled with appendValue() store only the values, which is
+    cheaper than creating a QSparqlBinding for each value.
+
+    \sa schema(), appendValue()
+*/
+
+QSparqlResultRow::QSparqlResultRow(const QSparqlResultSchema& schema)
+{
+    d = new QSparqlResultRowPrivate();
+    d->schema = schema;
+    d->hasSchema = true;
+}
+
 /*!
     Constructs a copy of \a other.
 
@@ -163,7 +225,16 @@ QSparqlResultRow::~QSparqlResultRow()
 */
 bool QSparqlResultRow::operator==(const QSparqlResultRow &other) const
 {
-    return d->bindings == other.d->bindings;
+    if (d->values.isEmpty() && other.d->values.isEmpty())
+        return d->bindings == other.d->bindings;
+
+    if (count() != other.count())
+        return false;
+    for (int i = 0; i < count(); ++i) {
+        if (d->binding(i) != other.d->binding(i))
+            return false;
+    }
+    return true;
 }
 
 /*!
@@ -175,7 +246,9 @@ bool QSparqlResultRow::operator==(const QSparqlResultRow &other) const
 
 QString QSparqlResultRow::variableName(int index) const
 {
-    return d->bindings.value(index).name();
+    if (!d->contains(index))
+        return QString();
+    return d->name(index);
 }
 
 /*!
@@ -184,13 +257,20 @@ QString QSparqlResultRow::variableName(int index) const
     case-sensitive. If more than one binding matches, the index of
     the first one is returned.
 
+    If the row has a schema, this is a hash lookup in the schema.
+
     \sa bindingName()
 */
 
 int QSparqlResultRow::indexOf(const QString& name) const
 {
+    if (d->hasSchema) {
+        const int i = d->schema.indexOf(name);
+        return i < count() ? i : -1;
+    }
+
     for (int i = 0; i < count(); ++i) {
-        if (d->bindings.at(i).name() == name)
+        if (d->name(i) == name)
             return i;
     }
     return -1;
@@ -202,7 +282,9 @@ int QSparqlResultRow::indexOf(const QString& name) const
  */
 QSparqlBinding QSparqlResultRow::binding(int index) const
 {
-    return d->bindings.value(index);
+    if (!d->contains(index))
+        return QSparqlBinding();
+    return d->binding(index);
 }
 
 /*!
@@ -211,6 +293,8 @@ QSparqlBinding QSparqlResultRow::binding(int index) const
  */
 QVariant QSparqlResultRow::value(int index) const
 {
+    if (!d->values.isEmpty())
+        return d->values.value(index);
     return d->bindings.value(index).value();
 }
 
@@ -240,9 +324,53 @@ QVariant QSparqlResultRow::value(const QString &name) const
 void QSparqlResultRow::append(const QSparqlBinding& binding)
 {
     detach();
+    if (!d->values.isEmpty())
+        d->valuesToBindings();
     d->bindings.append(binding);
 }
 
+/*!
+    Appends \a value to the end of the result row. The row stores only the
+    value; binding() creates the QSparqlBinding for it when asked, the same
+    as QSparqlBinding(name, \a value) with the variable name taken from the
+    schema.
+
+    \sa append() schema()
+*/
+
+void QSparqlResultRow::appendValue(const QVariant& value)
+{
+    detach();
+    if (!d->bindings.isEmpty()) {
+        d->bindings.append(QSparqlBinding(d->name(d->bindings.count()), value));
+    } else {
+        d->values.append(value);
+    }
+}
+
+/*!
+    Returns true if the row was constructed with a schema.
+
+    \sa schema()
+*/
+
+bool QSparqlResultRow::hasSchema() const
+{
+    return d->hasSchema;
+}
+
+/*!
+    Returns the schema describing the bindings of the row, or an empty schema
+    if the row has none.
+
+    \sa hasSchema()
+*/
+
+QSparqlResultSchema QSparqlResultRow::schema() const
+{
+    return d->schema;
+}
+
 /*!
     Removes all the result row's bindings.
 
@@ -253,6 +381,7 @@ void QSparqlResultRow::clear()
 {
     detach();
     d->bindings.clear();
+    d->values.clear();
 }
 
 /*!
@@ -264,7 +393,7 @@ void QSparqlResultRow::clear()
 
 bool QSparqlResultRow::isEmpty() const
 {
-    return d->bindings.isEmpty();
+    return d->count() == 0;
 }
 
 
@@ -288,6 +417,10 @@ bool QSparqlResultRow::contains(const QString& name) const
 void QSparqlResultRow::clearValues()
 {
     detach();
+    // A cleared binding is not a literal any more, which a bare value can't
+    // express
+    if (!d->values.isEmpty())
+        d->valuesToBindings();
     int count = d->bindings.count();
     for (int i = 0; i < count; ++i)
         d->bindings[i].clear();
@@ -301,7 +434,7 @@ void QSparqlResultRow::clearValues()
 
 int QSparqlResultRow::count() const
 {
-    return d->bindings.count();
+    return d->count();
 }
 
 
@@ -324,4 +457,21 @@ QDebug operator<<(QDebug dbg, const QSparqlResultRow &r)
 // LCOV_EXCL_STOP
 #endif
 
+// Defined here for the access to QSparqlResultRowPrivate
+void QSparqlMemoryUsage::add(const QSparqlResultRow& row)
+{
+    if (!row.d || !isFirstSeen(row.d))
+        return;
+
+    addAllocation(sizeof(QSparqlResultRowPrivate));
+    addArray(row.d->bindings);
+    Q_FOREACH (const QSparqlBinding& binding, row.d->bindings)
+        add(binding);
+    addArray(row.d->values);
+    Q_FOREACH (const QVariant& value, row.d->values)
+        add(value);
+    if (row.d->hasSchema)
+        add(row.d->schema);
+}
+
 QT_END_NAMESPACE
@@ -59,11 +59,13 @@ class QSparqlBinding;
 class QStringList;
 class QVariant;
 class QSparqlResultRowPrivate;
+class QSparqlResultSchema;
 
 class Q_SPARQL_EXPORT QSparqlResultRow
 {
 public:
     QSparqlResultRow();
+    explicit QSparqlResultRow(const QSparqlResultSchema& schema);
     QSparqlResultRow(const QSparqlResultRow& other);
     QSparqlResultRow& operator=(const QSparqlResultRow& other);
     ~QSparqlResultRow();
@@ -80,6 +82,10 @@ public:
     QVariant value(const QString &name) const;
 
     void append(const QSparqlBinding& binding);
+    void appendValue(const QVariant& value);
+
+    bool hasSchema() const;
+    QSparqlResultSchema schema() const;
 
     bool isEmpty() const;
     bool contains(const QString& name) const;
@@ -88,6 +94,7 @@ public:
     int count() const;
 
 private:
+    friend class QSparqlMemoryUsage;
     void detach();
     QSparqlResultRowPrivate* d;
 };
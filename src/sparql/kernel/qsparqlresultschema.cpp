@@ -0,0 +1,240 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsparqlresultschema.h"
+
+#include <QtCore/qhash.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qvector.h>
+
+#include "qsparqlmemoryusage_p.h"
+
+QT_BEGIN_NAMESPACE
+
+class QSparqlResultSchemaPrivate : public QSharedData
+{
+public:
+    QStringList names;
+    QVector<QVariant::Type> types;
+    QHash<QString, int> indexes; // variable name -> first column with it
+};
+
+/*!
+    \class QSparqlResultSchema
+
+    \brief The QSparqlResultSchema class describes the columns of a query
+    result.
+
+    A schema holds the variable names of the columns of a result, in order,
+    and optionally the type of the values in each column. It is shared by
+    all the rows of a result (see QSparqlResultRow::schema()), so that the
+    rows don't need to store the variable names themselves, and the position
+    of a variable can be looked up by name in constant time with indexOf().
+
+    QSparqlResultSchema is implicitly shared.
+
+    \sa QSparqlResultRow
+*/
+
+/*!
+    Constructs an empty schema.
+*/
+QSparqlResultSchema::QSparqlResultSchema()
+    : d(new QSparqlResultSchemaPrivate())
+{
+}
+
+/*!
+    Constructs a schema with one column for each of the \a variableNames.
+*/
+QSparqlResultSchema::QSparqlResultSchema(const QStringList& variableNames)
+    : d(new QSparqlResultSchemaPrivate())
+{
+    Q_FOREACH (const QString& name, variableNames)
+        append(name);
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QSparqlResultSchema::QSparqlResultSchema(const QSparqlResultSchema& other)
+    : d(other.d)
+{
+}
+
+/*!
+    Assigns \a other to this schema.
+*/
+QSparqlResultSchema& QSparqlResultSchema::operator=(const QSparqlResultSchema& other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    Destroys the object and frees any allocated resources.
+*/
+QSparqlResultSchema::~QSparqlResultSchema()
+{
+}
+
+/*!
+    Returns true if this schema has the same columns, with the same types, as
+    \a other.
+*/
+bool QSparqlResultSchema::operator==(const QSparqlResultSchema& other) const
+{
+    return d == other.d || (d->names == other.d->names && d->types == other.d->types);
+}
+
+/*!
+    \fn bool QSparqlResultSchema::operator!=(const QSparqlResultSchema& other) const
+
+    Returns true if this schema differs from \a other.
+*/
+
+/*!
+    Returns the number of columns.
+*/
+int QSparqlResultSchema::count() const
+{
+    return d->names.count();
+}
+
+/*!
+    Returns true if the schema has no columns.
+*/
+bool QSparqlResultSchema::isEmpty() const
+{
+    return d->names.isEmpty();
+}
+
+/*!
+    Returns the position of the column with the variable name \a name, or -1
+    if there is none. If several columns have the same name, the first one is
+    returned.
+*/
+int QSparqlResultSchema::indexOf(const QString& name) const
+{
+    return d->indexes.value(name, -1);
+}
+
+/*!
+    Returns true if there is a column with the variable name \a name.
+*/
+bool QSparqlResultSchema::contains(const QString& name) const
+{
+    return d->indexes.contains(name);
+}
+
+/*!
+    Returns the variable name of column \a i, or an empty string if the column
+    does not exist.
+*/
+QString QSparqlResultSchema::variableName(int i) const
+{
+    return d->names.value(i);
+}
+
+/*!
+    Returns the variable names of all the columns.
+*/
+QStringList QSparqlResultSchema::variableNames() const
+{
+    return d->names;
+}
+
+/*!
+    Returns the type of the values in column \a i, or QVariant::Invalid if it
+    is not known.
+*/
+QVariant::Type QSparqlResultSchema::columnType(int i) const
+{
+    return d->types.value(i, QVariant::Invalid);
+}
+
+/*!
+    Sets the type of the values in column \a i to \a type.
+*/
+void QSparqlResultSchema::setColumnType(int i, QVariant::Type type)
+{
+    if (i >= 0 && i < d->types.count())
+        d->types[i] = type;
+}
+
+/*!
+    Appends a column with the variable name \a name and values of type \a
+    type.
+*/
+void QSparqlResultSchema::append(const QString& name, QVariant::Type type)
+{
+    if (!d->indexes.contains(name))
+        d->indexes.insert(name, d->names.count());
+    d->names.append(name);
+    d->types.append(type);
+}
+
+/*!
+    Removes all the columns.
+*/
+void QSparqlResultSchema::clear()
+{
+    d->names.clear();
+    d->types.clear();
+    d->indexes.clear();
+}
+
+// Defined here for the access to QSparqlResultSchemaPrivate
+void QSparqlMemoryUsage::add(const QSparqlResultSchema& schema)
+{
+    if (!isFirstSeen(schema.d.constData()))
+        return;
+
+    addAllocation(sizeof(QSparqlResultSchemaPrivate));
+    add(schema.d->names);
+    addArray(schema.d->types);
+    // The hash shares its keys with the names
+    const QHash<QString, int>& indexes = schema.d->indexes;
+    if (indexes.capacity() > 0)
+        addAllocation(qint64(indexes.capacity()) * sizeof(void*));
+    for (int i = 0; i < indexes.count(); ++i)
+        addAllocation(2 * sizeof(void*) + sizeof(QString) + 2 * sizeof(int));
+}
+
+QT_END_NAMESPACE
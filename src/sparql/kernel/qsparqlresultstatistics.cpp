@@ -0,0 +1,252 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsparqlresultstatistics.h"
+
+#include <QtCore/qdebug.h>
+
+QT_BEGIN_NAMESPACE
+
+class QSparqlResultStatisticsPrivate : public QSharedData
+{
+public:
+    QSparqlResultStatisticsPrivate()
+        : queueTime(-1), executeTime(-1), timeToFirstRow(-1), fetchTime(-1),
+          decodeTime(-1), rowCount(0), bytesReceived(-1)
+    {}
+
+    qint64 queueTime;
+    qint64 executeTime;
+    qint64 timeToFirstRow;
+    qint64 fetchTime;
+    qint64 decodeTime;
+    int rowCount;
+    qint64 bytesReceived;
+};
+
+#ifndef QT_NO_DEBUG_STREAM
+// LCOV_EXCL_START
+QDebug operator<<(QDebug dbg, const QSparqlResultStatistics &s)
+{
+    dbg.nospace() << "QSparqlResultStatistics(queue " << s.queueTime()
+                  << ", execute " << s.executeTime()
+                  << ", first row " << s.timeToFirstRow()
+                  << ", fetch " << s.fetchTime()
+                  << ", decode " << s.decodeTime()
+                  << ", rows " << s.rowCount()
+                  << ", bytes " << s.bytesReceived() << ")";
+    return dbg.space();
+}
+// LCOV_EXCL_STOP
+#endif
+
+/*!
+    \class QSparqlResultStatistics
+
+    \brief The QSparqlResultStatistics class tells where the time of
+    executing a query went.
+
+    The statistics of a result are available from
+    QSparqlResult::statistics(), and are updated by the driver while the
+    query is being executed. All the times are in microseconds; a time which
+    the driver doesn't measure, or which hasn't passed yet, is -1.
+
+    With the statistics one can tell whether a query is slow because it
+    waits for a thread (queueTime()), because of the store (executeTime()),
+    or because of reading and decoding the rows (fetchTime() and
+    decodeTime()).
+
+    QSparqlResultStatistics is implicitly shared.
+
+    \sa QSparqlResult::statistics()
+*/
+
+/*!
+    Constructs statistics where nothing has been measured.
+*/
+QSparqlResultStatistics::QSparqlResultStatistics()
+    : d(new QSparqlResultStatisticsPrivate())
+{
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QSparqlResultStatistics::QSparqlResultStatistics(const QSparqlResultStatistics& other)
+    : d(other.d)
+{
+}
+
+/*!
+    Assigns \a other to these statistics.
+*/
+QSparqlResultStatistics& QSparqlResultStatistics::operator=(const QSparqlResultStatistics& other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    Destroys the object and frees any allocated resources.
+*/
+QSparqlResultStatistics::~QSparqlResultStatistics()
+{
+}
+
+/*!
+    Returns the time from the creation of the result until the driver
+    started executing the query, for instance waiting for a thread of the
+    QTRACKER_DIRECT thread pool.
+*/
+qint64 QSparqlResultStatistics::queueTime() const
+{
+    return d->queueTime;
+}
+
+/*!
+    Sets the time the query was queued to \a usecs.
+*/
+void QSparqlResultStatistics::setQueueTime(qint64 usecs)
+{
+    d->queueTime = usecs;
+}
+
+/*!
+    Returns the time the backend took to execute the query, until its
+    results started to be available.
+*/
+qint64 QSparqlResultStatistics::executeTime() const
+{
+    return d->executeTime;
+}
+
+/*!
+    Sets the execution time of the query to \a usecs.
+*/
+void QSparqlResultStatistics::setExecuteTime(qint64 usecs)
+{
+    d->executeTime = usecs;
+}
+
+/*!
+    Returns the time from the creation of the result until its first row was
+    available.
+*/
+qint64 QSparqlResultStatistics::timeToFirstRow() const
+{
+    return d->timeToFirstRow;
+}
+
+/*!
+    Sets the time to the first row to \a usecs.
+*/
+void QSparqlResultStatistics::setTimeToFirstRow(qint64 usecs)
+{
+    d->timeToFirstRow = usecs;
+}
+
+/*!
+    Returns the time spent fetching the rows after the execution, until the
+    result was finished.
+*/
+qint64 QSparqlResultStatistics::fetchTime() const
+{
+    return d->fetchTime;
+}
+
+/*!
+    Sets the fetch time to \a usecs.
+*/
+void QSparqlResultStatistics::setFetchTime(qint64 usecs)
+{
+    d->fetchTime = usecs;
+}
+
+/*!
+    Returns the part of the fetch time spent decoding the data of the
+    backend into rows.
+*/
+qint64 QSparqlResultStatistics::decodeTime() const
+{
+    return d->decodeTime;
+}
+
+/*!
+    Sets the decode time to \a usecs.
+*/
+void QSparqlResultStatistics::setDecodeTime(qint64 usecs)
+{
+    d->decodeTime = usecs;
+}
+
+/*!
+    Returns the number of rows fetched so far.
+*/
+int QSparqlResultStatistics::rowCount() const
+{
+    return d->rowCount;
+}
+
+/*!
+    Sets the number of rows fetched to \a count.
+*/
+void QSparqlResultStatistics::setRowCount(int count)
+{
+    d->rowCount = count;
+}
+
+/*!
+    Returns the number of bytes received from the network, or -1 if the
+    driver doesn't use the network.
+*/
+qint64 QSparqlResultStatistics::bytesReceived() const
+{
+    return d->bytesReceived;
+}
+
+/*!
+    Sets the number of bytes received to \a bytes.
+*/
+void QSparqlResultStatistics::setBytesReceived(qint64 bytes)
+{
+    d->bytesReceived = bytes;
+}
+
+QT_END_NAMESPACE
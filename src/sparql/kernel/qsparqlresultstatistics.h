@@ -0,0 +1,97 @@
+/***************************************************************************/
+/**
+** @copyright Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+**
+** @license Commercial Qt/LGPL 2.1 with Nokia exception/GPL 3.0
+**
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSPARQLRESULTSTATISTICS_H
+#define QSPARQLRESULTSTATISTICS_H
+
+#include "qsparql.h"
+
+#include <QtCore/qshareddata.h>
+
+QT_BEGIN_HEADER
+
+QT_BEGIN_NAMESPACE
+
+QT_MODULE(Sparql)
+
+class QDebug;
+class QSparqlResultStatisticsPrivate;
+
+class Q_SPARQL_EXPORT QSparqlResultStatistics
+{
+public:
+    QSparqlResultStatistics();
+    QSparqlResultStatistics(const QSparqlResultStatistics& other);
+    QSparqlResultStatistics& operator=(const QSparqlResultStatistics& other);
+    ~QSparqlResultStatistics();
+
+    qint64 queueTime() const;
+    void setQueueTime(qint64 usecs);
+    qint64 executeTime() const;
+    void setExecuteTime(qint64 usecs);
+    qint64 timeToFirstRow() const;
+    void setTimeToFirstRow(qint64 usecs);
+    qint64 fetchTime() const;
+    void setFetchTime(qint64 usecs);
+    qint64 decodeTime() const;
+    void setDecodeTime(qint64 usecs);
+
+    int rowCount() const;
+    void setRowCount(int count);
+    qint64 bytesReceived() const;
+    void setBytesReceived(qint64 bytes);
+
+private:
+    QSharedDataPointer<QSparqlResultStatisticsPrivate> d;
+};
+
+#ifndef QT_NO_DEBUG_STREAM
+Q_SPARQL_EXPORT QDebug operator<<(QDebug, const QSparqlResultStatistics&);
+#endif
+
+QT_END_NAMESPACE
+
+QT_END_HEADER
+
+#endif // QSPARQLRESULTSTATISTICS_H
@@ -0,0 +1,222 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsparqlrowblock.h"
+
+#include <QtCore/qstringlist.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QSparqlRowBlockPrivate : public QSharedData
+{
+public:
+    QSparqlRowBlockPrivate() : rows(0) {}
+
+    QStringList names;
+    // The values of all rows, stored row after row. Each row occupies
+    // names.count() consecutive entries.
+    QVector<QVariant> values;
+    int rows;
+};
+
+/*!
+    \class QSparqlRowBlock
+
+    \brief The QSparqlRowBlock class holds a block of consecutive result rows.
+
+    A QSparqlRowBlock is filled by QSparqlResult::fetchBlock(). It stores only
+    the values of the rows, laid out contiguously row after row, and the
+    variable names once for the whole block. Reading a block avoids the
+    per-cell virtual calls (and, for threaded drivers, the per-cell locking)
+    of navigating the result with next() and reading it with value().
+
+    The number of columns is fixed by setVariableNames(). Rows appended with
+    fewer values than there are columns are padded with invalid QVariants.
+
+    QSparqlRowBlock is implicitly shared.
+
+    \sa QSparqlResult::fetchBlock()
+*/
+
+/*!
+    Constructs an empty block with no columns.
+*/
+QSparqlRowBlock::QSparqlRowBlock()
+    : d(new QSparqlRowBlockPrivate())
+{
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QSparqlRowBlock::QSparqlRowBlock(const QSparqlRowBlock& other)
+    : d(other.d)
+{
+}
+
+/*!
+    Assigns \a other to this block.
+*/
+QSparqlRowBlock& QSparqlRowBlock::operator=(const QSparqlRowBlock& other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    Destroys the object and frees any allocated resources.
+*/
+QSparqlRowBlock::~QSparqlRowBlock()
+{
+}
+
+/*!
+    Returns the number of rows in the block.
+*/
+int QSparqlRowBlock::rowCount() const
+{
+    return d->rows;
+}
+
+/*!
+    Returns the number of columns in the block.
+
+    \sa setVariableNames()
+*/
+int QSparqlRowBlock::columnCount() const
+{
+    return d->names.count();
+}
+
+/*!
+    Returns true if the block contains no rows.
+*/
+bool QSparqlRowBlock::isEmpty() const
+{
+    return d->rows == 0;
+}
+
+/*!
+    Returns the variable name of column \a column, or an empty string if the
+    column does not exist.
+*/
+QString QSparqlRowBlock::variableName(int column) const
+{
+    return d->names.value(column);
+}
+
+/*!
+    Returns the variable names of all the columns.
+*/
+QStringList QSparqlRowBlock::variableNames() const
+{
+    return d->names;
+}
+
+/*!
+    Sets the variable names of the columns to \a names. This also sets the
+    number of columns, and removes all the rows from the block.
+*/
+void QSparqlRowBlock::setVariableNames(const QStringList& names)
+{
+    d->names = names;
+    d->values.clear();
+    d->rows = 0;
+}
+
+/*!
+    Returns the value on row \a row and column \a column. An invalid QVariant
+    is returned if the position is out of range.
+*/
+QVariant QSparqlRowBlock::value(int row, int column) const
+{
+    const int columns = d->names.count();
+    if (row < 0 || row >= d->rows || column < 0 || column >= columns)
+        return QVariant();
+    return d->values.at(row * columns + column);
+}
+
+/*!
+    Returns a pointer to the columnCount() values of row \a row, or 0 if the
+    row does not exist. The pointer is valid until the block is modified.
+*/
+const QVariant* QSparqlRowBlock::rowData(int row) const
+{
+    if (row < 0 || row >= d->rows || d->names.isEmpty())
+        return 0;
+    return d->values.constData() + row * d->names.count();
+}
+
+/*!
+    Reserves space for \a rows rows.
+*/
+void QSparqlRowBlock::reserve(int rows)
+{
+    d->values.reserve(rows * d->names.count());
+}
+
+/*!
+    Appends a row consisting of the first \a count values of \a values. If
+    \a count is smaller than columnCount(), the remaining columns are left
+    invalid; if it is larger, the extra values are ignored.
+*/
+void QSparqlRowBlock::appendRow(const QVariant* values, int count)
+{
+    const int columns = d->names.count();
+    const int n = qMin(count, columns);
+    for (int i = 0; i < n; ++i)
+        d->values.append(values[i]);
+    for (int i = n; i < columns; ++i)
+        d->values.append(QVariant());
+    ++d->rows;
+}
+
+/*!
+    Removes all the rows from the block. The variable names are kept.
+*/
+void QSparqlRowBlock::clear()
+{
+    d->values.clear();
+    d->rows = 0;
+}
+
+QT_END_NAMESPACE
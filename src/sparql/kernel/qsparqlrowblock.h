@@ -0,0 +1,94 @@
+/***************************************************************************/
+/**
+** @copyright Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+**
+** @license Commercial Qt/LGPL 2.1 with Nokia exception/GPL 3.0
+**
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSPARQLROWBLOCK_H
+#define QSPARQLROWBLOCK_H
+
+#include "qsparql.h"
+
+#include <QtCore/qshareddata.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_HEADER
+
+QT_BEGIN_NAMESPACE
+
+QT_MODULE(Sparql)
+
+class QStringList;
+class QVariant;
+class QSparqlRowBlockPrivate;
+
+class Q_SPARQL_EXPORT QSparqlRowBlock
+{
+public:
+    QSparqlRowBlock();
+    QSparqlRowBlock(const QSparqlRowBlock& other);
+    QSparqlRowBlock& operator=(const QSparqlRowBlock& other);
+    ~QSparqlRowBlock();
+
+    int rowCount() const;
+    int columnCount() const;
+    bool isEmpty() const;
+
+    QString variableName(int column) const;
+    QStringList variableNames() const;
+    void setVariableNames(const QStringList& names);
+
+    QVariant value(int row, int column) const;
+    const QVariant* rowData(int row) const;
+
+    void reserve(int rows);
+    void appendRow(const QVariant* values, int count);
+    void clear();
+
+private:
+    QSharedDataPointer<QSparqlRowBlockPrivate> d;
+};
+
+QT_END_NAMESPACE
+
+QT_END_HEADER
+
+#endif // QSPARQLROWBLOCK_H
@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSPARQLROWCOUNTER_P_H
+#define QSPARQLROWCOUNTER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  This header file may
+// change from version to version without notice, or even be
+// removed.
+//
+// We mean it.
+//
+
+#include <qsparql.h>
+
+QT_BEGIN_NAMESPACE
+
+QT_MODULE(Sparql)
+
+// Counts the rows a driver fetches between two calls of
+// QSparqlResult::recordRows(), so that the statistics are updated once per
+// batch of rows instead of once per row. Only the decoding of one row out of
+// SampleInterval is timed; the decode time of the batch is extrapolated from
+// these rows. The times are those of QSparqlResult::elapsedTime().
+class QSparqlRowCounter
+{
+public:
+    enum { SampleInterval = 16, BatchSize = 256 };
+
+    QSparqlRowCounter()
+        : rows(0), sampledRows(0), sampledTime(0), firstRowTime(-1), recorded(false)
+    {
+    }
+
+    // Whether the decoding of the next row is to be timed and counted with
+    // addSampledRow() instead of addRow()
+    bool isSampled() const
+    {
+        return rows % SampleInterval == 0;
+    }
+
+    void addRow()
+    {
+        ++rows;
+    }
+
+    void addSampledRow(qint64 decodeStart, qint64 decodeEnd)
+    {
+        if (rows == 0)
+            firstRowTime = decodeEnd;
+        ++rows;
+        ++sampledRows;
+        sampledTime += decodeEnd - decodeStart;
+    }
+
+    int rowCount() const
+    {
+        return rows;
+    }
+
+    // For drivers without batches of their own: whether the rows are to be
+    // recorded now, which is for the first row (for the time to the first
+    // row) and then every BatchSize rows
+    bool isBatchFull() const
+    {
+        return rows >= BatchSize || (rows > 0 && !recorded);
+    }
+
+    // When the first row was decoded, or -1 if it wasn't timed
+    qint64 firstRowDecoded() const
+    {
+        return firstRowTime;
+    }
+
+    // The decode time of the rows, or -1 if no row was timed
+    qint64 decodeTime() const
+    {
+        return sampledRows > 0 ? sampledTime * rows / sampledRows : -1;
+    }
+
+    // Called when the rows have been recorded
+    void clear()
+    {
+        rows = 0;
+        sampledRows = 0;
+        sampledTime = 0;
+        firstRowTime = -1;
+        recorded = true;
+    }
+
+private:
+    int rows;
+    int sampledRows;
+    qint64 sampledTime;
+    qint64 firstRowTime;
+    bool recorded;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSPARQLROWCOUNTER_P_H
@@ -0,0 +1,294 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsparqltracer_p.h"
+#include "qsparqlconnectionoptions.h"
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qthreadstorage.h>
+#include <QtCore/qdebug.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+struct TracerData
+{
+    TracerData() : pid(0), session(0), lastThreadId(0) {}
+
+    // Protects everything below; the events are written by whichever
+    // thread records them
+    QMutex mutex;
+    QFile file;
+    QElapsedTimer timer;
+    qint64 pid;
+    // Counts the start() calls, each trace file names its threads again
+    int session;
+    int lastThreadId;
+};
+
+// The small thread ids used in the trace, instead of the native handles
+struct ThreadId
+{
+    int session;
+    int id;
+};
+
+Q_GLOBAL_STATIC(TracerData, tracerData)
+Q_GLOBAL_STATIC(QThreadStorage<ThreadId*>, threadIds)
+
+void appendJsonString(QByteArray& out, const QString& str)
+{
+    const QByteArray utf8 = str.toUtf8();
+    out += '"';
+    for (int i = 0; i < utf8.size(); ++i) {
+        const char c = utf8.at(i);
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[7];
+                qsnprintf(escaped, sizeof(escaped), "\\u%04x", int(c));
+                out += escaped;
+            } else {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+void appendEventStart(QByteArray& out, const char* name, const char* phase, int tid)
+{
+    TracerData* data = tracerData();
+    out += "{\"name\":\"";
+    out += name;
+    out += "\",\"cat\":\"qsparql\",\"ph\":\"";
+    out += phase;
+    out += "\",\"pid\":";
+    out += QByteArray::number(data->pid);
+    out += ",\"tid\":";
+    out += QByteArray::number(tid);
+}
+
+void writeEvent(const QByteArray& event)
+{
+    // The events form a JSON array; the trace viewers also accept it
+    // without the closing bracket if the application doesn't exit cleanly
+    TracerData* data = tracerData();
+    data->file.write(",\n", 2);
+    data->file.write(event);
+}
+
+// Returns the id of the current thread in the trace, naming the thread the
+// first time. Called with the mutex held.
+int currentThreadId()
+{
+    TracerData* data = tracerData();
+    QThreadStorage<ThreadId*>* ids = threadIds();
+    if (!ids->hasLocalData())
+        ids->setLocalData(new ThreadId());
+    ThreadId* threadId = ids->localData();
+    if (threadId->session == data->session)
+        return threadId->id;
+
+    const int tid = ++data->lastThreadId;
+    threadId->session = data->session;
+    threadId->id = tid;
+
+    QString name = QThread::currentThread()->objectName();
+    if (name.isEmpty()) {
+        if (QCoreApplication::instance()
+                && QThread::currentThread() == QCoreApplication::instance()->thread())
+            name = QLatin1String("main");
+        else
+            name = QString::fromLatin1("thread %1").arg(tid);
+    }
+
+    QByteArray event;
+    appendEventStart(event, "thread_name", "M", tid);
+    event += ",\"args\":{\"name\":";
+    appendJsonString(event, name);
+    event += "}}";
+    writeEvent(event);
+    return tid;
+}
+
+void stopTracer()
+{
+    QSparqlTracer::stop();
+}
+
+} // end of unnamed namespace
+
+QAtomicInt QSparqlTracer::enabled;
+
+void QSparqlTracer::initialize(const QSparqlConnectionOptions& options)
+{
+    if (isEnabled())
+        return;
+
+    QString fileName = options.option(QLatin1String("traceFile")).toString();
+    if (fileName.isEmpty())
+        fileName = QFile::decodeName(qgetenv("QSPARQL_TRACE"));
+    if (!fileName.isEmpty())
+        start(fileName);
+}
+
+bool QSparqlTracer::start(const QString& fileName)
+{
+    TracerData* data = tracerData();
+    QMutexLocker locker(&data->mutex);
+    if (isEnabled())
+        return true;
+
+    data->file.setFileName(fileName);
+    if (!data->file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "QSparqlTracer: cannot write the trace to" << fileName
+                   << data->file.errorString();
+        return false;
+    }
+
+    data->pid = QCoreApplication::applicationPid();
+    ++data->session;
+    data->lastThreadId = 0;
+    data->timer.start();
+    // A first event which needs no comma before it, which also tells the
+    // viewer the name of the process
+    QByteArray event("[\n");
+    appendEventStart(event, "process_name", "M", 0);
+    event += ",\"args\":{\"name\":";
+    appendJsonString(event, QCoreApplication::applicationName().isEmpty()
+                            ? QString::fromLatin1("QtSparql")
+                            : QCoreApplication::applicationName());
+    event += "}}";
+    data->file.write(event);
+
+    static bool postRoutineAdded = false;
+    if (!postRoutineAdded && QCoreApplication::instance()) {
+        qAddPostRoutine(stopTracer);
+        postRoutineAdded = true;
+    }
+
+    enabled.fetchAndStoreRelease(1);
+    return true;
+}
+
+void QSparqlTracer::stop()
+{
+    TracerData* data = tracerData();
+    QMutexLocker locker(&data->mutex);
+    if (!isEnabled())
+        return;
+
+    enabled.fetchAndStoreRelease(0);
+    data->file.write("\n]\n");
+    data->file.close();
+}
+
+qint64 QSparqlTracer::now()
+{
+    const TracerData* data = tracerData();
+#if QT_VERSION >= 0x040800
+    return data->timer.nsecsElapsed() / 1000;
+#else
+    return data->timer.elapsed() * 1000;
+#endif
+}
+
+void QSparqlTracer::complete(const char* name, qint64 start, qint64 end,
+                             const QString& detail)
+{
+    TracerData* data = tracerData();
+    QMutexLocker locker(&data->mutex);
+    if (!isEnabled())
+        return;
+
+    QByteArray event;
+    appendEventStart(event, name, "X", currentThreadId());
+    event += ",\"ts\":";
+    event += QByteArray::number(start);
+    event += ",\"dur\":";
+    event += QByteArray::number(qMax(Q_INT64_C(0), end - start));
+    if (!detail.isEmpty()) {
+        event += ",\"args\":{\"detail\":";
+        // Long queries would make the trace unreadable
+        appendJsonString(event, detail.left(256));
+        event += '}';
+    }
+    event += '}';
+    writeEvent(event);
+}
+
+void QSparqlTracer::instant(const char* name, const QString& detail)
+{
+    TracerData* data = tracerData();
+    QMutexLocker locker(&data->mutex);
+    if (!isEnabled())
+        return;
+
+    QByteArray event;
+    appendEventStart(event, name, "i", currentThreadId());
+    event += ",\"s\":\"t\",\"ts\":";
+    event += QByteArray::number(now());
+    if (!detail.isEmpty()) {
+        event += ",\"args\":{\"detail\":";
+        appendJsonString(event, detail.left(256));
+        event += '}';
+    }
+    event += '}';
+    writeEvent(event);
+}
+
+QT_END_NAMESPACE
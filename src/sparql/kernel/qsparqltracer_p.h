@@ -0,0 +1,163 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSPARQLTRACER_P_H
+#define QSPARQLTRACER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  This header file may
+// change from version to version without notice, or even be
+// removed.
+//
+// We mean it.
+//
+
+#include <qsparql.h>
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+QT_MODULE(Sparql)
+
+class QSparqlConnectionOptions;
+
+// Records spans of the query execution as Chrome trace events (see
+// chrome://tracing), one file for the whole process. The tracing is started
+// by the QSPARQL_TRACE environment variable or the "traceFile" connection
+// option, both giving the name of the file; when it's off, the spans cost
+// one atomic read.
+class Q_SPARQL_EXPORT QSparqlTracer
+{
+public:
+    static inline bool isEnabled()
+    {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+        return enabled.load() != 0;
+#else
+        return enabled != 0;
+#endif
+    }
+
+    // Starts tracing if the environment or options ask for it
+    static void initialize(const QSparqlConnectionOptions& options);
+    static bool start(const QString& fileName);
+    static void stop();
+
+    // Microseconds since the tracing was started
+    static qint64 now();
+    static void complete(const char* name, qint64 start, qint64 end,
+                         const QString& detail = QString());
+    static void instant(const char* name, const QString& detail = QString());
+
+private:
+    static QAtomicInt enabled;
+};
+
+// Records the time between its construction and destruction as a span
+class QSparqlTraceSpan
+{
+public:
+    explicit QSparqlTraceSpan(const char* name)
+        : name(name), start(QSparqlTracer::isEnabled() ? QSparqlTracer::now() : -1)
+    {
+    }
+
+    QSparqlTraceSpan(const char* name, const QString& detail)
+        : name(name), start(-1)
+    {
+        if (QSparqlTracer::isEnabled()) {
+            start = QSparqlTracer::now();
+            this->detail = detail;
+        }
+    }
+
+    ~QSparqlTraceSpan()
+    {
+        if (start >= 0 && QSparqlTracer::isEnabled())
+            QSparqlTracer::complete(name, start, QSparqlTracer::now(), detail);
+    }
+
+    void setDetail(const QString& d)
+    {
+        if (start >= 0)
+            detail = d;
+    }
+
+private:
+    Q_DISABLE_COPY(QSparqlTraceSpan)
+    const char* name;
+    qint64 start;
+    QString detail;
+};
+
+// Like QMutexLocker, but records a span when the thread has to wait for the
+// mutex, so that lock contention shows in the trace
+class QSparqlTracedMutexLocker
+{
+public:
+    QSparqlTracedMutexLocker(QMutex* m, const char* name)
+        : mutex(m)
+    {
+        if (!QSparqlTracer::isEnabled()) {
+            mutex->lock();
+        } else if (!mutex->tryLock()) {
+            QSparqlTraceSpan span(name);
+            mutex->lock();
+        }
+    }
+
+    ~QSparqlTracedMutexLocker()
+    {
+        mutex->unlock();
+    }
+
+private:
+    Q_DISABLE_COPY(QSparqlTracedMutexLocker)
+    QMutex* mutex;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSPARQLTRACER_P_H
@@ -0,0 +1,1219 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsparqlturtle_p.h"
+#include "qsparqliripool_p.h"
+
+#include <qsparqlbinding.h>
+#include <qsparqlresultschema.h>
+
+#include <QtCore/qdebug.h>
+#include <QtCore/qhash.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+// A parsed subject, predicate, object or graph
+struct QSparqlTurtleTerm
+{
+    enum Kind { None, Iri, Blank, Literal };
+
+    QSparqlTurtleTerm() : kind(None) {}
+
+    Kind kind;
+    QVariant value; // a QUrl for IRIs, the label or lexical form otherwise
+    QString languageTag;
+    QUrl dataType;
+};
+
+typedef QSparqlTurtleTerm Term;
+
+static inline bool isAsciiAlpha(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// The ASCII subset of PN_CHARS, plus any byte of a UTF-8 sequence
+static inline bool isNameChar(char c)
+{
+    return isAsciiAlpha(c) || isDigit(c) || c == '_' || c == '-'
+        || static_cast<uchar>(c) > 0x7f;
+}
+
+static bool hasScheme(const QString& iri)
+{
+    for (int n = 0; n < iri.size(); ++n) {
+        const QChar c = iri.at(n);
+        if (c == QLatin1Char(':'))
+            return n > 0;
+        if (!(c.isLetter() || (n > 0 && (c.isDigit() || c == QLatin1Char('+')
+                                         || c == QLatin1Char('-') || c == QLatin1Char('.')))))
+            return false;
+    }
+    return false;
+}
+
+static bool parseHex(const char* p, int digits, uint* value)
+{
+    uint result = 0;
+    for (int n = 0; n < digits; ++n) {
+        const char c = p[n];
+        result <<= 4;
+        if (c >= '0' && c <= '9')
+            result |= c - '0';
+        else if (c >= 'a' && c <= 'f')
+            result |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            result |= c - 'A' + 10;
+        else
+            return false;
+    }
+    *value = result;
+    return true;
+}
+
+static void appendUcs4(QString& out, uint ucs4)
+{
+    if (ucs4 > 0xffff) {
+        out.append(QChar(QChar::highSurrogate(ucs4)));
+        out.append(QChar(QChar::lowSurrogate(ucs4)));
+    } else {
+        out.append(QChar(ushort(ucs4)));
+    }
+}
+
+class QSparqlTurtlePrivate
+{
+public:
+    QSparqlTurtlePrivate(QSparqlTurtle::Syntax s);
+
+    // Statement level
+    void parseAvailable();
+    bool parseStatement();
+    bool parseDirective(bool sparqlStyle);
+    bool parseTriples();
+    bool parseQuad();
+    bool parsePredicateObjectList(const Term& subject);
+    bool parseObjectList(const Term& subject, const Term& predicate);
+
+    // Terms
+    bool parseSubject(Term* term);
+    bool parseVerb(Term* term);
+    bool parseObject(Term* term);
+    bool parseIri(Term* term);
+    bool parseIriRef(QUrl* iri);
+    bool parsePrefixedName(QUrl* iri);
+    bool parseBlankNodeLabel(Term* term);
+    bool parseBlankNodePropertyList(Term* term);
+    bool parseCollection(Term* term);
+    bool parseLiteral(Term* term);
+    bool parseString(QString* value);
+    bool parseNumber(Term* term);
+
+    // Lexing
+    bool more(int n = 1);
+    bool lookingAtKeyword(const char* keyword, bool caseSensitive, bool* matched);
+    void skipWhiteSpace();
+    void fail(const QString& message);
+
+    Term newBlankNode();
+    void emitTriple(const Term& s, const Term& p, const Term& o, const Term* g = 0);
+    void appendTerm(QSparqlResultRow* row, const Term& term);
+
+    QSparqlTurtle::Syntax syntax;
+    QByteArray buffer;
+    const char* data;
+    int size;
+    int i;
+    int lineNumber;
+    bool finished;
+    // Set when a statement runs into the end of the data received so far
+    bool incomplete;
+    bool failed;
+    QString error;
+
+    QUrl base;
+    // Prefix -> namespace IRI, resolved against the base when declared
+    QHash<QString, QString> prefixes;
+    // Prefixed name -> expanded IRI, so that each name is expanded once
+    QHash<QByteArray, QUrl> prefixedNames;
+    QSparqlIriPool iris;
+    int blankNodeCount;
+
+    QSparqlResultSchema schema;
+    QVector<QSparqlResultRow> results;
+
+    Term rdfType;
+    Term rdfFirst;
+    Term rdfRest;
+    Term rdfNil;
+};
+
+static Term iriTerm(const char* iri)
+{
+    Term term;
+    term.kind = Term::Iri;
+    term.value = QUrl::fromEncoded(QByteArray(iri));
+    return term;
+}
+
+QSparqlTurtlePrivate::QSparqlTurtlePrivate(QSparqlTurtle::Syntax s)
+    : syntax(s), data(0), size(0), i(0), lineNumber(1), finished(false),
+      incomplete(false), failed(false), blankNodeCount(0)
+{
+    schema.append(QLatin1String("s"));
+    schema.append(QLatin1String("p"));
+    schema.append(QLatin1String("o"));
+    if (syntax == QSparqlTurtle::NQuads)
+        schema.append(QLatin1String("g"));
+
+    rdfType = iriTerm("http://www.w3.org/1999/02/22-rdf-syntax-ns#type");
+    rdfFirst = iriTerm("http://www.w3.org/1999/02/22-rdf-syntax-ns#first");
+    rdfRest = iriTerm("http://www.w3.org/1999/02/22-rdf-syntax-ns#rest");
+    rdfNil = iriTerm("http://www.w3.org/1999/02/22-rdf-syntax-ns#nil");
+}
+
+/*
+    Returns true if the next \a n bytes are available. Otherwise the
+    statement can't be completed yet, or at all if there is no more data.
+*/
+bool QSparqlTurtlePrivate::more(int n)
+{
+    if (incomplete)
+        return false;
+    if (i + n <= size)
+        return true;
+    if (finished)
+        fail(QLatin1String("Unexpected end of data"));
+    else
+        incomplete = true;
+    return false;
+}
+
+/*
+    Checks for \a keyword followed by a character that can't continue a
+    name. Returns false if that can't be decided with the data so far.
+*/
+bool QSparqlTurtlePrivate::lookingAtKeyword(const char* keyword, bool caseSensitive, bool* matched)
+{
+    const int length = qstrlen(keyword);
+    *matched = false;
+    for (int n = 0; n < length; ++n) {
+        if (i + n >= size) {
+            if (!finished) {
+                incomplete = true;
+                return false;
+            }
+            return true;
+        }
+        const char c = data[i + n];
+        if (caseSensitive ? c != keyword[n] : (c | 0x20) != keyword[n])
+            return true;
+    }
+    if (i + length >= size) {
+        if (!finished) {
+            incomplete = true;
+            return false;
+        }
+        *matched = true;
+        return true;
+    }
+    const char next = data[i + length];
+    *matched = !isNameChar(next) && next != ':';
+    return true;
+}
+
+void QSparqlTurtlePrivate::skipWhiteSpace()
+{
+    while (i < size) {
+        const char c = data[i];
+        if (c == '\n') {
+            ++lineNumber;
+        } else if (c == '#') {
+            const char* lf = static_cast<const char*>(memchr(data + i, '\n', size - i));
+            if (!lf) {
+                // Keep the comment until the rest of it has arrived
+                if (!finished)
+                    incomplete = true;
+                else
+                    i = size;
+                return;
+            }
+            i = lf - data;
+            continue;
+        } else if (c != ' ' && c != '\t' && c != '\r') {
+            return;
+        }
+        ++i;
+    }
+}
+
+void QSparqlTurtlePrivate::fail(const QString& message)
+{
+    if (failed)
+        return;
+    failed = true;
+    error = QString::fromLatin1("Line %1: %2").arg(lineNumber).arg(message);
+    qWarning() << "QSparqlTurtle: ERROR in line " << lineNumber << ":" << message;
+}
+
+Term QSparqlTurtlePrivate::newBlankNode()
+{
+    Term term;
+    term.kind = Term::Blank;
+    term.value = QString::fromLatin1("genid%1").arg(++blankNodeCount);
+    return term;
+}
+
+void QSparqlTurtlePrivate::appendTerm(QSparqlResultRow* row, const Term& term)
+{
+    switch (term.kind) {
+    case Term::Iri:
+        row->appendValue(term.value);
+        break;
+    case Term::Blank:
+    {
+        QSparqlBinding binding;
+        binding.setBlankNodeLabel(term.value.toString());
+        row->append(binding);
+        break;
+    }
+    case Term::Literal:
+        if (!term.languageTag.isEmpty()) {
+            QSparqlBinding binding;
+            binding.setValue(term.value);
+            binding.setLanguageTag(term.languageTag);
+            row->append(binding);
+        } else if (!term.dataType.isEmpty()) {
+            QSparqlBinding binding;
+            binding.setValue(term.value.toString(), term.dataType);
+            row->append(binding);
+        } else {
+            row->appendValue(term.value);
+        }
+        break;
+    case Term::None:
+        break;
+    }
+}
+
+void QSparqlTurtlePrivate::emitTriple(const Term& s, const Term& p, const Term& o, const Term* g)
+{
+    QSparqlResultRow row(schema);
+    appendTerm(&row, s);
+    appendTerm(&row, p);
+    appendTerm(&row, o);
+    // Quads in the default graph have no "g" binding
+    if (g)
+        appendTerm(&row, *g);
+    results.append(row);
+}
+
+void QSparqlTurtlePrivate::parseAvailable()
+{
+    data = buffer.constData();
+    size = buffer.size();
+
+    while (!failed) {
+        incomplete = false;
+        skipWhiteSpace();
+        if (i >= size || incomplete)
+            break;
+
+        // A statement which can't be completed yet is parsed again from the
+        // start when more data has arrived.
+        const int start = i;
+        const int startLine = lineNumber;
+        const int rowCount = results.count();
+        const int blankNodes = blankNodeCount;
+
+        if (!parseStatement()) {
+            results.resize(rowCount);
+            if (incomplete) {
+                i = start;
+                lineNumber = startLine;
+                blankNodeCount = blankNodes;
+            }
+            break;
+        }
+    }
+
+    // Only the unparsed tail of the data needs to be kept
+    if (i > 0) {
+        buffer.remove(0, i);
+        i = 0;
+        data = buffer.constData();
+        size = buffer.size();
+    }
+}
+
+bool QSparqlTurtlePrivate::parseStatement()
+{
+    if (syntax == QSparqlTurtle::NQuads)
+        return parseQuad();
+
+    const char c = data[i];
+    if (c == '@')
+        return parseDirective(false);
+
+    if (c == 'P' || c == 'p' || c == 'B' || c == 'b') {
+        bool prefix = false;
+        bool base = false;
+        if (!lookingAtKeyword("prefix", false, &prefix))
+            return false;
+        if (!prefix && !lookingAtKeyword("base", false, &base))
+            return false;
+        if (prefix || base)
+            return parseDirective(true);
+    }
+
+    return parseTriples();
+}
+
+/*
+    Parses "@prefix p: <iri> .", "@base <iri> ." or their SPARQL forms
+    without the '@' and the final '.'.
+*/
+bool QSparqlTurtlePrivate::parseDirective(bool sparqlStyle)
+{
+    if (!sparqlStyle)
+        ++i;
+
+    bool isPrefix = false;
+    if (!lookingAtKeyword("prefix", !sparqlStyle, &isPrefix))
+        return false;
+
+    if (isPrefix) {
+        i += 6;
+        skipWhiteSpace();
+        const int start = i;
+        while (i < size && (isNameChar(data[i]) || data[i] == '.'))
+            ++i;
+        if (!more())
+            return false;
+        if (data[i] != ':') {
+            fail(QLatin1String("Expected ':' after the prefix name"));
+            return false;
+        }
+        const QString prefix = QString::fromUtf8(data + start, i - start);
+        ++i;
+
+        skipWhiteSpace();
+        QUrl iri;
+        if (!more() || !parseIriRef(&iri))
+            return false;
+        if (!sparqlStyle) {
+            skipWhiteSpace();
+            if (!more())
+                return false;
+            if (data[i] != '.') {
+                fail(QLatin1String("Expected '.' after the prefix declaration"));
+                return false;
+            }
+            ++i;
+        }
+
+        // The names expanded with an earlier declaration are stale now
+        if (prefixes.contains(prefix))
+            prefixedNames.clear();
+        prefixes.insert(prefix, iri.toString());
+        return true;
+    }
+
+    bool isBase = false;
+    if (!lookingAtKeyword("base", !sparqlStyle, &isBase))
+        return false;
+    if (!isBase) {
+        fail(QLatin1String("Unknown directive"));
+        return false;
+    }
+
+    i += 4;
+    skipWhiteSpace();
+    QUrl iri;
+    if (!more() || !parseIriRef(&iri))
+        return false;
+    if (!sparqlStyle) {
+        skipWhiteSpace();
+        if (!more())
+            return false;
+        if (data[i] != '.') {
+            fail(QLatin1String("Expected '.' after the base declaration"));
+            return false;
+        }
+        ++i;
+    }
+
+    base = iri;
+    return true;
+}
+
+bool QSparqlTurtlePrivate::parseTriples()
+{
+    Term subject;
+    if (data[i] == '[') {
+        if (!parseBlankNodePropertyList(&subject))
+            return false;
+        skipWhiteSpace();
+        if (!more())
+            return false;
+        // "[ :p :o ] ." is a complete statement on its own
+        if (data[i] != '.' && !parsePredicateObjectList(subject))
+            return false;
+    } else {
+        if (!parseSubject(&subject) || !parsePredicateObjectList(subject))
+            return false;
+    }
+
+    skipWhiteSpace();
+    if (!more())
+        return false;
+    if (data[i] != '.') {
+        fail(QLatin1String("Expected '.' as statement terminator"));
+        return false;
+    }
+    ++i;
+    return true;
+}
+
+bool QSparqlTurtlePrivate::parseQuad()
+{
+    Term subject;
+    Term predicate;
+    Term object;
+    Term graph;
+
+    if (!parseSubject(&subject))
+        return false;
+    skipWhiteSpace();
+    if (!more() || !parseIri(&predicate))
+        return false;
+    if (!parseObject(&object))
+        return false;
+
+    skipWhiteSpace();
+    if (!more())
+        return false;
+    if (data[i] == '<') {
+        if (!parseIri(&graph))
+            return false;
+    } else if (data[i] == '_') {
+        if (!parseBlankNodeLabel(&graph))
+            return false;
+    }
+
+    skipWhiteSpace();
+    if (!more())
+        return false;
+    if (data[i] != '.') {
+        fail(QLatin1String("Expected '.' as statement terminator"));
+        return false;
+    }
+    ++i;
+
+    emitTriple(subject, predicate, object, graph.kind == Term::None ? 0 : &graph);
+    return true;
+}
+
+bool QSparqlTurtlePrivate::parsePredicateObjectList(const Term& subject)
+{
+    for (;;) {
+        Term predicate;
+        if (!parseVerb(&predicate) || !parseObjectList(subject, predicate))
+            return false;
+
+        skipWhiteSpace();
+        if (!more())
+            return false;
+        if (data[i] != ';')
+            return true;
+        while (data[i] == ';') {
+            ++i;
+            skipWhiteSpace();
+            if (!more())
+                return false;
+        }
+        // A trailing ';' may end the list
+        if (data[i] == '.' || data[i] == ']')
+            return true;
+    }
+}
+
+bool QSparqlTurtlePrivate::parseObjectList(const Term& subject, const Term& predicate)
+{
+    for (;;) {
+        Term object;
+        if (!parseObject(&object))
+            return false;
+        emitTriple(subject, predicate, object);
+
+        skipWhiteSpace();
+        if (!more())
+            return false;
+        if (data[i] != ',')
+            return true;
+        ++i;
+    }
+}
+
+bool QSparqlTurtlePrivate::parseSubject(Term* term)
+{
+    skipWhiteSpace();
+    if (!more())
+        return false;
+
+    switch (data[i]) {
+    case '_':
+        return parseBlankNodeLabel(term);
+    case '(':
+        if (syntax == QSparqlTurtle::NQuads)
+            break;
+        return parseCollection(term);
+    case '[':
+        if (syntax == QSparqlTurtle::NQuads)
+            break;
+        return parseBlankNodePropertyList(term);
+    case '<':
+        return parseIri(term);
+    default:
+        if (syntax == QSparqlTurtle::Turtle)
+            return parseIri(term);
+        break;
+    }
+
+    fail(QLatin1String("Expected subject node"));
+    return false;
+}
+
+bool QSparqlTurtlePrivate::parseVerb(Term* term)
+{
+    skipWhiteSpace();
+    if (!more())
+        return false;
+
+    if (data[i] == 'a') {
+        bool matched = false;
+        if (!lookingAtKeyword("a", true, &matched))
+            return false;
+        if (matched) {
+            ++i;
+            *term = rdfType;
+            return true;
+        }
+    }
+    return parseIri(term);
+}
+
+bool QSparqlTurtlePrivate::parseObject(Term* term)
+{
+    skipWhiteSpace();
+    if (!more())
+        return false;
+
+    const char c = data[i];
+    switch (c) {
+    case '<':
+        return parseIri(term);
+    case '_':
+        return parseBlankNodeLabel(term);
+    case '"':
+        return parseLiteral(term);
+    default:
+        break;
+    }
+
+    if (syntax == QSparqlTurtle::NQuads) {
+        fail(QLatin1String("Expected object node"));
+        return false;
+    }
+
+    if (c == '\'')
+        return parseLiteral(term);
+    if (c == '(')
+        return parseCollection(term);
+    if (c == '[')
+        return parseBlankNodePropertyList(term);
+    if (isDigit(c) || c == '+' || c == '-' || c == '.')
+        return parseNumber(term);
+
+    if (c == 't' || c == 'f') {
+        bool matched = false;
+        if (!lookingAtKeyword(c == 't' ? "true" : "false", true, &matched))
+            return false;
+        if (matched) {
+            term->kind = Term::Literal;
+            term->value = QString::fromLatin1(c == 't' ? "true" : "false");
+            term->dataType = QUrl::fromEncoded("http://www.w3.org/2001/XMLSchema#boolean");
+            i += c == 't' ? 4 : 5;
+            return true;
+        }
+    }
+
+    return parseIri(term);
+}
+
+bool QSparqlTurtlePrivate::parseIri(Term* term)
+{
+    QUrl iri;
+    const bool ok = data[i] == '<' ? parseIriRef(&iri) : parsePrefixedName(&iri);
+    if (!ok)
+        return false;
+    term->kind = Term::Iri;
+    term->value = iri;
+    return true;
+}
+
+/*
+    Parses <iri>, decoding \u escapes and resolving relative IRIs against
+    the base IRI.
+*/
+bool QSparqlTurtlePrivate::parseIriRef(QUrl* iri)
+{
+    if (data[i] != '<') {
+        fail(QLatin1String("Expected IRI"));
+        return false;
+    }
+
+    const int start = i + 1;
+    const char* gt = static_cast<const char*>(memchr(data + start, '>', size - start));
+    if (!gt) {
+        i = size;
+        return more();
+    }
+    const int end = gt - data;
+
+    bool plain = true;
+    for (int n = start; n < end && plain; ++n)
+        plain = static_cast<uchar>(data[n]) <= 0x7f && data[n] != '\\';
+
+    QString text;
+    if (plain) {
+        // The common case: an absolute ASCII IRI is decoded straight from
+        // the data, and shared with its earlier occurrences
+        if (end > start && (base.isEmpty() || hasScheme(QString::fromLatin1(data + start, qMin(end - start, 32))))) {
+            *iri = iris.fromEncoded(data + start, end - start);
+            i = end + 1;
+            return true;
+        }
+        text = QString::fromLatin1(data + start, end - start);
+    } else {
+        int run = start;
+        for (int n = start; n < end; ++n) {
+            if (data[n] != '\\')
+                continue;
+            text += QString::fromUtf8(data + run, n - run);
+            const int digits = n + 1 < end && data[n + 1] == 'U' ? 8 : 4;
+            uint ucs4 = 0;
+            if (n + 1 >= end || (data[n + 1] != 'u' && data[n + 1] != 'U')
+                || n + 1 + digits >= end || !parseHex(data + n + 2, digits, &ucs4)) {
+                fail(QLatin1String("Invalid escape sequence in IRI"));
+                return false;
+            }
+            appendUcs4(text, ucs4);
+            n += 1 + digits;
+            run = n + 1;
+        }
+        text += QString::fromUtf8(data + run, end - run);
+    }
+
+    i = end + 1;
+    if (!base.isEmpty() && !hasScheme(text))
+        *iri = base.resolved(QUrl(text));
+    else
+        *iri = iris.fromString(text);
+    return true;
+}
+
+bool QSparqlTurtlePrivate::parsePrefixedName(QUrl* iri)
+{
+    const int start = i;
+
+    // The prefix, possibly empty
+    while (i < size && (isNameChar(data[i]) || data[i] == '.'))
+        ++i;
+    if (!more())
+        return false;
+    if (data[i] != ':' || (i > start && data[i - 1] == '.')) {
+        fail(QLatin1String("Expected IRI or prefixed name"));
+        return false;
+    }
+    const int colon = i;
+    ++i;
+
+    // The local part, where '.' is allowed but not at the end
+    bool escaped = false;
+    while (i < size) {
+        const char c = data[i];
+        if (c == '\\') {
+            if (!more(2))
+                return false;
+            escaped = true;
+            i += 2;
+        } else if (c == '%') {
+            if (!more(3))
+                return false;
+            i += 3;
+        } else if (isNameChar(c) || c == '.' || c == ':') {
+            ++i;
+        } else {
+            break;
+        }
+    }
+    // The name may continue in the data still to come
+    if (i >= size && !finished) {
+        incomplete = true;
+        return false;
+    }
+    while (i > colon + 1 && data[i - 1] == '.' && data[i - 2] != '\\')
+        --i;
+
+    const QByteArray name = QByteArray::fromRawData(data + start, i - start);
+    const QHash<QByteArray, QUrl>::const_iterator it = prefixedNames.constFind(name);
+    if (it != prefixedNames.constEnd()) {
+        *iri = it.value();
+        return true;
+    }
+
+    const QString prefix = QString::fromUtf8(data + start, colon - start);
+    const QHash<QString, QString>::const_iterator ns = prefixes.constFind(prefix);
+    if (ns == prefixes.constEnd()) {
+        fail(QString::fromLatin1("Undefined prefix '%1'").arg(prefix));
+        return false;
+    }
+
+    QString local = QString::fromUtf8(data + colon + 1, i - colon - 1);
+    if (escaped) {
+        // Reserved characters escaped with a backslash stand for themselves
+        for (int n = 0; n < local.size(); ++n) {
+            if (local.at(n) == QLatin1Char('\\'))
+                local.remove(n, 1);
+        }
+    }
+
+    *iri = QUrl(ns.value() + local);
+    if (prefixedNames.count() < QSparqlIriPool::DefaultMaxEntries)
+        prefixedNames.insert(QByteArray(data + start, i - start), *iri);
+    return true;
+}
+
+bool QSparqlTurtlePrivate::parseBlankNodeLabel(Term* term)
+{
+    if (!more(2))
+        return false;
+    if (data[i + 1] != ':') {
+        fail(QLatin1String("Expected blank node '_:xxxx'"));
+        return false;
+    }
+    i += 2;
+
+    const int start = i;
+    while (i < size && (isNameChar(data[i]) || data[i] == '.'))
+        ++i;
+    if (i >= size && !finished) {
+        incomplete = true;
+        return false;
+    }
+    while (i > start && data[i - 1] == '.')
+        --i;
+
+    // The generated labels are "genid" and a number; the labels of the
+    // document which start with "genid" get a "genid-" prefix, which no
+    // generated label has, so that the two never name the same node
+    QString label = QString::fromUtf8(data + start, i - start);
+    if (label.startsWith(QLatin1String("genid")))
+        label.prepend(QLatin1String("genid-"));
+
+    term->kind = Term::Blank;
+    term->value = iris.label(label);
+    return true;
+}
+
+/*
+    Parses "[]" or "[ predicateObjectList ]", emitting the triples of the
+    list with a new blank node as the subject.
+*/
+bool QSparqlTurtlePrivate::parseBlankNodePropertyList(Term* term)
+{
+    ++i;
+    *term = newBlankNode();
+
+    skipWhiteSpace();
+    if (!more())
+        return false;
+    if (data[i] != ']') {
+        if (!parsePredicateObjectList(*term))
+            return false;
+        skipWhiteSpace();
+        if (!more())
+            return false;
+        if (data[i] != ']') {
+            fail(QLatin1String("Expected ']'"));
+            return false;
+        }
+    }
+    ++i;
+    return true;
+}
+
+/*
+    Parses "( object* )" into an rdf:first / rdf:rest list.
+*/
+bool QSparqlTurtlePrivate::parseCollection(Term* term)
+{
+    ++i;
+    Term head;
+    Term node;
+    bool empty = true;
+
+    for (;;) {
+        skipWhiteSpace();
+        if (!more())
+            return false;
+        if (data[i] == ')') {
+            ++i;
+            break;
+        }
+
+        Term item;
+        if (!parseObject(&item))
+            return false;
+        const Term next = newBlankNode();
+        if (empty)
+            head = next;
+        else
+            emitTriple(node, rdfRest, next);
+        emitTriple(next, rdfFirst, item);
+        node = next;
+        empty = false;
+    }
+
+    if (empty) {
+        *term = rdfNil;
+    } else {
+        emitTriple(node, rdfRest, rdfNil);
+        *term = head;
+    }
+    return true;
+}
+
+bool QSparqlTurtlePrivate::parseLiteral(Term* term)
+{
+    QString value;
+    if (!parseString(&value))
+        return false;
+
+    term->kind = Term::Literal;
+    term->value = value;
+
+    // A language tag or a data type may follow
+    if (i >= size && !finished) {
+        incomplete = true;
+        return false;
+    }
+    if (i < size && data[i] == '@') {
+        const int start = ++i;
+        while (i < size && (isAsciiAlpha(data[i]) || (i > start && (data[i] == '-' || isDigit(data[i])))))
+            ++i;
+        if (i >= size && !finished) {
+            incomplete = true;
+            return false;
+        }
+        term->languageTag = QString::fromLatin1(data + start, i - start);
+    } else if (i < size && data[i] == '^') {
+        if (!more(2))
+            return false;
+        if (data[i + 1] != '^') {
+            fail(QLatin1String("Expected '^^'"));
+            return false;
+        }
+        i += 2;
+        if (!more())
+            return false;
+        QUrl dataType;
+        if (data[i] == '<' ? !parseIriRef(&dataType) : !parsePrefixedName(&dataType))
+            return false;
+        term->dataType = dataType;
+    }
+    return true;
+}
+
+/*
+    Parses a string in any of the four Turtle quotings and decodes its
+    escape sequences.
+*/
+bool QSparqlTurtlePrivate::parseString(QString* value)
+{
+    const char quote = data[i];
+
+    // Tell "" (empty) from """ (long string)
+    if (!more(2))
+        return false;
+    bool isLong = false;
+    if (data[i + 1] == quote) {
+        if (i + 2 >= size && !finished) {
+            incomplete = true;
+            return false;
+        }
+        isLong = i + 2 < size && data[i + 2] == quote;
+    }
+
+    i += isLong ? 3 : 1;
+    int run = i;
+    int newlines = 0;
+    QString result;
+    bool hasEscapes = false;
+
+    for (;;) {
+        if (!more())
+            return false;
+        const char c = data[i];
+        if (c == quote) {
+            if (!isLong)
+                break;
+            if (!more(3))
+                return false;
+            if (data[i + 1] == quote && data[i + 2] == quote) {
+                // The string ends at the last three quotes of a run
+                if (i + 3 >= size && !finished) {
+                    incomplete = true;
+                    return false;
+                }
+                if (i + 3 >= size || data[i + 3] != quote)
+                    break;
+            }
+            ++i;
+        } else if (c == '\\') {
+            if (!more(2))
+                return false;
+            hasEscapes = true;
+            result += QString::fromUtf8(data + run, i - run);
+            const char e = data[i + 1];
+            int length = 2;
+            switch (e) {
+            case 't': result += QLatin1Char('\t'); break;
+            case 'b': result += QLatin1Char('\b'); break;
+            case 'n': result += QLatin1Char('\n'); break;
+            case 'r': result += QLatin1Char('\r'); break;
+            case 'f': result += QLatin1Char('\f'); break;
+            case '"': result += QLatin1Char('"'); break;
+            case '\'': result += QLatin1Char('\''); break;
+            case '\\': result += QLatin1Char('\\'); break;
+            case 'u':
+            case 'U':
+            {
+                const int digits = e == 'u' ? 4 : 8;
+                uint ucs4 = 0;
+                if (!more(2 + digits))
+                    return false;
+                if (!parseHex(data + i + 2, digits, &ucs4)) {
+                    fail(QLatin1String("Invalid unicode escape sequence"));
+                    return false;
+                }
+                appendUcs4(result, ucs4);
+                length += digits;
+                break;
+            }
+            default:
+                fail(QLatin1String("Invalid literal escape sequence"));
+                return false;
+            }
+            i += length;
+            run = i;
+        } else if (c == '\n') {
+            if (!isLong) {
+                fail(QLatin1String("Unterminated string"));
+                return false;
+            }
+            ++newlines;
+            ++i;
+        } else {
+            ++i;
+        }
+    }
+
+    if (hasEscapes) {
+        result += QString::fromUtf8(data + run, i - run);
+        *value = result;
+    } else {
+        *value = QString::fromUtf8(data + run, i - run);
+    }
+    i += isLong ? 3 : 1;
+    lineNumber += newlines;
+    return true;
+}
+
+bool QSparqlTurtlePrivate::parseNumber(Term* term)
+{
+    const int start = i;
+    const char* type = "http://www.w3.org/2001/XMLSchema#integer";
+
+    if (data[i] == '+' || data[i] == '-')
+        ++i;
+    while (i < size && isDigit(data[i]))
+        ++i;
+    if (i < size && data[i] == '.') {
+        // A '.' is only a decimal point if a digit follows it
+        if (i + 1 >= size && !finished) {
+            incomplete = true;
+            return false;
+        }
+        if (i + 1 < size && isDigit(data[i + 1])) {
+            type = "http://www.w3.org/2001/XMLSchema#decimal";
+            ++i;
+            while (i < size && isDigit(data[i]))
+                ++i;
+        }
+    }
+    if (i < size && (data[i] == 'e' || data[i] == 'E')) {
+        type = "http://www.w3.org/2001/XMLSchema#double";
+        ++i;
+        if (i < size && (data[i] == '+' || data[i] == '-'))
+            ++i;
+        while (i < size && isDigit(data[i]))
+            ++i;
+    }
+    if (i >= size && !finished) {
+        incomplete = true;
+        return false;
+    }
+
+    const QString lexical = QString::fromLatin1(data + start, i - start);
+    if (lexical.isEmpty() || lexical == QLatin1String("+") || lexical == QLatin1String("-")
+        || lexical == QLatin1String(".")) {
+        fail(QLatin1String("Expected object node"));
+        return false;
+    }
+
+    term->kind = Term::Literal;
+    term->value = lexical;
+    term->dataType = QUrl::fromEncoded(type);
+    return true;
+}
+
+/*!
+    \internal
+    \class QSparqlTurtle
+*/
+
+QSparqlTurtle::QSparqlTurtle(Syntax syntax)
+    : d(new QSparqlTurtlePrivate(syntax))
+{
+}
+
+QSparqlTurtle::~QSparqlTurtle()
+{
+    delete d;
+}
+
+/*
+    Sets the IRI against which relative IRIs are resolved, until the data
+    declares its own base.
+*/
+void QSparqlTurtle::setBaseUri(const QUrl& base)
+{
+    d->base = base;
+}
+
+/*
+    Parses the statements completed by \a data. The last, incomplete
+    statement is kept until the data continuing it arrives.
+*/
+void QSparqlTurtle::addData(const QByteArray& data)
+{
+    if (d->failed || d->finished)
+        return;
+    d->buffer += data;
+    d->parseAvailable();
+}
+
+/*
+    Parses any statement left, once all the data has been given to
+    addData().
+*/
+void QSparqlTurtle::finish()
+{
+    if (d->finished)
+        return;
+    d->finished = true;
+    if (!d->failed)
+        d->parseAvailable();
+}
+
+/*
+    Returns the rows parsed since the last call.
+*/
+QVector<QSparqlResultRow> QSparqlTurtle::takeResults()
+{
+    QVector<QSparqlResultRow> results;
+    qSwap(results, d->results);
+    return results;
+}
+
+/*
+    Parses the complete document \a data and returns its rows.
+*/
+QVector<QSparqlResultRow> QSparqlTurtle::parse(const QByteArray& data)
+{
+    addData(data);
+    finish();
+    return takeResults();
+}
+
+bool QSparqlTurtle::hasError() const
+{
+    return d->failed;
+}
+
+QString QSparqlTurtle::errorString() const
+{
+    return d->error;
+}
+
+int QSparqlTurtle::lineNumber() const
+{
+    return d->lineNumber;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,184 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#define XSD_ALL
+#include "qsparqlxsd_p.h"
+
+#include <QtCore/qbytearray.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace XSD {
+
+static const char xsdPrefix[] = "http://www.w3.org/2001/XMLSchema#";
+static const int xsdPrefixLength = sizeof(xsdPrefix) - 1;
+
+// The local names, indexed by TypeId
+static const char* const localNames[TypeCount] = {
+    "",
+    "int",
+    "integer",
+    "nonNegativeInteger",
+    "unsignedInt",
+    "decimal",
+    "short",
+    "long",
+    "unsignedLong",
+    "boolean",
+    "double",
+    "float",
+    "string",
+    "date",
+    "time",
+    "dateTime",
+    "base64Binary"
+};
+
+// A perfect hash of the local names: hashLocalName() maps every name in
+// localNames to a different slot of this table.
+static const TypeId hashTable[32] = {
+    UnknownType,      Base64BinaryType, UnsignedLongType, UnknownType,
+    UnknownType,      LongType,         UnknownType,      DateTimeType,
+    FloatType,        ShortType,        UnknownType,      IntType,
+    UnknownType,      UnknownType,      UnknownType,      DateType,
+    NonNegativeIntegerType, UnknownType, DecimalType,     UnknownType,
+    StringType,       IntegerType,      BooleanType,      UnsignedIntType,
+    UnknownType,      UnknownType,      UnknownType,      DoubleType,
+    UnknownType,      UnknownType,      UnknownType,      TimeType
+};
+
+static inline uint hashLocalName(int length, uint first, uint last)
+{
+    return (6 * length + 5 * first + 7 * last) & 31;
+}
+
+// Char is char for the encoded form of a QUrl and ushort for a QString.
+template <typename Char>
+static TypeId lookup(const Char* uri, int length)
+{
+    const int localLength = length - xsdPrefixLength;
+    if (localLength <= 0)
+        return UnknownType;
+    for (int i = 0; i < xsdPrefixLength; ++i) {
+        if (uint(uri[i]) != uint(uchar(xsdPrefix[i])))
+            return UnknownType;
+    }
+
+    const Char* local = uri + xsdPrefixLength;
+    const TypeId candidate =
+        hashTable[hashLocalName(localLength, uint(local[0]), uint(local[localLength - 1]))];
+    if (candidate == UnknownType)
+        return UnknownType;
+
+    const char* name = localNames[candidate];
+    for (int i = 0; i < localLength; ++i) {
+        if (name[i] == 0 || uint(local[i]) != uint(uchar(name[i])))
+            return UnknownType;
+    }
+    return name[localLength] == 0 ? candidate : UnknownType;
+}
+
+/*!
+    \internal
+    Returns the ID of the XSD data type \a uri, or UnknownType if \a uri is
+    not one of the known types.
+*/
+TypeId typeId(const QUrl& uri)
+{
+    const QByteArray encoded = uri.toEncoded();
+    return lookup(encoded.constData(), encoded.size());
+}
+
+/*!
+    \internal
+    \overload
+*/
+TypeId typeId(const QString& uri)
+{
+    return lookup(uri.utf16(), uri.size());
+}
+
+/*!
+    \internal
+    Returns the URI of the data type \a id, or an empty QUrl for UnknownType.
+    The URIs are created only once.
+*/
+QUrl typeUri(TypeId id)
+{
+    switch (id) {
+    case IntType:
+        return *Int();
+    case IntegerType:
+        return *Integer();
+    case NonNegativeIntegerType:
+        return *NonNegativeInteger();
+    case UnsignedIntType:
+        return *UnsignedInt();
+    case DecimalType:
+        return *Decimal();
+    case ShortType:
+        return *Short();
+    case LongType:
+        return *Long();
+    case UnsignedLongType:
+        return *UnsignedLong();
+    case BooleanType:
+        return *Boolean();
+    case DoubleType:
+        return *Double();
+    case FloatType:
+        return *Float();
+    case StringType:
+        return *String();
+    case DateType:
+        return *Date();
+    case TimeType:
+        return *Time();
+    case DateTimeType:
+        return *DateTime();
+    case Base64BinaryType:
+        return *Base64Binary();
+    default:
+        return QUrl();
+    }
+}
+
+} // namespace XSD
+
+QT_END_NAMESPACE
@@ -47,6 +47,7 @@
 
 #include "qsparql.h"
 
+#include <QtCore/qstring.h>
 #include <QtCore/qurl.h>
 
 QT_BEGIN_HEADER
@@ -56,6 +57,35 @@ QT_BEGIN_NAMESPACE
 QT_MODULE(Sparql)
 
 namespace XSD {
+
+// Compact IDs for the XSD data types the bindings know how to convert. The
+// bindings store these instead of a QUrl; UnknownType means either no data
+// type or one which isn't listed here.
+enum TypeId {
+    UnknownType = 0,
+    IntType,
+    IntegerType,
+    NonNegativeIntegerType,
+    UnsignedIntType,
+    DecimalType,
+    ShortType,
+    LongType,
+    UnsignedLongType,
+    BooleanType,
+    DoubleType,
+    FloatType,
+    StringType,
+    DateType,
+    TimeType,
+    DateTimeType,
+    Base64BinaryType,
+    TypeCount
+};
+
+Q_SPARQL_EXPORT TypeId typeId(const QUrl& uri);
+Q_SPARQL_EXPORT TypeId typeId(const QString& uri);
+Q_SPARQL_EXPORT QUrl typeUri(TypeId id);
+
 #if defined XSD_INTEGER || defined XSD_ALL
 Q_GLOBAL_STATIC_WITH_ARGS(QUrl, Integer,
                           (QLatin1String("http://www.w3.org/2001/XMLSchema#integer")))
@@ -1,7 +1,19 @@
 HEADERS +=      models/qsparqlquerymodel.h \
                 models/qsparqlquerymodel_p.h \
-                models/qsparqlresultslist_p.h
+                models/qsparqlresultslist_p.h \
+                models/qsparqlrowdiff_p.h
 
 SOURCES +=      models/qsparqlquerymodel.cpp \
-		models/qsparqlresultslist.cpp
+		models/qsparqlresultslist.cpp \
+		models/qsparqlrowdiff.cpp
 
+
+# Models following the change notifications of a Tracker store; the driver
+# is chosen at runtime, so this doesn't depend on how the drivers are built
+contains(QT_CONFIG, dbus) {
+    HEADERS += models/qsparqllivequery_p.h
+    SOURCES += models/qsparqllivequery.cpp
+    DEFINES += QT_SPARQL_LIVE_QUERY
+
+    QT += dbus
+}
@@ -0,0 +1,317 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsparqllivequery_p.h"
+
+#include <qsparqlbinding.h>
+#include <qsparqlconnection.h>
+#include <qsparqlerror.h>
+#include <qsparqlquery.h>
+#include <qsparqlresult.h>
+
+#include <QtCore/qregexp.h>
+#include <QtCore/qurl.h>
+#include <QtDBus/qdbusargument.h>
+#include <QtDBus/qdbusconnection.h>
+#include <QtDBus/qdbusmessage.h>
+
+#include <qdebug.h>
+
+QT_BEGIN_NAMESPACE
+
+// The sender isn't matched, so that a test double on the session bus can
+// emit the signal in place of the store
+static const char resourcesPath[] = "/org/freedesktop/Tracker1/Resources";
+static const char resourcesInterface[] = "org.freedesktop.Tracker1.Resources";
+static const char graphUpdatedSignal[] = "GraphUpdated";
+static const char graphUpdatedSignature[] = "sa(iiii)a(iiii)";
+
+// The subjects of an array of (graph, subject, predicate, object) ids
+static void addSubjects(const QVariant& argument, QSet<int>* subjects)
+{
+    const QDBusArgument array = qvariant_cast<QDBusArgument>(argument);
+    array.beginArray();
+    while (!array.atEnd()) {
+        int graph, subject, predicate, object;
+        array.beginStructure();
+        array >> graph >> subject >> predicate >> object;
+        array.endStructure();
+        subjects->insert(subject);
+    }
+    array.endArray();
+}
+
+QSparqlLiveQuery* QSparqlLiveQuery::create(QSparqlConnection* connection, const QString& query,
+                                             const QString& keyVariable, QObject* parent)
+{
+    const QString driverName = connection->driverName();
+    if (driverName != QLatin1String("QTRACKER") && driverName != QLatin1String("QTRACKER_DIRECT"))
+        return 0;
+
+    QSparqlLiveQuery* live = new QSparqlLiveQuery(connection, query, keyVariable, parent);
+    if (live->classNames.isEmpty()) {
+        qWarning() << "QSparqlLiveQuery: the query uses no class to follow:" << query;
+        delete live;
+        return 0;
+    }
+    return live;
+}
+
+QSparqlLiveQuery::QSparqlLiveQuery(QSparqlConnection* connection, const QString& query,
+                                     const QString& keyVariable, QObject* parent)
+    : QObject(parent), liveConnection(connection), queryText(query), key(keyVariable),
+      restrictable(false), refreshPending(false)
+{
+    collectTimer.setSingleShot(true);
+    collectTimer.setInterval(CollectInterval);
+    connect(&collectTimer, SIGNAL(timeout()), this, SLOT(processChanges()));
+
+    const QString text = query.simplified();
+
+    QRegExp prefixDeclaration(QLatin1String("PREFIX\\s+([\\w-]*):\\s*<([^>]*)>"), Qt::CaseInsensitive);
+    for (int pos = 0; (pos = prefixDeclaration.indexIn(text, pos)) >= 0;
+         pos += prefixDeclaration.matchedLength())
+        declaredPrefixes.insert(prefixDeclaration.cap(1), prefixDeclaration.cap(2));
+
+    // The classes in "?x a class" and "?x rdf:type class" patterns
+    const QString typePredicate =
+        QLatin1String("(?:a|rdf:type|<http://www\\.w3\\.org/1999/02/22-rdf-syntax-ns#type>)\\s+");
+    const QString className = QLatin1String("(<[^>]*>|[\\w-]*:[\\w-]+)");
+    QRegExp typePattern(QLatin1String("(?:^|[\\s;{.,])") + typePredicate + className);
+    for (int pos = 0; (pos = typePattern.indexIn(text, pos)) >= 0; pos += typePattern.matchedLength())
+        classNames.append(typePattern.cap(1));
+
+    if (!key.isEmpty()) {
+        QRegExp keyTypePattern(QLatin1String("[?$]") + QRegExp::escape(key) + QLatin1String("\\s+")
+                               + typePredicate + className);
+        if (keyTypePattern.indexIn(text) >= 0)
+            keyClassName = keyTypePattern.cap(1);
+    }
+
+    // Another resource of the class of the key could change the row of a
+    // key, as could the rows around it in an ordered or grouped query
+    QRegExp modifiers(QLatin1String("\\b(ORDER\\s+BY|GROUP\\s+BY|LIMIT|OFFSET)\\b"), Qt::CaseInsensitive);
+    restrictable = !keyClassName.isEmpty() && classNames.count(keyClassName) == 1
+        && modifiers.indexIn(text) < 0 && queryText.lastIndexOf(QLatin1Char('}')) >= 0;
+
+    if (classNames.isEmpty())
+        return;
+
+    if (expandClasses(QHash<QString, QString>())) {
+        subscribe();
+    } else {
+        // The prefixes Tracker knows without a declaration
+        namespacesResult = liveConnection->exec(QSparqlQuery(QLatin1String(
+            "SELECT ?ns ?prefix WHERE { ?ns a tracker:Namespace ; tracker:prefix ?prefix }")));
+        if (namespacesResult->hasError())
+            namespacesFinished();
+        else
+            connect(namespacesResult, SIGNAL(finished()), this, SLOT(namespacesFinished()));
+    }
+}
+
+QSparqlLiveQuery::~QSparqlLiveQuery()
+{
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    Q_FOREACH (const QString& classIri, classIris) {
+        bus.disconnect(QString(), QLatin1String(resourcesPath), QLatin1String(resourcesInterface),
+                       QLatin1String(graphUpdatedSignal), QStringList() << classIri,
+                       QLatin1String(graphUpdatedSignature),
+                       this, SLOT(graphUpdated(QDBusMessage)));
+    }
+    delete namespacesResult;
+    delete rowsResult;
+    delete keysResult;
+}
+
+// Turns the class names of the query into IRIs; returns false if a prefix
+// is neither declared in the query nor in namespaces
+bool QSparqlLiveQuery::expandClasses(const QHash<QString, QString>& namespaces)
+{
+    classIris.clear();
+    keyClassIri.clear();
+    Q_FOREACH (const QString& name, classNames) {
+        QString iri;
+        if (name.startsWith(QLatin1Char('<'))) {
+            iri = name.mid(1, name.length() - 2);
+        } else {
+            const int colon = name.indexOf(QLatin1Char(':'));
+            const QString prefix = name.left(colon);
+            if (declaredPrefixes.contains(prefix))
+                iri = declaredPrefixes.value(prefix);
+            else if (namespaces.contains(prefix))
+                iri = namespaces.value(prefix);
+            else
+                return false;
+            iri += name.mid(colon + 1);
+        }
+        if (!classIris.contains(iri))
+            classIris.append(iri);
+        if (name == keyClassName)
+            keyClassIri = iri;
+    }
+    return true;
+}
+
+void QSparqlLiveQuery::subscribe()
+{
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    Q_FOREACH (const QString& classIri, classIris) {
+        // The first argument of the signal is the class
+        bus.connect(QString(), QLatin1String(resourcesPath), QLatin1String(resourcesInterface),
+                    QLatin1String(graphUpdatedSignal), QStringList() << classIri,
+                    QLatin1String(graphUpdatedSignature),
+                    this, SLOT(graphUpdated(QDBusMessage)));
+    }
+}
+
+void QSparqlLiveQuery::namespacesFinished()
+{
+    if (!namespacesResult)
+        return;
+    QHash<QString, QString> namespaces;
+    if (namespacesResult->hasError()) {
+        qWarning() << "QSparqlLiveQuery: cannot read the namespaces:"
+                   << namespacesResult->lastError().message();
+    } else {
+        while (namespacesResult->next())
+            namespaces.insert(namespacesResult->value(1).toString(),
+                              namespacesResult->value(0).toUrl().toString());
+    }
+    namespacesResult->deleteLater();
+    namespacesResult = 0;
+
+    if (expandClasses(namespaces))
+        subscribe();
+    else
+        qWarning() << "QSparqlLiveQuery: unknown prefix in the classes" << classNames;
+}
+
+void QSparqlLiveQuery::graphUpdated(const QDBusMessage& message)
+{
+    const QList<QVariant> arguments = message.arguments();
+    if (arguments.count() != 3)
+        return;
+
+    if (restrictable && arguments[0].toString() == keyClassIri) {
+        addSubjects(arguments[1], &changedResources);
+        addSubjects(arguments[2], &changedResources);
+    } else {
+        refreshPending = true;
+    }
+
+    // The timer isn't restarted, so that a stream of changes still shows
+    if (!collectTimer.isActive())
+        collectTimer.start();
+}
+
+void QSparqlLiveQuery::processChanges()
+{
+    // The changes which arrive meanwhile are processed after these rows
+    if (rowsResult || !liveConnection)
+        return;
+
+    if (refreshPending || changedResources.count() > MaxChangedResources) {
+        refreshPending = false;
+        changedResources.clear();
+        Q_EMIT refreshNeeded();
+        return;
+    }
+    if (changedResources.isEmpty())
+        return;
+
+    fetchedResources = changedResources.toList();
+    changedResources.clear();
+    QStringList ids;
+    Q_FOREACH (int id, fetchedResources)
+        ids.append(QString::number(id));
+    const QString filter = QString::fromLatin1(" FILTER (tracker:id(?%1) IN (%2)) ")
+        .arg(key, ids.join(QLatin1String(", ")));
+
+    // The rows of the changed resources, and their keys, which tell the
+    // resources which have left the result from those which were deleted
+    QString rowsQuery = queryText;
+    rowsQuery.insert(rowsQuery.lastIndexOf(QLatin1Char('}')), filter);
+    const QString keysQuery = QString::fromLatin1("SELECT ?%1 WHERE { ?%1 a rdfs:Resource .%2}")
+        .arg(key, filter);
+    rowsResult = liveConnection->exec(QSparqlQuery(rowsQuery));
+    keysResult = liveConnection->exec(QSparqlQuery(keysQuery));
+
+    // Results in the error state don't emit finished()
+    if (rowsResult->hasError() || keysResult->hasError()) {
+        changedRowsFinished();
+        return;
+    }
+    connect(rowsResult, SIGNAL(finished()), this, SLOT(changedRowsFinished()));
+    connect(keysResult, SIGNAL(finished()), this, SLOT(changedRowsFinished()));
+}
+
+void QSparqlLiveQuery::changedRowsFinished()
+{
+    if (!rowsResult || !keysResult)
+        return;
+    const bool failed = rowsResult->hasError() || keysResult->hasError();
+    if (!failed && (!rowsResult->isFinished() || !keysResult->isFinished()))
+        return;
+
+    QStringList keys;
+    QVector<QSparqlResultRow> rows;
+    if (!failed) {
+        while (keysResult->next())
+            keys.append(keysResult->binding(0).toString());
+        while (rowsResult->next())
+            rows.append(rowsResult->current());
+    }
+    const bool deleted = keys.count() < fetchedResources.count();
+    rowsResult->deleteLater();
+    keysResult->deleteLater();
+    rowsResult = 0;
+    keysResult = 0;
+    fetchedResources.clear();
+
+    if (failed || deleted)
+        refreshPending = true;
+    else
+        Q_EMIT rowsChanged(keys, rows);
+
+    processChanges();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,140 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QSPARQLLIVEQUERY_P_H
+#define QSPARQLLIVEQUERY_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of qsparql*model.h .  This header file may change from version to version
+// without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <qsparqlresultrow.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qset.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QDBusMessage;
+class QSparqlConnection;
+class QSparqlResult;
+
+// Follows the rows of a query to a Tracker store from the GraphUpdated
+// signals of the store. The signals of the classes the query uses are
+// collected for a moment, and then either the rows of the changed resources
+// are fetched with a query restricted to them, or the whole query must be
+// executed again.
+//
+// Only resources of the class of the key variable are fetched on their own,
+// and only when the query has no ORDER BY, LIMIT, OFFSET or GROUP BY, as the
+// rows of other resources may depend on them. Resources which were deleted
+// can't be mapped back to their rows, so they need a whole query too.
+class QSparqlLiveQuery : public QObject
+{
+    Q_OBJECT
+public:
+    // Returns 0 if the connection doesn't use a Tracker driver or the query
+    // uses no class which could be followed. keyVariable may be empty, and
+    // then every change needs a whole query.
+    static QSparqlLiveQuery* create(QSparqlConnection* connection, const QString& query,
+                                     const QString& keyVariable, QObject* parent = 0);
+    ~QSparqlLiveQuery();
+
+    QSparqlConnection* connection() const { return liveConnection; }
+    QString query() const { return queryText; }
+    QString keyVariable() const { return key; }
+
+Q_SIGNALS:
+    // The query must be executed again
+    void refreshNeeded();
+    // The resources in keys changed, and rows are their rows now; the
+    // resources with no rows have left the result
+    void rowsChanged(const QStringList& keys, const QVector<QSparqlResultRow>& rows);
+
+private Q_SLOTS:
+    void namespacesFinished();
+    void graphUpdated(const QDBusMessage& message);
+    void processChanges();
+    void changedRowsFinished();
+
+private:
+    enum { CollectInterval = 100, MaxChangedResources = 500 };
+
+    QSparqlLiveQuery(QSparqlConnection* connection, const QString& query,
+                      const QString& keyVariable, QObject* parent);
+    bool expandClasses(const QHash<QString, QString>& namespaces);
+    void subscribe();
+
+    // The results are children of the connection, and the models may let it
+    // go before this is deleted
+    QPointer<QSparqlConnection> liveConnection;
+    QString queryText;
+    QString key;
+    bool restrictable; // the rows of a resource don't depend on other rows
+    QStringList classNames; // as written in the query
+    QString keyClassName;
+    QStringList classIris; // the classes subscribed to
+    QString keyClassIri;
+    QHash<QString, QString> declaredPrefixes;
+    QPointer<QSparqlResult> namespacesResult;
+
+    QTimer collectTimer;
+    QSet<int> changedResources; // tracker:id of the resources of the key class
+    bool refreshPending;
+    QList<int> fetchedResources;
+    QPointer<QSparqlResult> rowsResult;
+    QPointer<QSparqlResult> keysResult;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSPARQLLIVEQUERY_P_H
@@ -44,6 +44,12 @@
 #include "private/qsparqldriver_p.h"
 #include <qsparqlbinding.h>
 #include <qsparqlresult.h>
+#include <qsparqlrowblock.h>
+#include "qsparqlrowdiff_p.h"
+#include "private/qsparqlquerytemplate_p.h"
+#ifdef QT_SPARQL_LIVE_QUERY
+#include "qsparqllivequery_p.h"
+#endif
 #include <QRegExp>
 QT_BEGIN_NAMESPACE
 
@@ -81,6 +87,8 @@ void QSparqlQueryModelPrivate::beginQuery(int totalResults)
         initColOffsets(newResultRow.count());
 
     resultRow = newResultRow;
+    resultColumns = newResultRow.count();
+    rowCache.clear();
     atEnd = false;
 
     if (columnsChanged && hasNewData)
@@ -121,6 +129,7 @@ void QSparqlQueryModelPrivate::prefetch(int limit)
 
 QSparqlQueryModelPrivate::~QSparqlQueryModelPrivate()
 {
+    stopPaging();
 }
 
 void QSparqlQueryModelPrivate::initColOffsets(int size)
@@ -129,95 +138,337 @@ void QSparqlQueryModelPrivate::initColOffsets(int size)
     memset(colOffsets.data(), 0, colOffsets.size() * sizeof(int));
 }
 
-void QSparqlQueryModelPrivate::findRoleNames()
+const QVector<QVariant>* QSparqlQueryModelPrivate::rowValues(int row)
 {
-    QString queryString = query.preparedQueryText().simplified();
-    roleNames.clear();
-    QList<QString> uniqueNames;
+    if (const QVector<QVariant>* values = rowCache.object(row))
+        return values;
 
-    bool processLoop = true;
-    bool process = false;
-    int firstPosition = 0;
-    int deletePosition = 0;
-
-    QChar closeChar;
-    QChar openChar;
-    QList<QPair<QLatin1Char, QLatin1Char> > bracketMatch;
-
-    bracketMatch.append( qMakePair( QLatin1Char('('), QLatin1Char(')') ) );
-    bracketMatch.append( qMakePair( QLatin1Char('{'), QLatin1Char('}') ) );
-    bracketMatch.append( qMakePair( QLatin1Char('"'), QLatin1Char('"') ) );
-    bracketMatch.append( qMakePair( QLatin1Char('\''), QLatin1Char('\'') ) );
-
-    // check query is valid, will ensure we don't get stuck in the loop
-    if ( queryString.count(QLatin1Char('(')) == queryString.count(QLatin1Char(')'))
-        && queryString.count(QLatin1Char('{')) == queryString.count(QLatin1Char('}'))
-        && queryString.count(QLatin1Char('"')) % 2 == 0
-        && queryString.count(QLatin1Char('\'')) % 2 == 0 )
-    {
-        // first remove any, potentially nested, brackets
-        while (processLoop) {
-            if (!process) {
-                for (int i = 0; i < bracketMatch.size(); ++i) {
-                    firstPosition = queryString.indexOf( bracketMatch.at(i).first );
-                    if (firstPosition != -1) {
-                        openChar = bracketMatch.at(i).first;
-                        closeChar = bracketMatch.at(i).second;
-                        deletePosition = firstPosition;
-                        break;
-                    }
-                 }
-            }
-            if (firstPosition != -1) {
-                process = true;
-                int openCount = 0;
-                int closeCount = 0;
-                // go to the first close, count how many opens, repeat until they match
-                // then delete!
-                do {
-                    deletePosition = queryString.indexOf(closeChar, deletePosition+1);
-                    openCount = queryString.left(deletePosition).count(openChar);
-                    if(deletePosition != -1)
-                        closeCount++;
-                    } while (closeCount != openCount);
-                    queryString.remove(firstPosition, (deletePosition-firstPosition)+1);
-                    firstPosition = 0;
-                    closeCount = 0;
-                    process = false;
-            } else {
-                processLoop = false;
-            }
+    if (!result->setPos(row)) {
+        error = result->lastError();
+        return 0;
+    }
+
+    // QSparqlResult::value() doesn't construct a QSparqlBinding for each cell
+    QVector<QVariant>* values = new QVector<QVariant>(resultColumns);
+    for (int i = 0; i < resultColumns; ++i)
+        (*values)[i] = result->value(i);
+    rowCache.insert(row, values);
+    return values;
+}
+
+void QSparqlQueryModelPrivate::beginPaging()
+{
+    // The PREFIX and BASE declarations must stay in front when the query is
+    // wrapped in the COUNT query
+    const QString text = query.preparedQueryText();
+    QRegExp prologue(QLatin1String("^\\s*((?:(?:PREFIX\\s+[^\\s:]*:\\s*|BASE\\s*)<[^>]*>\\s*)*)"),
+                     Qt::CaseInsensitive);
+    prologue.indexIn(text);
+    queryPrologue = prologue.cap(1);
+    queryBody = text.mid(prologue.matchedLength());
+
+    countResult = connection->exec(QSparqlQuery(queryPrologue
+                                                + QLatin1String("SELECT (COUNT(*) AS ?count) WHERE { ")
+                                                + queryBody + QLatin1String(" }")));
+    connect(countResult, SIGNAL(finished()), this, SLOT(countFinished()));
+    requestPage(0);
+}
+
+void QSparqlQueryModelPrivate::stopPaging()
+{
+    qDeleteAll(pageResults.keys());
+    pageResults.clear();
+    delete countResult;
+    countResult = 0;
+    pages.clear();
+    pagedRows = 0;
+    totalRows = -1;
+}
+
+void QSparqlQueryModelPrivate::requestPage(int page)
+{
+    if (page < 0 || pages.contains(page) || pageResults.key(page, 0))
+        return;
+
+    const QString text = queryPrologue + queryBody
+                         + QString::fromLatin1(" LIMIT %1 OFFSET %2").arg(pageSize).arg(page * pageSize);
+    QSparqlResult* pageResult = connection->exec(QSparqlQuery(text));
+    pageResults.insert(pageResult, page);
+    connect(pageResult, SIGNAL(finished()), this, SLOT(pageFinished()));
+}
+
+void QSparqlQueryModelPrivate::setTotalRows(int rows)
+{
+    if (totalRows >= 0 && totalRows <= rows)
+        return;
+
+    totalRows = rows;
+    if (newQuery)
+        return;
+
+    // Once the number of rows is known all of them are announced, and the
+    // pages are fetched when the views ask for their data. Rows announced by
+    // fetchMore() past the end are removed.
+    if (pagedRows < totalRows) {
+        q->beginInsertRows(QModelIndex(), pagedRows, totalRows - 1);
+        pagedRows = totalRows;
+        q->endInsertRows();
+    } else if (pagedRows > totalRows) {
+        q->beginRemoveRows(QModelIndex(), totalRows, pagedRows - 1);
+        pagedRows = totalRows;
+        q->endRemoveRows();
+    }
+}
+
+const QVariant* QSparqlQueryModelPrivate::pagedRow(int row)
+{
+    const int page = row / pageSize;
+    const QVector<QVariant>* values = pages.object(page);
+    if (!values) {
+        // The data arrives with dataChanged() when the page has been fetched
+        requestPage(page);
+        return 0;
+    }
+
+    const int offset = (row - page * pageSize) * resultColumns;
+    if (offset + resultColumns > values->count())
+        return 0;
+    return values->constData() + offset;
+}
+
+void QSparqlQueryModelPrivate::pageFinished()
+{
+    QSparqlResult* pageResult = qobject_cast<QSparqlResult*>(sender());
+    if (!pageResult || !pageResults.contains(pageResult))
+        return;
+
+    const int page = pageResults.take(pageResult);
+    pageResult->deleteLater();
+
+    if (pageResult->hasError()) {
+        error = pageResult->lastError();
+        if (newQuery) {
+            newQuery = false;
+            Q_EMIT q->finished();
         }
+        return;
+    }
 
-        QStringList stringList = queryString.split(QLatin1Char(' '), QString::SkipEmptyParts);
-        Q_FOREACH(QString word, stringList) {
-            if ((word.at(0) == QLatin1Char('?') || word.at(0) == QLatin1Char('$'))
-            && (!word.contains(QLatin1Char(';')) && !word.contains(QLatin1Char(':')))) {
-                //remove the ? or $
-                word.remove(0,1);
-                // select ?u{?u a ... is valid, need to make sure
-                // this is dealt with
-                if (word.contains(QLatin1Char('{'))) {
-                   word = word.split(QLatin1Char('{'), QString::SkipEmptyParts).at(0);
-                }
-                QRegExp cleanUp(QLatin1String("[,]|[{]|[}]|[.]"));
-                word.replace(cleanUp,QLatin1String(""));
-                if (!uniqueNames.contains(word)) {
-                   uniqueNames.append(word);
-                }
-            }
+    QSparqlRowBlock block;
+    pageResult->fetchBlock(pageSize, &block);
+    const int count = block.rowCount();
+    const QStringList names = block.variableNames();
+
+    // The pages are stored with the columns of the first page, and the
+    // columns of the other pages are found by name, as their blocks can
+    // have other columns
+    QVector<int> sourceColumns;
+    if (newQuery) {
+        for (int column = 0; column < names.count(); ++column)
+            sourceColumns.append(column);
+    } else {
+        sourceColumns.reserve(resultColumns);
+        for (int column = 0; column < resultColumns; ++column) {
+            const QString name = resultRow.variableName(column);
+            sourceColumns.append(column < names.count() && names[column] == name
+                                 ? column : names.indexOf(name));
         }
+    }
+    const int columns = sourceColumns.count();
+
+    QVector<QVariant>* values = new QVector<QVariant>();
+    values->reserve(count * columns);
+    for (int row = 0; row < count; ++row) {
+        const QVariant* rowData = block.rowData(row);
+        for (int column = 0; column < columns; ++column)
+            values->append(sourceColumns[column] < 0 ? QVariant() : rowData[sourceColumns[column]]);
+    }
+    pages.insert(page, values);
 
-        int roleCounter = Qt::UserRole + 1;
-        Q_FOREACH(QString word, uniqueNames) {
-            roleNames[roleCounter++] = word.toLatin1();
+    if (count < pageSize)
+        setTotalRows(page * pageSize + count);
+
+    if (newQuery) {
+        // The first page tells the columns
+        newQuery = false;
+        QSparqlResultRow newResultRow;
+        Q_FOREACH (const QString& name, names)
+            newResultRow.append(QSparqlBinding(name));
+
+        q->beginResetModel();
+        resultRow = newResultRow;
+        resultColumns = columns;
+        initColOffsets(columns);
+        pagedRows = totalRows >= 0 ? totalRows : count;
+        q->endResetModel();
+
+        q->queryChange();
+        Q_EMIT q->finished();
+        return;
+    }
+
+    const int first = page * pageSize;
+    const int last = qMin(first + count, pagedRows) - 1;
+    if (last >= first && resultRow.count() > 0)
+        Q_EMIT q->dataChanged(q->index(first, 0), q->index(last, resultRow.count() - 1));
+}
+
+void QSparqlQueryModelPrivate::countFinished()
+{
+    if (sender() != countResult)
+        return;
+
+    QSparqlResult* counted = countResult;
+    countResult = 0;
+    counted->deleteLater();
+
+    // Without a count, a page with less than pageSize rows tells where the
+    // result ends
+    if (counted->hasError() || !counted->next())
+        return;
+
+    bool ok = false;
+    const int count = counted->value(0).toInt(&ok);
+    if (ok)
+        setTotalRows(count);
+}
+
+void QSparqlQueryModelPrivate::keyedQueryFinished()
+{
+    if (result->hasError()) {
+        // The rows of the previous query stay
+        error = result->lastError();
+        Q_EMIT q->finished();
+        return;
+    }
+
+    QVector<QSparqlResultRow> newRows;
+    if (result->first()) {
+        newRows.reserve(result->size());
+        do {
+            newRows.append(result->current());
+        } while (result->next());
+    }
+
+    applyKeyedRows(newRows);
+    q->queryChange();
+    Q_EMIT q->finished();
+}
+
+// Turns the rows into newRows with the operations of QSparqlRowDiff, or
+// resets the model if they can't be compared
+void QSparqlQueryModelPrivate::applyKeyedRows(const QVector<QSparqlResultRow>& newRows)
+{
+    QVector<QSparqlRowDiff::Operation> operations;
+    const bool sameVariables = newRows.isEmpty()
+        || (resultColumns > 0 && QSparqlRowDiff::sameVariables(resultRow, newRows.first()));
+    if (!sameVariables || !QSparqlRowDiff::diff(keyedRows, newRows, keyColumn, &operations)) {
+        q->beginResetModel();
+        keyedRows = newRows;
+        resultRow = newRows.isEmpty() ? QSparqlResultRow() : newRows.first();
+        resultColumns = resultRow.count();
+        initColOffsets(resultColumns);
+        q->endResetModel();
+    } else {
+        const int lastColumn = resultRow.count() - 1;
+        Q_FOREACH (const QSparqlRowDiff::Operation& operation, operations) {
+            switch (operation.type) {
+            case QSparqlRowDiff::Operation::Remove:
+                q->beginRemoveRows(QModelIndex(), operation.first, operation.first + operation.count - 1);
+                QSparqlRowDiff::apply(operation, &keyedRows, newRows);
+                q->endRemoveRows();
+                break;
+            case QSparqlRowDiff::Operation::Insert:
+                q->beginInsertRows(QModelIndex(), operation.first, operation.first + operation.count - 1);
+                QSparqlRowDiff::apply(operation, &keyedRows, newRows);
+                q->endInsertRows();
+                break;
+            case QSparqlRowDiff::Operation::Move:
+                q->beginMoveRows(QModelIndex(), operation.first, operation.first,
+                                 QModelIndex(), operation.destination);
+                QSparqlRowDiff::apply(operation, &keyedRows, newRows);
+                q->endMoveRows();
+                break;
+            case QSparqlRowDiff::Operation::Change:
+                QSparqlRowDiff::apply(operation, &keyedRows, newRows);
+                Q_EMIT q->dataChanged(q->index(operation.first, 0),
+                                      q->index(operation.first + operation.count - 1, lastColumn));
+                break;
+            }
         }
-#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
-        q->setRoleNames(roleNames);
+    }
+}
+
+void QSparqlQueryModelPrivate::startLiveQuery()
+{
+#ifdef QT_SPARQL_LIVE_QUERY
+    // The live query is kept when the same query is executed again
+    const QString text = query.preparedQueryText();
+    const QString key = keyed ? keyColumn : QString();
+    if (liveQuery && live && !paging && liveQuery->connection() == connection
+        && liveQuery->query() == text && liveQuery->keyVariable() == key)
+        return;
+
+    stopLiveQuery();
+    if (!live || paging)
+        return;
+
+    liveQuery = QSparqlLiveQuery::create(connection, text, key, this);
+    if (liveQuery) {
+        connect(liveQuery, SIGNAL(refreshNeeded()), this, SLOT(liveRefresh()));
+        connect(liveQuery, SIGNAL(rowsChanged(QStringList,QVector<QSparqlResultRow>)),
+                this, SLOT(liveRowsChanged(QStringList,QVector<QSparqlResultRow>)));
+    }
 #endif
-    } else {
-        qWarning() << "QSparqlQueryModel: Invalid Query";
+}
+
+void QSparqlQueryModelPrivate::stopLiveQuery()
+{
+#ifdef QT_SPARQL_LIVE_QUERY
+    // It may be emitting the signal which got us here
+    if (liveQuery) {
+        liveQuery->disconnect(this);
+        liveQuery->deleteLater();
+        liveQuery = 0;
+    }
+#endif
+}
+
+void QSparqlQueryModelPrivate::liveRefresh()
+{
+    q->setQuery(query, *connection);
+}
+
+void QSparqlQueryModelPrivate::liveRowsChanged(const QStringList& keys,
+                                               const QVector<QSparqlResultRow>& rows)
+{
+    // The result of a query which is running may have missed the changes
+    if (result && !result->isFinished()) {
+        liveRefresh();
+        return;
+    }
+    applyKeyedRows(QSparqlRowDiff::patch(keyedRows, keyColumn, keys, rows));
+}
+
+void QSparqlQueryModelPrivate::findRoleNames()
+{
+    // The projection is found once when the query text is set; bound values
+    // don't change it. The role of a column is Qt::UserRole + 1 + its index,
+    // so columns of expressions without AS, which have no name, keep their
+    // place without a role.
+    const QStringList projection = qt_sparqlQueryProjection(query);
+    roleNames.clear();
+    QList<QString> uniqueNames;
+    for (int i = 0; i < projection.count(); ++i) {
+        const QString& name = projection.at(i);
+        if (name.isEmpty() || uniqueNames.contains(name))
+            continue;
+        uniqueNames.append(name);
+        roleNames[Qt::UserRole + 1 + i] = name.toLatin1();
     }
+#if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
+    q->setRoleNames(roleNames);
+#endif
 }
 
 /*!
@@ -282,7 +533,11 @@ QSparqlQueryModel::~QSparqlQueryModel()
  */
 int QSparqlQueryModel::rowCount(const QModelIndex &index) const
 {
-    return index.isValid() ? 0 : d->bottom.row() + 1;
+    if (index.isValid())
+        return 0;
+    if (d->keyed)
+        return d->keyedRows.count();
+    return d->paging ? d->pagedRows : d->bottom.row() + 1;
 }
 
 /*!
@@ -304,7 +559,7 @@ int QSparqlQueryModel::columnCount(const QModelIndex &parent) const
 */
 QVariant QSparqlQueryModel::data(const QModelIndex &item, int role) const
 {
-    if (!item.isValid() || !d->result)
+    if (!item.isValid() || (!d->result && !d->paging && !d->keyed))
         return QVariant();
 
     int userRole = 0;
@@ -327,15 +582,27 @@ QVariant QSparqlQueryModel::data(const QModelIndex &item, int role) const
         dItem = indexInQuery(item);
     }
 
+    if (d->keyed) {
+        if (dItem.row() < 0 || dItem.row() >= d->keyedRows.count())
+            return v;
+        return d->keyedRows[dItem.row()].value(dItem.column());
+    }
+
+    if (d->paging) {
+        if (dItem.row() < 0 || dItem.row() >= d->pagedRows || dItem.column() >= d->resultColumns)
+            return v;
+        const QVariant* values = d->pagedRow(dItem.row());
+        return values ? values[dItem.column()] : v;
+    }
+
     if (dItem.row() > d->bottom.row())
         const_cast<QSparqlQueryModelPrivate *>(d)->prefetch(dItem.row());
 
-    if (!d->result->setPos(dItem.row())) {
-        d->error = d->result->lastError();
+    const QVector<QVariant>* values = const_cast<QSparqlQueryModelPrivate *>(d)->rowValues(dItem.row());
+    if (!values)
         return v;
-    }
 
-    return d->result->binding(dItem.column()).value();
+    return values->value(dItem.column());
 }
 
 /*!
@@ -382,20 +649,37 @@ void QSparqlQueryModel::setQuery(const QSparqlQuery &query, QSparqlConnection &c
 {
     d->query = query;
     d->findRoleNames();
-    bool mustClearModel = d->bottom.isValid();
+    // A keyed model keeps its rows until the new result has arrived
+    const bool keyed = d->pageSize == 0 && !d->keyColumn.isEmpty();
+    bool mustClearModel = !(keyed && d->keyed) && rowCount() > 0;
     if (mustClearModel) {
         d->atEnd = true;
-        beginRemoveRows(QModelIndex(), 0, qMax(d->bottom.row(), 0));
+        beginRemoveRows(QModelIndex(), 0, qMax(rowCount() - 1, 0));
         d->bottom = QModelIndex();
+        d->pagedRows = 0;
+        d->keyedRows.clear();
         endRemoveRows();
     }
 
     d->connection = &connection;
+    d->rowCache.clear();
     delete d->result;
-    d->result = connection.exec(query);
+    d->result = 0;
+    d->stopPaging();
     d->newQuery = true;
-    connect(d->result, SIGNAL(finished()), d, SLOT(queryFinished()));
-    connect(d->result, SIGNAL(dataReady(int)), d, SLOT(addData(int)));
+    d->paging = d->pageSize > 0;
+    d->keyed = keyed;
+    if (d->paging) {
+        d->beginPaging();
+    } else if (d->keyed) {
+        d->result = connection.exec(query);
+        connect(d->result, SIGNAL(finished()), d, SLOT(keyedQueryFinished()));
+    } else {
+        d->result = connection.exec(query);
+        connect(d->result, SIGNAL(finished()), d, SLOT(queryFinished()));
+        connect(d->result, SIGNAL(dataReady(int)), d, SLOT(addData(int)));
+    }
+    d->startLiveQuery();
     Q_EMIT started();
 
 }
@@ -413,6 +697,13 @@ void QSparqlQueryModel::clear()
 
     delete d->result; // TODO: is this ok?
     d->result = 0;
+    d->rowCache.clear();
+    d->resultColumns = 0;
+    d->stopPaging();
+    d->paging = false;
+    d->keyedRows.clear();
+    d->keyed = false;
+    d->stopLiveQuery();
 
     // TODO: or should we just delete d; d = 0;
 
@@ -422,6 +713,171 @@ void QSparqlQueryModel::clear()
     d->headers.clear();
 }
 
+/*!
+    Sets the number of rows fetched at a time to \a rows. The default is 0,
+    which executes the query once and keeps all of its rows.
+
+    With a page size, the query is executed a page at a time with LIMIT and
+    OFFSET appended, and only the last maximumPages() pages used are kept in
+    memory. Pages are fetched when data() asks for their rows and are
+    announced with dataChanged() when they arrive. A COUNT query tells the
+    number of rows, and rowCount() returns it once it has finished. Until
+    then, or if the endpoint can't execute it, rows are added a page at a
+    time with fetchMore().
+
+    The query should have an ORDER BY clause, so that the pages are stable,
+    and must not have a LIMIT or OFFSET of its own. The connection must
+    outlive the model. The page size is used by the next call to
+    setQuery().
+
+    \sa setMaximumPages(), fetchMore()
+*/
+void QSparqlQueryModel::setPageSize(int rows)
+{
+    d->pageSize = qMax(rows, 0);
+}
+
+/*!
+    Returns the number of rows fetched at a time, or 0 if the model keeps
+    all rows of the query.
+
+    \sa setPageSize()
+*/
+int QSparqlQueryModel::pageSize() const
+{
+    return d->pageSize;
+}
+
+/*!
+    Sets the number of pages kept in memory to \a pages. When a page is
+    fetched and the maximum has been reached, the least recently used page
+    is dropped; it is fetched again if it is needed later. The pages should
+    cover more rows than a view shows at once. The default is 4.
+
+    \sa setPageSize()
+*/
+void QSparqlQueryModel::setMaximumPages(int pages)
+{
+    d->pages.setMaxCost(qMax(pages, 1));
+}
+
+/*!
+    Returns the number of pages kept in memory.
+
+    \sa setMaximumPages()
+*/
+int QSparqlQueryModel::maximumPages() const
+{
+    return d->pages.maxCost();
+}
+
+/*!
+    Sets the name of the variable which identifies the rows of the query to
+    \a name. With a key column, setQuery() keeps the rows of the previous
+    query until the new result has finished, and then reports the rows
+    which were removed, inserted, moved or changed instead of clearing the
+    model, so that the views keep their state for the rest of the rows. The
+    rows are matched by the string form of their key binding.
+
+    The key column is used by the next call to setQuery(), and is ignored
+    when the model fetches pages. By default there is no key column.
+
+    \sa keyColumn(), setPageSize()
+*/
+void QSparqlQueryModel::setKeyColumn(const QString &name)
+{
+    d->keyColumn = name;
+}
+
+/*!
+    Returns the name of the variable which identifies the rows, or an empty
+    string if there is none.
+
+    \sa setKeyColumn()
+*/
+QString QSparqlQueryModel::keyColumn() const
+{
+    return d->keyColumn;
+}
+
+/*!
+    Sets whether the model follows the changes of the store to  live.
+    In the live mode, a model whose connection uses the QTRACKER or
+    QTRACKER_DIRECT driver listens to the GraphUpdated signals Tracker emits
+    for the classes the query uses, and updates itself a moment after a
+    change instead of having to be polled with setQuery().
+
+    With a key column, and a query without ORDER BY, LIMIT, OFFSET or GROUP
+    BY, changes to resources of the class of the key variable only fetch the
+    rows of those resources, and the model updates the rows in place; new
+    resources are appended. Other changes, and resources which were deleted,
+    execute the whole query again, which updates a keyed model with the rows
+    that changed and resets a model without a key column.
+
+    The live mode is used by the next call to setQuery(); turning it off
+    takes effect at once. It is ignored for other drivers, when the model
+    fetches pages, and when QtSparql was built without QtDBus. The drivers
+    can be built into the library or as plugins. The connection must outlive
+    the model. By default the model is not live.
+
+    \sa isLive(), setKeyColumn()
+*/
+void QSparqlQueryModel::setLive(bool live)
+{
+    d->live = live;
+    if (!live)
+        d->stopLiveQuery();
+}
+
+/*!
+    Returns true if the model follows the changes of the store.
+
+    \sa setLive()
+*/
+bool QSparqlQueryModel::isLive() const
+{
+    return d->live;
+}
+
+/*!
+    Returns true if the model has been set to fetch pages and the rows
+    announced so far are not all the rows of the query.
+
+    \sa fetchMore(), setPageSize()
+*/
+bool QSparqlQueryModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !d->paging || d->newQuery)
+        return false;
+    if (d->totalRows >= 0)
+        return d->pagedRows < d->totalRows;
+    // The end is not known; wait until the last page has arrived
+    return d->pagedRows > 0 && !d->pageResults.key((d->pagedRows - 1) / d->pageSize, 0);
+}
+
+/*!
+    Adds the rows of the next page to the model and starts fetching it.
+
+    \sa canFetchMore(), setPageSize()
+*/
+void QSparqlQueryModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    const int first = d->pagedRows;
+    int rows = first + d->pageSize;
+    if (d->totalRows >= 0)
+        rows = qMin(rows, d->totalRows);
+
+    beginInsertRows(QModelIndex(), first, rows - 1);
+    d->pagedRows = rows;
+    endInsertRows();
+
+    for (int page = first / d->pageSize; page <= (rows - 1) / d->pageSize; ++page)
+        d->requestPage(page);
+}
+
 /*!
     Sets the caption for a horizontal header for the specified \a role to
     \a value. This is useful if the model is used to
@@ -494,6 +950,19 @@ void QSparqlQueryModel::setLastError(const QSparqlError &error)
 */
 QSparqlResultRow QSparqlQueryModel::resultRow(int row) const
 {
+    if (d->keyed)
+        return row >= 0 && row < d->keyedRows.count() ? d->keyedRows[row] : d->resultRow;
+
+    if (d->paging) {
+        const QVariant* values = row >= 0 && row < d->pagedRows ? d->pagedRow(row) : 0;
+        if (!values)
+            return d->resultRow;
+        QSparqlResultRow pagedRow;
+        for (int i = 0; i < d->resultColumns; ++i)
+            pagedRow.append(QSparqlBinding(d->resultRow.variableName(i), values[i]));
+        return pagedRow;
+    }
+
     if (!d->result)
         return QSparqlResultRow();
 
@@ -80,6 +80,9 @@ public:
     bool setHeaderData(int section, Qt::Orientation orientation, const QVariant &value,
                        int role = Qt::EditRole);
 
+    bool canFetchMore(const QModelIndex &parent = QModelIndex()) const;
+    void fetchMore(const QModelIndex &parent = QModelIndex());
+
     bool insertColumns(int column, int count, const QModelIndex &parent = QModelIndex());
     bool removeColumns(int column, int count, const QModelIndex &parent = QModelIndex());
 
@@ -87,6 +90,17 @@ public:
     QSparqlQuery query() const;
     virtual void clear(); // FIXME: do we need this?
 
+    void setPageSize(int rows);
+    int pageSize() const;
+    void setMaximumPages(int pages);
+    int maximumPages() const;
+
+    void setKeyColumn(const QString &name);
+    QString keyColumn() const;
+
+    void setLive(bool live);
+    bool isLive() const;
+
     QSparqlError lastError() const;
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
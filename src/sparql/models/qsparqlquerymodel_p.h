@@ -55,7 +55,9 @@
 #include <qsparqlquery.h>
 #include <qsparqlresultrow.h>
 
+#include <QtCore/qcache.h>
 #include <QtCore/qhash.h>
+#include <QtCore/qstringlist.h>
 #include <QtCore/qvarlengtharray.h>
 #include <QtCore/qvector.h>
 #include <QtCore/qabstractitemmodel.h>
@@ -66,35 +68,80 @@ QT_BEGIN_NAMESPACE
 class QSparqlQueryModel;
 class QSparqlResult;
 class QSparqlConnection;
+class QSparqlLiveQuery;
 
 class QSparqlQueryModelPrivate : public QObject
 {
     Q_OBJECT
 public:
     QSparqlQueryModelPrivate(QSparqlQueryModel* q_)
-        : q(q_), result(0), connection(0), atEnd(false), newQuery(false) {}
+        : q(q_), result(0), connection(0), atEnd(false), newQuery(false),
+          resultColumns(0), rowCache(RowCacheSize), pageSize(0), pagedRows(0),
+          totalRows(-1), paging(false), countResult(0), pages(4), keyed(false),
+          live(false), liveQuery(0) {}
     ~QSparqlQueryModelPrivate();
     void prefetch(int);
     void initColOffsets(int size);
+    const QVector<QVariant>* rowValues(int row);
 
     QSparqlQueryModel* q;
     mutable QSparqlQuery query;
     mutable QSparqlError error;
     mutable QSparqlResult *result;
-    const QSparqlConnection* connection;
+    QSparqlConnection* connection;
     QModelIndex bottom;
     QSparqlResultRow resultRow;
     uint atEnd : 1;
     QVector<QHash<int, QVariant> > headers;
     QVarLengthArray<int, 56> colOffsets; // used to calculate indexInQuery of columns
     bool newQuery;
+    // Values of recently read rows, so that repainting a view doesn't
+    // position the result and fetch each cell again
+    enum { RowCacheSize = 256 };
+    int resultColumns;
+    QCache<int, QVector<QVariant> > rowCache;
     void beginQuery(int totalResults);
     void findRoleNames();
     QHash<int, QByteArray> roleNames;
 
+    // Paging: with pageSize > 0 the query is executed a page at a time
+    // with LIMIT and OFFSET, and only the last used pages are kept
+    int pageSize;
+    int pagedRows; // rows announced to the views
+    int totalRows; // from the COUNT query or a short page, -1 if not known
+    bool paging; // pageSize was set when the query was started
+    QSparqlResult* countResult;
+    QHash<QSparqlResult*, int> pageResults; // pages being fetched
+    QCache<int, QVector<QVariant> > pages; // values of page rows, row by row
+    QString queryPrologue; // the PREFIX and BASE declarations
+    QString queryBody;
+    void beginPaging();
+    void stopPaging();
+    void requestPage(int page);
+    void setTotalRows(int rows);
+    const QVariant* pagedRow(int row);
+
+    // With a key column, the model holds the rows itself and a new query
+    // updates the rows which changed instead of resetting the model
+    QString keyColumn;
+    bool keyed; // keyColumn was set when the query was started
+    QVector<QSparqlResultRow> keyedRows;
+    void applyKeyedRows(const QVector<QSparqlResultRow>& newRows);
+
+    // In the live mode the model follows the changes of a Tracker store
+    bool live;
+    QSparqlLiveQuery* liveQuery;
+    void startLiveQuery();
+    void stopLiveQuery();
+
 public Q_SLOTS:
     void addData(int totalResults);
     void queryFinished();
+    void pageFinished();
+    void countFinished();
+    void keyedQueryFinished();
+    void liveRefresh();
+    void liveRowsChanged(const QStringList& keys, const QVector<QSparqlResultRow>& rows);
 };
 
 QT_END_NAMESPACE
@@ -40,9 +40,106 @@
 #include <qsparqlerror.h>
 
 #include <QtCore/QDebug>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QVector>
 #include <QtNetwork/qnetworkaccessmanager.h>
 
 #include "qsparqlresultslist_p.h"
+#include "qsparqlrowdiff_p.h"
+#ifdef QT_SPARQL_LIVE_QUERY
+#include "qsparqllivequery_p.h"
+#endif
+
+namespace {
+
+// Connections shared by the lists which use the same driver and options, so
+// that changing the query of a list doesn't open a new connection. A
+// connection is closed when the last list using it is deleted or switches to
+// other options. There is one pool per thread, as a connection belongs to
+// the thread which created it.
+class ConnectionPool
+{
+public:
+    QSparqlConnection* acquire(const QString& driverName, const QSparqlConnectionOptions& options);
+    void release(QSparqlConnection* connection);
+
+private:
+    struct Entry
+    {
+        QString driverName;
+        QSparqlConnectionOptions options;
+        QSparqlConnection* connection;
+        int users;
+        // A connection which failed isn't given to new users
+        bool failed;
+    };
+    QList<Entry> entries;
+};
+
+QSparqlConnection* ConnectionPool::acquire(const QString& driverName,
+                                           const QSparqlConnectionOptions& options)
+{
+    for (int i = 0; i < entries.count(); ++i) {
+        Entry& entry = entries[i];
+        if (entry.failed || entry.driverName != driverName || !(entry.options == options))
+            continue;
+        // Opening it again may succeed, for example once the store is
+        // running; the users of the failed one keep it until they release it
+        if (entry.connection->hasError()) {
+            entry.failed = true;
+            continue;
+        }
+        ++entry.users;
+        return entry.connection;
+    }
+
+    Entry entry;
+    entry.driverName = driverName;
+    entry.options = options;
+    entry.connection = new QSparqlConnection(driverName, options);
+    entry.users = 1;
+    entry.failed = false;
+    entries.append(entry);
+    return entry.connection;
+}
+
+void ConnectionPool::release(QSparqlConnection* connection)
+{
+    for (int i = 0; i < entries.count(); ++i) {
+        if (entries[i].connection == connection) {
+            if (--entries[i].users == 0) {
+                delete connection;
+                entries.removeAt(i);
+            }
+            return;
+        }
+    }
+}
+
+Q_GLOBAL_STATIC(QThreadStorage<ConnectionPool*>, connectionPools)
+
+QSparqlConnection* acquireConnection(const QString& driverName,
+                                     const QSparqlConnectionOptions& options)
+{
+    QThreadStorage<ConnectionPool*>* pools = connectionPools();
+    if (!pools)
+        return new QSparqlConnection(driverName, options);
+    if (!pools->hasLocalData())
+        pools->setLocalData(new ConnectionPool);
+    return pools->localData()->acquire(driverName, options);
+}
+
+void releaseConnection(QSparqlConnection* connection)
+{
+    // The pool is gone once its thread or the application has finished
+    QThreadStorage<ConnectionPool*>* pools = connectionPools();
+    if (pools && pools->hasLocalData())
+        pools->localData()->release(connection);
+    else
+        delete connection;
+}
+
+} // namespace
 
 /*!
     \fn void QSparqlQueryModel::finished()
@@ -51,14 +148,28 @@
     finished retrieving its data or when there was an error.
 */
 
+QT_BEGIN_NAMESPACE
+class QSparqlLiveQuery;
+QT_END_NAMESPACE
+
 class QSparqlResultsListPrivate
 {
 public:
     QSparqlResultsListPrivate(QSparqlResultsList* _q) :
-        q(_q), connection(0), result(0), options(0), lastRowCount(0), status(QSparqlResultsList::Null)
+        q(_q), connection(0), result(0), options(0), lastRowCount(0), status(QSparqlResultsList::Null),
+        keyed(false), live(false), liveQuery(0), refreshPending(false), cachedRow(-1)
     {
     }
 
+    bool setCachedRow(int row);
+
+    // A role is either the value of a column or its '$' string form
+    struct RoleColumn
+    {
+        int column;
+        bool stringForm;
+    };
+
     QSparqlResultsList *q;
     QSparqlConnection *connection;
     QSparqlResult *result;
@@ -69,8 +180,48 @@ public:
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
     QHash<int, QByteArray> roleNames;
 #endif
+    // Indexed by role - (Qt::UserRole + 1)
+    QVector<RoleColumn> roleColumns;
+
+    // With a key column the list holds the rows itself, and a reload turns
+    // them into the new rows with the operations of QSparqlRowDiff
+    QString keyColumn;
+    bool keyed;
+    QVector<QSparqlResultRow> rows;
+
+    // A live list follows the changes of a Tracker store
+    bool live;
+    QSparqlLiveQuery* liveQuery;
+    bool refreshPending; // a change arrived while a query was running
+
+    // The row last read by data(). QML delegates read several roles of the
+    // same row, so it is only built once, and the '$' string forms of its
+    // columns are made the first time they're asked for.
+    int cachedRow;
+    QSparqlResultRow cachedResultRow;
+    QVector<QVariant> cachedStrings;
 };
 
+bool QSparqlResultsListPrivate::setCachedRow(int row)
+{
+    if (row == cachedRow)
+        return true;
+
+    if (keyed) {
+        if (row < 0 || row >= rows.count())
+            return false;
+        cachedResultRow = rows[row];
+    } else {
+        if (!result->setPos(row))
+            return false;
+        cachedResultRow = result->current();
+    }
+
+    cachedRow = row;
+    cachedStrings.fill(QVariant(), cachedResultRow.count());
+    return true;
+}
+
 QSparqlResultsList::QSparqlResultsList(QObject *parent) :
     QAbstractListModel(parent)
 {
@@ -79,13 +230,20 @@ QSparqlResultsList::QSparqlResultsList(QObject *parent) :
 
 QSparqlResultsList::~QSparqlResultsList()
 {
+#ifdef QT_SPARQL_LIVE_QUERY
+    delete d->liveQuery;
+#endif
     delete d->result;
-    delete d->connection;
+    if (d->connection)
+        releaseConnection(d->connection);
     delete d;
 }
 
 int QSparqlResultsList::rowCount(const QModelIndex &) const
 {
+    if (d->keyed)
+        return d->rows.count();
+
     if (d->result == 0)
         return 0;
 
@@ -94,17 +252,26 @@ int QSparqlResultsList::rowCount(const QModelIndex &) const
 
 QVariant QSparqlResultsList::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid())
+    if (!index.isValid() || (d->result == 0 && !d->keyed))
         return QVariant();
 
-    d->result->setPos(index.row());
-    QSparqlResultRow row = d->result->current();
-    int i = role - (Qt::UserRole + 1);
+    const int i = role - (Qt::UserRole + 1);
+    if (i < 0 || i >= d->roleColumns.count())
+        return QVariant();
 
-    if (i >= row.count())
-        return row.binding(i - row.count()).toString();
-    else
-        return row.value(i);
+    if (!d->setCachedRow(index.row()))
+        return QVariant();
+
+    const QSparqlResultsListPrivate::RoleColumn& roleColumn = d->roleColumns[i];
+    if (roleColumn.column >= d->cachedResultRow.count())
+        return QVariant();
+    if (!roleColumn.stringForm)
+        return d->cachedResultRow.value(roleColumn.column);
+
+    QVariant& string = d->cachedStrings[roleColumn.column];
+    if (!string.isValid())
+        string = d->cachedResultRow.binding(roleColumn.column).toString();
+    return string;
 }
 
 void QSparqlResultsList::reload()
@@ -112,17 +279,31 @@ void QSparqlResultsList::reload()
     if (d->options == 0 || d->query.isEmpty())
         return;
 
-    if (d->result != 0) {
-        if (!d->result->isFinished())
-            return;
-        else
-            delete d->result;
-    }
+    if (d->result != 0 && !d->result->isFinished())
+        return;
 
     delete d->result;
-    delete d->connection;
+    d->result = 0;
+    d->cachedRow = -1;
+    d->cachedResultRow.clear();
+
+    // A keyed list keeps its rows until the new result has arrived; switching
+    // between the modes starts from an empty list
+    const bool keyed = !d->keyColumn.isEmpty();
+    if (keyed != d->keyed) {
+        beginResetModel();
+        d->keyed = keyed;
+        d->rows.clear();
+        d->lastRowCount = 0;
+        endResetModel();
+    }
 
-    d->connection = new QSparqlConnection(d->options->driverName(), *d->options);
+    // The connection is only replaced when the driver or the options change;
+    // acquiring the new one first keeps it open if they didn't
+    QSparqlConnection* connection = acquireConnection(d->options->driverName(), *d->options);
+    if (d->connection)
+        releaseConnection(d->connection);
+    d->connection = connection;
     d->result = d->connection->exec(QSparqlQuery(d->query));
 
     if (d->result->hasError())
@@ -134,49 +315,130 @@ void QSparqlResultsList::reload()
     connect(d->result, SIGNAL(finished()), this, SIGNAL(finished()));
     connect(d->result, SIGNAL(finished()), this, SLOT(queryFinished()));
     connect(d->result, SIGNAL(dataReady(int)), this, SLOT(queryData(int)));
+    startLiveQuery();
 }
 
-void QSparqlResultsList::queryData(int rowCount)
+void QSparqlResultsList::createRoleNames(const QSparqlResultRow &resultRow)
 {
-    QAbstractItemModel::beginInsertRows(QModelIndex(), d->lastRowCount, rowCount - 1);
-
-    if (d->lastRowCount == 0 && d->result->first()) {
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
-        QHash<int, QByteArray> &roleNames = d->roleNames;
-        roleNames = QAbstractItemModel::roleNames();
+    QHash<int, QByteArray> &roleNames = d->roleNames;
+    roleNames = QAbstractItemModel::roleNames();
 #else
-        QHash<int, QByteArray> roleNames = QAbstractItemModel::roleNames();
+    QHash<int, QByteArray> roleNames = QAbstractItemModel::roleNames();
 #endif
-        QSparqlResultRow resultRow = d->result->current();
-
-        // Create two sets of declarative variables from the variable names used
-        // in the select statement
-        // 'foo' is just a literal like 1234, but '$foo' is "1234"^^xsd:integer
-        // 'bar' is a string 'http://www.w3.org/2002/07/owl#sameAs', but '$bar'
-        // is a uri <http://www.w3.org/2002/07/owl#sameAs>
-        for (int i = 0; i < resultRow.count(); i++) {
-            roleNames.insert((Qt::UserRole + 1) + i, resultRow.binding(i).name().toLatin1());
-        }
 
-        for (int i = 0; i < resultRow.count(); i++) {
-            roleNames.insert((Qt::UserRole + 1) + i + resultRow.count(), QByteArray("$") + resultRow.binding(i).name().toLatin1());
-        }
+    // Create two sets of declarative variables from the variable names used
+    // in the select statement
+    // 'foo' is just a literal like 1234, but '$foo' is "1234"^^xsd:integer
+    // 'bar' is a string 'http://www.w3.org/2002/07/owl#sameAs', but '$bar'
+    // is a uri <http://www.w3.org/2002/07/owl#sameAs>
+    for (int i = 0; i < resultRow.count(); i++) {
+        roleNames.insert((Qt::UserRole + 1) + i, resultRow.binding(i).name().toLatin1());
+    }
+
+    for (int i = 0; i < resultRow.count(); i++) {
+        roleNames.insert((Qt::UserRole + 1) + i + resultRow.count(), QByteArray("$") + resultRow.binding(i).name().toLatin1());
+    }
+
+    d->roleColumns.resize(resultRow.count() * 2);
+    for (int i = 0; i < resultRow.count(); i++) {
+        d->roleColumns[i].column = i;
+        d->roleColumns[i].stringForm = false;
+        d->roleColumns[i + resultRow.count()].column = i;
+        d->roleColumns[i + resultRow.count()].stringForm = true;
+    }
 
 #if QT_VERSION < QT_VERSION_CHECK(5, 0, 0)
-        setRoleNames(roleNames);
+    setRoleNames(roleNames);
 #endif
-    }
+}
+
+void QSparqlResultsList::queryData(int rowCount)
+{
+    // With a key column the rows are compared with the previous ones when
+    // the query has finished
+    if (d->keyed)
+        return;
+
+    QAbstractItemModel::beginInsertRows(QModelIndex(), d->lastRowCount, rowCount - 1);
+
+    if (d->lastRowCount == 0 && d->result->first())
+        createRoleNames(d->result->current());
 
     d->lastRowCount = rowCount;
     QAbstractItemModel::endInsertRows();
     Q_EMIT countChanged();
 }
 
+void QSparqlResultsList::updateRows(const QVector<QSparqlResultRow> &newRows)
+{
+    QVector<QSparqlRowDiff::Operation> operations;
+    const bool sameVariables = d->rows.isEmpty() || newRows.isEmpty()
+        || QSparqlRowDiff::sameVariables(d->rows.first(), newRows.first());
+    if (!sameVariables || !QSparqlRowDiff::diff(d->rows, newRows, d->keyColumn, &operations)) {
+        beginResetModel();
+        if (!newRows.isEmpty())
+            createRoleNames(newRows.first());
+        d->rows = newRows;
+        d->cachedRow = -1;
+        endResetModel();
+        return;
+    }
+
+    if (d->roleColumns.isEmpty() && !newRows.isEmpty())
+        createRoleNames(newRows.first());
+
+    // The views may read the rows between the operations, so the cached row
+    // is dropped after each of them
+    Q_FOREACH (const QSparqlRowDiff::Operation& operation, operations) {
+        switch (operation.type) {
+        case QSparqlRowDiff::Operation::Remove:
+            beginRemoveRows(QModelIndex(), operation.first, operation.first + operation.count - 1);
+            QSparqlRowDiff::apply(operation, &d->rows, newRows);
+            d->cachedRow = -1;
+            endRemoveRows();
+            break;
+        case QSparqlRowDiff::Operation::Insert:
+            beginInsertRows(QModelIndex(), operation.first, operation.first + operation.count - 1);
+            QSparqlRowDiff::apply(operation, &d->rows, newRows);
+            d->cachedRow = -1;
+            endInsertRows();
+            break;
+        case QSparqlRowDiff::Operation::Move:
+            beginMoveRows(QModelIndex(), operation.first, operation.first,
+                          QModelIndex(), operation.destination);
+            QSparqlRowDiff::apply(operation, &d->rows, newRows);
+            d->cachedRow = -1;
+            endMoveRows();
+            break;
+        case QSparqlRowDiff::Operation::Change:
+            QSparqlRowDiff::apply(operation, &d->rows, newRows);
+            d->cachedRow = -1;
+            Q_EMIT dataChanged(index(operation.first), index(operation.first + operation.count - 1));
+            break;
+        }
+    }
+}
+
 void QSparqlResultsList::queryFinished()
 {
-    beginResetModel();
-    endResetModel();
-    
+    if (d->keyed) {
+        // A failed query keeps the previous rows
+        if (!d->result->hasError()) {
+            QVector<QSparqlResultRow> newRows;
+            if (d->result->first()) {
+                newRows.reserve(d->result->size());
+                do {
+                    newRows.append(d->result->current());
+                } while (d->result->next());
+            }
+            updateRows(newRows);
+        }
+    } else {
+        beginResetModel();
+        endResetModel();
+    }
+
     if (d->result->hasError())
         d->status = Error;
     else
@@ -184,6 +446,70 @@ void QSparqlResultsList::queryFinished()
 
     Q_EMIT statusChanged(d->status);
     Q_EMIT countChanged();
+
+    // The result can't be deleted while it's emitting finished()
+    if (d->refreshPending) {
+        d->refreshPending = false;
+        QMetaObject::invokeMethod(this, "reload", Qt::QueuedConnection);
+    }
+}
+
+void QSparqlResultsList::startLiveQuery()
+{
+#ifdef QT_SPARQL_LIVE_QUERY
+    // The live query is kept when the same query is executed again
+    const QString key = d->keyed ? d->keyColumn : QString();
+    if (d->liveQuery && d->live && d->liveQuery->connection() == d->connection
+        && d->liveQuery->query() == d->query && d->liveQuery->keyVariable() == key)
+        return;
+
+    stopLiveQuery();
+    if (!d->live || d->connection == 0)
+        return;
+
+    d->liveQuery = QSparqlLiveQuery::create(d->connection, d->query, key, this);
+    if (d->liveQuery) {
+        connect(d->liveQuery, SIGNAL(refreshNeeded()), this, SLOT(liveRefresh()));
+        connect(d->liveQuery, SIGNAL(rowsChanged(QStringList,QVector<QSparqlResultRow>)),
+                this, SLOT(liveRowsChanged(QStringList,QVector<QSparqlResultRow>)));
+    }
+#endif
+}
+
+void QSparqlResultsList::stopLiveQuery()
+{
+#ifdef QT_SPARQL_LIVE_QUERY
+    // It may be emitting the signal which got us here
+    if (d->liveQuery) {
+        d->liveQuery->disconnect(this);
+        d->liveQuery->deleteLater();
+        d->liveQuery = 0;
+    }
+#endif
+    d->refreshPending = false;
+}
+
+void QSparqlResultsList::liveRefresh()
+{
+    if (d->result != 0 && !d->result->isFinished())
+        d->refreshPending = true;
+    else
+        reload();
+}
+
+void QSparqlResultsList::liveRowsChanged(const QStringList &keys,
+                                         const QVector<QSparqlResultRow> &rows)
+{
+    // The result of a query which is running may have missed the changes
+    if (d->result != 0 && !d->result->isFinished()) {
+        d->refreshPending = true;
+        return;
+    }
+    if (!d->keyed)
+        return;
+
+    updateRows(QSparqlRowDiff::patch(d->rows, d->keyColumn, keys, rows));
+    Q_EMIT countChanged();
 }
 
 SparqlConnectionOptions* QSparqlResultsList::options() const
@@ -212,8 +538,48 @@ void QSparqlResultsList::setQuery(const QString &query)
     }
 }
 
+QString QSparqlResultsList::keyColumn() const
+{
+    return d->keyColumn;
+}
+
+// Setting a key column, the name of a variable which identifies the rows,
+// makes a reload update the rows which changed instead of resetting the
+// list, so that the views keep the delegates of the other rows
+void QSparqlResultsList::setKeyColumn(const QString &name)
+{
+    if (d->keyColumn != name) {
+        d->keyColumn = name;
+        Q_EMIT keyColumnChanged();
+    }
+}
+
+bool QSparqlResultsList::isLive() const
+{
+    return d->live;
+}
+
+// A live list, with a connection using the QTRACKER or QTRACKER_DIRECT
+// driver, follows the GraphUpdated signals of Tracker for the classes of the
+// query instead of having to be reloaded. With a key column, changes to
+// resources of the class of the key variable only fetch the rows of those
+// resources; other changes reload the list. See QSparqlQueryModel::setLive().
+void QSparqlResultsList::setLive(bool live)
+{
+    if (d->live != live) {
+        d->live = live;
+        if (live)
+            startLiveQuery();
+        else
+            stopLiveQuery();
+        Q_EMIT liveChanged();
+    }
+}
+
 int QSparqlResultsList::count() const
 {
+    if (d->keyed)
+        return d->rows.count();
     return d->result == 0 ? 0 : d->result->size();
 }
 
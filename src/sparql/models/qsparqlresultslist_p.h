@@ -49,6 +49,8 @@
 #include <private/qsparqlsparqlconnectionoptions_p.h>
 
 #include <QtCore/QAbstractListModel>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
 
 QT_BEGIN_HEADER
 
@@ -64,6 +66,8 @@ class Q_SPARQL_EXPORT QSparqlResultsList : public QAbstractListModel
     Q_ENUMS(Status)
     Q_PROPERTY(SparqlConnectionOptions * options READ options WRITE setOptions NOTIFY optionsChanged)
     Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
+    Q_PROPERTY(QString keyColumn READ keyColumn WRITE setKeyColumn NOTIFY keyColumnChanged)
+    Q_PROPERTY(bool live READ isLive WRITE setLive NOTIFY liveChanged)
     Q_PROPERTY(int count READ count NOTIFY countChanged)
     Q_PROPERTY(Status status READ status NOTIFY statusChanged)
     Q_CLASSINFO("DefaultProperty", "query")
@@ -81,6 +85,12 @@ public:
     QString query() const;
     void setQuery(const QString &query);
 
+    QString keyColumn() const;
+    void setKeyColumn(const QString &name);
+
+    bool isLive() const;
+    void setLive(bool live);
+
     int count() const;
 
     enum Status { Null, Ready, Loading, Error };
@@ -100,13 +110,22 @@ Q_SIGNALS:
     void statusChanged(QSparqlResultsList::Status);
     void optionsChanged();
     void queryChanged();
+    void keyColumnChanged();
+    void liveChanged();
     void countChanged();
 
 private Q_SLOTS:
     void queryData(int totalResults);
     void queryFinished();
+    void liveRefresh();
+    void liveRowsChanged(const QStringList &keys, const QVector<QSparqlResultRow> &rows);
 
 private:
+    void createRoleNames(const QSparqlResultRow &resultRow);
+    void updateRows(const QVector<QSparqlResultRow> &newRows);
+    void startLiveQuery();
+    void stopLiveQuery();
+
     QSparqlResultsListPrivate* d;
 };
 
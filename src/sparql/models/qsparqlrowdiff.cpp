@@ -0,0 +1,302 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsparqlrowdiff_p.h"
+
+#include <qsparqlbinding.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qset.h>
+
+QT_BEGIN_NAMESPACE
+
+// Keys made unique with the number of the occurrence, so that rows with the
+// same key are matched in order. Returns false if a row has no binding for
+// key.
+static bool rowKeys(const QVector<QSparqlResultRow>& rows, const QString& key,
+                    QVector<QString>* keys)
+{
+    keys->resize(rows.count());
+    QHash<QString, int> occurrences;
+    for (int i = 0; i < rows.count(); ++i) {
+        const int column = rows[i].indexOf(key);
+        if (column < 0)
+            return false;
+        QString rowKey = rows[i].binding(column).toString();
+        const int occurrence = occurrences[rowKey]++;
+        if (occurrence > 0) {
+            rowKey += QLatin1Char('\0');
+            rowKey += QString::number(occurrence);
+        }
+        (*keys)[i] = rowKey;
+    }
+    return true;
+}
+
+// Marks the elements of a longest strictly increasing subsequence of values
+static QVector<bool> longestIncreasing(const QVector<int>& values)
+{
+    // tails[k] is the index of the smallest last value of an increasing
+    // subsequence of length k + 1
+    QVector<int> tails;
+    QVector<int> previous(values.count(), -1);
+    for (int i = 0; i < values.count(); ++i) {
+        int low = 0;
+        int high = tails.count();
+        while (low < high) {
+            const int middle = (low + high) / 2;
+            if (values[tails[middle]] < values[i])
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        if (low > 0)
+            previous[i] = tails[low - 1];
+        if (low == tails.count())
+            tails.append(i);
+        else
+            tails[low] = i;
+    }
+
+    QVector<bool> result(values.count(), false);
+    for (int i = tails.isEmpty() ? -1 : tails.last(); i >= 0; i = previous[i])
+        result[i] = true;
+    return result;
+}
+
+static QSparqlRowDiff::Operation operation(QSparqlRowDiff::Operation::Type type,
+                                           int first, int count,
+                                           int destination = -1, int source = -1)
+{
+    QSparqlRowDiff::Operation operation;
+    operation.type = type;
+    operation.first = first;
+    operation.count = count;
+    operation.destination = destination;
+    operation.source = source;
+    return operation;
+}
+
+static void appendChange(QVector<QSparqlRowDiff::Operation>* operations, int row)
+{
+    // Extend the previous operation if it changed the rows just above
+    if (!operations->isEmpty()) {
+        QSparqlRowDiff::Operation& last = operations->last();
+        if (last.type == QSparqlRowDiff::Operation::Change && last.first + last.count == row
+            && last.source + last.count == row) {
+            ++last.count;
+            return;
+        }
+    }
+    operations->append(operation(QSparqlRowDiff::Operation::Change, row, 1, -1, row));
+}
+
+bool QSparqlRowDiff::diff(const QVector<QSparqlResultRow>& oldRows,
+                          const QVector<QSparqlResultRow>& newRows,
+                          const QString& key, QVector<Operation>* operations)
+{
+    operations->clear();
+
+    QVector<QString> oldKeys;
+    QVector<QString> newKeys;
+    if (!rowKeys(oldRows, key, &oldKeys) || !rowKeys(newRows, key, &newKeys))
+        return false;
+
+    QHash<QString, int> newIndexes;
+    newIndexes.reserve(newKeys.count());
+    for (int i = 0; i < newKeys.count(); ++i)
+        newIndexes.insert(newKeys[i], i);
+
+    // The row in the new rows of each old row, and the reverse
+    QVector<int> targets(oldKeys.count());
+    QVector<int> sources(newKeys.count(), -1);
+    for (int i = 0; i < oldKeys.count(); ++i) {
+        targets[i] = newIndexes.value(oldKeys[i], -1);
+        if (targets[i] >= 0)
+            sources[targets[i]] = i;
+    }
+
+    // Removed rows, from the bottom so that the ranges above keep their
+    // positions
+    for (int i = oldKeys.count() - 1; i >= 0;) {
+        if (targets[i] >= 0) {
+            --i;
+            continue;
+        }
+        const int last = i;
+        while (i >= 0 && targets[i] < 0)
+            --i;
+        operations->append(operation(Operation::Remove, i + 1, last - i));
+    }
+
+    // What the model holds while the operations are applied: the new row of
+    // each of its rows
+    QVector<int> current;
+    current.reserve(newKeys.count());
+    for (int i = 0; i < targets.count(); ++i) {
+        if (targets[i] >= 0)
+            current.append(targets[i]);
+    }
+
+    QVector<bool> stays(newKeys.count(), false);
+    const QVector<bool> increasing = longestIncreasing(current);
+    for (int i = 0; i < current.count(); ++i) {
+        if (increasing[i])
+            stays[current[i]] = true;
+    }
+
+    // Build the new rows from the top: rows before i are in place
+    for (int i = 0; i < newKeys.count();) {
+        if (sources[i] < 0) {
+            int count = 1;
+            while (i + count < newKeys.count() && sources[i + count] < 0)
+                ++count;
+            operations->append(operation(Operation::Insert, i, count, -1, i));
+            current.insert(i, count, 0);
+            for (int j = 0; j < count; ++j)
+                current[i + j] = i + j;
+            i += count;
+            continue;
+        }
+
+        if (stays[i]) {
+            // The rows which stay keep their order, so only rows which
+            // move later can be in the way; they go to the bottom until
+            // their turn comes
+            while (current[i] != i) {
+                Q_ASSERT(!stays[current[i]] && i < current.count() - 1);
+                operations->append(operation(Operation::Move, i, 1, current.count()));
+                current.append(current[i]);
+                current.remove(i);
+            }
+        } else if (current[i] != i) {
+            const int from = current.indexOf(i, i + 1);
+            Q_ASSERT(from > i);
+            operations->append(operation(Operation::Move, from, 1, i));
+            current.remove(from);
+            current.insert(i, i);
+        }
+
+        if (oldRows[sources[i]] != newRows[i])
+            appendChange(operations, i);
+        ++i;
+    }
+
+    return true;
+}
+
+void QSparqlRowDiff::apply(const Operation& operation, QVector<QSparqlResultRow>* rows,
+                           const QVector<QSparqlResultRow>& newRows)
+{
+    switch (operation.type) {
+    case Operation::Remove:
+        rows->remove(operation.first, operation.count);
+        break;
+    case Operation::Insert:
+        rows->insert(operation.first, operation.count, QSparqlResultRow());
+        // fall through
+    case Operation::Change:
+        for (int i = 0; i < operation.count; ++i)
+            (*rows)[operation.first + i] = newRows[operation.source + i];
+        break;
+    case Operation::Move: {
+        const QSparqlResultRow row = rows->at(operation.first);
+        rows->remove(operation.first);
+        rows->insert(operation.destination > operation.first ? operation.destination - 1
+                                                             : operation.destination, row);
+        break;
+    }
+    }
+}
+
+static QString rowKey(const QSparqlResultRow& row, const QString& key)
+{
+    const int column = row.indexOf(key);
+    return column < 0 ? QString() : row.binding(column).toString();
+}
+
+QVector<QSparqlResultRow> QSparqlRowDiff::patch(const QVector<QSparqlResultRow>& rows,
+                                                const QString& key, const QStringList& keys,
+                                                const QVector<QSparqlResultRow>& changedRows)
+{
+    // A resource can have several rows; they are all replaced where its
+    // first row was
+    QHash<QString, QVector<QSparqlResultRow> > changed;
+    QStringList changedOrder;
+    Q_FOREACH (const QString& changedKey, keys)
+        changed.insert(changedKey, QVector<QSparqlResultRow>());
+    Q_FOREACH (const QSparqlResultRow& row, changedRows) {
+        const QString changedKey = rowKey(row, key);
+        QVector<QSparqlResultRow>& group = changed[changedKey];
+        if (group.isEmpty())
+            changedOrder.append(changedKey);
+        group.append(row);
+    }
+
+    QVector<QSparqlResultRow> patched;
+    patched.reserve(rows.count() + changedRows.count());
+    QSet<QString> placed;
+    Q_FOREACH (const QSparqlResultRow& row, rows) {
+        const QString currentKey = rowKey(row, key);
+        if (currentKey.isEmpty() || !changed.contains(currentKey)) {
+            patched.append(row);
+        } else if (!placed.contains(currentKey)) {
+            placed.insert(currentKey);
+            patched += changed.value(currentKey);
+        }
+    }
+    Q_FOREACH (const QString& changedKey, changedOrder) {
+        if (!placed.contains(changedKey))
+            patched += changed.value(changedKey);
+    }
+    return patched;
+}
+
+bool QSparqlRowDiff::sameVariables(const QSparqlResultRow& row, const QSparqlResultRow& other)
+{
+    if (row.count() != other.count())
+        return false;
+    for (int i = 0; i < row.count(); ++i) {
+        if (row.variableName(i) != other.variableName(i))
+            return false;
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
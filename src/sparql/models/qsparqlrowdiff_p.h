@@ -0,0 +1,111 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSPARQLROWDIFF_P_H
+#define QSPARQLROWDIFF_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of qsparql*model.h .  This header file may change from version to version
+// without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <qsparqlresultrow.h>
+
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+// Computes how the rows of a model change from a previous result to a new
+// one, as the ranges a model reports to its views, so that a requery
+// doesn't reset the model. Rows are matched by the string form of the
+// binding of a key variable; rows with the same key are matched in order.
+// Rows which keep their relative order stay where they are, the others are
+// moved.
+class Q_SPARQL_EXPORT QSparqlRowDiff
+{
+public:
+    struct Operation
+    {
+        enum Type { Remove, Insert, Move, Change };
+        Type type;
+        // The first row, at the time the operation is applied
+        int first;
+        // Rows removed, inserted or changed; 1 for Move
+        int count;
+        // Move: the row it's moved before, as in beginMoveRows()
+        int destination;
+        // Insert and Change: the first row in the new rows
+        int source;
+    };
+
+    // Returns false, and no operations, if a row has no binding for key
+    static bool diff(const QVector<QSparqlResultRow>& oldRows,
+                     const QVector<QSparqlResultRow>& newRows,
+                     const QString& key, QVector<Operation>* operations);
+
+    // Applies operation to rows, taking the inserted and changed rows from
+    // newRows
+    static void apply(const Operation& operation, QVector<QSparqlResultRow>* rows,
+                      const QVector<QSparqlResultRow>& newRows);
+
+    // Returns rows with the rows of the resources in keys replaced by their
+    // rows in changedRows, or removed if they have none there. The rows of
+    // changedRows whose key isn't in rows are appended. Rows without a
+    // binding for key are kept.
+    static QVector<QSparqlResultRow> patch(const QVector<QSparqlResultRow>& rows,
+                                           const QString& key, const QStringList& keys,
+                                           const QVector<QSparqlResultRow>& changedRows);
+
+    // True if the rows have the same variables
+    static bool sameVariables(const QSparqlResultRow& row, const QSparqlResultRow& other);
+};
+
+Q_DECLARE_TYPEINFO(QSparqlRowDiff::Operation, Q_PRIMITIVE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QSPARQLROWDIFF_P_H
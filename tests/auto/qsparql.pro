@@ -5,9 +5,15 @@ SUBDIRS = \
     qsparqlquery \
     qsparqlbinding \
     qsparqlresultrow \
+    qsparqlrowdiff \
     qsparql \
+    qsparql_allocation_benchmark \
     qsparql_endpoint \
+    qsparql_endpoint_benchmark \
     qsparql_ntriples \
+    qsparql_ntriples_benchmark \
+    qsparql_synthetic_benchmark \
+    qsparql_turtle \
     qsparql_threading \
     qsparql_tracker \
     qsparql_tracker_direct \
@@ -22,9 +28,9 @@ SUBDIRS = \
 contains(sparql-plugins, tracker_direct): SUBDIRS += qsparql_benchmark
 
 QSPARQL_TESTS = qsparql qsparqlquery qsparqlbinding qsparql_api qsparql_tracker \
-                qsparql_tracker_direct qsparql_tracker_direct_sync qsparql_ntriples \
+                qsparql_tracker_direct qsparql_tracker_direct_sync qsparql_ntriples qsparql_turtle \
                 qsparql_tracker_direct_crashes qsparql_threading \
-                qsparqlresultrow qsparql_qmlbindings qsparql_endpoint
+                qsparqlresultrow qsparqlrowdiff qsparql_qmlbindings qsparql_endpoint
 
 check.CONFIG = recursive
 check.recurse = $$QSPARQL_TESTS
@@ -42,6 +42,11 @@
 
 #include <private/qsparqlconnection_p.h>
 #include <private/qsparqldriver_p.h>
+#include <private/qsparqlresultextension_p.h>
+#include <private/qsparqltracer_p.h>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+#include <QtCore/qjsondocument.h>
+#endif
 
 class MockDriver;
 
@@ -80,16 +85,22 @@ class MockSyncFwOnlyResult : public QSparqlResult
     MockSyncFwOnlyResult()
         : pos(-1) // first row is row 0, we start BeforeFirstRow
     {
+        markExecutionStarted();
+        markExecutionFinished();
     }
     // Only this is needed for iterating the result
     bool next()
     {
         // Do some work to fetch the next row
         if (++pos < size_) { // determine if the row was the last or not
+            const qint64 decodeStart = elapsedTime();
             updatePos(pos);
+            addDecodeTime(elapsedTime() - decodeStart);
+            addFetchedRows(1);
             return true;
         }
         updatePos(QSparql::AfterLastRow);
+        markFetchFinished();
         return false;
     }
     bool hasFeature(QSparqlResult::Feature f) const
@@ -117,10 +128,53 @@ class MockSyncFwOnlyResult : public QSparqlResult
     static int size_;
 };
 
+// Serves rows which leave out the variables they don't bind, like the rows
+// of a SPARQL endpoint
+class MockRowsResult : public QSparqlResult, public QSparqlResultExtension
+{
+    Q_OBJECT
+    public:
+    MockRowsResult(const QVector<QSparqlResultRow>& rows, const QStringList& variableNames)
+        : rows(rows), variableNames(variableNames)
+    {
+        setResultExtension(this);
+    }
+
+    int fetchRowBlock(int maxRows, QSparqlRowBlock *block)
+    {
+        return fetchBlockFromRows(rows, variableNames, maxRows, block);
+    }
+
+    QSparqlResultRow current() const
+    {
+        return isValid() ? rows[pos()] : QSparqlResultRow();
+    }
+
+    QSparqlBinding binding(int i) const
+    {
+        return current().binding(i);
+    }
+
+    QVariant value(int i) const
+    {
+        return current().value(i);
+    }
+
+    int size() const
+    {
+        return rows.count();
+    }
+
+    QVector<QSparqlResultRow> rows;
+    QStringList variableNames;
+};
+
 class MockDriver : public QSparqlDriver
 {
     Q_OBJECT
     public:
+    using QSparqlDriver::joinUpdates;
+
     MockDriver()
     {
     }
@@ -140,7 +194,8 @@ class MockDriver : public QSparqlDriver
     }
     bool hasFeature(QSparqlConnection::Feature f) const
     {
-        if (f == QSparqlConnection::SyncExec || f == QSparqlConnection::AsyncExec)
+        if (f == QSparqlConnection::SyncExec || f == QSparqlConnection::AsyncExec
+            || f == QSparqlConnection::UpdateQueries)
             return true;
         return false;
     }
@@ -150,6 +205,7 @@ class MockDriver : public QSparqlDriver
     }
     QSparqlResult* exec(const QString&, QSparqlQuery::StatementType, const QSparqlQueryOptions& options)
     {
+        ++execCount;
         switch(options.executionMethod()) {
         case QSparqlQueryOptions::AsyncExec:
             return new MockResult(this);
@@ -160,9 +216,23 @@ class MockDriver : public QSparqlDriver
         }
     }
 
+    QList<QSparqlResult*> execMany(const QStringList& queries, QSparqlQuery::StatementType type, const QSparqlQueryOptions& options)
+    {
+        if (!batchExec)
+            return QSparqlDriver::execMany(queries, type, options);
+        if (type == QSparqlQuery::InsertStatement || type == QSparqlQuery::DeleteStatement)
+            lastBatch = joinUpdates(queries);
+        else
+            lastBatch = queries.join("\n");
+        return splitBatchResult(exec(lastBatch, type, options), queries, type);
+    }
+
     static int openCount;
     static int closeCount;
+    static int execCount;
     static bool openRetVal;
+    static bool batchExec;
+    static QString lastBatch;
 };
 
 int MockResult::size_ = 0;
@@ -170,7 +240,10 @@ int MockSyncFwOnlyResult::size_ = 0;
 
 int MockDriver::openCount = 0;
 int MockDriver::closeCount = 0;
+int MockDriver::execCount = 0;
 bool MockDriver::openRetVal = true;
+bool MockDriver::batchExec = false;
+QString MockDriver::lastBatch;
 
 MockResult::MockResult(const MockDriver*)
     : QSparqlResult()
@@ -185,6 +258,11 @@ class MockDriverCreator : public QSparqlDriverCreatorBase
     }
 };
 
+static QString pluginIndexFileName()
+{
+    return QDir::tempPath() + QLatin1String("/tst_qsparql-sparqldrivers.index");
+}
+
 class tst_QSparql : public QObject
 {
     Q_OBJECT
@@ -206,6 +284,10 @@ private slots:
     void open_fails();
     void connection_scope();
     void drivers_list();
+    void plugin_index();
+    void cache_driver();
+    void cache_driver_invalidation();
+    void cache_driver_time_to_live();
 
     void iterate_empty_result();
     void iterate_nonempty_result();
@@ -215,6 +297,17 @@ private slots:
     void iterate_nonempty_fwonly_result();
     void iterate_nonempty_fwonly_result_first();
 
+    void fetch_block_nonempty_result();
+    void result_statistics();
+    void trace_file();
+    void fetch_block_nonempty_fwonly_result();
+    void fetch_block_unbound_variables();
+    void row_block_values();
+
+    void exec_many();
+    void exec_many_batched();
+    void exec_many_batched_updates();
+
     void default_QSparqlQueryOptions();
     void copies_of_QSparqlQueryOptions_are_equal_and_independent();
     void assignment_of_QSparqlQueryOptions_creates_equal_and_independent_copy();
@@ -242,16 +335,22 @@ void tst_QSparql::initTestCase()
     // For running the test without installing the plugins. Should work in
     // normal and vpath builds.
     QCoreApplication::addLibraryPath("../../../plugins");
+
+    // Keep the plugin index of the test away from the user's cache
+    QFile::remove(pluginIndexFileName());
+    qputenv("QSPARQL_PLUGIN_INDEX", QFile::encodeName(pluginIndexFileName()));
 }
 
 void tst_QSparql::cleanupTestCase()
 {
+    QFile::remove(pluginIndexFileName());
 }
 
 void tst_QSparql::init()
 {
     MockDriver::openCount = 0;
     MockDriver::closeCount = 0;
+    MockDriver::execCount = 0;
     MockDriver::openRetVal = true;
     MockResult::size_ = 0;
     MockSyncFwOnlyResult::size_ = 0;
@@ -307,7 +406,7 @@ void tst_QSparql::connection_scope()
 void tst_QSparql::drivers_list()
 {
     QStringList expectedDrivers;
-    expectedDrivers << "QSPARQL_ENDPOINT" << "QTRACKER" << "QTRACKER_DIRECT" << "QVIRTUOSO" << "MOCK";
+    expectedDrivers << "QSPARQL_ENDPOINT" << "QTRACKER" << "QTRACKER_DIRECT" << "QVIRTUOSO" << "QSPARQL_CACHE" << "MOCK";
 
     QStringList drivers = QSparqlConnection::drivers();
     foreach (const QString& driver, drivers) {
@@ -316,6 +415,134 @@ void tst_QSparql::drivers_list()
     }
     QVERIFY(drivers.size() >= 1);
     QVERIFY(drivers.contains("MOCK"));
+    QVERIFY(drivers.contains("QSPARQL_CACHE"));
+}
+
+void tst_QSparql::plugin_index()
+{
+    QDir pluginDir("../../../plugins/sparqldrivers");
+    const QStringList pluginNames = pluginDir.entryList(QDir::Files);
+    if (pluginNames.isEmpty()) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+        QSKIP("No driver plugins built");
+#else
+        QSKIP("No driver plugins built", SkipAll);
+#endif
+    }
+
+    // Listing the drivers indexes every plugin file found
+    QSparqlConnection::drivers();
+    QFile file(pluginIndexFileName());
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QString index = QString::fromUtf8(file.readAll());
+    // The files are indexed by the canonical path of their directory
+    const QDir canonicalDir(pluginDir.canonicalPath());
+    Q_FOREACH (const QString& pluginName, pluginNames)
+        QVERIFY(index.contains("\t" + canonicalDir.absoluteFilePath(pluginName) + "\n"));
+}
+
+void tst_QSparql::cache_driver()
+{
+    QSparqlConnectionOptions options;
+    {
+        // The cache needs a driver to fetch the results with
+        QSparqlConnection conn("QSPARQL_CACHE", options);
+        QVERIFY(conn.hasError());
+    }
+
+    options.setOption("cacheDriver", "MOCK");
+    QSparqlConnection conn("QSPARQL_CACHE", options);
+    QVERIFY(!conn.hasError());
+    QCOMPARE(MockDriver::openCount, 1);
+
+    QSparqlQueryOptions syncOptions;
+    syncOptions.setExecutionMethod(QSparqlQueryOptions::SyncExec);
+    MockSyncFwOnlyResult::size_ = 3;
+
+    QSparqlResult* res = conn.exec(QSparqlQuery("foo"), syncOptions);
+    QVERIFY(!res->hasError());
+    QVERIFY(res->isFinished());
+    QCOMPARE(res->size(), 3);
+    QCOMPARE(MockDriver::execCount, 1);
+    delete res;
+
+    // Served from the cache, synchronously...
+    res = conn.exec(QSparqlQuery("foo"), syncOptions);
+    QCOMPARE(MockDriver::execCount, 1);
+    QVERIFY(res->isFinished());
+    int rows = 0;
+    while (res->next())
+        ++rows;
+    QCOMPARE(rows, 3);
+    delete res;
+
+    // ... or from the event loop
+    res = conn.exec(QSparqlQuery("foo"));
+    QCOMPARE(MockDriver::execCount, 1);
+    QSignalSpy spy(res, SIGNAL(finished()));
+    QVERIFY(!res->isFinished());
+    QTest::qWait(10);
+    QCOMPARE(spy.count(), 1);
+    QVERIFY(res->isFinished());
+    QCOMPARE(res->size(), 3);
+    delete res;
+
+    // Other queries are not
+    delete conn.exec(QSparqlQuery("bar"), syncOptions);
+    QCOMPARE(MockDriver::execCount, 2);
+}
+
+void tst_QSparql::cache_driver_invalidation()
+{
+    QSparqlConnectionOptions options;
+    options.setOption("cacheDriver", "MOCK");
+    QSparqlConnection conn("QSPARQL_CACHE", options);
+
+    QSparqlQueryOptions untagged;
+    untagged.setExecutionMethod(QSparqlQueryOptions::SyncExec);
+    QSparqlQueryOptions tagA(untagged);
+    tagA.setCacheTags(QStringList() << "graphA");
+    QSparqlQueryOptions tagB(untagged);
+    tagB.setCacheTags(QStringList() << "graphB");
+
+    delete conn.exec(QSparqlQuery("untagged"), untagged);
+    delete conn.exec(QSparqlQuery("a"), tagA);
+    delete conn.exec(QSparqlQuery("b"), tagB);
+    QCOMPARE(MockDriver::execCount, 3);
+
+    // An update drops the results with its tags and the untagged ones
+    delete conn.exec(QSparqlQuery("insert a", QSparqlQuery::InsertStatement), tagA);
+    QCOMPARE(MockDriver::execCount, 4);
+    delete conn.exec(QSparqlQuery("b"), tagB);
+    QCOMPARE(MockDriver::execCount, 4);
+    delete conn.exec(QSparqlQuery("a"), tagA);
+    QCOMPARE(MockDriver::execCount, 5);
+    delete conn.exec(QSparqlQuery("untagged"), untagged);
+    QCOMPARE(MockDriver::execCount, 6);
+
+    // An update without tags drops everything
+    delete conn.exec(QSparqlQuery("delete", QSparqlQuery::DeleteStatement), untagged);
+    QCOMPARE(MockDriver::execCount, 7);
+    delete conn.exec(QSparqlQuery("b"), tagB);
+    QCOMPARE(MockDriver::execCount, 8);
+}
+
+void tst_QSparql::cache_driver_time_to_live()
+{
+    QSparqlConnectionOptions options;
+    options.setOption("cacheDriver", "MOCK");
+    options.setOption("cacheTimeToLive", 50);
+    QSparqlConnection conn("QSPARQL_CACHE", options);
+
+    QSparqlQueryOptions syncOptions;
+    syncOptions.setExecutionMethod(QSparqlQueryOptions::SyncExec);
+    delete conn.exec(QSparqlQuery("foo"), syncOptions);
+    delete conn.exec(QSparqlQuery("foo"), syncOptions);
+    QCOMPARE(MockDriver::execCount, 1);
+
+    QTest::qWait(100);
+    delete conn.exec(QSparqlQuery("foo"), syncOptions);
+    QCOMPARE(MockDriver::execCount, 2);
 }
 
 void tst_QSparql::iterate_empty_result()
@@ -454,6 +681,261 @@ void tst_QSparql::iterate_nonempty_fwonly_result_first()
     QCOMPARE(res->pos(), 0);
 }
 
+void tst_QSparql::result_statistics()
+{
+    QSparqlConnection conn("MOCK");
+    QSparqlResult* res = conn.syncExec(QSparqlQuery("foo"));
+    QVERIFY(!res->hasError());
+    MockSyncFwOnlyResult::size_ = 3;
+
+    QSparqlResultStatistics stats = res->statistics();
+    QVERIFY(stats.queueTime() >= 0);
+    QVERIFY(stats.executeTime() >= 0);
+    QCOMPARE(stats.timeToFirstRow(), Q_INT64_C(-1));
+    QCOMPARE(stats.fetchTime(), Q_INT64_C(-1));
+    QCOMPARE(stats.rowCount(), 0);
+    // The mock doesn't use the network
+    QCOMPARE(stats.bytesReceived(), Q_INT64_C(-1));
+
+    while (res->next())
+        ;
+    stats = res->statistics();
+    QCOMPARE(stats.rowCount(), 3);
+    QVERIFY(stats.timeToFirstRow() >= stats.queueTime());
+    QVERIFY(stats.fetchTime() >= 0);
+    QVERIFY(stats.decodeTime() >= 0);
+    QCOMPARE(stats.bytesReceived(), Q_INT64_C(-1));
+
+    // The statistics are a snapshot
+    QSparqlResultStatistics copy = stats;
+    copy.setRowCount(10);
+    QCOMPARE(stats.rowCount(), 3);
+    QCOMPARE(res->statistics().rowCount(), 3);
+    delete res;
+}
+
+void tst_QSparql::trace_file()
+{
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    const QString fileName = file.fileName();
+    file.close();
+
+    QSparqlConnectionOptions options;
+    options.setOption("traceFile", fileName);
+    {
+        QSparqlConnection conn("MOCK", options);
+        QVERIFY(QSparqlTracer::isEnabled());
+        QSparqlResult* res = conn.exec(QSparqlQuery("SELECT \"quoted\" {}"));
+        QVERIFY(!res->hasError());
+        delete res;
+        QSparqlTracer::instant("marker");
+    }
+    QSparqlTracer::stop();
+    QVERIFY(!QSparqlTracer::isEnabled());
+
+    QFile trace(fileName);
+    QVERIFY(trace.open(QIODevice::ReadOnly));
+    const QByteArray data = trace.readAll().trimmed();
+    QVERIFY(data.startsWith('['));
+    QVERIFY(data.endsWith(']'));
+    QVERIFY(data.contains("\"name\":\"QSparqlConnection::exec\",\"cat\":\"qsparql\",\"ph\":\"X\""));
+    QVERIFY(data.contains("\"name\":\"marker\""));
+    QVERIFY(data.contains("\"name\":\"thread_name\""));
+    // The query text is escaped
+    QVERIFY(data.contains("SELECT \\\"quoted\\\" {}"));
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    QJsonParseError error;
+    QJsonDocument::fromJson(data, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+#endif
+}
+
+void tst_QSparql::fetch_block_nonempty_result()
+{
+    QSparqlConnection conn("MOCK");
+    QSparqlResult* res = conn.exec(QSparqlQuery("foo"));
+    QVERIFY(!res->hasError());
+    MockResult::size_ = 5;
+    QSparqlRowBlock block;
+    QCOMPARE(res->fetchBlock(3, &block), 3);
+    QCOMPARE(block.rowCount(), 3);
+    QCOMPARE(res->pos(), 2);
+    // Only 2 rows are left; the result ends up after the last row
+    QCOMPARE(res->fetchBlock(3, &block), 2);
+    QCOMPARE(block.rowCount(), 2);
+    QVERIFY(res->pos() == QSparql::AfterLastRow);
+    QCOMPARE(res->fetchBlock(3, &block), 0);
+    QVERIFY(block.isEmpty());
+    QVERIFY(res->pos() == QSparql::AfterLastRow);
+    delete res;
+}
+
+void tst_QSparql::fetch_block_nonempty_fwonly_result()
+{
+    QSparqlConnection conn("MOCK");
+    QSparqlResult* res = conn.syncExec(QSparqlQuery("foo"));
+    QVERIFY(!res->hasError());
+    MockSyncFwOnlyResult::size_ = 3;
+    QSparqlRowBlock block;
+    QCOMPARE(res->fetchBlock(2, &block), 2);
+    QCOMPARE(res->pos(), 1);
+    QCOMPARE(res->fetchBlock(2, &block), 1);
+    QCOMPARE(block.rowCount(), 1);
+    QVERIFY(res->pos() == QSparql::AfterLastRow);
+    delete res;
+}
+
+static QSparqlResultRow mockRow(const QStringList& names, const QVariantList& values)
+{
+    QSparqlResultRow row;
+    for (int i = 0; i < names.count(); ++i)
+        row.append(QSparqlBinding(names[i], values[i]));
+    return row;
+}
+
+void tst_QSparql::fetch_block_unbound_variables()
+{
+    QVector<QSparqlResultRow> rows;
+    rows << mockRow(QStringList() << "s" << "label", QVariantList() << 1 << "one")
+         << mockRow(QStringList() << "s" << "comment", QVariantList() << 2 << "two")
+         << mockRow(QStringList() << "comment" << "s", QVariantList() << "three" << 3);
+
+    // With the variables of the result, the values are placed by name
+    MockRowsResult withHead(rows, QStringList() << "s" << "label" << "comment");
+    QSparqlRowBlock block;
+    QCOMPARE(withHead.fetchBlock(10, &block), 3);
+    QCOMPARE(block.variableNames(), QStringList() << "s" << "label" << "comment");
+    QCOMPARE(block.value(0, 0), QVariant(1));
+    QCOMPARE(block.value(0, 1), QVariant("one"));
+    QVERIFY(!block.value(0, 2).isValid());
+    QCOMPARE(block.value(1, 0), QVariant(2));
+    QVERIFY(!block.value(1, 1).isValid());
+    QCOMPARE(block.value(1, 2), QVariant("two"));
+    QCOMPARE(block.value(2, 0), QVariant(3));
+    QVERIFY(!block.value(2, 1).isValid());
+    QCOMPARE(block.value(2, 2), QVariant("three"));
+
+    // Without them, the columns are the variables bound by the rows
+    MockRowsResult withoutHead(rows, QStringList());
+    withoutHead.next();
+    QCOMPARE(withoutHead.fetchBlock(10, &block), 2);
+    QCOMPARE(block.variableNames(), QStringList() << "s" << "comment");
+    QCOMPARE(block.value(0, 0), QVariant(2));
+    QCOMPARE(block.value(0, 1), QVariant("two"));
+    QCOMPARE(block.value(1, 0), QVariant(3));
+    QCOMPARE(block.value(1, 1), QVariant("three"));
+}
+
+void tst_QSparql::row_block_values()
+{
+    QSparqlRowBlock block;
+    block.setVariableNames(QStringList() << "a" << "b");
+    QCOMPARE(block.columnCount(), 2);
+
+    QVariant row1[] = { QVariant(1), QVariant("x") };
+    QVariant row2[] = { QVariant(2) };
+    block.appendRow(row1, 2);
+    // Short rows are padded with invalid values
+    block.appendRow(row2, 1);
+    QCOMPARE(block.rowCount(), 2);
+    QCOMPARE(block.variableName(1), QString("b"));
+    QCOMPARE(block.value(0, 0), QVariant(1));
+    QCOMPARE(block.value(0, 1), QVariant("x"));
+    QCOMPARE(block.rowData(1)[0], QVariant(2));
+    QVERIFY(!block.value(1, 1).isValid());
+    QVERIFY(!block.value(2, 0).isValid());
+    QVERIFY(block.rowData(2) == 0);
+
+    // Copies are independent
+    QSparqlRowBlock copy(block);
+    block.clear();
+    QVERIFY(block.isEmpty());
+    QCOMPARE(block.columnCount(), 2);
+    QCOMPARE(copy.rowCount(), 2);
+}
+
+void tst_QSparql::exec_many()
+{
+    QSparqlConnection conn("MOCK");
+    QVector<QSparqlResultRow> rows;
+    for (int i = 0; i < 3; ++i) {
+        QSparqlResultRow row;
+        row.append(QSparqlBinding("x", i));
+        rows.append(row);
+    }
+    QList<QSparqlResult*> results = conn.execMany(QSparqlQuery("select ?:x {}"), rows);
+    QCOMPARE(results.count(), 3);
+    Q_FOREACH (QSparqlResult* res, results) {
+        QVERIFY(!res->hasError());
+        QVERIFY(res->parent() == &conn);
+    }
+    qDeleteAll(results);
+
+    QVERIFY(conn.execMany(QSparqlQuery("select ?:x {}"), QVector<QSparqlResultRow>()).isEmpty());
+
+    // An empty query is reported for each row, the same way as exec() does
+    results = conn.execMany(QSparqlQuery(), rows);
+    QCOMPARE(results.count(), 3);
+    Q_FOREACH (QSparqlResult* res, results)
+        QCOMPARE(res->lastError().type(), QSparqlError::StatementError);
+    qDeleteAll(results);
+}
+
+void tst_QSparql::exec_many_batched()
+{
+    MockDriver::batchExec = true;
+    QSparqlConnection conn("MOCK");
+    QVector<QSparqlResultRow> rows;
+    for (int i = 0; i < 2; ++i) {
+        QSparqlResultRow row;
+        row.append(QSparqlBinding("x", i));
+        rows.append(row);
+    }
+    QList<QSparqlResult*> results =
+        conn.execMany(QSparqlQuery("select ?s { ?s <b> ?:x }"), rows);
+    MockDriver::batchExec = false;
+
+    QCOMPARE(results.count(), 2);
+    QCOMPARE(results[0]->query(), QString("select ?s { ?s <b> 0 }"));
+    QCOMPARE(results[1]->query(), QString("select ?s { ?s <b> 1 }"));
+    QVERIFY(results[1]->parent() == &conn);
+    // The batch result is deleted with the last of the results
+    qDeleteAll(results);
+}
+
+void tst_QSparql::exec_many_batched_updates()
+{
+    MockDriver::batchExec = true;
+    QSparqlConnection conn("MOCK");
+    QVector<QSparqlResultRow> rows;
+    for (int i = 0; i < 3; ++i) {
+        QSparqlResultRow row;
+        row.append(QSparqlBinding("x", i));
+        rows.append(row);
+    }
+    // The prologue of each row is declared once, before the operations
+    QSparqlQuery query("PREFIX ex: <http://example.org/> PREFIX : <http://example.org/default/>\n"
+                       "INSERT { :a ex:value ?:x } ;",
+                       QSparqlQuery::InsertStatement);
+    QList<QSparqlResult*> results = conn.execMany(query, rows);
+    QCOMPARE(results.count(), 3);
+    QCOMPARE(MockDriver::lastBatch,
+             QString("PREFIX ex: <http://example.org/>\n"
+                     "PREFIX : <http://example.org/default/>\n"
+                     "INSERT { :a ex:value 0 };\n"
+                     "INSERT { :a ex:value 1 };\n"
+                     "INSERT { :a ex:value 2 }"));
+    qDeleteAll(results);
+
+    // Prefixes declared differently can't share a prologue
+    QStringList conflicting;
+    conflicting << "PREFIX ex: <http://example.org/a#> INSERT { ex:a ex:b 1 }"
+                << "PREFIX ex: <http://example.org/b#> INSERT { ex:a ex:b 2 }";
+    QVERIFY(MockDriver::joinUpdates(conflicting).isEmpty());
+    MockDriver::batchExec = false;
+}
+
 void tst_QSparql::default_QSparqlQueryOptions()
 {
     QSparqlQueryOptions opt;
@@ -0,0 +1,21 @@
+include(../sparqltest.pri)
+CONFIG += qt warn_on console depend_includepath
+QT += testlib xml network
+
+INCLUDEPATH += ../qsparql_endpoint
+HEADERS += ../qsparql_endpoint/EndpointServer.h \
+           ../utils/benchmarkreport.h \
+           ../utils/memorynetworkaccessmanager.h \
+           ../utils/syntheticdriver.h
+SOURCES += tst_qsparql_allocation_benchmark.cpp \
+           ../qsparql_endpoint/EndpointServer.cpp \
+           ../utils/benchmarkreport.cpp \
+           ../utils/memorynetworkaccessmanager.cpp \
+           ../utils/syntheticdriver.cpp
+
+check.depends = $$TARGET
+check.commands = ./tst_qsparql_allocation_benchmark
+
+QMAKE_EXTRA_TARGETS += check
+
+#QT = sparql # enable this later
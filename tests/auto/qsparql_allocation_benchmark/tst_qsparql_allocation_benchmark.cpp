@@ -0,0 +1,357 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the test suite of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "EndpointServer.h"
+#include "../utils/benchmarkreport.h"
+#include "../utils/memorynetworkaccessmanager.h"
+#include "../utils/syntheticdriver.h"
+
+#include <QtTest/QtTest>
+#include <QtSparql>
+
+#include <stdio.h>
+
+static const int runs = 5;
+
+// The allocations are counted by replacing malloc and friends in the test
+// executable, which the dynamic linker prefers over the ones in libc for
+// every library. The replacements call the glibc implementations, so this
+// only works with glibc.
+#if defined(__GLIBC__)
+#define COUNT_ALLOCATIONS
+#include <errno.h>
+#include <malloc.h>
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace {
+
+volatile int counting = 0;
+long allocationCount = 0;
+long allocatedBytes = 0;
+long liveBytes = 0;
+long peakLiveBytes = 0;
+
+inline void recordAllocation(void* ptr)
+{
+    if (!ptr || !counting)
+        return;
+    const long size = malloc_usable_size(ptr);
+    __sync_fetch_and_add(&allocationCount, 1);
+    __sync_fetch_and_add(&allocatedBytes, size);
+    const long live = __sync_add_and_fetch(&liveBytes, size);
+    // Not exact when several threads allocate at once, which is rare here
+    if (live > peakLiveBytes)
+        peakLiveBytes = live;
+}
+
+inline void recordFree(void* ptr)
+{
+    if (ptr && counting)
+        __sync_fetch_and_sub(&liveBytes, long(malloc_usable_size(ptr)));
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size)
+{
+    void* ptr = __libc_malloc(size);
+    recordAllocation(ptr);
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size)
+{
+    void* ptr = __libc_calloc(count, size);
+    recordAllocation(ptr);
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    recordFree(ptr);
+    void* result = __libc_realloc(ptr, size);
+    recordAllocation(result);
+    return result;
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size)
+{
+    void* ptr = __libc_memalign(alignment, size);
+    if (!ptr)
+        return ENOMEM;
+    recordAllocation(ptr);
+    *result = ptr;
+    return 0;
+}
+
+void free(void* ptr)
+{
+    recordFree(ptr);
+    __libc_free(ptr);
+}
+
+} // extern "C"
+#endif // __GLIBC__
+
+// What was allocated between start() and stop(). Blocks allocated before
+// start() and freed while counting make netBytes smaller.
+struct AllocationCount
+{
+    qint64 allocations;
+    qint64 bytes;
+    qint64 netBytes;
+    qint64 peakBytes;
+
+    void start()
+    {
+#ifdef COUNT_ALLOCATIONS
+        allocationCount = allocatedBytes = liveBytes = peakLiveBytes = 0;
+        counting = 1;
+#endif
+    }
+
+    void stop()
+    {
+#ifdef COUNT_ALLOCATIONS
+        counting = 0;
+        allocations = allocationCount;
+        bytes = allocatedBytes;
+        netBytes = liveBytes;
+        peakBytes = peakLiveBytes;
+#else
+        allocations = bytes = netBytes = peakBytes = 0;
+#endif
+    }
+};
+
+class tst_QSparqlAllocationBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_QSparqlAllocationBenchmark();
+    virtual ~tst_QSparqlAllocationBenchmark();
+
+public slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+private slots:
+    void allocations_data();
+    void allocations();
+
+private:
+    BenchmarkReport report;
+};
+
+tst_QSparqlAllocationBenchmark::tst_QSparqlAllocationBenchmark()
+    : report("allocation", "allocation counts")
+{
+}
+
+tst_QSparqlAllocationBenchmark::~tst_QSparqlAllocationBenchmark()
+{
+}
+
+void tst_QSparqlAllocationBenchmark::initTestCase()
+{
+#ifndef COUNT_ALLOCATIONS
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+    QSKIP("Counting allocations needs glibc");
+#else
+    QSKIP("Counting allocations needs glibc", SkipAll);
+#endif
+#endif
+    registerSyntheticDriver();
+
+    // For running the test without installing the plugins. Should work in
+    // normal and vpath builds.
+    QCoreApplication::addLibraryPath("../../../plugins");
+}
+
+void tst_QSparqlAllocationBenchmark::cleanupTestCase()
+{
+    const QString fileName = report.save();
+    if (!fileName.isEmpty())
+        qDebug() << "Report saved in" << fileName;
+}
+
+void tst_QSparqlAllocationBenchmark::allocations_data()
+{
+    QTest::addColumn<QString>("driver");
+    QTest::addColumn<QString>("format");
+    QTest::addColumn<QString>("columns");
+    QTest::addColumn<QString>("query");
+
+    // Row shapes for the drivers which get their data generated
+    const char* shapes[][2] = {
+        { "1-uri", "uri" },
+        { "3-mixed", "uri,string,integer" },
+        { "4-typed", "uri,bnode,langstring,datetime" },
+        { "8-strings", "string,string,string,string,string,string,string,string" }
+    };
+    for (unsigned int i = 0; i < sizeof(shapes) / sizeof(shapes[0]); ++i) {
+        const QString shape = shapes[i][0];
+        const QString columns = shapes[i][1];
+        QTest::newRow(qPrintable("endpoint-xml-" + shape))
+            << "QSPARQL_ENDPOINT" << "xml" << columns << QString();
+        QTest::newRow(qPrintable("endpoint-ntriples-" + shape))
+            << "QSPARQL_ENDPOINT" << "ntriples" << columns << QString();
+        QTest::newRow(qPrintable("synthetic-" + shape))
+            << "QSPARQL_SYNTHETIC" << QString() << columns << QString();
+    }
+
+    // The Tracker drivers read whatever is in the store; the test is skipped
+    // if there is no store
+    const char* trackerQueries[][2] = {
+        { "1-uri", "SELECT ?u WHERE { ?u a rdfs:Resource } LIMIT 2000" },
+        { "2-uri", "SELECT ?u ?t WHERE { ?u a ?t } LIMIT 2000" },
+        { "3-mixed", "SELECT ?u ?t ?added WHERE { ?u a ?t ; tracker:added ?added } LIMIT 2000" }
+    };
+    for (unsigned int i = 0; i < sizeof(trackerQueries) / sizeof(trackerQueries[0]); ++i) {
+        const QString shape = trackerQueries[i][0];
+        QTest::newRow(qPrintable("tracker_direct-" + shape))
+            << "QSPARQL_TRACKER_DIRECT" << QString() << QString() << trackerQueries[i][1];
+        QTest::newRow(qPrintable("tracker-" + shape))
+            << "QSPARQL_TRACKER" << QString() << QString() << trackerQueries[i][1];
+    }
+}
+
+void tst_QSparqlAllocationBenchmark::allocations()
+{
+    // Allocations and bytes per row while executing a query and storing its
+    // rows, compared with the estimate of QSparqlResult::memoryUsage()
+    QFETCH(QString, driver);
+    QFETCH(QString, format);
+    QFETCH(QString, columns);
+    QFETCH(QString, query);
+
+    const int rows = 5000;
+    QSparqlConnectionOptions options;
+    QScopedPointer<MemoryNetworkAccessManager> manager;
+    if (driver == "QSPARQL_ENDPOINT") {
+        const QByteArray data = EndpointServer::generateResults(format, rows, columns.split(','));
+        manager.reset(new MemoryNetworkAccessManager(data, EndpointServer::contentType(format)));
+        options.setHostName("localhost");
+        options.setNetworkAccessManager(manager.data());
+    } else if (driver == "QSPARQL_SYNTHETIC") {
+        options.setOption("rows", rows);
+        options.setOption("columns", columns);
+    }
+    if (query.isEmpty())
+        query = format == "ntriples" ? "CONSTRUCT { ?s ?p ?o } WHERE { ?s ?p ?o }"
+                                     : "SELECT * WHERE { ?s ?p ?o }";
+    const QSparqlQuery q(query, format == "ntriples" ? QSparqlQuery::ConstructStatement
+                                                     : QSparqlQuery::SelectStatement);
+
+    QSparqlConnection conn(driver, options);
+    if (!conn.isValid())
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+        QSKIP("The driver is not available");
+#else
+        QSKIP("The driver is not available", SkipSingle);
+#endif
+
+    // A first run, so that what is allocated only once (the driver, pools
+    // and caches in Qt) isn't counted
+    QSparqlResult* warmup = conn.exec(q);
+    warmup->waitForFinished();
+    const bool failed = warmup->hasError() || warmup->size() <= 0;
+    delete warmup;
+    if (failed)
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+        QSKIP("The query failed or returned no rows");
+#else
+        QSKIP("The query failed or returned no rows", SkipSingle);
+#endif
+
+    QList<qint64> allocations;
+    QList<qint64> bytes;
+    QList<qint64> peakBytes;
+    QList<qint64> netBytes;
+    QList<qint64> estimates;
+    int count = 0;
+    for (int run = 0; run < runs; ++run) {
+        AllocationCount counter;
+        counter.start();
+        QSparqlResult* r = conn.exec(q);
+        r->waitForFinished();
+        counter.stop();
+
+        QVERIFY(!r->hasError());
+        count = r->size();
+        QVERIFY(count > 0);
+        allocations << counter.allocations;
+        bytes << counter.bytes;
+        peakBytes << counter.peakBytes;
+        netBytes << counter.netBytes;
+        estimates << r->memoryUsage();
+        delete r;
+    }
+
+    const QString name = "alloc-" + QString(QTest::currentDataTag());
+    report.addResult(name + "-allocations", allocations);
+    report.addResult(name + "-bytes", bytes);
+    report.addResult(name + "-peak-bytes", peakBytes);
+    report.addResult(name + "-net-bytes", netBytes);
+    report.addResult(name + "-estimate", estimates);
+
+    qSort(allocations);
+    qSort(bytes);
+    qSort(netBytes);
+    qSort(estimates);
+    const int median = runs / 2;
+    fprintf(stderr, "%-40s %d rows: %.1f allocations, %.0f bytes allocated, "
+            "%.0f bytes kept, %.0f bytes estimated per row\n",
+            qPrintable(name), count, double(allocations[median]) / count,
+            double(bytes[median]) / count, double(netBytes[median]) / count,
+            double(estimates[median]) / count);
+}
+
+QTEST_MAIN(tst_QSparqlAllocationBenchmark)
+#include "tst_qsparql_allocation_benchmark.moc"
@@ -1,6 +1,6 @@
 include(../sparqltest.pri)
 CONFIG += qt warn_on console depend_includepath
-QT += testlib
+QT += testlib dbus
 SOURCES  += tst_qsparql_api.cpp
 
 check.depends = $$TARGET
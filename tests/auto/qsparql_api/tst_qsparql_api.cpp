@@ -39,6 +39,7 @@
 
 #include <QtTest/QtTest>
 #include <QtSparql>
+#include <QtDBus/QtDBus>
 
 #include "../messagerecorder.h"
 #include "../testhelpers.h"
@@ -93,6 +94,12 @@ private slots:
     void queryModel_test();
     void queryModel_test_data();
 
+    void queryModel_paging_test();
+    void queryModel_paging_test_data();
+
+    void queryModel_live_test();
+    void queryModel_live_test_data();
+
     void syncExec_waitForFinished_query_test();
     void syncExec_waitForFinished_query_test_data();
 
@@ -123,6 +130,33 @@ private:
     bool testEndpoint;
 };
 
+// A (graph, subject, predicate, object) of the GraphUpdated signal
+struct TrackerQuad
+{
+    int graph;
+    int subject;
+    int predicate;
+    int object;
+};
+Q_DECLARE_METATYPE(TrackerQuad)
+Q_DECLARE_METATYPE(QList<TrackerQuad>)
+
+QDBusArgument& operator<<(QDBusArgument& argument, const TrackerQuad& quad)
+{
+    argument.beginStructure();
+    argument << quad.graph << quad.subject << quad.predicate << quad.object;
+    argument.endStructure();
+    return argument;
+}
+
+const QDBusArgument& operator>>(const QDBusArgument& argument, TrackerQuad& quad)
+{
+    argument.beginStructure();
+    argument >> quad.graph >> quad.subject >> quad.predicate >> quad.object;
+    argument.endStructure();
+    return argument;
+}
+
 namespace {
 
 const QString contactSelectQueryTemplate =
@@ -1558,6 +1592,193 @@ void tst_QSparqlAPI::queryModel_test_data()
     }
 }
 
+void tst_QSparqlAPI::queryModel_paging_test()
+{
+    QFETCH(QString, connectionDriver);
+    QFETCH(QString, query);
+    QFETCH(int, expectedResultsSize);
+
+    const QString orderedQuery = query + " ORDER BY ?u";
+    QSparqlConnectionOptions options = getConnectionOptions(connectionDriver);
+    QSparqlConnection conn(connectionDriver, options);
+    QSparqlQueryModel model;
+    model.setPageSize(2);
+    model.setMaximumPages(2);
+    QCOMPARE(model.pageSize(), 2);
+    QCOMPARE(model.maximumPages(), 2);
+
+    model.setQuery(QSparqlQuery(orderedQuery), conn);
+
+    // finished() is emitted when the first page has arrived; the COUNT query
+    // finishes soon after
+    FinishedSignalReceiver signalReceiver;
+    signalReceiver.connectFinished(&model);
+    signalReceiver.waitForFinished(2000);
+    signalReceiver.ensureOneFinishedReceived(100);
+    QTime timeoutTimer;
+    timeoutTimer.start();
+    while (model.rowCount() < expectedResultsSize && timeoutTimer.elapsed() < 2000) {
+        if (model.canFetchMore())
+            model.fetchMore();
+        else
+            QTest::qWait(20);
+    }
+
+    QCOMPARE(model.rowCount(), expectedResultsSize);
+    QCOMPARE(model.columnCount(), contactSelectColumnCount);
+
+    QSparqlResult *r = conn.syncExec(QSparqlQuery(orderedQuery));
+    int row = 0;
+    while (r->next()) {
+        // Rows of pages which are not kept are fetched again
+        timeoutTimer.restart();
+        QModelIndex index = model.index(row, 1);
+        while (!model.data(index).isValid() && timeoutTimer.elapsed() < 2000)
+            QTest::qWait(20);
+        QCOMPARE(model.data(model.index(row, 0)).toString(), r->value(0).toString());
+        QCOMPARE(model.data(index).toString(), r->value(1).toString());
+        ++row;
+    }
+    QCOMPARE(row, expectedResultsSize);
+
+    delete r;
+}
+
+void tst_QSparqlAPI::queryModel_paging_test_data()
+{
+    queryModel_test_data();
+}
+
+namespace {
+
+const QString personContactClass =
+    "http://www.semanticdesktop.org/ontologies/2007/03/22/nco#PersonContact";
+
+int trackerId(QSparqlConnection& conn, const QString& uri)
+{
+    QSparqlResult* r = conn.syncExec(QSparqlQuery(QString("select tracker:id(<%1>) {}").arg(uri)));
+    const int id = r->next() ? r->value(0).toInt() : 0;
+    delete r;
+    return id;
+}
+
+// Emits the signal of the store as if the resource had been inserted; the
+// live model doesn't match the sender
+void emitGraphUpdated(const QString& classIri, int subject)
+{
+    TrackerQuad quad = { 0, subject, 0, 0 };
+    QDBusMessage signal = QDBusMessage::createSignal("/org/freedesktop/Tracker1/Resources",
+                                                     "org.freedesktop.Tracker1.Resources",
+                                                     "GraphUpdated");
+    signal << classIri << QVariant::fromValue(QList<TrackerQuad>())
+           << QVariant::fromValue(QList<TrackerQuad>() << quad);
+    QVERIFY(QDBusConnection::sessionBus().send(signal));
+}
+
+void execUpdate(QSparqlConnection& conn, const QString& update)
+{
+    QSparqlResult* r = conn.syncExec(QSparqlQuery(update, QSparqlQuery::InsertStatement));
+    QVERIFY(!r->hasError());
+    delete r;
+}
+
+} // namespace
+
+void tst_QSparqlAPI::queryModel_live_test()
+{
+    QFETCH(QString, connectionDriver);
+    QFETCH(QString, query);
+    QFETCH(int, expectedResultsSize);
+
+    qDBusRegisterMetaType<TrackerQuad>();
+    qDBusRegisterMetaType<QList<TrackerQuad> >();
+
+    QSparqlConnection conn(connectionDriver);
+    QSparqlQueryModel model;
+    model.setKeyColumn("u");
+    model.setLive(true);
+    QVERIFY(model.isLive());
+    model.setQuery(QSparqlQuery(query), conn);
+
+    FinishedSignalReceiver signalReceiver;
+    signalReceiver.connectFinished(&model);
+    signalReceiver.waitForFinished(2000);
+    QCOMPARE(model.rowCount(), expectedResultsSize);
+
+    QSignalSpy resetSpy(&model, SIGNAL(modelReset()));
+    QSignalSpy changedSpy(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+    QSignalSpy insertedSpy(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy startedSpy(&model, SIGNAL(started()));
+
+    // A changed resource only fetches its own rows. The store emits the
+    // signal too when it's running; the changes are collected for a moment.
+    execUpdate(conn, "delete { <uri001> nco:nameGiven ?ng } where { <uri001> nco:nameGiven ?ng } "
+                     "insert { <uri001> nco:nameGiven \"live001\" }");
+    emitGraphUpdated(personContactClass, trackerId(conn, "uri001"));
+    int row = -1;
+    for (int i = 0; i < model.rowCount(); ++i) {
+        if (model.data(model.index(i, 0)).toString() == "uri001")
+            row = i;
+    }
+    QVERIFY(row >= 0);
+    QTime timeoutTimer;
+    timeoutTimer.start();
+    while (model.data(model.index(row, 1)).toString() != "live001" && timeoutTimer.elapsed() < 2000)
+        QTest::qWait(20);
+    QCOMPARE(model.data(model.index(row, 1)).toString(), QString("live001"));
+    QVERIFY(changedSpy.count() >= 1);
+    QCOMPARE(startedSpy.count(), 0);
+
+    // A new resource is appended
+    execUpdate(conn, "insert { <uri0099> a nco:PersonContact ; "
+                     "nie:isLogicalPartOf <qsparql-api-tests> ; nco:nameGiven \"name0099\" }");
+    emitGraphUpdated(personContactClass, trackerId(conn, "uri0099"));
+    timeoutTimer.restart();
+    while (model.rowCount() == expectedResultsSize && timeoutTimer.elapsed() < 2000)
+        QTest::qWait(20);
+    QCOMPARE(model.rowCount(), expectedResultsSize + 1);
+    QCOMPARE(model.data(model.index(expectedResultsSize, 0)).toString(), QString("uri0099"));
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(startedSpy.count(), 0);
+
+    // A deleted resource can't be mapped to its rows, so the whole query is
+    // executed again, and the keyed model removes the row
+    const int deletedId = trackerId(conn, "uri0099");
+    execUpdate(conn, "delete { <uri0099> a rdfs:Resource }");
+    emitGraphUpdated(personContactClass, deletedId);
+    timeoutTimer.restart();
+    while (model.rowCount() > expectedResultsSize && timeoutTimer.elapsed() < 2000)
+        QTest::qWait(20);
+    QCOMPARE(model.rowCount(), expectedResultsSize);
+    QVERIFY(startedSpy.count() >= 1);
+    QCOMPARE(resetSpy.count(), 0);
+
+    // Turning the live mode off stops following the store
+    model.setLive(false);
+    execUpdate(conn, "delete { <uri001> nco:nameGiven ?ng } where { <uri001> nco:nameGiven ?ng } "
+                     "insert { <uri001> nco:nameGiven \"name001\" }");
+    emitGraphUpdated(personContactClass, trackerId(conn, "uri001"));
+    QTest::qWait(500);
+    QCOMPARE(model.data(model.index(row, 1)).toString(), QString("live001"));
+}
+
+void tst_QSparqlAPI::queryModel_live_test_data()
+{
+    QTest::addColumn<QString>("connectionDriver");
+    QTest::addColumn<QString>("query");
+    QTest::addColumn<int>("expectedResultsSize");
+
+    QTest::newRow("Tracker Direct Live")
+        << "QTRACKER_DIRECT"
+        << contactSelectQueryTemplate.arg("")
+        << NUM_INSERTS;
+
+    QTest::newRow("DBus Live")
+        << "QTRACKER"
+        << contactSelectQueryTemplate.arg("")
+        << NUM_INSERTS;
+}
+
 void tst_QSparqlAPI::syncExec_waitForFinished_query_test()
 {
     QFETCH(QString, connectionDriver);
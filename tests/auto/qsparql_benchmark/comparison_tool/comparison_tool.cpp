@@ -46,6 +46,366 @@
 #include <QDomDocument>
 #include <QDomNode>
 #include <QDomNodeList>
+#include <QDateTime>
+#include <QFileInfo>
+
+#include <stdio.h>
+
+// Tests with fewer repeated runs than this, in the current results or in the
+// baseline, are never reported as regressions
+static const int minimumRuns = 3;
+
+struct Options
+{
+    Options() : confidence(0.95), threshold(5.0), resamples(2000), updateBaseline(false) {}
+    QString dirPath;
+    QString baselinePath;
+    QString jsonPath;
+    double confidence;      // of the bootstrap intervals
+    double threshold;       // smallest change of the median reported, in percent
+    int resamples;
+    bool updateBaseline;
+};
+
+// The repeated runs of a test in the newest results, compared to the runs
+// in the baseline
+struct TestComparison
+{
+    TestComparison() : median(0), low(0), high(0), baselineMedian(0),
+                       change(0), changeLow(0), changeHigh(0) {}
+    QString name;
+    QList<double> samples;
+    QList<double> baselineSamples;
+    double median, low, high;
+    double baselineMedian;
+    // Relative change of the median from the baseline, and its interval
+    double change, changeLow, changeHigh;
+    QString status;
+};
+
+// A small deterministic generator (xorshift64), so that the same results
+// always give the same intervals
+class Random
+{
+public:
+    Random() : state(Q_UINT64_C(88172645463325252)) {}
+    int bounded(int n)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return int(state % quint64(n));
+    }
+private:
+    quint64 state;
+};
+
+double median(QList<double> values)
+{
+    if (values.isEmpty())
+        return 0;
+    qSort(values);
+    const int middle = values.count() / 2;
+    return values.count() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+double percentile(const QList<double> &sorted, double p)
+{
+    if (sorted.isEmpty())
+        return 0;
+    const int index = int(p * (sorted.count() - 1) + 0.5);
+    return sorted[qBound(0, index, sorted.count() - 1)];
+}
+
+QList<double> resample(const QList<double> &samples, Random &random)
+{
+    QList<double> result;
+    for (int i = 0; i < samples.count(); ++i)
+        result << samples[random.bounded(samples.count())];
+    return result;
+}
+
+// Percentile bootstrap of the median of the runs, and of the relative change
+// of the median from the baseline
+void bootstrap(TestComparison &test, const Options &options)
+{
+    Random random;
+    QList<double> medians;
+    QList<double> changes;
+    for (int i = 0; i < options.resamples; ++i) {
+        const double current = median(resample(test.samples, random));
+        medians << current;
+        if (!test.baselineSamples.isEmpty()) {
+            const double baseline = median(resample(test.baselineSamples, random));
+            if (baseline > 0)
+                changes << (current - baseline) / baseline;
+        }
+    }
+    qSort(medians);
+    qSort(changes);
+
+    const double alpha = (1 - options.confidence) / 2;
+    test.median = median(test.samples);
+    test.low = percentile(medians, alpha);
+    test.high = percentile(medians, 1 - alpha);
+
+    if (test.baselineSamples.isEmpty()) {
+        test.status = "new";
+        return;
+    }
+    test.baselineMedian = median(test.baselineSamples);
+    test.change = test.baselineMedian > 0
+                  ? (test.median - test.baselineMedian) / test.baselineMedian : 0;
+    test.changeLow = percentile(changes, alpha);
+    test.changeHigh = percentile(changes, 1 - alpha);
+
+    // Only a change whose whole interval is beyond the threshold counts, so
+    // noisy tests don't raise false alarms
+    if (test.samples.count() < minimumRuns || test.baselineSamples.count() < minimumRuns)
+        test.status = "insufficient-data";
+    else if (test.changeLow * 100 > options.threshold)
+        test.status = "regression";
+    else if (test.changeHigh * 100 < -options.threshold)
+        test.status = "improvement";
+    else
+        test.status = "unchanged";
+}
+
+// The baseline keeps the runs of every test:
+// <baseline><test name="..."><run value="..."/>...</test></baseline>
+QHash<QString, QList<double> > readBaseline(const QString &path)
+{
+    QHash<QString, QList<double> > baseline;
+    QFile file(path);
+    QDomDocument doc("baseline");
+    if (!file.open(QIODevice::ReadOnly) || !doc.setContent(&file))
+        return baseline;
+
+    QDomNodeList tests = doc.documentElement().elementsByTagName("test");
+    for (int i = 0; i < tests.count(); i++) {
+        QDomElement test = tests.at(i).toElement();
+        QDomNodeList runs = test.elementsByTagName("run");
+        QList<double> samples;
+        for (int j = 0; j < runs.count(); j++)
+            samples << runs.at(j).toElement().attribute("value").toDouble();
+        baseline[test.attribute("name")] = samples;
+    }
+    return baseline;
+}
+
+bool writeBaseline(const QString &path, const QHash<QString, QList<double> > &baseline)
+{
+    QDomDocument doc("baseline");
+    QDomElement root = doc.createElement("baseline");
+    root.setAttribute("created", QDateTime::currentDateTime().toString(Qt::ISODate));
+    doc.appendChild(root);
+    QStringList names = baseline.keys();
+    qSort(names);
+    Q_FOREACH (const QString &name, names) {
+        QDomElement test = doc.createElement("test");
+        test.setAttribute("name", name);
+        Q_FOREACH (double value, baseline[name]) {
+            QDomElement run = doc.createElement("run");
+            run.setAttribute("value", value);
+            test.appendChild(run);
+        }
+        root.appendChild(test);
+    }
+
+    QFile file(path);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+    QTextStream out(&file);
+    doc.save(out, 4);
+    return true;
+}
+
+QString jsonString(const QString &value)
+{
+    QString escaped;
+    for (int i = 0; i < value.size(); ++i) {
+        const QChar c = value[i];
+        if (c == '"' || c == '\\')
+            escaped += QString("\\") + c;
+        else if (c.unicode() < 0x20)
+            escaped += QString("\\u%1").arg(c.unicode(), 4, 16, QLatin1Char('0'));
+        else
+            escaped += c;
+    }
+    return "\"" + escaped + "\"";
+}
+
+QString jsonNumber(double value)
+{
+    return QString::number(value, 'g', 12);
+}
+
+QString jsonList(const QList<double> &values)
+{
+    QStringList items;
+    Q_FOREACH (double value, values)
+        items << jsonNumber(value);
+    return "[" + items.join(",") + "]";
+}
+
+QString makeJson(const QList<TestComparison> &comparisons, const Options &options,
+                 int regressions)
+{
+    QString json = "{\n";
+    json += "  \"baseline\": " + jsonString(options.baselinePath) + ",\n";
+    json += "  \"confidence\": " + jsonNumber(options.confidence) + ",\n";
+    json += "  \"threshold\": " + jsonNumber(options.threshold) + ",\n";
+    json += QString("  \"resamples\": %1,\n").arg(options.resamples);
+    json += QString("  \"regressions\": %1,\n").arg(regressions);
+    json += "  \"tests\": [";
+    for (int i = 0; i < comparisons.count(); i++) {
+        const TestComparison &test = comparisons[i];
+        json += i ? ",\n    {" : "\n    {";
+        json += "\"name\": " + jsonString(test.name);
+        json += ", \"status\": " + jsonString(test.status);
+        json += ", \"runs\": " + jsonList(test.samples);
+        json += QString(", \"median\": %1, \"low\": %2, \"high\": %3")
+                .arg(jsonNumber(test.median)).arg(jsonNumber(test.low))
+                .arg(jsonNumber(test.high));
+        if (!test.baselineSamples.isEmpty()) {
+            json += ", \"baselineRuns\": " + jsonList(test.baselineSamples);
+            json += QString(", \"baselineMedian\": %1, \"change\": %2"
+                            ", \"changeLow\": %3, \"changeHigh\": %4")
+                    .arg(jsonNumber(test.baselineMedian)).arg(jsonNumber(test.change))
+                    .arg(jsonNumber(test.changeLow)).arg(jsonNumber(test.changeHigh));
+        }
+        json += "}";
+    }
+    json += "\n  ]\n}\n";
+    return json;
+}
+
+QString makeRegressionTable(const QList<TestComparison> &comparisons, const Options &options)
+{
+    QString table = QString("<h2>Changes from the baseline</h2>"
+        "<p>Medians of repeated runs with their %1% bootstrap intervals. A change is only "
+        "reported when its whole interval is beyond %2%.</p>"
+        "<table><tr><td>Test name</td><td>baseline</td><td>current</td><td>interval</td>"
+        "<td>change</td><td>status</td></tr>\n")
+        .arg(options.confidence * 100).arg(options.threshold);
+    for (int i = 0; i < comparisons.count(); i++) {
+        const TestComparison &test = comparisons[i];
+        const QString status = test.status == "regression" ? "<sup class=\"t1\">regression</sup>"
+                             : test.status == "improvement" ? "<sup class=\"t2\">improvement</sup>"
+                             : test.status;
+        QString change;
+        if (!test.baselineSamples.isEmpty())
+            change = QString("%1% [%2%, %3%]").arg(test.change * 100, 0, 'f', 1)
+                     .arg(test.changeLow * 100, 0, 'f', 1).arg(test.changeHigh * 100, 0, 'f', 1);
+        table += QString("<tr><td class=\"row%1\">%2</td><td class=\"row%1\">%3</td>"
+                         "<td class=\"row%1\">%4 (%5 runs)</td><td class=\"row%1\">%6 - %7</td>"
+                         "<td class=\"row%1\">%8</td><td class=\"row%1\">%9</td></tr>\n")
+                 .arg(i % 2 + 1).arg(test.name)
+                 .arg(test.baselineSamples.isEmpty() ? QString("-") : QString::number(test.baselineMedian))
+                 .arg(test.median).arg(test.samples.count()).arg(test.low).arg(test.high)
+                 .arg(change).arg(status);
+    }
+    table += "</table>";
+    return table;
+}
+
+void printUsage()
+{
+    fprintf(stderr,
+            "Usage: comparison_tool [options]\n"
+            "Reads the benchmark-*.xml files, writes index.html, tests-comparison.html and\n"
+            "benchmark-comparison.json, and exits with 1 when a test got significantly\n"
+            "slower than in the baseline. The files of the repeated runs of one benchmark,\n"
+            "NAME.run-1.xml, NAME.run-2.xml and so on, are the samples of the newest results.\n"
+            "\n"
+            "  --dir DIR             directory of the benchmark files (default: home)\n"
+            "  --baseline FILE       baseline (default: DIR/qsparql-benchmark-baseline.xml)\n"
+            "  --update-baseline     store the newest results in the baseline\n"
+            "  --json FILE           JSON output (default: DIR/benchmark-comparison.json)\n"
+            "  --confidence LEVEL    of the intervals (default: 0.95)\n"
+            "  --threshold PERCENT   smallest change reported (default: 5)\n"
+            "  --resamples N         bootstrap resamples (default: 2000)\n");
+}
+
+bool parseArguments(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; i++) {
+        const QString argument = QString::fromLocal8Bit(argv[i]);
+        const bool hasValue = i + 1 < argc;
+        if (argument == "--update-baseline")
+            options.updateBaseline = true;
+        else if (argument == "--dir" && hasValue)
+            options.dirPath = QFile::decodeName(argv[++i]);
+        else if (argument == "--baseline" && hasValue)
+            options.baselinePath = QFile::decodeName(argv[++i]);
+        else if (argument == "--json" && hasValue)
+            options.jsonPath = QFile::decodeName(argv[++i]);
+        else if (argument == "--confidence" && hasValue)
+            options.confidence = QString(argv[++i]).toDouble();
+        else if (argument == "--threshold" && hasValue)
+            options.threshold = QString(argv[++i]).toDouble();
+        else if (argument == "--resamples" && hasValue)
+            options.resamples = QString(argv[++i]).toInt();
+        else
+            return false;
+    }
+    if (options.confidence <= 0 || options.confidence >= 1 || options.resamples < 1)
+        return false;
+
+    if (options.dirPath.isEmpty())
+        options.dirPath = QDir::homePath();
+    if (!options.dirPath.endsWith(QDir::separator()))
+        options.dirPath += QDir::separator();
+    if (options.baselinePath.isEmpty())
+        options.baselinePath = options.dirPath + "qsparql-benchmark-baseline.xml";
+    if (options.jsonPath.isEmpty())
+        options.jsonPath = options.dirPath + "benchmark-comparison.json";
+    return true;
+}
+
+// The samples of a test are its medians in the files of the newest group of
+// repeated runs which has the test
+QList<TestComparison> compareRuns(const QHash<QString, QStringList> &results,
+                                  const QStringList &fileList, const QStringList &testNames,
+                                  const QHash<QString, QList<double> > &baseline,
+                                  const Options &options)
+{
+    QHash<QString, QStringList> groups;
+    QHash<QString, QDateTime> groupTimes;
+    Q_FOREACH (const QString &fileName, fileList) {
+        const int run = fileName.lastIndexOf(".run-");
+        const QString group = run >= 0 ? fileName.left(run) : fileName;
+        groups[group] << fileName;
+        const QDateTime modified = QFileInfo(options.dirPath + fileName).lastModified();
+        if (!groupTimes.contains(group) || modified > groupTimes[group])
+            groupTimes[group] = modified;
+    }
+
+    QList<TestComparison> comparisons;
+    Q_FOREACH (const QString &name, testNames) {
+        TestComparison test;
+        test.name = name;
+        QDateTime newest;
+        Q_FOREACH (const QString &group, groups.keys()) {
+            QList<double> samples;
+            Q_FOREACH (const QString &fileName, groups[group]) {
+                const QStringList values = results.value(fileName + name);
+                if (values.count() >= 3)
+                    samples << values.at(0).toDouble();
+            }
+            if (!samples.isEmpty() && (newest.isNull() || groupTimes[group] > newest)) {
+                newest = groupTimes[group];
+                test.samples = samples;
+            }
+        }
+        if (test.samples.isEmpty())
+            continue;
+        test.baselineSamples = baseline.value(name);
+        bootstrap(test, options);
+        comparisons << test;
+    }
+    return comparisons;
+}
 
 QString makeTable(QHash<QString, QStringList> &results, QString fileName,
                   QString testName1, QString testName2)
@@ -110,11 +470,15 @@ QString makeTableCombined(QHash<QString, QStringList> &results, QString fileName
 }
 int main(int argc, char *argv[])
 {
-    Q_UNUSED(argc);
-    Q_UNUSED(argv);
-    QString dirPath = QDir::homePath() + QDir::separator();
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+    QString dirPath = options.dirPath;
     QDir myDir(dirPath);
     QStringList fileList = myDir.entryList(QStringList() << "benchmark-*.xml");
+    fileList.removeAll(QFileInfo(options.baselinePath).fileName());
     QString pageOutput;
     pageOutput = "<html>"
     "<head>"
@@ -196,6 +560,23 @@ int main(int argc, char *argv[])
         }
     }
 
+    //repeated runs of the newest results compared to the baseline
+    QHash<QString, QList<double> > baseline = readBaseline(options.baselinePath);
+    QList<TestComparison> comparisons = compareRuns(results, fileList, testNames, baseline,
+                                                    options);
+    int regressions = 0;
+    for(int i=0; i < comparisons.count(); i++)
+    {
+        if(comparisons[i].status == "regression")
+        {
+            regressions++;
+            fprintf(stderr, "Regression: %s %g -> %g (%+.1f%%, interval %+.1f%% to %+.1f%%)\n",
+                    qPrintable(comparisons[i].name), comparisons[i].baselineMedian,
+                    comparisons[i].median, comparisons[i].change * 100,
+                    comparisons[i].changeLow * 100, comparisons[i].changeHigh * 100);
+        }
+    }
+
     //overall comparison html page
     pageOutput.append("<br /><table><tr><td>Test name</td>");
     for(int dirIterator=0; dirIterator < fileList.count(); dirIterator++)
@@ -240,6 +621,7 @@ int main(int argc, char *argv[])
         pageOutput.append("</tr>\n\n");
     }
     pageOutput.append("</tr></table>");
+    pageOutput.append(makeRegressionTable(comparisons, options));
     pageOutput.append("</body></html>");
 
     //between-tests-comparison html page
@@ -280,5 +662,24 @@ int main(int argc, char *argv[])
     }
     else
         qDebug() << "Couldn't save report in " << dirPath << "Check writing permissions!";
-    return 0;
+    data.setFileName(options.jsonPath);
+    if (data.open(QFile::WriteOnly | QFile::Truncate)) {
+        QTextStream out(&data);
+        out << makeJson(comparisons, options, regressions);
+        qDebug() << "JSON report saved in " << options.jsonPath;
+    }
+    else
+        qDebug() << "Couldn't save JSON report in " << options.jsonPath;
+
+    //the exit code still tells about the previous baseline
+    if (options.updateBaseline)
+    {
+        for(int i=0; i < comparisons.count(); i++)
+            baseline[comparisons[i].name] = comparisons[i].samples;
+        if (writeBaseline(options.baselinePath, baseline))
+            qDebug() << "Baseline saved in " << options.baselinePath;
+        else
+            qDebug() << "Couldn't save baseline in " << options.baselinePath;
+    }
+    return regressions ? 1 : 0;
 }
\ No newline at end of file
@@ -38,12 +38,155 @@
 ****************************************************************************/
 
 #include "EndpointServer.h"
+#include <QDateTime>
 #include <QTextStream>
 #include <QTcpSocket>
-#include <QStringList>
+#include <QTimer>
+#include <QUrl>
+
+namespace {
+
+// The replies are throttled by writing a slice of them every tick
+const int throttleInterval = 10;
+
+enum TermKind { Uri, BlankNode, Literal };
+
+struct Term
+{
+    TermKind kind;
+    QByteArray value;
+    QByteArray datatype;
+    QByteArray language;
+};
+
+Term generateTerm(const QString& type, int i)
+{
+    static const QByteArray xsd("http://www.w3.org/2001/XMLSchema#");
+    Term term;
+    term.kind = Literal;
+    if (type == "uri") {
+        term.kind = Uri;
+        term.value = "http://www.example.org/resource/" + QByteArray::number(i);
+    } else if (type == "bnode") {
+        term.kind = BlankNode;
+        term.value = "b" + QByteArray::number(i);
+    } else if (type == "langstring") {
+        term.value = "Synthetic text number " + QByteArray::number(i);
+        term.language = "en";
+    } else if (type == "integer") {
+        term.value = QByteArray::number(i);
+        term.datatype = xsd + "integer";
+    } else if (type == "double") {
+        term.value = QByteArray::number(i * 0.5);
+        term.datatype = xsd + "double";
+    } else if (type == "boolean") {
+        term.value = i % 2 ? "true" : "false";
+        term.datatype = xsd + "boolean";
+    } else if (type == "datetime") {
+        const QDateTime epoch(QDate(2012, 1, 1), QTime(0, 0), Qt::UTC);
+        term.value = epoch.addSecs(i).toString(Qt::ISODate).toLatin1();
+        term.datatype = xsd + "dateTime";
+    } else {
+        term.value = "Synthetic text number " + QByteArray::number(i);
+    }
+    return term;
+}
+
+void appendXml(QByteArray& out, const Term& term)
+{
+    switch (term.kind) {
+    case Uri:
+        out += "<uri>" + term.value + "</uri>";
+        break;
+    case BlankNode:
+        out += "<bnode>" + term.value + "</bnode>";
+        break;
+    case Literal:
+        if (!term.language.isEmpty())
+            out += "<literal xml:lang=\"" + term.language + "\">";
+        else if (!term.datatype.isEmpty())
+            out += "<literal datatype=\"" + term.datatype + "\">";
+        else
+            out += "<literal>";
+        out += term.value + "</literal>";
+        break;
+    }
+}
+
+void appendJson(QByteArray& out, const Term& term)
+{
+    switch (term.kind) {
+    case Uri:
+        out += "{\"type\":\"uri\",\"value\":\"" + term.value + "\"}";
+        break;
+    case BlankNode:
+        out += "{\"type\":\"bnode\",\"value\":\"" + term.value + "\"}";
+        break;
+    case Literal:
+        out += "{\"type\":\"literal\",\"value\":\"" + term.value + "\"";
+        if (!term.language.isEmpty())
+            out += ",\"xml:lang\":\"" + term.language + "\"";
+        else if (!term.datatype.isEmpty())
+            out += ",\"datatype\":\"" + term.datatype + "\"";
+        out += "}";
+        break;
+    }
+}
+
+// The N-Triples syntax, which is also used by the TSV results
+void appendNTriples(QByteArray& out, const Term& term)
+{
+    switch (term.kind) {
+    case Uri:
+        out += "<" + term.value + ">";
+        break;
+    case BlankNode:
+        out += "_:" + term.value;
+        break;
+    case Literal:
+        out += "\"" + term.value + "\"";
+        if (!term.language.isEmpty())
+            out += "@" + term.language;
+        else if (!term.datatype.isEmpty())
+            out += "^^<" + term.datatype + ">";
+        break;
+    }
+}
+
+quint32 crc32(const QByteArray& data)
+{
+    static quint32 table[256];
+    static bool tableReady = false;
+    if (!tableReady) {
+        for (quint32 n = 0; n < 256; ++n) {
+            quint32 c = n;
+            for (int k = 0; k < 8; ++k)
+                c = c & 1 ? 0xedb88320 ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        tableReady = true;
+    }
+
+    quint32 crc = 0xffffffff;
+    for (int i = 0; i < data.size(); ++i)
+        crc = table[(crc ^ (uchar)data[i]) & 0xff] ^ (crc >> 8);
+    return crc ^ 0xffffffff;
+}
+
+void appendLittleEndian(QByteArray& out, quint32 value)
+{
+    for (int i = 0; i < 4; ++i)
+        out += char((value >> (8 * i)) & 0xff);
+}
+
+} // namespace
 
 EndpointServer::EndpointServer(int _port) : port(_port), disabled(true)
 {
+    throttleTimer = new QTimer(this);
+    throttleTimer->setInterval(throttleInterval);
+    connect(throttleTimer, SIGNAL(timeout()), this, SLOT(writeThrottled()));
+
     if (!listen(QHostAddress::Any, port)) {
         qWarning() << "Can't bind server to port "<< port;
     } else {
@@ -64,7 +207,11 @@ void EndpointServer::stop()
     close();
 }
 
+#if QT_VERSION >= 0x050000
+void EndpointServer::incomingConnection(qintptr socket)
+#else
 void EndpointServer::incomingConnection(int socket)
+#endif
 {
     if (disabled)
         return;
@@ -78,7 +225,32 @@ void EndpointServer::incomingConnection(int socket)
 QString EndpointServer::sparqlData(QString url)
 {
     // returned data is based on http://www.w3.org/TR/rdf-sparql-protocol/
-    if (url.contains("select", Qt::CaseInsensitive)) {
+    if (url.contains("optional", Qt::CaseInsensitive)) {
+        // The first result leaves out the optional variable, and the second
+        // binds the variables in another order than the head
+        return QString( "HTTP/1.0 200 Ok\r\n"
+        "Content-Type: text/html; charset=\"utf-8\"\r\n"
+        "\r\n"
+        "<?xml version=\"1.0\"?>"
+        "<sparql xmlns=\"http://www.w3.org/2005/sparql-results#\">"
+        "<head>"
+        "   <variable name=\"book\"/>"
+        "   <variable name=\"title\"/>"
+        "   <variable name=\"who\"/>"
+        "</head>"
+        "<results distinct=\"false\" ordered=\"false\">"
+        "<result>"
+        "    <binding name=\"book\"><uri>http://www.example/book/book5</uri></binding>"
+        "    <binding name=\"who\"><bnode>r29392923r2922</bnode></binding>"
+        "</result>"
+        "<result>"
+        "    <binding name=\"who\"><bnode>r8484882r49593</bnode></binding>"
+        "    <binding name=\"title\"><literal>Book 6</literal></binding>"
+        "    <binding name=\"book\"><uri>http://www.example/book/book6</uri></binding>"
+        "</result>"
+        "</results>"
+        "</sparql>\n");
+    } else if (url.contains("select", Qt::CaseInsensitive)) {
         return QString( "HTTP/1.0 200 Ok\r\n"
         "Content-Type: text/html; charset=\"utf-8\"\r\n"
         "\r\n"
@@ -139,34 +311,231 @@ QString EndpointServer::sparqlData(QString url)
     return QString();
 }
 
+QByteArray EndpointServer::contentType(const QString& format)
+{
+    if (format == "json")
+        return "application/sparql-results+json";
+    if (format == "tsv")
+        return "text/tab-separated-values";
+    // The endpoint driver reads anything but Turtle and N-Quads as
+    // N-Triples, and Virtuoso uses text/plain for them
+    if (format == "ntriples")
+        return "text/plain";
+    return "application/sparql-results+xml";
+}
+
+QByteArray EndpointServer::generateResults(const QString& format, int rows,
+                                           const QStringList& columns)
+{
+    QStringList names;
+    for (int c = 0; c < columns.count(); ++c)
+        names << columns[c] + QString::number(c);
+
+    QByteArray out;
+    if (format == "ntriples") {
+        // One statement per row, with the object types taking turns
+        for (int i = 0; i < rows; ++i) {
+            const QString type = columns[i % columns.count()];
+            appendNTriples(out, generateTerm("uri", i));
+            out += " <http://www.example.org/property/" + type.toLatin1() + "> ";
+            appendNTriples(out, generateTerm(type, i));
+            out += " .\n";
+        }
+    } else if (format == "tsv") {
+        out += "?" + names.join("\t?").toLatin1() + "\n";
+        for (int i = 0; i < rows; ++i) {
+            for (int c = 0; c < columns.count(); ++c) {
+                if (c > 0)
+                    out += "\t";
+                appendNTriples(out, generateTerm(columns[c], i));
+            }
+            out += "\n";
+        }
+    } else if (format == "json") {
+        out += "{\"head\":{\"vars\":[\"" + names.join("\",\"").toLatin1() + "\"]},\n"
+               "\"results\":{\"bindings\":[\n";
+        for (int i = 0; i < rows; ++i) {
+            out += i > 0 ? ",{" : "{";
+            for (int c = 0; c < columns.count(); ++c) {
+                if (c > 0)
+                    out += ",";
+                out += "\"" + names[c].toLatin1() + "\":";
+                appendJson(out, generateTerm(columns[c], i));
+            }
+            out += "}\n";
+        }
+        out += "]}}\n";
+    } else {
+        out += "<?xml version=\"1.0\"?>\n"
+               "<sparql xmlns=\"http://www.w3.org/2005/sparql-results#\">\n<head>";
+        Q_FOREACH (const QString& name, names)
+            out += "<variable name=\"" + name.toLatin1() + "\"/>";
+        out += "</head>\n<results distinct=\"false\" ordered=\"false\">\n";
+        for (int i = 0; i < rows; ++i) {
+            out += "<result>";
+            for (int c = 0; c < columns.count(); ++c) {
+                out += "<binding name=\"" + names[c].toLatin1() + "\">";
+                appendXml(out, generateTerm(columns[c], i));
+                out += "</binding>";
+            }
+            out += "</result>\n";
+        }
+        out += "</results>\n</sparql>\n";
+    }
+    return out;
+}
+
+QByteArray EndpointServer::gzip(const QByteArray& data)
+{
+    // qCompress() gives a 4 byte length and a zlib stream, which is a 2 byte
+    // header, the deflated data and a 4 byte checksum. The deflated data is
+    // the same in a gzip stream.
+    const QByteArray compressed = qCompress(data, 6);
+    QByteArray out("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\x03", 10);
+    out += compressed.mid(6, compressed.size() - 10);
+    appendLittleEndian(out, crc32(data));
+    appendLittleEndian(out, data.size());
+    return out;
+}
+
+void EndpointServer::serveGenerated(QTcpSocket* socket, const QByteArray& target,
+                                    const QByteArray& headers)
+{
+    QByteArray path = target;
+    const int queryStart = path.indexOf('?');
+    if (queryStart >= 0)
+        path.truncate(queryStart);
+
+    QHash<QString, QString> parameters;
+    Q_FOREACH (const QString& parameter, QUrl::fromPercentEncoding(path).split(';')) {
+        const int separator = parameter.indexOf('=');
+        if (separator > 0)
+            parameters.insert(parameter.left(separator), parameter.mid(separator + 1));
+    }
+
+    const QString format = parameters.value("format", "xml");
+    const int rows = parameters.value("rows", "1000").toInt();
+    const QString columns = parameters.value("columns", "uri,string,integer");
+    const int chunk = parameters.value("chunk").toInt();
+    const int kbps = parameters.value("kbps").toInt();
+    const bool compress = parameters.value("gzip") == "1"
+                          && headers.toLower().contains("accept-encoding:")
+                          && headers.toLower().contains("gzip");
+    const bool keepAlive = parameters.value("keepalive", "1") != "0"
+                           && !headers.toLower().contains("connection: close");
+
+    const QString key = QString("%1;%2;%3;%4").arg(format).arg(rows).arg(columns).arg(compress);
+    if (!generated.contains(key)) {
+        QByteArray body = generateResults(format, rows, columns.split(','));
+        generated.insert(key, compress ? gzip(body) : body);
+    }
+    const QByteArray body = generated.value(key);
+
+    QByteArray reply = "HTTP/1.1 200 OK\r\n"
+                       "Content-Type: " + contentType(format) + "; charset=utf-8\r\n";
+    if (compress)
+        reply += "Content-Encoding: gzip\r\n";
+    reply += keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    if (chunk > 0) {
+        reply += "Transfer-Encoding: chunked\r\n\r\n";
+        for (int offset = 0; offset < body.size(); offset += chunk) {
+            const QByteArray piece = body.mid(offset, chunk);
+            reply += QByteArray::number(piece.size(), 16) + "\r\n" + piece + "\r\n";
+        }
+        reply += "0\r\n\r\n";
+    } else {
+        reply += "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n";
+        reply += body;
+    }
+
+    if (kbps <= 0) {
+        socket->write(reply);
+        if (!keepAlive)
+            socket->disconnectFromHost();
+        return;
+    }
+
+    Client& client = clients[socket];
+    client.pending += reply;
+    client.bytesPerTick = qMax(1, kbps * 1024 / (1000 / throttleInterval));
+    client.closeWhenSent = !keepAlive;
+    if (!throttleTimer->isActive())
+        throttleTimer->start();
+}
+
 void EndpointServer::readClient()
 {
     if (disabled)
         return;
 
-    // This slot is called when the client sent data to the server. The
-    // server looks if it was a get request and sends a very simple HTML
-    // document back.
     QTcpSocket* socket = (QTcpSocket*)sender();
-    if (socket->canReadLine()) {
-        QStringList tokens = QString(socket->readLine()).split(QRegExp("[ \r\n][ \r\n]*"));
-        if (tokens[0] == "GET") {
-            QString url = tokens[1];
-            QTextStream os(socket);
-            os.setAutoDetectUnicode(true);
-            os << sparqlData(url);
-            socket->close();
-
-            if (socket->state() == QTcpSocket::UnconnectedState) {
-                delete socket;
-            }
+    clients[socket].request += socket->readAll();
+
+    // A client keeping the connection alive can send several requests
+    for (;;) {
+        QByteArray& request = clients[socket].request;
+        const int headersEnd = request.indexOf("\r\n\r\n");
+        if (headersEnd < 0)
+            return;
+        const QByteArray headers = request.left(headersEnd);
+        request.remove(0, headersEnd + 4);
+
+        const int lineEnd = headers.indexOf("\r\n");
+        const QList<QByteArray> tokens = (lineEnd < 0 ? headers : headers.left(lineEnd))
+                                         .simplified().split(' ');
+        if (tokens.count() < 2 || tokens[0] != "GET")
+            continue;
+
+        if (tokens[1].startsWith("/generate")) {
+            serveGenerated(socket, tokens[1], headers);
+            if (socket->state() != QAbstractSocket::ConnectedState)
+                return;
+            continue;
+        }
+
+        // The fixed documents are sent and the connection closed
+        QTextStream os(socket);
+        os.setAutoDetectUnicode(true);
+        os << sparqlData(tokens[1]);
+        os.flush();
+        clients.remove(socket);
+        socket->close();
+
+        if (socket->state() == QTcpSocket::UnconnectedState) {
+            delete socket;
         }
+        return;
+    }
+}
+
+void EndpointServer::writeThrottled()
+{
+    // Closing a socket can remove it from the clients, so that is done after
+    // the iteration
+    QList<QTcpSocket*> finished;
+    bool pending = false;
+    for (QHash<QTcpSocket*, Client>::iterator it = clients.begin(); it != clients.end(); ++it) {
+        Client& client = it.value();
+        if (client.pending.isEmpty())
+            continue;
+        it.key()->write(client.pending.left(client.bytesPerTick));
+        client.pending.remove(0, client.bytesPerTick);
+        if (!client.pending.isEmpty())
+            pending = true;
+        else if (client.closeWhenSent)
+            finished << it.key();
     }
+
+    if (!pending)
+        throttleTimer->stop();
+    Q_FOREACH (QTcpSocket* socket, finished)
+        socket->disconnectFromHost();
 }
 
 void EndpointServer::discardClient()
 {
     QTcpSocket* socket = (QTcpSocket*)sender();
+    clients.remove(socket);
     socket->deleteLater();
 }
 
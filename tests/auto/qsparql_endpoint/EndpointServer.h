@@ -42,8 +42,27 @@
 
 #include <QTcpServer>
 #include <QEventLoop>
+#include <QHash>
 #include <QString>
+#include <QStringList>
 
+class QTcpSocket;
+class QTimer;
+
+// Serves the fixed documents used by tst_qsparql_endpoint, and generated
+// results for the benchmarks. Generated results are requested with a path
+// of the form
+//   /generate;format=xml;rows=10000;columns=uri,string;chunk=4096;gzip=1;kbps=512;keepalive=0
+// where every parameter is optional:
+// - format: xml, json or tsv SELECT results, or ntriples statements
+// - rows: the number of result rows or statements (default 1000)
+// - columns: the types of the columns, as in the synthetic driver: uri,
+//   bnode, string, langstring, integer, double, boolean or datetime
+// - chunk: send the body with chunked transfer encoding, in chunks of this
+//   many bytes
+// - gzip: compress the body if the client accepts gzip
+// - kbps: limit the bandwidth of the reply, in kilobytes per second
+// - keepalive: 0 closes the connection after the reply
 class EndpointServer : public QTcpServer
 {
     Q_OBJECT
@@ -55,15 +74,38 @@ public:
     void pause();
     bool resume();
     void stop();
+
+    static QByteArray contentType(const QString& format);
+    static QByteArray generateResults(const QString& format, int rows, const QStringList& columns);
+    static QByteArray gzip(const QByteArray& data);
 private:
+#if QT_VERSION >= 0x050000
+    void incomingConnection(qintptr socket);
+#else
     void incomingConnection(int socket);
+#endif
     QString sparqlData(QString url);
+    void serveGenerated(QTcpSocket* socket, const QByteArray& target, const QByteArray& headers);
 private Q_SLOTS:
     void readClient();
     void discardClient();
+    void writeThrottled();
 private:
+    struct Client
+    {
+        Client() : bytesPerTick(0), closeWhenSent(false) {}
+        QByteArray request;     // received data not yet handled
+        QByteArray pending;     // throttled data not yet written
+        int bytesPerTick;
+        bool closeWhenSent;
+    };
+
     int port;
     bool disabled;
+    QHash<QTcpSocket*, Client> clients;
+    // Generated bodies, so that generating them doesn't delay the replies
+    QHash<QString, QByteArray> generated;
+    QTimer* throttleTimer;
 };
 
 #endif // QSPARQL_ENDPOINT_SERVER_H
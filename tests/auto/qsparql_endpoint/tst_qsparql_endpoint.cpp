@@ -57,6 +57,7 @@ public slots:
 
 private slots:
     void select_query();
+    void fetch_block_optional();
     void ask_query();
     void query_with_error();
     void select_query_server_not_responding();
@@ -131,6 +132,39 @@ void tst_QSparqlEndpoint::select_query()
     delete r;
 }
 
+void tst_QSparqlEndpoint::fetch_block_optional()
+{
+    QSparqlConnectionOptions options;
+    options.setPort(8080);
+    options.setHostName("127.0.0.1");
+    QSparqlConnection conn("QSPARQL_ENDPOINT", options);
+
+    QSparqlQuery q("SELECT ?book ?title ?who "
+                   "WHERE { "
+                   "?book a <http://www.example/Book> . "
+                   "?who <http://www.example/Author> ?book . "
+                   "OPTIONAL { ?book <http://www.example/Title> ?title } }");
+    QSparqlResult* r = conn.exec(q);
+    QVERIFY(r != 0);
+    r->waitForFinished();
+    QCOMPARE(r->hasError(), false);
+
+    // The columns are the variables of the head, and the values are placed
+    // by variable name
+    QSparqlRowBlock block;
+    QCOMPARE(r->fetchBlock(10, &block), 2);
+    QCOMPARE(block.variableNames(), QStringList() << "book" << "title" << "who");
+    QCOMPARE(block.value(0, 0), QVariant(QUrl("http://www.example/book/book5")));
+    QVERIFY(!block.value(0, 1).isValid());
+    QCOMPARE(block.value(0, 2).toString(), QString("r29392923r2922"));
+    QCOMPARE(block.value(1, 0), QVariant(QUrl("http://www.example/book/book6")));
+    QCOMPARE(block.value(1, 1), QVariant(QString("Book 6")));
+    QCOMPARE(block.value(1, 2).toString(), QString("r8484882r49593"));
+    QCOMPARE(r->pos(), int(QSparql::AfterLastRow));
+
+    delete r;
+}
+
 void tst_QSparqlEndpoint::ask_query()
 {
     QSparqlConnectionOptions options;
@@ -0,0 +1,19 @@
+include(../sparqltest.pri)
+CONFIG += qt warn_on console depend_includepath
+QT += testlib xml network
+
+INCLUDEPATH += ../qsparql_endpoint
+HEADERS += ../qsparql_endpoint/EndpointService.h \
+           ../qsparql_endpoint/EndpointServer.h \
+           ../utils/benchmarkreport.h
+SOURCES += tst_qsparql_endpoint_benchmark.cpp \
+           ../qsparql_endpoint/EndpointService.cpp \
+           ../qsparql_endpoint/EndpointServer.cpp \
+           ../utils/benchmarkreport.cpp
+
+check.depends = $$TARGET
+check.commands = ./tst_qsparql_endpoint_benchmark
+
+QMAKE_EXTRA_TARGETS += check
+
+#QT = sparql # enable this later
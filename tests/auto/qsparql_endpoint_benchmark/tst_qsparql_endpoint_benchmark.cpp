@@ -0,0 +1,348 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the test suite of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "EndpointService.h"
+#include "EndpointServer.h"
+#include "../utils/benchmarkreport.h"
+
+#include <QtTest/QtTest>
+#include <QtSparql>
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkreply.h>
+
+#include <stdio.h>
+
+static const int port = 8082;
+static const int runs = 10;
+
+static qint64 elapsedUsecs(const QElapsedTimer& timer)
+{
+#if QT_VERSION >= 0x040800
+    return timer.nsecsElapsed() / 1000;
+#else
+    return timer.elapsed() * 1000;
+#endif
+}
+
+// Memory use is read from /proc/self/status, so it is only measured on
+// Linux. Returns the value of the field in kB, or -1.
+static qint64 memoryStatus(const char* field)
+{
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly))
+        return -1;
+    Q_FOREACH (const QByteArray& line, file.readAll().split('\n')) {
+        if (line.startsWith(field))
+            return line.mid(qstrlen(field)).trimmed().split(' ').first().toLongLong();
+    }
+    return -1;
+}
+
+// Resets VmHWM, the peak resident memory, to the current resident memory
+static void resetPeakMemory()
+{
+    QFile file("/proc/self/clear_refs");
+    if (file.open(QIODevice::WriteOnly))
+        file.write("5");
+}
+
+// Records how long after the start the first rows or bytes arrived
+class FirstDataTimer : public QObject
+{
+    Q_OBJECT
+public:
+    FirstDataTimer(const QElapsedTimer& timer) : timer(timer), firstData(-1) {}
+    qint64 elapsed() const { return firstData; }
+
+public Q_SLOTS:
+    void dataArrived()
+    {
+        if (firstData < 0)
+            firstData = elapsedUsecs(timer);
+    }
+
+private:
+    const QElapsedTimer& timer;
+    qint64 firstData;
+};
+
+class tst_QSparqlEndpointBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_QSparqlEndpointBenchmark();
+    virtual ~tst_QSparqlEndpointBenchmark();
+
+public slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+private slots:
+    void driver_data();
+    void driver();
+    void transfer_data();
+    void transfer();
+    void keep_alive_data();
+    void keep_alive();
+
+private:
+    static QString generatePath(const QString& format, int rows, const QString& parameters);
+    void addTimes(const QString& name, int rows, const QList<qint64>& times,
+                  const QList<qint64>& firstDataTimes, const QList<qint64>& peakMemory);
+
+    EndpointService* endpointService;
+    BenchmarkReport report;
+};
+
+tst_QSparqlEndpointBenchmark::tst_QSparqlEndpointBenchmark()
+    : endpointService(0), report("endpoint", "local endpoint server")
+{
+}
+
+tst_QSparqlEndpointBenchmark::~tst_QSparqlEndpointBenchmark()
+{
+}
+
+void tst_QSparqlEndpointBenchmark::initTestCase()
+{
+    endpointService = new EndpointService(port);
+    endpointService->start();
+    while (!endpointService->isRunning())
+        QTest::qWait(100);
+
+    // For running the test without installing the plugins. Should work in
+    // normal and vpath builds.
+    QCoreApplication::addLibraryPath("../../../plugins");
+}
+
+void tst_QSparqlEndpointBenchmark::cleanupTestCase()
+{
+    endpointService->stopService(2000);
+    delete endpointService;
+
+    const QString fileName = report.save();
+    if (!fileName.isEmpty())
+        qDebug() << "Report saved in" << fileName;
+}
+
+QString tst_QSparqlEndpointBenchmark::generatePath(const QString& format, int rows,
+                                                   const QString& parameters)
+{
+    return QString("/generate;format=%1;rows=%2;columns=uri,string,integer,datetime%3")
+           .arg(format).arg(rows).arg(parameters);
+}
+
+void tst_QSparqlEndpointBenchmark::addTimes(const QString& name, int rows,
+                                             const QList<qint64>& times,
+                                             const QList<qint64>& firstDataTimes,
+                                             const QList<qint64>& peakMemory)
+{
+    report.addResult(name, times);
+    report.addResult(name + "-first-row", firstDataTimes);
+    if (!peakMemory.isEmpty() && peakMemory.first() >= 0)
+        report.addResult(name + "-peak-kB", peakMemory);
+
+    QList<qint64> sorted = times;
+    qSort(sorted);
+    const qint64 median = sorted[sorted.count() / 2];
+    if (median > 0)
+        fprintf(stderr, "%-50s %lld rows/s\n", qPrintable(name), rows * Q_INT64_C(1000000) / median);
+}
+
+static void addFormatRows(bool driverFormatsOnly)
+{
+    QTest::addColumn<QString>("format");
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<QString>("parameters");
+
+    const char* formats[] = { "xml", "ntriples", "json", "tsv" };
+    // The endpoint driver reads SELECT results as XML and graph results as
+    // N-Triples, so the other formats are only transferred
+    const int formatCount = driverFormatsOnly ? 2 : 4;
+    for (int i = 0; i < formatCount; ++i) {
+        const QString format = formats[i];
+        QTest::newRow(qPrintable(format)) << format << 10000 << QString();
+        QTest::newRow(qPrintable(format + "-chunked")) << format << 10000 << ";chunk=4096";
+        QTest::newRow(qPrintable(format + "-gzip")) << format << 10000 << ";gzip=1";
+        QTest::newRow(qPrintable(format + "-throttled")) << format << 2000 << ";kbps=1024";
+    }
+}
+
+void tst_QSparqlEndpointBenchmark::driver_data()
+{
+    addFormatRows(true);
+}
+
+void tst_QSparqlEndpointBenchmark::driver()
+{
+    // Rows per second, time to the first dataReady() and peak memory of the
+    // endpoint driver reading a result
+    QFETCH(QString, format);
+    QFETCH(int, rows);
+    QFETCH(QString, parameters);
+
+    QSparqlConnectionOptions options;
+    options.setHostName("127.0.0.1");
+    options.setPort(port);
+    options.setPath(generatePath(format, rows, parameters));
+    QSparqlConnection conn("QSPARQL_ENDPOINT", options);
+    const QSparqlQuery query = format == "ntriples"
+        ? QSparqlQuery("CONSTRUCT { ?s ?p ?o } WHERE { ?s ?p ?o }", QSparqlQuery::ConstructStatement)
+        : QSparqlQuery("SELECT ?u ?s ?i ?d WHERE { ?u ?p ?s }");
+
+    QList<qint64> times;
+    QList<qint64> firstRowTimes;
+    QList<qint64> peakMemory;
+    for (int run = 0; run < runs; ++run) {
+        resetPeakMemory();
+        const qint64 baseline = memoryStatus("VmRSS:");
+
+        QElapsedTimer timer;
+        timer.start();
+        FirstDataTimer firstRow(timer);
+        QSparqlResult* r = conn.exec(query);
+        connect(r, SIGNAL(dataReady(int)), &firstRow, SLOT(dataArrived()));
+        connect(r, SIGNAL(finished()), &firstRow, SLOT(dataArrived()));
+        r->waitForFinished();
+        times.append(elapsedUsecs(timer));
+        firstRowTimes.append(firstRow.elapsed());
+
+        const qint64 peak = memoryStatus("VmHWM:");
+        peakMemory.append(peak >= 0 && baseline >= 0 ? peak - baseline : -1);
+
+        QVERIFY2(!r->hasError(), qPrintable(r->lastError().message()));
+        QCOMPARE(r->size(), rows);
+        delete r;
+    }
+    addTimes("endpoint-driver-" + QString(QTest::currentDataTag()), rows,
+             times, firstRowTimes, peakMemory);
+}
+
+void tst_QSparqlEndpointBenchmark::transfer_data()
+{
+    addFormatRows(false);
+}
+
+void tst_QSparqlEndpointBenchmark::transfer()
+{
+    // The same replies read without parsing them, the lower bound for the
+    // driver
+    QFETCH(QString, format);
+    QFETCH(int, rows);
+    QFETCH(QString, parameters);
+
+    QNetworkAccessManager manager;
+    QUrl url;
+    url.setScheme("http");
+    url.setHost("127.0.0.1");
+    url.setPort(port);
+    url.setPath(generatePath(format, rows, parameters));
+
+    QList<qint64> times;
+    QList<qint64> firstByteTimes;
+    QList<qint64> peakMemory;
+    for (int run = 0; run < runs; ++run) {
+        resetPeakMemory();
+        const qint64 baseline = memoryStatus("VmRSS:");
+
+        QElapsedTimer timer;
+        timer.start();
+        FirstDataTimer firstByte(timer);
+        QNetworkReply* reply = manager.get(QNetworkRequest(url));
+        connect(reply, SIGNAL(readyRead()), &firstByte, SLOT(dataArrived()));
+        QEventLoop loop;
+        qint64 bytes = 0;
+        while (!reply->isFinished()) {
+            loop.processEvents(QEventLoop::WaitForMoreEvents);
+            bytes += reply->readAll().size();
+        }
+        bytes += reply->readAll().size();
+        times.append(elapsedUsecs(timer));
+        firstByteTimes.append(firstByte.elapsed());
+
+        const qint64 peak = memoryStatus("VmHWM:");
+        peakMemory.append(peak >= 0 && baseline >= 0 ? peak - baseline : -1);
+
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QVERIFY(bytes > 0);
+        delete reply;
+    }
+    addTimes("endpoint-transfer-" + QString(QTest::currentDataTag()), rows,
+             times, firstByteTimes, peakMemory);
+}
+
+void tst_QSparqlEndpointBenchmark::keep_alive_data()
+{
+    QTest::addColumn<QString>("parameters");
+
+    QTest::newRow("keep-alive") << QString();
+    QTest::newRow("close") << ";keepalive=0";
+}
+
+void tst_QSparqlEndpointBenchmark::keep_alive()
+{
+    // Many small queries, where setting up connections dominates
+    QFETCH(QString, parameters);
+
+    QSparqlConnectionOptions options;
+    options.setHostName("127.0.0.1");
+    options.setPort(port);
+    options.setPath(generatePath("xml", 10, parameters));
+    QSparqlConnection conn("QSPARQL_ENDPOINT", options);
+    const QSparqlQuery query("SELECT ?u ?s ?i ?d WHERE { ?u ?p ?s }");
+
+    QList<qint64> times;
+    for (int run = 0; run < runs; ++run) {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < 50; ++i) {
+            QSparqlResult* r = conn.exec(query);
+            r->waitForFinished();
+            QVERIFY(!r->hasError());
+            QCOMPARE(r->size(), 10);
+            delete r;
+        }
+        times.append(elapsedUsecs(timer));
+    }
+    report.addResult("endpoint-queries-" + QString(QTest::currentDataTag()), times);
+}
+
+QTEST_MAIN(tst_QSparqlEndpointBenchmark)
+#include "tst_qsparql_endpoint_benchmark.moc"
@@ -41,6 +41,8 @@
 #include <QtSparql>
 #include <private/qsparqlntriples_p.h>
 
+#include "../messagerecorder.h"
+
 class tst_QSparqlNTriples : public QObject
 {
     Q_OBJECT
@@ -57,6 +59,10 @@ public slots:
 
 private slots:
     void parse_file();
+    void parse_long_literals();
+    void parse_unicode_escapes();
+    void parse_parallel();
+    void interned_iris();
 };
 
 tst_QSparqlNTriples::tst_QSparqlNTriples()
@@ -217,5 +223,129 @@ void tst_QSparqlNTriples::parse_file()
 
 }
 
+void tst_QSparqlNTriples::parse_long_literals()
+{
+    // Literals longer than one scanning block, with the escapes and
+    // non-ASCII characters at different offsets
+    const QByteArray filler("abcdefghijklmnopqrstuvwxyz0123456789");
+    QByteArray buffer;
+    QStringList expected;
+    for (int pos = 0; pos <= filler.size(); ++pos) {
+        QByteArray literal = filler;
+        literal.insert(pos, "\\\"");
+        buffer += "<urn:s> <urn:p> \"" + literal + "\" .\n";
+        expected << "\"" + QString::fromLatin1(filler).insert(pos, "\\\\\\\"") + "\"";
+
+        literal = filler;
+        literal.insert(pos, "\xc3\xa9");
+        buffer += "<urn:s> <urn:p> \"" + literal + "\"@fr .\n";
+        expected << "\"" + QString::fromUtf8(literal) + "\"@fr";
+    }
+
+    QSparqlNTriples parser(buffer);
+    QVector<QSparqlResultRow> results = parser.parse();
+    QCOMPARE(results.count(), expected.count());
+    for (int i = 0; i < results.count(); ++i) {
+        QCOMPARE(results[i].count(), 3);
+        QCOMPARE(results[i].binding("s").toString(), QString("<urn:s>"));
+        QCOMPARE(results[i].binding("o").toString(), expected[i]);
+    }
+}
+
+void tst_QSparqlNTriples::parse_unicode_escapes()
+{
+    QByteArray buffer("_:b1 <urn:p> \"caf\\u00E9 \\U0001F600 \\uD83D\\uDE00\" .\n");
+    QSparqlNTriples parser(buffer);
+    QVector<QSparqlResultRow> results = parser.parse();
+    QCOMPARE(results.count(), 1);
+    QVERIFY(results[0].binding("s").isBlank());
+    QCOMPARE(results[0].variableName(0), QString("s"));
+    QCOMPARE(results[0].value("o").toString(),
+             QString::fromUtf8("caf\xc3\xa9 \xf0\x9f\x98\x80 \xf0\x9f\x98\x80"));
+}
+
+void tst_QSparqlNTriples::parse_parallel()
+{
+    // Enough statements for several chunks. Some literals span lines, so
+    // that chunks get split inside them, and some lines have errors.
+    QByteArray buffer;
+    for (int i = 0; i < 60000; ++i) {
+        const QByteArray n = QByteArray::number(i);
+        switch (i % 7) {
+        case 0:
+            buffer += "<urn:s" + n + "> <urn:p> \"line one\nline two\nline three " + n + "\" .\n";
+            break;
+        case 1:
+            buffer += "_:b" + n + " <urn:p> \"caf\xc3\xa9\"@fr .\n";
+            break;
+        case 2:
+            buffer += "# comment " + n + "\n\n";
+            break;
+        case 3:
+            if (i % 700 == 3)
+                buffer += "<urn:s" + n + "> junk\n";
+            else
+                buffer += "<urn:s" + n + "> <urn:p> \"" + n + "\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n";
+            break;
+        default:
+            buffer += "<urn:s" + n + "> <urn:p> <urn:o" + n + "> .\n";
+            break;
+        }
+    }
+
+    MessageRecorder recorder;
+    recorder.addMsgTypeToRecord(QtWarningMsg);
+
+    QSparqlNTriples sequential(buffer);
+    const QVector<QSparqlResultRow> expected = sequential.parse();
+    const QStringList expectedWarnings = recorder[QtWarningMsg];
+    QVERIFY(!expectedWarnings.isEmpty());
+
+    QSparqlNTriples parallel(buffer);
+    const QVector<QSparqlResultRow> results = parallel.parseParallel(4);
+    QCOMPARE(recorder[QtWarningMsg].mid(expectedWarnings.count()), expectedWarnings);
+
+    QCOMPARE(results.count(), expected.count());
+    for (int i = 0; i < results.count(); ++i) {
+        QCOMPARE(results[i].count(), expected[i].count());
+        for (int j = 0; j < results[i].count(); ++j)
+            QCOMPARE(results[i].binding(j).toString(), expected[i].binding(j).toString());
+    }
+    QCOMPARE(parallel.lineNumber, sequential.lineNumber);
+}
+
+void tst_QSparqlNTriples::interned_iris()
+{
+    QByteArray buffer(
+        "<urn:s1> <http://example.org/property> _:b1 .\n"
+        "<urn:s2> <http://example.org/property> _:b1 .\n"
+        "<urn:s3> <http://example.org/property> \"x\"^^<http://example.org/type> .\n"
+        "<urn:s4> <http://example.org/property> \"y\"^^<http://example.org/type> .\n");
+    QSparqlNTriples parser(buffer);
+    QVector<QSparqlResultRow> results = parser.parse();
+    QCOMPARE(results.count(), 4);
+
+    // The repeated predicates share one QUrl
+    QUrl p1 = results[0].value("p").toUrl();
+    QUrl p2 = results[3].value("p").toUrl();
+    QCOMPARE(p1, QUrl("http://example.org/property"));
+    QCOMPARE(p1, p2);
+    QVERIFY(p1.data_ptr() == p2.data_ptr());
+
+    QCOMPARE(results[1].binding("o").toString(), QString("_:b1"));
+    QCOMPARE(results[3].binding("o").dataTypeUri(), QUrl("http://example.org/type"));
+
+    // A full pool still decodes, it just stops sharing
+    QSparqlIriPool pool(1);
+    QUrl a1 = pool.fromEncoded("urn:a", 5);
+    QUrl b1 = pool.fromEncoded("urn:b", 5);
+    QUrl a2 = pool.fromEncoded("urn:a", 5);
+    QUrl b2 = pool.fromEncoded("urn:b", 5);
+    QCOMPARE(pool.count(), 1);
+    QCOMPARE(b2, QUrl("urn:b"));
+    QVERIFY(a1.data_ptr() == a2.data_ptr());
+    QVERIFY(b1.data_ptr() != b2.data_ptr());
+}
+
 QTEST_MAIN(tst_QSparqlNTriples)
 #include "tst_qsparql_ntriples.moc"
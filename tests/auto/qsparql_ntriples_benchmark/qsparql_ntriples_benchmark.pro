@@ -0,0 +1,7 @@
+include(../sparqltest.pri)
+CONFIG += qt warn_on console depend_includepath
+QT += testlib
+
+SOURCES  += tst_qsparql_ntriples_benchmark.cpp
+
+#QT = sparql # enable this later
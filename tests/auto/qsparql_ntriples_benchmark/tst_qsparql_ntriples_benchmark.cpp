@@ -0,0 +1,133 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the test suite of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtSparql>
+#include <private/qsparqlntriples_p.h>
+
+Q_DECLARE_METATYPE(QByteArray)
+
+class tst_QSparqlNTriplesBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_QSparqlNTriplesBenchmark();
+    virtual ~tst_QSparqlNTriplesBenchmark();
+
+private slots:
+    void parse_data();
+    void parse();
+
+private:
+    static QByteArray generate(const char* object, int statements);
+};
+
+tst_QSparqlNTriplesBenchmark::tst_QSparqlNTriplesBenchmark()
+{
+}
+
+tst_QSparqlNTriplesBenchmark::~tst_QSparqlNTriplesBenchmark()
+{
+}
+
+// Generates a CONSTRUCT-like dump with distinct subjects and the given
+// object in every statement
+QByteArray tst_QSparqlNTriplesBenchmark::generate(const char* object, int statements)
+{
+    QByteArray buffer;
+    for (int i = 0; i < statements; ++i) {
+        buffer += "<http://www.example.org/resource/";
+        buffer += QByteArray::number(i);
+        buffer += "> <http://www.semanticdesktop.org/ontologies/2007/03/22/nmo#plainTextMessageContent> ";
+        buffer += object;
+        buffer += " .\n";
+    }
+    return buffer;
+}
+
+void tst_QSparqlNTriplesBenchmark::parse_data()
+{
+    QTest::addColumn<QByteArray>("buffer");
+    QTest::addColumn<int>("statements");
+
+    const int statements = 10000;
+
+    QByteArray longText;
+    for (int i = 0; i < 40; ++i)
+        longText += "Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do eiusmod. ";
+
+    QTest::newRow("uri_objects") <<
+        generate("<http://www.example.org/resource/object>", statements) << statements;
+    QTest::newRow("blank_node_objects") <<
+        generate("_:blank1", statements) << statements;
+    QTest::newRow("short_literals") <<
+        generate("\"Short subject line\"", statements) << statements;
+    QTest::newRow("long_literals") <<
+        generate(("\"" + longText + "\"").constData(), statements) << statements;
+    QTest::newRow("long_escaped_literals") <<
+        generate(("\"" + longText + "\\n\\\"quoted\\\"\\n" + longText + "\"").constData(), statements) << statements;
+    QTest::newRow("long_utf8_literals") <<
+        generate(("\"" + longText + "\xc3\xa9\xe2\x82\xac" + longText + "\"").constData(), statements) << statements;
+    QTest::newRow("unicode_escaped_literals") <<
+        generate("\"caf\\u00E9 \\U0001F600\"", statements) << statements;
+    QTest::newRow("language_literals") <<
+        generate("\"chat\"@fr", statements) << statements;
+    QTest::newRow("typed_literals") <<
+        generate("\"42\"^^<http://www.w3.org/2001/XMLSchema#integer>", statements) << statements;
+}
+
+void tst_QSparqlNTriplesBenchmark::parse()
+{
+    QFETCH(QByteArray, buffer);
+    QFETCH(int, statements);
+
+    QVector<QSparqlResultRow> results;
+    QBENCHMARK {
+        QSparqlNTriples parser(buffer);
+        results = parser.parse();
+    }
+
+    QCOMPARE(results.count(), statements);
+    QCOMPARE(results.last().count(), 3);
+}
+
+QTEST_MAIN(tst_QSparqlNTriplesBenchmark)
+#include "tst_qsparql_ntriples_benchmark.moc"
@@ -0,0 +1,22 @@
+include(../sparqltest.pri)
+CONFIG += qt warn_on console depend_includepath
+# QSparqlResultsList needs the declarative module, and QApplication from
+# QTEST_MAIN()
+QT += testlib xml network gui
+equals(QT_MAJOR_VERSION, 4): QT += declarative
+equals(QT_MAJOR_VERSION, 5): QT += qml
+
+HEADERS += ../utils/syntheticdriver.h \
+           ../utils/benchmarkreport.h \
+           ../utils/memorynetworkaccessmanager.h
+SOURCES += tst_qsparql_synthetic_benchmark.cpp \
+           ../utils/syntheticdriver.cpp \
+           ../utils/benchmarkreport.cpp \
+           ../utils/memorynetworkaccessmanager.cpp
+
+check.depends = $$TARGET
+check.commands = ./tst_qsparql_synthetic_benchmark
+
+QMAKE_EXTRA_TARGETS += check
+
+#QT = sparql # enable this later
@@ -0,0 +1,570 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the test suite of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "../utils/syntheticdriver.h"
+#include "../utils/benchmarkreport.h"
+#include "../utils/memorynetworkaccessmanager.h"
+
+#include <QtTest/QtTest>
+#include <QtSparql>
+#include <private/qsparqlntriples_p.h>
+#include <private/qsparqlresultslist_p.h>
+
+// Every benchmark is repeated this many times; the report has the median,
+// mean and total of the times, in microseconds
+static const int runs = 20;
+
+static qint64 elapsedUsecs(const QElapsedTimer& timer)
+{
+#if QT_VERSION >= 0x040800
+    return timer.nsecsElapsed() / 1000;
+#else
+    return timer.elapsed() * 1000;
+#endif
+}
+
+class tst_QSparqlSyntheticBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_QSparqlSyntheticBenchmark();
+    virtual ~tst_QSparqlSyntheticBenchmark();
+
+public slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+private slots:
+    void exec_data();
+    void exec();
+    void iterate_data();
+    void iterate();
+    void query_model();
+    void query_model_scroll();
+    void query_model_keyed_requery();
+    void results_list();
+    void results_list_requery();
+    void results_list_keyed_requery();
+    void xml_parser();
+    void ntriples_parser();
+
+private:
+    static QSparqlConnectionOptions syntheticOptions(int rows, const QString& columns);
+    static QByteArray generateXml(int rows);
+    static QByteArray generateNTriples(int statements);
+
+    BenchmarkReport report;
+};
+
+tst_QSparqlSyntheticBenchmark::tst_QSparqlSyntheticBenchmark()
+    : report("synthetic", "synthetic driver")
+{
+}
+
+tst_QSparqlSyntheticBenchmark::~tst_QSparqlSyntheticBenchmark()
+{
+}
+
+void tst_QSparqlSyntheticBenchmark::initTestCase()
+{
+    registerSyntheticDriver();
+}
+
+void tst_QSparqlSyntheticBenchmark::cleanupTestCase()
+{
+    const QString fileName = report.save();
+    if (!fileName.isEmpty())
+        qDebug() << "Report saved in" << fileName;
+}
+
+QSparqlConnectionOptions tst_QSparqlSyntheticBenchmark::syntheticOptions(int rows,
+                                                                         const QString& columns)
+{
+    QSparqlConnectionOptions options;
+    options.setOption("rows", rows);
+    options.setOption("columns", columns);
+    return options;
+}
+
+void tst_QSparqlSyntheticBenchmark::exec_data()
+{
+    QTest::addColumn<QString>("benchmarkName");
+    QTest::addColumn<int>("executionMethod");
+
+    QTest::newRow("async") << "synthetic-exec-Async" << (int)QSparqlQueryOptions::AsyncExec;
+    QTest::newRow("sync") << "synthetic-exec-Sync" << (int)QSparqlQueryOptions::SyncExec;
+}
+
+void tst_QSparqlSyntheticBenchmark::exec()
+{
+    // The cost of executing a query and deleting its result, when the store
+    // costs nothing
+    QFETCH(QString, benchmarkName);
+    QFETCH(int, executionMethod);
+
+    QSparqlConnection conn("QSPARQL_SYNTHETIC", syntheticOptions(1, "uri"));
+    QSparqlQueryOptions queryOptions;
+    queryOptions.setExecutionMethod((QSparqlQueryOptions::ExecutionMethod)executionMethod);
+    const QSparqlQuery query("SELECT ?u WHERE { ?u a nmm:MusicPiece }");
+
+    QList<qint64> times;
+    for (int run = 0; run < runs; ++run) {
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < 100; ++i) {
+            QSparqlResult* r = conn.exec(query, queryOptions);
+            r->waitForFinished();
+            QVERIFY(!r->hasError());
+            delete r;
+        }
+        times.append(elapsedUsecs(timer));
+    }
+    report.addResult(benchmarkName, times);
+}
+
+void tst_QSparqlSyntheticBenchmark::iterate_data()
+{
+    QTest::addColumn<QString>("benchmarkName");
+    QTest::addColumn<int>("executionMethod");
+    QTest::addColumn<QString>("columns");
+    QTest::addColumn<QString>("access");
+
+    const QString columns = "uri,string,integer,double,datetime";
+    const char* accesses[] = { "next", "value", "stringValue", "binding", "current", "fetchBlock" };
+    for (unsigned int i = 0; i < sizeof(accesses) / sizeof(accesses[0]); ++i) {
+        const QString access = accesses[i];
+        QTest::newRow(qPrintable("async-" + access))
+            << "synthetic-iterate-Async-" + access << (int)QSparqlQueryOptions::AsyncExec
+            << columns << access;
+        QTest::newRow(qPrintable("sync-" + access))
+            << "synthetic-iterate-Sync-" + access << (int)QSparqlQueryOptions::SyncExec
+            << columns << access;
+    }
+    // Rows which need whole bindings instead of values
+    QTest::newRow("async-value-bindings")
+        << "synthetic-iterate-Async-value-bindings" << (int)QSparqlQueryOptions::AsyncExec
+        << "uri,bnode,langstring" << "value";
+}
+
+void tst_QSparqlSyntheticBenchmark::iterate()
+{
+    QFETCH(QString, benchmarkName);
+    QFETCH(int, executionMethod);
+    QFETCH(QString, columns);
+    QFETCH(QString, access);
+
+    const int rows = 10000;
+    const int columnCount = columns.split(',').count();
+    QSparqlConnection conn("QSPARQL_SYNTHETIC", syntheticOptions(rows, columns));
+    QSparqlQueryOptions queryOptions;
+    queryOptions.setExecutionMethod((QSparqlQueryOptions::ExecutionMethod)executionMethod);
+    const QSparqlQuery query("SELECT * WHERE { ?s ?p ?o }");
+
+    QList<qint64> times;
+    for (int run = 0; run < runs; ++run) {
+        QSparqlResult* r = conn.exec(query, queryOptions);
+        r->waitForFinished();
+        QVERIFY(!r->hasError());
+
+        int count = 0;
+        QElapsedTimer timer;
+        timer.start();
+        if (access == "fetchBlock") {
+            QSparqlRowBlock block;
+            int fetched;
+            while ((fetched = r->fetchBlock(100, &block)) > 0)
+                count += fetched;
+        } else {
+            while (r->next()) {
+                if (access == "value") {
+                    for (int c = 0; c < columnCount; ++c)
+                        r->value(c);
+                } else if (access == "stringValue") {
+                    for (int c = 0; c < columnCount; ++c)
+                        r->stringValue(c);
+                } else if (access == "binding") {
+                    for (int c = 0; c < columnCount; ++c)
+                        r->binding(c);
+                } else if (access == "current") {
+                    r->current();
+                }
+                ++count;
+            }
+        }
+        times.append(elapsedUsecs(timer));
+        QCOMPARE(count, rows);
+        delete r;
+    }
+    report.addResult(benchmarkName, times);
+}
+
+void tst_QSparqlSyntheticBenchmark::query_model()
+{
+    const int rows = 5000;
+    const int columns = 3;
+    QSparqlConnection conn("QSPARQL_SYNTHETIC", syntheticOptions(rows, "uri,string,integer"));
+    const QSparqlQuery query("SELECT ?u ?name ?count WHERE { ?u nie:title ?name ; nie:usageCounter ?count }");
+
+    QList<qint64> populateTimes;
+    QList<qint64> readTimes;
+    for (int run = 0; run < runs; ++run) {
+        QSparqlQueryModel model;
+        QEventLoop loop;
+        connect(&model, SIGNAL(finished()), &loop, SLOT(quit()));
+
+        QElapsedTimer timer;
+        timer.start();
+        model.setQuery(query, conn);
+        loop.exec();
+        populateTimes.append(elapsedUsecs(timer));
+        QCOMPARE(model.rowCount(), rows);
+
+        timer.restart();
+        for (int row = 0; row < rows; ++row) {
+            for (int column = 0; column < columns; ++column)
+                model.data(model.index(row, column));
+        }
+        readTimes.append(elapsedUsecs(timer));
+    }
+    report.addResult("synthetic-querymodel-fin", populateTimes);
+    report.addResult("synthetic-querymodel-read", readTimes);
+}
+
+void tst_QSparqlSyntheticBenchmark::query_model_scroll()
+{
+    // A view showing 40 rows of 10 columns, scrolling one row per frame.
+    // Every frame reads each visible cell for the display role.
+    const int rows = 5000;
+    const int columns = 10;
+    const int visibleRows = 40;
+    const int frames = 1000;
+    QSparqlConnection conn("QSPARQL_SYNTHETIC",
+                           syntheticOptions(rows, "uri,string,integer,string,integer,"
+                                                  "uri,string,integer,string,integer"));
+    const QSparqlQuery query("SELECT ?u ?a ?b ?c ?d ?e ?f ?g ?h ?i WHERE { ?u a nie:InformationElement }");
+
+    QSparqlQueryModel model;
+    QEventLoop loop;
+    connect(&model, SIGNAL(finished()), &loop, SLOT(quit()));
+    model.setQuery(query, conn);
+    loop.exec();
+    QCOMPARE(model.rowCount(), rows);
+    QCOMPARE(model.columnCount(), columns);
+
+    // The cached values must be the ones of the result
+    for (int row = 0; row < visibleRows; ++row) {
+        const QSparqlResultRow resultRow = model.resultRow(row);
+        for (int column = 0; column < columns; ++column)
+            QCOMPARE(model.data(model.index(row, column)), resultRow.value(column));
+    }
+
+    QList<qint64> times;
+    for (int run = 0; run < runs; ++run) {
+        QElapsedTimer timer;
+        timer.start();
+        for (int frame = 0; frame < frames; ++frame) {
+            for (int row = frame; row < frame + visibleRows; ++row) {
+                for (int column = 0; column < columns; ++column)
+                    model.data(model.index(row, column));
+            }
+        }
+        times.append(elapsedUsecs(timer));
+    }
+    report.addResult("synthetic-querymodel-scroll", times);
+}
+
+void tst_QSparqlSyntheticBenchmark::query_model_keyed_requery()
+{
+    // A periodic refresh of a 2000 row model where one row has been added.
+    // The synthetic driver generates the same rows for the same options, so
+    // the rows of the two connections only differ by the last one.
+    const int rows = 2000;
+    QSparqlConnection conn("QSPARQL_SYNTHETIC", syntheticOptions(rows, "uri,string,integer"));
+    QSparqlConnection connAdded("QSPARQL_SYNTHETIC", syntheticOptions(rows + 1, "uri,string,integer"));
+    const QSparqlQuery query("SELECT ?u ?name ?count WHERE { ?u nie:title ?name ; nie:usageCounter ?count }");
+
+    QSparqlQueryModel model;
+    model.setKeyColumn("uri0");
+    QCOMPARE(model.keyColumn(), QString("uri0"));
+    QEventLoop loop;
+    connect(&model, SIGNAL(finished()), &loop, SLOT(quit()));
+    model.setQuery(query, conn);
+    loop.exec();
+    QCOMPARE(model.rowCount(), rows);
+
+    QSignalSpy resetSpy(&model, SIGNAL(modelReset()));
+    QSignalSpy insertSpy(&model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+    QSignalSpy removeSpy(&model, SIGNAL(rowsRemoved(QModelIndex, int, int)));
+    QSignalSpy changeSpy(&model, SIGNAL(dataChanged(QModelIndex, QModelIndex)));
+
+    QList<qint64> times;
+    for (int run = 0; run < runs; ++run) {
+        QElapsedTimer timer;
+        timer.start();
+        model.setQuery(query, connAdded);
+        loop.exec();
+        model.setQuery(query, conn);
+        loop.exec();
+        times.append(elapsedUsecs(timer));
+    }
+    report.addResult("synthetic-querymodel-keyed-requery", times);
+
+    QCOMPARE(model.rowCount(), rows);
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(changeSpy.count(), 0);
+    QCOMPARE(insertSpy.count(), runs);
+    QCOMPARE(removeSpy.count(), runs);
+    QCOMPARE(insertSpy.first().at(1).toInt(), rows);
+    QCOMPARE(insertSpy.first().at(2).toInt(), rows);
+}
+
+void tst_QSparqlSyntheticBenchmark::results_list()
+{
+    const int rows = 5000;
+    const int columns = 3;
+    SparqlConnectionOptions options;
+    options.setDriverName("QSPARQL_SYNTHETIC");
+    options.setOption("rows", rows);
+    options.setOption("columns", "uri,string,integer");
+
+    QList<qint64> populateTimes;
+    QList<qint64> readTimes;
+    QList<qint64> delegateTimes;
+    for (int run = 0; run < runs; ++run) {
+        QSparqlResultsList list;
+        list.setOptions(&options);
+        QEventLoop loop;
+        connect(&list, SIGNAL(finished()), &loop, SLOT(quit()));
+
+        QElapsedTimer timer;
+        timer.start();
+        list.setQuery("SELECT ?u ?name ?count WHERE { ?u nie:title ?name ; nie:usageCounter ?count }");
+        loop.exec();
+        populateTimes.append(elapsedUsecs(timer));
+        QCOMPARE(list.count(), rows);
+
+        timer.restart();
+        for (int row = 0; row < rows; ++row) {
+            const QModelIndex index = list.index(row);
+            for (int column = 0; column < columns; ++column)
+                list.data(index, Qt::UserRole + 1 + column);
+        }
+        readTimes.append(elapsedUsecs(timer));
+
+        // A delegate reading both the value and the '$' string form of
+        // each column
+        timer.restart();
+        for (int row = 0; row < rows; ++row) {
+            const QModelIndex index = list.index(row);
+            for (int role = Qt::UserRole + 1; role <= Qt::UserRole + 2 * columns; ++role)
+                list.data(index, role);
+        }
+        delegateTimes.append(elapsedUsecs(timer));
+
+        QCOMPARE(list.data(list.index(0), Qt::UserRole + 1 + columns).toString(),
+                 QString("<http://www.example.org/resource/0>"));
+    }
+    report.addResult("synthetic-resultslist-fin", populateTimes);
+    report.addResult("synthetic-resultslist-read", readTimes);
+    report.addResult("synthetic-resultslist-delegate", delegateTimes);
+}
+
+void tst_QSparqlSyntheticBenchmark::results_list_requery()
+{
+    // A search field changing the query of a list on every keystroke; the
+    // list keeps using the connection it has
+    const int queries = 200;
+    SparqlConnectionOptions options;
+    options.setDriverName("QSPARQL_SYNTHETIC");
+    options.setOption("rows", 20);
+
+    QList<qint64> times;
+    for (int run = 0; run < runs; ++run) {
+        QSparqlResultsList list;
+        list.setOptions(&options);
+        const int opened = SyntheticDriver::openCount;
+        QEventLoop loop;
+        connect(&list, SIGNAL(finished()), &loop, SLOT(quit()));
+
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < queries; ++i) {
+            list.setQuery(QString("SELECT ?u WHERE { ?u nie:title \"%1\" }").arg(i));
+            loop.exec();
+        }
+        times.append(elapsedUsecs(timer));
+        QCOMPARE(SyntheticDriver::openCount - opened, 1);
+    }
+    report.addResult("synthetic-resultslist-requery", times);
+}
+
+void tst_QSparqlSyntheticBenchmark::results_list_keyed_requery()
+{
+    // The same refresh as query_model_keyed_requery for the QML list model
+    const int rows = 2000;
+    SparqlConnectionOptions options;
+    options.setDriverName("QSPARQL_SYNTHETIC");
+    options.setOption("rows", rows);
+    SparqlConnectionOptions optionsAdded;
+    optionsAdded.setDriverName("QSPARQL_SYNTHETIC");
+    optionsAdded.setOption("rows", rows + 1);
+
+    QSparqlResultsList list;
+    list.setKeyColumn("uri0");
+    QEventLoop loop;
+    connect(&list, SIGNAL(finished()), &loop, SLOT(quit()));
+    list.setOptions(&options);
+    list.setQuery("SELECT ?u ?name ?count WHERE { ?u nie:title ?name ; nie:usageCounter ?count }");
+    loop.exec();
+    QCOMPARE(list.count(), rows);
+
+    QSignalSpy resetSpy(&list, SIGNAL(modelReset()));
+    QSignalSpy insertSpy(&list, SIGNAL(rowsInserted(QModelIndex, int, int)));
+    QSignalSpy removeSpy(&list, SIGNAL(rowsRemoved(QModelIndex, int, int)));
+
+    QList<qint64> times;
+    for (int run = 0; run < runs; ++run) {
+        QElapsedTimer timer;
+        timer.start();
+        list.setOptions(&optionsAdded);
+        loop.exec();
+        list.setOptions(&options);
+        loop.exec();
+        times.append(elapsedUsecs(timer));
+    }
+    report.addResult("synthetic-resultslist-keyed-requery", times);
+
+    QCOMPARE(list.count(), rows);
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(insertSpy.count(), runs);
+    QCOMPARE(removeSpy.count(), runs);
+}
+
+// Generates SPARQL query results XML with a URI, a plain literal and a typed
+// literal on each row
+QByteArray tst_QSparqlSyntheticBenchmark::generateXml(int rows)
+{
+    QByteArray xml =
+        "<?xml version=\"1.0\"?>\n"
+        "<sparql xmlns=\"http://www.w3.org/2005/sparql-results#\">\n"
+        "<head><variable name=\"u\"/><variable name=\"name\"/><variable name=\"count\"/></head>\n"
+        "<results>\n";
+    for (int i = 0; i < rows; ++i) {
+        const QByteArray n = QByteArray::number(i);
+        xml += "<result>"
+               "<binding name=\"u\"><uri>http://www.example.org/resource/" + n + "</uri></binding>"
+               "<binding name=\"name\"><literal>Synthetic text number " + n + "</literal></binding>"
+               "<binding name=\"count\"><literal datatype=\"http://www.w3.org/2001/XMLSchema#integer\">"
+               + n + "</literal></binding>"
+               "</result>\n";
+    }
+    xml += "</results>\n</sparql>\n";
+    return xml;
+}
+
+void tst_QSparqlSyntheticBenchmark::xml_parser()
+{
+    // The endpoint driver parsing results XML, with the network replaced by
+    // a reply in memory
+    const int rows = 5000;
+    MemoryNetworkAccessManager manager(generateXml(rows), "application/sparql-results+xml");
+    QSparqlConnectionOptions options;
+    options.setHostName("localhost");
+    options.setNetworkAccessManager(&manager);
+    QSparqlConnection conn("QSPARQL_ENDPOINT", options);
+    if (!conn.isValid())
+#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
+        QSKIP("The QSPARQL_ENDPOINT driver is not available");
+#else
+        QSKIP("The QSPARQL_ENDPOINT driver is not available", SkipAll);
+#endif
+    const QSparqlQuery query("SELECT ?u ?name ?count WHERE { ?u nie:title ?name ; nie:usageCounter ?count }");
+
+    QList<qint64> times;
+    for (int run = 0; run < runs; ++run) {
+        QElapsedTimer timer;
+        timer.start();
+        QSparqlResult* r = conn.exec(query);
+        r->waitForFinished();
+        times.append(elapsedUsecs(timer));
+        QVERIFY(!r->hasError());
+        QCOMPARE(r->size(), rows);
+        delete r;
+    }
+    report.addResult("synthetic-endpoint-xml", times);
+}
+
+QByteArray tst_QSparqlSyntheticBenchmark::generateNTriples(int statements)
+{
+    QByteArray buffer;
+    for (int i = 0; i < statements; ++i) {
+        const QByteArray n = QByteArray::number(i);
+        buffer += "<http://www.example.org/resource/" + n + "> "
+                  "<http://www.semanticdesktop.org/ontologies/2007/01/19/nie#title> "
+                  "\"Synthetic text number " + n + "\"@en .\n";
+    }
+    return buffer;
+}
+
+void tst_QSparqlSyntheticBenchmark::ntriples_parser()
+{
+    const int statements = 20000;
+    const QByteArray buffer = generateNTriples(statements);
+
+    QList<qint64> times;
+    QList<qint64> parallelTimes;
+    for (int run = 0; run < runs; ++run) {
+        QElapsedTimer timer;
+        timer.start();
+        QSparqlNTriples parser(buffer);
+        QCOMPARE(parser.parse().count(), statements);
+        times.append(elapsedUsecs(timer));
+
+        timer.restart();
+        QSparqlNTriples parallelParser(buffer);
+        QCOMPARE(parallelParser.parseParallel().count(), statements);
+        parallelTimes.append(elapsedUsecs(timer));
+    }
+    report.addResult("synthetic-ntriples", times);
+    report.addResult("synthetic-ntriples-parallel", parallelTimes);
+}
+
+QTEST_MAIN(tst_QSparqlSyntheticBenchmark)
+#include "tst_qsparql_synthetic_benchmark.moc"
@@ -0,0 +1,15 @@
+include(../sparqltest.pri)
+CONFIG += qt warn_on console depend_includepath
+QT += testlib
+
+SOURCES  += tst_qsparql_turtle.cpp
+
+check.depends = $$TARGET
+check.commands = ./tst_qsparql_turtle
+
+memcheck.depends = $$TARGET
+memcheck.commands = $$VALGRIND $$VALGRIND_OPT ./tst_qsparql_turtle
+
+QMAKE_EXTRA_TARGETS += check memcheck
+
+#QT = sparql # enable this later
@@ -0,0 +1,306 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the test suite of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtSparql>
+#include <private/qsparqlturtle_p.h>
+
+#include "../messagerecorder.h"
+
+class tst_QSparqlTurtle : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_QSparqlTurtle();
+    virtual ~tst_QSparqlTurtle();
+
+public slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+private slots:
+    void parse_triples();
+    void parse_literals();
+    void parse_blank_nodes();
+    void parse_base();
+    void parse_streaming();
+    void parse_nquads();
+    void parse_errors();
+};
+
+static const char turtleDocument[] =
+    "# A comment\n"
+    "@prefix ex: <http://example.org/> .\n"
+    "PREFIX foaf: <http://xmlns.com/foaf/0.1/>\n"
+    "ex:alice a foaf:Person ;\n"
+    "    foaf:name \"Alice\"@en, \"Alicia\"@es ;\n"
+    "    foaf:age 42 ;\n"
+    "    foaf:knows [ foaf:name \"Bob\" ], _:carol .\n"
+    "_:carol foaf:name \"\"\"Carol\n"
+    "Smith\"\"\" ; ex:list ( 1 2.5 ) ; ex:ok true .\n"
+    "<http://example.org/x> ex:note 'it\\'s' ; ex:empty () . # trailing\n";
+
+static QStringList rowStrings(const QVector<QSparqlResultRow>& rows)
+{
+    QStringList result;
+    Q_FOREACH (const QSparqlResultRow& row, rows) {
+        QStringList terms;
+        for (int i = 0; i < row.count(); ++i)
+            terms << row.binding(i).toString();
+        result << terms.join(" ");
+    }
+    return result;
+}
+
+tst_QSparqlTurtle::tst_QSparqlTurtle()
+{
+}
+
+tst_QSparqlTurtle::~tst_QSparqlTurtle()
+{
+}
+
+void tst_QSparqlTurtle::initTestCase()
+{
+}
+
+void tst_QSparqlTurtle::cleanupTestCase()
+{
+}
+
+void tst_QSparqlTurtle::init()
+{
+}
+
+void tst_QSparqlTurtle::cleanup()
+{
+}
+
+void tst_QSparqlTurtle::parse_triples()
+{
+    QSparqlTurtle parser;
+    QVector<QSparqlResultRow> results = parser.parse(QByteArray(turtleDocument));
+    QVERIFY(!parser.hasError());
+    QCOMPARE(results.count(), 16);
+
+    QCOMPARE(results[0].variableName(0), QString("s"));
+    QCOMPARE(results[0].variableName(1), QString("p"));
+    QCOMPARE(results[0].variableName(2), QString("o"));
+    QCOMPARE(results[0].value("s").toUrl(), QUrl("http://example.org/alice"));
+    QCOMPARE(results[0].value("p").toUrl(), QUrl("http://www.w3.org/1999/02/22-rdf-syntax-ns#type"));
+    QCOMPARE(results[0].value("o").toUrl(), QUrl("http://xmlns.com/foaf/0.1/Person"));
+
+    QCOMPARE(results[1].binding("o").toString(), QString("\"Alice\"@en"));
+    QCOMPARE(results[2].binding("o").toString(), QString("\"Alicia\"@es"));
+    QCOMPARE(results[2].value("s").toUrl(), QUrl("http://example.org/alice"));
+    QCOMPARE(results[3].value("o").toInt(), 42);
+    QCOMPARE(results[3].binding("o").dataTypeUri(), QUrl("http://www.w3.org/2001/XMLSchema#integer"));
+
+    // The triples of [ ... ] come before the triple using the blank node
+    QVERIFY(results[4].binding("s").isBlank());
+    QCOMPARE(results[4].value("o").toString(), QString("Bob"));
+    QCOMPARE(results[5].binding("o").toString(), results[4].binding("s").toString());
+    QCOMPARE(results[6].binding("o").toString(), QString("_:carol"));
+
+    QCOMPARE(results[7].value("o").toString(), QString("Carol\nSmith"));
+    QCOMPARE(results[12].binding("o").toString(), results[8].binding("s").toString());
+    QCOMPARE(results[14].value("o").toString(), QString("it's"));
+
+    // The empty collection is rdf:nil
+    QCOMPARE(results[15].value("s").toUrl(), QUrl("http://example.org/x"));
+    QCOMPARE(results[15].value("o").toUrl(), QUrl("http://www.w3.org/1999/02/22-rdf-syntax-ns#nil"));
+}
+
+void tst_QSparqlTurtle::parse_literals()
+{
+    QSparqlTurtle parser;
+    QVector<QSparqlResultRow> results = parser.parse(
+        "@prefix xsd: <http://www.w3.org/2001/XMLSchema#> .\n"
+        "<urn:s> <urn:p> \"tab\\tquote\\\"caf\\u00E9 \\U0001F600\" ,\n"
+        "    \"5\"^^xsd:integer, \"6\"^^<http://www.w3.org/2001/XMLSchema#integer> ,\n"
+        "    -1.5, 1e3, false, '''a 'quoted' \"\"word\"\"''', \"\" .\n");
+    QVERIFY(!parser.hasError());
+    QCOMPARE(results.count(), 8);
+
+    QCOMPARE(results[0].value("o").toString(),
+             QString::fromUtf8("tab\tquote\"caf\xc3\xa9 \xf0\x9f\x98\x80"));
+    QCOMPARE(results[1].value("o").toInt(), 5);
+    QCOMPARE(results[2].value("o").toInt(), 6);
+    QCOMPARE(results[3].binding("o").dataTypeUri(), QUrl("http://www.w3.org/2001/XMLSchema#decimal"));
+    QCOMPARE(results[3].value("o").toDouble(), -1.5);
+    QCOMPARE(results[4].binding("o").dataTypeUri(), QUrl("http://www.w3.org/2001/XMLSchema#double"));
+    QCOMPARE(results[4].value("o").toDouble(), 1000.0);
+    QCOMPARE(results[5].binding("o").dataTypeUri(), QUrl("http://www.w3.org/2001/XMLSchema#boolean"));
+    QCOMPARE(results[5].value("o").toBool(), false);
+    QCOMPARE(results[6].value("o").toString(), QString("a 'quoted' \"\"word\"\""));
+    QCOMPARE(results[7].value("o").toString(), QString(""));
+}
+
+void tst_QSparqlTurtle::parse_blank_nodes()
+{
+    QSparqlTurtle parser;
+    QVector<QSparqlResultRow> results = parser.parse(
+        "<urn:s> <urn:list> ( <urn:a> [ <urn:p> \"x\" ] ) .\n"
+        "[ <urn:p> \"y\" ] .\n"
+        "_:n1 <urn:p> _:n1 .\n");
+    QVERIFY(!parser.hasError());
+    QCOMPARE(results.count(), 8);
+
+    QStringList rows = rowStrings(results);
+    QCOMPARE(rows[0], QString("_:genid1 <http://www.w3.org/1999/02/22-rdf-syntax-ns#first> <urn:a>"));
+    QCOMPARE(rows[1], QString("_:genid2 <urn:p> \"x\""));
+    QCOMPARE(rows[2], QString("_:genid1 <http://www.w3.org/1999/02/22-rdf-syntax-ns#rest> _:genid3"));
+    QCOMPARE(rows[3], QString("_:genid3 <http://www.w3.org/1999/02/22-rdf-syntax-ns#first> _:genid2"));
+    QCOMPARE(rows[4], QString("_:genid3 <http://www.w3.org/1999/02/22-rdf-syntax-ns#rest> <http://www.w3.org/1999/02/22-rdf-syntax-ns#nil>"));
+    QCOMPARE(rows[5], QString("<urn:s> <urn:list> _:genid1"));
+    QCOMPARE(rows[6], QString("_:genid4 <urn:p> \"y\""));
+    QCOMPARE(rows[7], QString("_:n1 <urn:p> _:n1"));
+
+    // The labels of the document don't collide with the generated ones
+    QSparqlTurtle labelParser;
+    results = labelParser.parse("_:genid1 <urn:p> [] .\n_:genid-genid1 <urn:p> _:genid2 .\n");
+    QVERIFY(!labelParser.hasError());
+    rows = rowStrings(results);
+    QCOMPARE(rows.count(), 2);
+    QCOMPARE(rows[0], QString("_:genid-genid1 <urn:p> _:genid1"));
+    QCOMPARE(rows[1], QString("_:genid-genid-genid1 <urn:p> _:genid-genid2"));
+}
+
+void tst_QSparqlTurtle::parse_base()
+{
+    QSparqlTurtle parser;
+    parser.setBaseUri(QUrl("http://example.org/data/"));
+    QVector<QSparqlResultRow> results = parser.parse(
+        "<a> <b> <#c> .\n"
+        "@base <http://example.com/> .\n"
+        "@prefix : <ns/> .\n"
+        "<d> :e :f.g .\n");
+    QVERIFY(!parser.hasError());
+    QCOMPARE(results.count(), 2);
+    QCOMPARE(rowStrings(results)[0],
+             QString("<http://example.org/data/a> <http://example.org/data/b> <http://example.org/data/#c>"));
+    QCOMPARE(rowStrings(results)[1],
+             QString("<http://example.com/d> <http://example.com/ns/e> <http://example.com/ns/f.g>"));
+}
+
+void tst_QSparqlTurtle::parse_streaming()
+{
+    // Statements split at every possible place give the same rows
+    const QByteArray document(turtleDocument);
+    QSparqlTurtle reference;
+    const QStringList expected = rowStrings(reference.parse(document));
+
+    for (int chunkSize = 1; chunkSize < 16; ++chunkSize) {
+        QSparqlTurtle parser;
+        QVector<QSparqlResultRow> results;
+        for (int i = 0; i < document.size(); i += chunkSize) {
+            parser.addData(document.mid(i, chunkSize));
+            results += parser.takeResults();
+        }
+        parser.finish();
+        results += parser.takeResults();
+        QVERIFY(!parser.hasError());
+        QCOMPARE(rowStrings(results), expected);
+        QCOMPARE(parser.lineNumber(), reference.lineNumber());
+    }
+
+    // Complete statements are available before the end of the data
+    QSparqlTurtle parser;
+    parser.addData("<urn:s> <urn:p> 1 .\n<urn:s> <urn:p> 12");
+    QCOMPARE(parser.takeResults().count(), 1);
+    parser.addData("3 .\n");
+    QVector<QSparqlResultRow> results = parser.takeResults();
+    QCOMPARE(results.count(), 1);
+    QCOMPARE(results[0].value("o").toInt(), 123);
+}
+
+void tst_QSparqlTurtle::parse_nquads()
+{
+    QSparqlTurtle parser(QSparqlTurtle::NQuads);
+    QVector<QSparqlResultRow> results = parser.parse(
+        "<urn:s> <urn:p> <urn:o> <urn:g> .\n"
+        "_:b <urn:p> \"x\"@en _:g .\n"
+        "<urn:s> <urn:p> \"1\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n");
+    QVERIFY(!parser.hasError());
+    QCOMPARE(results.count(), 3);
+
+    QCOMPARE(results[0].count(), 4);
+    QCOMPARE(results[0].variableName(3), QString("g"));
+    QCOMPARE(results[0].value("g").toUrl(), QUrl("urn:g"));
+    QCOMPARE(rowStrings(results)[1], QString("_:b <urn:p> \"x\"@en _:g"));
+
+    // Quads in the default graph have no graph binding
+    QCOMPARE(results[2].count(), 3);
+    QCOMPARE(results[2].indexOf("g"), -1);
+    QCOMPARE(results[2].value("o").toInt(), 1);
+}
+
+void tst_QSparqlTurtle::parse_errors()
+{
+    MessageRecorder recorder;
+    recorder.addMsgTypeToRecord(QtWarningMsg);
+
+    QSparqlTurtle parser;
+    QVector<QSparqlResultRow> results = parser.parse(
+        "<urn:s> <urn:p> <urn:o> .\n"
+        "<urn:s> <urn:p> \"half\" , undefined:name .\n"
+        "<urn:s> <urn:p> <urn:o2> .\n");
+    QVERIFY(parser.hasError());
+    QCOMPARE(parser.lineNumber(), 2);
+    QVERIFY(parser.errorString().contains("undefined"));
+    QCOMPARE(recorder[QtWarningMsg].count(), 1);
+
+    // The rows of the statement in error are dropped
+    QCOMPARE(results.count(), 1);
+
+    QSparqlTurtle truncated;
+    truncated.parse("<urn:s> <urn:p> \"\"\"unterminated .\n");
+    QVERIFY(truncated.hasError());
+    QVERIFY(truncated.errorString().contains("end of data"));
+
+    QSparqlTurtle quads(QSparqlTurtle::NQuads);
+    quads.parse("<urn:s> <urn:p> ( <urn:o> ) .\n");
+    QVERIFY(quads.hasError());
+}
+
+QTEST_MAIN(tst_QSparqlTurtle)
+#include "tst_qsparql_turtle.moc"
@@ -42,6 +42,7 @@ Q_DECLARE_METATYPE(QVariant)
 
 #include <QtTest/QtTest>
 #include <QtSparql>
+#include <private/qsparqlbinding_p.h>
 Q_DECLARE_METATYPE(QSparqlBinding)
 
 #include <QUrl>
@@ -69,6 +70,10 @@ private slots:
     void equality_operator();
     void assignment_operator();
     void clear();
+    void data_types_data();
+    void data_types();
+    void escape_long_string();
+    void append_to();
 
 private:
     void add_toString_data_rows(const char* dataTag,
@@ -518,5 +523,119 @@ void tst_QSparqlBinding::clear()
     QCOMPARE(b4.value(), QVariant());
 }
 
+void tst_QSparqlBinding::data_types_data()
+{
+    QTest::addColumn<QString>("dataType");
+    QTest::addColumn<QString>("lexical");
+    QTest::addColumn<QVariant>("value");
+
+    const QString xsd("http://www.w3.org/2001/XMLSchema#");
+    QTest::newRow("int") << xsd + "int" << "-5" << QVariant(-5);
+    QTest::newRow("integer") << xsd + "integer" << "12" << QVariant(Q_INT64_C(12));
+    QTest::newRow("nonNegativeInteger") << xsd + "nonNegativeInteger" << "7" << QVariant(Q_UINT64_C(7));
+    QTest::newRow("unsignedInt") << xsd + "unsignedInt" << "8" << QVariant(8u);
+    QTest::newRow("short") << xsd + "short" << "3" << QVariant(3);
+    QTest::newRow("long") << xsd + "long" << "-9" << QVariant(Q_INT64_C(-9));
+    QTest::newRow("unsignedLong") << xsd + "unsignedLong" << "9" << QVariant(Q_UINT64_C(9));
+    QTest::newRow("boolean") << xsd + "boolean" << "true" << QVariant(true);
+    QTest::newRow("double") << xsd + "double" << "1.5" << QVariant(1.5);
+    QTest::newRow("float") << xsd + "float" << "2.5" << QVariant(2.5);
+    QTest::newRow("decimal") << xsd + "decimal" << "0.25" << QVariant(0.25);
+    QTest::newRow("string") << xsd + "string" << "text" << QVariant("text");
+    QTest::newRow("date") << xsd + "date" << "2011-02-03" << QVariant(QDate(2011, 2, 3));
+    QTest::newRow("dateTime") << xsd + "dateTime" << "2011-02-03T04:05:06"
+                              << QVariant(QDateTime(QDate(2011, 2, 3), QTime(4, 5, 6)));
+    QTest::newRow("base64Binary") << xsd + "base64Binary" << "Zm9v" << QVariant(QByteArray("foo"));
+    // Not known types: the value is kept as a string
+    QTest::newRow("similar_name") << xsd + "ints" << "1" << QVariant("1");
+    QTest::newRow("other_namespace") << QString("http://example.com/types#int") << "1" << QVariant("1");
+}
+
+void tst_QSparqlBinding::data_types()
+{
+    QFETCH(QString, dataType);
+    QFETCH(QString, lexical);
+    QFETCH(QVariant, value);
+
+    QSparqlBinding b("b");
+    b.setValue(lexical, QUrl(dataType));
+    QCOMPARE(b.value(), value);
+    QCOMPARE(b.dataTypeUri(), QUrl(dataType));
+
+    QSparqlBinding b2("b2", value);
+    b2.setDataTypeUri(QUrl(dataType));
+    QCOMPARE(b2.dataTypeUri(), QUrl(dataType));
+    QVERIFY(b2.toString().endsWith("^^<" + dataType + ">"));
+
+    // The drivers set the well-known types by their ID
+    const XSD::TypeId id = XSD::typeId(dataType);
+    if (id != XSD::UnknownType) {
+        QSparqlBinding b3("b");
+        QSparqlTypedLiteral::setValue(&b3, lexical, id);
+        QCOMPARE(b3.value(), value);
+        QCOMPARE(b3.dataTypeUri(), QUrl(dataType));
+        QVERIFY(b3 == b);
+    }
+}
+
+void tst_QSparqlBinding::escape_long_string()
+{
+    // Put each escaped character at every offset of a string long enough
+    // to be scanned in blocks, and compare with escaping one by one.
+    const QString special = QString::fromUtf8("\t\n\r\b\f\"'\\\x01\x0b\xc3\xa4\xe4\xb8\xad");
+    const QString filler("abcdefghijklmnopqrstuvwxyz0123456789");
+    for (int c = 0; c < special.size(); ++c) {
+        for (int pos = 0; pos < filler.size(); ++pos) {
+            QString str = filler;
+            str.insert(pos, special.at(c));
+            str.append(special.at(special.size() - 1 - c));
+
+            QString expected("\"");
+            Q_FOREACH (const QChar ch, str) {
+                switch (ch.unicode()) {
+                case '\t': expected += "\\t"; break;
+                case '\n': expected += "\\n"; break;
+                case '\r': expected += "\\r"; break;
+                case '\b': expected += "\\b"; break;
+                case '\f': expected += "\\f"; break;
+                case '\"': expected += "\\\""; break;
+                case '\'': expected += "\\'"; break;
+                case '\\': expected += "\\\\"; break;
+                default: expected += ch; break;
+                }
+            }
+            expected += "\"";
+
+            QCOMPARE(QSparqlBinding("b", str).toString(), expected);
+        }
+    }
+}
+
+void tst_QSparqlBinding::append_to()
+{
+    QSparqlBinding b1("b1", QVariant("say \"hi\""));
+    QSparqlBinding b2("b2", QUrl("urn:test"));
+    QSparqlBinding b3("b3", QVariant(54));
+    b3.setDataTypeUri(QUrl("http://www.w3.org/2001/XMLSchema#int"));
+
+    QString buffer("INSERT DATA { ");
+    b2.appendTo(&buffer);
+    buffer += " <urn:p> ";
+    b1.appendTo(&buffer);
+    buffer += ", ";
+    b3.appendTo(&buffer);
+    buffer += " . }";
+
+    QCOMPARE(buffer, "INSERT DATA { " + b2.toString() + " <urn:p> " + b1.toString()
+             + ", " + b3.toString() + " . }");
+    QCOMPARE(buffer, QString("INSERT DATA { <urn:test> <urn:p> \"say \\\"hi\\\"\", "
+                             "\"54\"^^<http://www.w3.org/2001/XMLSchema#int> . }"));
+
+    // Invalid bindings append nothing
+    QString empty("x");
+    QSparqlBinding().appendTo(&empty);
+    QCOMPARE(empty, QString("x"));
+}
+
 QTEST_MAIN( tst_QSparqlBinding )
 #include "tst_qsparqlbinding.moc"
@@ -42,6 +42,9 @@
 
 #include <QUrl>
 
+#include <private/qsparqllexer_p.h>
+#include <private/qsparqlquerytemplate_p.h>
+
 class tst_QSparqlQuery : public QObject
 {
     Q_OBJECT
@@ -64,6 +67,10 @@ private slots:
     void different_datatypes_data();
     void different_datatypes();
     void copy();
+    void unbound_placeholder();
+    void query_template();
+    void projection_data();
+    void projection();
 };
 
 tst_QSparqlQuery::tst_QSparqlQuery()
@@ -140,6 +147,12 @@ void tst_QSparqlQuery::replacement_data()
         (QStringList() << "value") <<
         (QVariantList() << "some\"thing") <<
         QString("the \"some\\\"thing\" goes here");
+
+    QTest::newRow("repeated") <<
+        QString("?:foo ?:bar $:foo, ?:foo") <<
+        (QStringList() << "foo" << "bar") <<
+        (QVariantList() << "FOO" << "BAR") <<
+        QString("\"FOO\" \"BAR\" \"FOO\", \"FOO\"");
 }
 
 void tst_QSparqlQuery::replacement()
@@ -288,5 +301,94 @@ void tst_QSparqlQuery::copy()
     QCOMPARE(q1.query(), query1);
 }
 
+void tst_QSparqlQuery::unbound_placeholder()
+{
+    QSparqlQuery q("replace ?:foo and ?:bar");
+    q.bindValue("bar", "BAR");
+    QCOMPARE(q.preparedQueryText(), QString("replace ?:foo and \"BAR\""));
+}
+
+void tst_QSparqlQuery::query_template()
+{
+    const QString text = QString::fromUtf8("select ?:a \"?:b\" $:a ?:c\xc3\xa4");
+    QSparqlQueryTemplate t(text);
+    QCOMPARE(t.text(), text);
+    QCOMPARE(t.slotCount(), 2);
+    QCOMPARE(t.placeholderCount(), 3);
+    QCOMPARE(t.slotName(0), QString("a"));
+    QCOMPARE(t.slotIndex("c"), 1);
+    QCOMPARE(t.slotIndex("b"), -1);
+
+    QVector<QString> values(2);
+    values[0] = QString::fromUtf8("\xc3\xb6");
+    // A null value leaves the placeholder in place
+    const QString expected = QString::fromUtf8("select \xc3\xb6 \"?:b\" \xc3\xb6 ?:c\xc3\xa4");
+    QCOMPARE(t.render(values), expected);
+
+    values[1] = "";
+    QCOMPARE(t.render(values), QString::fromUtf8("select \xc3\xb6 \"?:b\" \xc3\xb6 \xc3\xa4"));
+
+    QSparqlQueryTemplate empty;
+    QCOMPARE(empty.slotCount(), 0);
+    QVERIFY(empty.render(values).isEmpty());
+}
+
+void tst_QSparqlQuery::projection_data()
+{
+    QTest::addColumn<QString>("query");
+    QTest::addColumn<QStringList>("names");
+
+    QTest::newRow("variables")
+        << "select ?u ?ng $nf { ?u a nco:PersonContact; nco:nameGiven ?ng; nco:nameFamily ?nf }"
+        << (QStringList() << "u" << "ng" << "nf");
+    QTest::newRow("no space before the where clause")
+        << "select ?u{?u a nco:PersonContact}"
+        << (QStringList() << "u");
+    QTest::newRow("prologue and distinct")
+        << "# contacts\nPREFIX ex: <http://example.org/a#> BASE <http://example.org/>\n"
+           "SELECT DISTINCT ?u WHERE { ?u a ex:Contact }"
+        << (QStringList() << "u");
+    QTest::newRow("expressions with as")
+        << "SELECT (COUNT(?x) AS ?count) (CONCAT(?a, \")(\", ?b) AS ?joined) ?a "
+           "WHERE { ?x ?a ?b } GROUP BY ?a"
+        << (QStringList() << "count" << "joined" << "a");
+    QTest::newRow("tracker functions")
+        << "select ?u fn:string-join( (?ng, ?nf), ' ') AS ?joinName tracker:id(?u) "
+           "{ ?u a nco:PersonContact; nco:nameGiven ?ng; nco:nameFamily ?nf }"
+        << (QStringList() << "u" << "joinName" << "");
+    QTest::newRow("expression without as")
+        << "select (?a + 1) ?b { ?x ?a ?b }"
+        << (QStringList() << "" << "b");
+    QTest::newRow("from")
+        << "select ?s from <http://example.org/g> where { ?s ?p ?o }"
+        << (QStringList() << "s");
+    QTest::newRow("all variables")
+        << "select * { ?s ?p ?o }"
+        << QStringList();
+    QTest::newRow("ask")
+        << "ask { ?s ?p ?o }"
+        << QStringList();
+    QTest::newRow("insert")
+        << "insert { <a> a nco:PersonContact }"
+        << QStringList();
+    QTest::newRow("empty")
+        << ""
+        << QStringList();
+}
+
+void tst_QSparqlQuery::projection()
+{
+    QFETCH(QString, query);
+    QFETCH(QStringList, names);
+
+    QCOMPARE(QSparqlLexer::projection(query), names);
+
+    // The query keeps the projection of its template, whatever is bound
+    QSparqlQuery q(query);
+    q.bindValue("ng", "x");
+    QCOMPARE(qt_sparqlQueryProjection(q), names);
+    QCOMPARE(qt_sparqlQueryProjection(QSparqlQuery(q)), names);
+}
+
 QTEST_MAIN( tst_QSparqlQuery )
 #include "tst_qsparqlquery.moc"
@@ -72,6 +72,8 @@ private slots:
     void variableName();
     void binding();
     void value();
+    void schema();
+    void schema_values();
 
 private:
 };
@@ -274,5 +276,70 @@ void tst_QSparqlResultRow::value()
     QCOMPARE(r1.value("testBinding2"), v2);
 }
 
+void tst_QSparqlResultRow::schema()
+{
+    QSparqlResultSchema schema(QStringList() << "a" << "b" << "a");
+    QCOMPARE(schema.count(), 3);
+    QCOMPARE(schema.indexOf("a"), 0);
+    QCOMPARE(schema.indexOf("b"), 1);
+    QCOMPARE(schema.indexOf("c"), -1);
+    QCOMPARE(schema.variableName(2), QString("a"));
+    QCOMPARE(schema.columnType(1), QVariant::Invalid);
+    schema.setColumnType(1, QVariant::Int);
+    QCOMPARE(schema.columnType(1), QVariant::Int);
+
+    // Bindings appended to a row with a schema get their names from it
+    QSparqlResultRow r1(schema);
+    QVERIFY(r1.hasSchema());
+    QCOMPARE(r1.schema(), schema);
+    r1.append(QSparqlBinding(QString(), QVariant(-67)));
+    QCOMPARE(r1.variableName(0), QString("a"));
+    QCOMPARE(r1.binding(0).name(), QString("a"));
+    QCOMPARE(r1.indexOf("a"), 0);
+    // Column b is in the schema, but not in the row yet
+    QCOMPARE(r1.indexOf("b"), -1);
+    QCOMPARE(r1.value("a"), QVariant(-67));
+
+    QVERIFY(!QSparqlResultRow().hasSchema());
+}
+
+void tst_QSparqlResultRow::schema_values()
+{
+    QSparqlResultSchema schema(QStringList() << "x" << "y");
+    QSparqlResultRow r1(schema);
+    r1.appendValue(QVariant(5));
+    r1.appendValue(QUrl("urn:test"));
+    QCOMPARE(r1.count(), 2);
+    QCOMPARE(r1.value(0), QVariant(5));
+    QCOMPARE(r1.value("y"), QVariant(QUrl("urn:test")));
+    QCOMPARE(r1.binding("x"), QSparqlBinding("x", QVariant(5)));
+    QCOMPARE(r1.binding(1).name(), QString("y"));
+    QVERIFY(r1.binding(1).isUri());
+
+    // A row of values equals the same row made of bindings
+    QSparqlResultRow r2;
+    r2.append(QSparqlBinding("x", QVariant(5)));
+    r2.append(QSparqlBinding("y", QUrl("urn:test")));
+    QVERIFY(r1 == r2);
+
+    // Copies detach
+    QSparqlResultRow r3(r1);
+    r3.appendValue(QVariant(1));
+    QCOMPARE(r1.count(), 2);
+    QCOMPARE(r3.count(), 3);
+
+    // Mixing bindings and values keeps the order
+    r3.append(QSparqlBinding("z", QVariant(2)));
+    QCOMPARE(r3.count(), 4);
+    QCOMPARE(r3.value(0), QVariant(5));
+    QCOMPARE(r3.value(3), QVariant(2));
+    QCOMPARE(r3.variableName(1), QString("y"));
+
+    r1.clearValues();
+    QCOMPARE(r1.count(), 2);
+    QVERIFY(!r1.binding(0).isLiteral());
+    QCOMPARE(r1.value(0), QVariant());
+}
+
 QTEST_MAIN( tst_QSparqlResultRow )
 #include "tst_qsparqlresultrow.moc"
@@ -0,0 +1,15 @@
+include(../sparqltest.pri)
+CONFIG += qt warn_on console depend_includepath
+QT += testlib
+
+SOURCES  += tst_qsparqlrowdiff.cpp
+
+check.depends = $$TARGET
+check.commands = ./tst_qsparqlrowdiff
+
+memcheck.depends = $$TARGET
+memcheck.commands = $$VALGRIND $$VALGRIND_OPT ./tst_qsparqlrowdiff
+
+QMAKE_EXTRA_TARGETS += check memcheck
+
+#QT = sparql # enable this later
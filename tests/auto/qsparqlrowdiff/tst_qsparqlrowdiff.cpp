@@ -0,0 +1,213 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the test suite of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtSparql>
+
+#include <private/qsparqlrowdiff_p.h>
+
+// Rows written as "key:value key:value ..."
+static QVector<QSparqlResultRow> makeRows(const QString& spec)
+{
+    QVector<QSparqlResultRow> rows;
+    Q_FOREACH (const QString& item, spec.split(' ', QString::SkipEmptyParts)) {
+        const QStringList parts = item.split(':');
+        QSparqlResultRow row;
+        row.append(QSparqlBinding("key", parts[0]));
+        row.append(QSparqlBinding("value", parts[1]));
+        rows.append(row);
+    }
+    return rows;
+}
+
+class tst_QSparqlRowDiff : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_QSparqlRowDiff();
+    virtual ~tst_QSparqlRowDiff();
+
+public slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+private slots:
+    void diff_apply_data();
+    void diff_apply();
+    void diff_missing_key();
+
+private:
+};
+
+tst_QSparqlRowDiff::tst_QSparqlRowDiff()
+{
+}
+
+tst_QSparqlRowDiff::~tst_QSparqlRowDiff()
+{
+}
+
+void tst_QSparqlRowDiff::initTestCase()
+{
+}
+
+void tst_QSparqlRowDiff::cleanupTestCase()
+{
+}
+
+void tst_QSparqlRowDiff::init()
+{
+}
+
+void tst_QSparqlRowDiff::cleanup()
+{
+}
+
+void tst_QSparqlRowDiff::diff_apply_data()
+{
+    QTest::addColumn<QString>("oldRows");
+    QTest::addColumn<QString>("newRows");
+    QTest::addColumn<int>("removed");
+    QTest::addColumn<int>("inserted");
+    QTest::addColumn<int>("changed");
+    QTest::addColumn<bool>("moved");
+
+    QTest::newRow("empty to empty") << "" << "" << 0 << 0 << 0 << false;
+    QTest::newRow("empty to full") << "" << "a:1 b:2 c:3" << 0 << 3 << 0 << false;
+    QTest::newRow("full to empty") << "a:1 b:2 c:3" << "" << 3 << 0 << 0 << false;
+    QTest::newRow("unchanged") << "a:1 b:2 c:3" << "a:1 b:2 c:3" << 0 << 0 << 0 << false;
+    QTest::newRow("changed rows") << "a:1 b:2 c:3" << "a:1 b:20 c:30" << 0 << 0 << 2 << false;
+    QTest::newRow("move up") << "a:1 b:2 c:3 d:4" << "d:4 a:1 b:2 c:3" << 0 << 0 << 0 << true;
+    QTest::newRow("move down") << "a:1 b:2 c:3 d:4" << "b:2 c:3 d:4 a:1" << 0 << 0 << 0 << true;
+    QTest::newRow("swap") << "a:1 b:2 c:3 d:4" << "a:1 c:3 b:2 d:4" << 0 << 0 << 0 << true;
+    QTest::newRow("reverse") << "a:1 b:2 c:3 d:4 e:5" << "e:5 d:4 c:3 b:2 a:1" << 0 << 0 << 0 << true;
+    QTest::newRow("moved and changed") << "a:1 b:2 c:3" << "c:30 a:1 b:20" << 0 << 0 << 2 << true;
+    QTest::newRow("inserted and removed") << "a:1 b:2 c:3" << "x:0 a:1 c:3 y:5" << 1 << 2 << 0 << false;
+    QTest::newRow("removed ranges") << "a:1 b:2 c:3 d:4 e:5 f:6" << "a:1 d:4 f:6" << 3 << 0 << 0 << false;
+    // Rows with the same key are matched in order
+    QTest::newRow("duplicate keys") << "a:1 a:2 b:3" << "a:2 b:3 a:1" << 0 << 0 << 2 << true;
+    QTest::newRow("duplicate key removed") << "a:1 a:2 a:3" << "a:1 a:3" << 1 << 0 << 1 << false;
+    QTest::newRow("duplicate key inserted") << "a:1 b:2" << "a:1 a:1 b:2 a:1" << 0 << 2 << 0 << false;
+    QTest::newRow("mixed") << "a:1 b:2 c:3 d:4 e:5" << "e:5 c:30 x:9 a:1" << 2 << 1 << 1 << true;
+}
+
+void tst_QSparqlRowDiff::diff_apply()
+{
+    QFETCH(QString, oldRows);
+    QFETCH(QString, newRows);
+    QFETCH(int, removed);
+    QFETCH(int, inserted);
+    QFETCH(int, changed);
+    QFETCH(bool, moved);
+
+    const QVector<QSparqlResultRow> before = makeRows(oldRows);
+    const QVector<QSparqlResultRow> after = makeRows(newRows);
+    QVector<QSparqlRowDiff::Operation> operations;
+    QVERIFY(QSparqlRowDiff::diff(before, after, "key", &operations));
+
+    int removedRows = 0;
+    int insertedRows = 0;
+    int changedRows = 0;
+    int moves = 0;
+    QVector<QSparqlResultRow> rows = before;
+    Q_FOREACH (const QSparqlRowDiff::Operation& operation, operations) {
+        // Every operation is valid for the rows it is applied to, as the
+        // ranges reported to the views have to be
+        QVERIFY(operation.count > 0);
+        QVERIFY(operation.first >= 0);
+        switch (operation.type) {
+        case QSparqlRowDiff::Operation::Remove:
+            QVERIFY(operation.first + operation.count <= rows.count());
+            removedRows += operation.count;
+            break;
+        case QSparqlRowDiff::Operation::Insert:
+            QVERIFY(operation.first <= rows.count());
+            QVERIFY(operation.source + operation.count <= after.count());
+            insertedRows += operation.count;
+            break;
+        case QSparqlRowDiff::Operation::Change:
+            QVERIFY(operation.first + operation.count <= rows.count());
+            QVERIFY(operation.source + operation.count <= after.count());
+            changedRows += operation.count;
+            break;
+        case QSparqlRowDiff::Operation::Move:
+            QCOMPARE(operation.count, 1);
+            QVERIFY(operation.first < rows.count());
+            QVERIFY(operation.destination >= 0 && operation.destination <= rows.count());
+            // Moving a row before itself or the row after it is no move
+            QVERIFY(operation.destination != operation.first);
+            QVERIFY(operation.destination != operation.first + 1);
+            ++moves;
+            break;
+        }
+        QSparqlRowDiff::apply(operation, &rows, after);
+    }
+
+    QCOMPARE(rows.count(), after.count());
+    for (int i = 0; i < rows.count(); ++i)
+        QVERIFY(rows[i] == after[i]);
+    QCOMPARE(removedRows, removed);
+    QCOMPARE(insertedRows, inserted);
+    QCOMPARE(changedRows, changed);
+    QCOMPARE(moves > 0, moved);
+}
+
+void tst_QSparqlRowDiff::diff_missing_key()
+{
+    QVector<QSparqlResultRow> before = makeRows("a:1 b:2");
+    QSparqlResultRow unkeyed;
+    unkeyed.append(QSparqlBinding("value", "3"));
+    QVector<QSparqlResultRow> after = before;
+    after.append(unkeyed);
+
+    QVector<QSparqlRowDiff::Operation> operations;
+    QVERIFY(!QSparqlRowDiff::diff(before, after, "key", &operations));
+    QVERIFY(operations.isEmpty());
+    QVERIFY(!QSparqlRowDiff::diff(after, before, "key", &operations));
+    QVERIFY(operations.isEmpty());
+    // A key which none of the rows bind
+    QVERIFY(!QSparqlRowDiff::diff(before, before, "other", &operations));
+    QVERIFY(operations.isEmpty());
+}
+
+QTEST_MAIN( tst_QSparqlRowDiff )
+#include "tst_qsparqlrowdiff.moc"
@@ -0,0 +1,132 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the test suite of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "benchmarkreport.h"
+
+#include <QtCore/qdatetime.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qtextstream.h>
+
+#include <stdio.h>
+
+BenchmarkReport::BenchmarkReport(const QString& suiteName, const QString& backend)
+    : suiteName(suiteName)
+{
+    QDomElement benchmarkElement = document.createElement("benchmark");
+    QDomElement assetElement = document.createElement("asset");
+    QDomElement createdElement = document.createElement("created");
+    QDomElement trackerElement = document.createElement("tracker");
+    QDomElement qsparqlElement = document.createElement("qsparql");
+
+    createdElement.appendChild(document.createTextNode(QDate::currentDate().toString()));
+    // comparison_tool shows the backend where it shows the Tracker version
+    trackerElement.appendChild(document.createTextNode(backend));
+    qsparqlElement.appendChild(document.createTextNode(QString("QSparql (Qt %1)").arg(qVersion())));
+
+    assetElement.appendChild(createdElement);
+    assetElement.appendChild(trackerElement);
+    assetElement.appendChild(qsparqlElement);
+    document.appendChild(benchmarkElement);
+    benchmarkElement.appendChild(assetElement);
+    benchmarkElement.appendChild(document.createElement("tests"));
+}
+
+void BenchmarkReport::addResult(const QString& name, QList<qint64> times)
+{
+    if (times.isEmpty())
+        return;
+
+    qSort(times);
+    const qint64 median = times.count() % 2
+                          ? times[times.count() / 2]
+                          : (times[times.count() / 2 - 1] + times[times.count() / 2]) / 2;
+    qint64 total = 0;
+    Q_FOREACH (qint64 time, times)
+        total += time;
+    const qint64 mean = total / times.count();
+
+    fprintf(stderr, "%-50s median %8lld  mean %8lld  total %10lld\n", qPrintable(name),
+            median, mean, total);
+
+    QDomElement test = document.createElement("test");
+    test.setAttribute("name", name);
+    QDomElement medianElement = document.createElement("median");
+    medianElement.setAttribute("value", median);
+    test.appendChild(medianElement);
+    QDomElement meanElement = document.createElement("mean");
+    meanElement.setAttribute("value", mean);
+    test.appendChild(meanElement);
+    QDomElement totalElement = document.createElement("total");
+    totalElement.setAttribute("value", total);
+    test.appendChild(totalElement);
+
+    QDomElement tests = document.documentElement().namedItem("tests").toElement();
+    tests.appendChild(test);
+    tests.setAttribute("count", tests.elementsByTagName("test").count());
+}
+
+QString BenchmarkReport::save(const QString& dirPath) const
+{
+    QString dir = dirPath;
+    if (dir.isEmpty())
+        dir = QFile::decodeName(qgetenv("QSPARQL_BENCHMARK_DIR"));
+    if (dir.isEmpty())
+        dir = QDir::homePath();
+
+    // The date in the file name keeps the reports in chronological order
+    const QString baseName = QString("benchmark-%1-%2").arg(suiteName)
+                             .arg(QDate::currentDate().toString("yyyy-MM-dd"));
+    QString filePath;
+    int run = 0;
+    do {
+        ++run;
+        filePath = QDir(dir).filePath(QString("%1.run-%2.xml").arg(baseName).arg(run));
+    } while (QFileInfo(filePath).exists());
+
+    QFile file(filePath);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        fprintf(stderr, "Could not open %s for writing\n", qPrintable(filePath));
+        return QString();
+    }
+    QTextStream out(&file);
+    document.save(out, 4);
+    return filePath;
+}
@@ -0,0 +1,67 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the test suite of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef BENCHMARKREPORT_H
+#define BENCHMARKREPORT_H
+
+#include <QtCore/qlist.h>
+#include <QtCore/qstring.h>
+#include <QtXml/qdom.h>
+
+// Collects the times of repeated benchmark runs and saves them in the format
+// read by qsparql_benchmark/comparison_tool: a "benchmark-*.xml" file with
+// the median, mean and total of each benchmark.
+class BenchmarkReport
+{
+public:
+    BenchmarkReport(const QString& suiteName, const QString& backend);
+
+    // Also prints the statistics of the times to stderr
+    void addResult(const QString& name, QList<qint64> times);
+    // Saves the report into dirPath, by default the directory given by the
+    // QSPARQL_BENCHMARK_DIR environment variable or the home directory.
+    // Returns the name of the file, or an empty string on failure.
+    QString save(const QString& dirPath = QString()) const;
+
+private:
+    QString suiteName;
+    QDomDocument document;
+};
+
+#endif // BENCHMARKREPORT_H
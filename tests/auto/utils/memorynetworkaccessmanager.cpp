@@ -0,0 +1,102 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the test suite of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "memorynetworkaccessmanager.h"
+
+#include <QtCore/qtimer.h>
+
+#include <string.h>
+
+MemoryReply::MemoryReply(const QNetworkRequest& request, const QByteArray& data,
+                         const QByteArray& contentType, QObject* parent)
+    : QNetworkReply(parent), data(data), offset(0)
+{
+    setRequest(request);
+    setUrl(request.url());
+    setOperation(QNetworkAccessManager::GetOperation);
+    setHeader(QNetworkRequest::ContentTypeHeader, contentType);
+    setHeader(QNetworkRequest::ContentLengthHeader, data.size());
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    QTimer::singleShot(0, this, SLOT(deliver()));
+}
+
+void MemoryReply::abort()
+{
+}
+
+bool MemoryReply::isSequential() const
+{
+    return true;
+}
+
+qint64 MemoryReply::bytesAvailable() const
+{
+    return data.size() - offset + QIODevice::bytesAvailable();
+}
+
+qint64 MemoryReply::readData(char* buffer, qint64 maxSize)
+{
+    const qint64 count = qMin(maxSize, qint64(data.size() - offset));
+    if (count <= 0)
+        return offset < data.size() ? 0 : -1;
+    memcpy(buffer, data.constData() + offset, count);
+    offset += count;
+    return count;
+}
+
+void MemoryReply::deliver()
+{
+    setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 200);
+    Q_EMIT metaDataChanged();
+    Q_EMIT readyRead();
+    setFinished(true);
+    Q_EMIT finished();
+}
+
+MemoryNetworkAccessManager::MemoryNetworkAccessManager(const QByteArray& data,
+                                                       const QByteArray& contentType)
+    : data(data), contentType(contentType)
+{
+}
+
+QNetworkReply* MemoryNetworkAccessManager::createRequest(Operation, const QNetworkRequest& request,
+                                                         QIODevice*)
+{
+    return new MemoryReply(request, data, contentType, this);
+}
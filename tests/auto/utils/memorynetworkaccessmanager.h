@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the test suite of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef MEMORYNETWORKACCESSMANAGER_H
+#define MEMORYNETWORKACCESSMANAGER_H
+
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtNetwork/qnetworkrequest.h>
+
+// Serves a fixed document from memory instead of the network, so that the
+// endpoint driver can be benchmarked without a server
+class MemoryReply : public QNetworkReply
+{
+    Q_OBJECT
+public:
+    MemoryReply(const QNetworkRequest& request, const QByteArray& data,
+                const QByteArray& contentType, QObject* parent);
+
+    void abort();
+    bool isSequential() const;
+    qint64 bytesAvailable() const;
+
+protected:
+    qint64 readData(char* buffer, qint64 maxSize);
+
+private Q_SLOTS:
+    void deliver();
+
+private:
+    QByteArray data;
+    int offset;
+};
+
+// Answers every request with a MemoryReply of the same document
+class MemoryNetworkAccessManager : public QNetworkAccessManager
+{
+public:
+    MemoryNetworkAccessManager(const QByteArray& data, const QByteArray& contentType);
+
+protected:
+    QNetworkReply* createRequest(Operation, const QNetworkRequest& request, QIODevice*);
+
+private:
+    QByteArray data;
+    QByteArray contentType;
+};
+
+#endif // MEMORYNETWORKACCESSMANAGER_H
@@ -0,0 +1,306 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the test suite of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "syntheticdriver.h"
+
+#include <private/qsparqlconnection_p.h>
+#include <private/qsparqlmemoryusage_p.h>
+
+#include <QtCore/qdatetime.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qtimer.h>
+#include <QtCore/qurl.h>
+#include <QtTest/QtTest>
+
+int SyntheticDriver::openCount = 0;
+
+SyntheticDriver::SyntheticDriver()
+    : latency(0), dataReadyInterval(0)
+{
+}
+
+SyntheticDriver::~SyntheticDriver()
+{
+}
+
+bool SyntheticDriver::open(const QSparqlConnectionOptions& options)
+{
+    ++openCount;
+    QVariant rowCount = options.option("rows");
+    QVariant columns = options.option("columns");
+    const QString columnTypes = columns.isValid() ? columns.toString()
+                                                  : QString("uri,string,integer");
+    const int count = rowCount.isValid() ? rowCount.toInt() : 1000;
+    // Generated rows are shared between connections with the same options,
+    // so that opening a connection inside a benchmark stays cheap
+    static QHash<QString, QVector<QSparqlResultRow> > generated;
+    const QString key = QString::number(count) + ':' + columnTypes;
+    if (!generated.contains(key))
+        generated.insert(key, generateRows(count, columnTypes.split(',')));
+    rows = generated.value(key);
+    latency = options.option("latency").toInt();
+    // dataReadyInterval() defaults to 1; without the option all the rows
+    // arrive at once
+    dataReadyInterval = options.option("dataReadyInterval").isValid() ? options.dataReadyInterval()
+                                                                      : rows.count();
+    setOpen(true);
+    return true;
+}
+
+void SyntheticDriver::close()
+{
+    rows.clear();
+    setOpen(false);
+}
+
+bool SyntheticDriver::hasFeature(QSparqlConnection::Feature f) const
+{
+    switch (f) {
+    case QSparqlConnection::QuerySize:
+    case QSparqlConnection::SyncExec:
+    case QSparqlConnection::AsyncExec:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool SyntheticDriver::hasError() const
+{
+    return false;
+}
+
+QSparqlResult* SyntheticDriver::exec(const QString& query, QSparqlQuery::StatementType type,
+                                     const QSparqlQueryOptions& options)
+{
+    return new SyntheticResult(this, query, type,
+                               options.executionMethod() == QSparqlQueryOptions::SyncExec);
+}
+
+QVector<QSparqlResultRow> SyntheticDriver::generateRows(int count, const QStringList& columnTypes)
+{
+    QSparqlResultSchema schema;
+    bool needsBindings = false;
+    for (int c = 0; c < columnTypes.count(); ++c) {
+        const QString type = columnTypes[c].trimmed();
+        schema.append(type + QString::number(c));
+        // Blank nodes and language tags don't fit in a plain value
+        if (type == "bnode" || type == "langstring")
+            needsBindings = true;
+    }
+
+    const QDateTime epoch(QDate(2012, 1, 1), QTime(0, 0), Qt::UTC);
+    QVector<QSparqlResultRow> result;
+    result.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QSparqlResultRow row(schema);
+        for (int c = 0; c < columnTypes.count(); ++c) {
+            const QString type = columnTypes[c].trimmed();
+            QSparqlBinding binding;
+            binding.setName(schema.variableName(c));
+            if (type == "uri") {
+                binding.setValue(QUrl(QString("http://www.example.org/resource/%1").arg(i)));
+            } else if (type == "bnode") {
+                binding.setBlankNodeLabel(QString("b%1").arg(i));
+            } else if (type == "langstring") {
+                binding.setValue(QString("Synthetic text number %1").arg(i));
+                binding.setLanguageTag("en");
+            } else if (type == "integer") {
+                binding.setValue(i);
+            } else if (type == "double") {
+                binding.setValue(i * 0.5);
+            } else if (type == "boolean") {
+                binding.setValue(i % 2 == 0);
+            } else if (type == "datetime") {
+                binding.setValue(epoch.addSecs(i));
+            } else {
+                binding.setValue(QString("Synthetic text number %1").arg(i));
+            }
+
+            if (needsBindings)
+                row.append(binding);
+            else
+                row.appendValue(binding.value());
+        }
+        result.append(row);
+    }
+    return result;
+}
+
+SyntheticResult::SyntheticResult(const SyntheticDriver* driver, const QString& query,
+                                 QSparqlQuery::StatementType type, bool sync)
+    : rows(driver->rows), available(0), dataReadyInterval(driver->dataReadyInterval),
+      sync(sync), finished_(false)
+{
+    setQuery(query);
+    setStatementType(type);
+    if (type != QSparqlQuery::SelectStatement)
+        rows.clear();
+
+    setResultExtension(this);
+    if (sync) {
+        // Synchronous results are read one row at a time by next(), also
+        // by fetchBlock()
+        if (driver->latency > 0)
+            QTest::qSleep(driver->latency);
+        available = rows.count();
+        finished_ = true;
+    } else {
+        QTimer::singleShot(driver->latency, this, SLOT(deliver()));
+    }
+}
+
+bool SyntheticResult::isCurrentValid() const
+{
+    return pos() >= 0 && pos() < available;
+}
+
+QSparqlResultRow SyntheticResult::current() const
+{
+    return isCurrentValid() ? rows[pos()] : QSparqlResultRow();
+}
+
+QSparqlBinding SyntheticResult::binding(int i) const
+{
+    return isCurrentValid() ? rows[pos()].binding(i) : QSparqlBinding();
+}
+
+QVariant SyntheticResult::value(int i) const
+{
+    return isCurrentValid() ? rows[pos()].value(i) : QVariant();
+}
+
+int SyntheticResult::size() const
+{
+    return sync ? -1 : available;
+}
+
+bool SyntheticResult::next()
+{
+    if (!sync)
+        return QSparqlResult::next();
+
+    if (pos() == QSparql::AfterLastRow)
+        return false;
+    const int nextPos = pos() == QSparql::BeforeFirstRow ? 0 : pos() + 1;
+    if (nextPos >= rows.count()) {
+        updatePos(QSparql::AfterLastRow);
+        return false;
+    }
+    updatePos(nextPos);
+    return true;
+}
+
+int SyntheticResult::fetchRowBlock(int maxRows, QSparqlRowBlock *block)
+{
+    if (sync) {
+        // Like the generic fetchBlock(), through next() and current()
+        block->setVariableNames(QStringList());
+        QVector<QVariant> values;
+        int fetched = 0;
+        while (fetched < maxRows && next()) {
+            const QSparqlResultRow row = current();
+            if (fetched == 0) {
+                QStringList names;
+                for (int i = 0; i < row.count(); ++i)
+                    names.append(row.variableName(i));
+                block->setVariableNames(names);
+                values.resize(names.count());
+            }
+            for (int i = 0; i < values.count(); ++i)
+                values[i] = row.value(i);
+            block->appendRow(values.constData(), values.count());
+            ++fetched;
+        }
+        return fetched;
+    }
+    return fetchBlockFromRows(available == rows.count() ? rows : rows.mid(0, available),
+                              QStringList(), maxRows, block);
+}
+
+bool SyntheticResult::isFinished() const
+{
+    return finished_;
+}
+
+bool SyntheticResult::hasFeature(QSparqlResult::Feature feature) const
+{
+    switch (feature) {
+    case QSparqlResult::QuerySize:
+        return !sync;
+    case QSparqlResult::ForwardOnly:
+    case QSparqlResult::Sync:
+        return sync;
+    default:
+        return false;
+    }
+}
+
+void SyntheticResult::waitForFinished()
+{
+    // Don't wait for the latency; the benchmarks waiting for a result
+    // measure the code around it
+    deliver();
+}
+
+void SyntheticResult::deliver()
+{
+    if (finished_)
+        return;
+    finished_ = true;
+    while (available < rows.count()) {
+        available = qMin(rows.count(), available + dataReadyInterval);
+        Q_EMIT dataReady(available);
+    }
+    Q_EMIT finished();
+}
+
+qint64 SyntheticResult::resultMemoryUsage() const
+{
+    // The rows are shared with the driver
+    QSparqlMemoryUsage usage;
+    usage.add(rows);
+    return usage.total();
+}
+
+void registerSyntheticDriver()
+{
+    qSparqlRegisterConnectionCreator("QSPARQL_SYNTHETIC",
+                                     new QSparqlDriverCreator<SyntheticDriver>());
+}
@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** Copyright (C) 2010-2011 Nokia Corporation and/or its subsidiary(-ies).
+** All rights reserved.
+** Contact: Nokia Corporation (ivan.frade@nokia.com)
+**
+** This file is part of the test suite of the QtSparql module (not yet part of the Qt Toolkit).
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** GNU Lesser General Public License Usage
+** This file may be used under the terms of the GNU Lesser General Public
+** License version 2.1 as published by the Free Software Foundation and
+** appearing in the file LICENSE.LGPL included in the packaging of this
+** file. Please review the following information to ensure the GNU Lesser
+** General Public License version 2.1 requirements will be met:
+** http://www.gnu.org/licenses/old-licenses/lgpl-2.1.html.
+**
+** In addition, as a special exception, Nokia gives you certain additional
+** rights. These rights are described in the Nokia Qt LGPL Exception
+** version 1.1, included in the file LGPL_EXCEPTION.txt in this package.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU General
+** Public License version 3.0 as published by the Free Software Foundation
+** and appearing in the file LICENSE.GPL included in the packaging of this
+** file. Please review the following information to ensure the GNU General
+** Public License version 3.0 requirements will be met:
+** http://www.gnu.org/copyleft/gpl.html.
+**
+** Other Usage
+** Alternatively, this file may be used in accordance with the terms and
+** conditions contained in a signed written agreement between you and Nokia.
+**
+** If you have questions regarding the use of this file, please contact
+** Nokia at ivan.frade@nokia.com.
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef SYNTHETICDRIVER_H
+#define SYNTHETICDRIVER_H
+
+#include <QtSparql>
+#include <private/qsparqldriver_p.h>
+#include <private/qsparqlresultextension_p.h>
+
+#include <QtCore/qvector.h>
+
+// A driver which generates its results instead of querying a store, so that
+// the code above the drivers can be benchmarked on any machine. It is
+// registered as "QSPARQL_SYNTHETIC" by registerSyntheticDriver(), and
+// configured with these custom connection options:
+// - "rows" (int, default 1000), the number of rows of every SELECT result
+// - "columns" (QString, default "uri,string,integer"), the comma separated
+//   types of the columns: uri, bnode, string, langstring, integer, double,
+//   boolean or datetime
+// - "latency" (int, default 0), the milliseconds before the results arrive
+// - dataReadyInterval (default: all the rows at once)
+// The rows are generated once for each combination of "rows" and "columns",
+// so generating them isn't part of what is measured.
+class SyntheticDriver : public QSparqlDriver
+{
+    Q_OBJECT
+public:
+    SyntheticDriver();
+    ~SyntheticDriver();
+
+    bool open(const QSparqlConnectionOptions& options);
+    void close();
+    bool hasFeature(QSparqlConnection::Feature f) const;
+    bool hasError() const;
+    QSparqlResult* exec(const QString& query, QSparqlQuery::StatementType type,
+                        const QSparqlQueryOptions& options);
+
+    static QVector<QSparqlResultRow> generateRows(int count, const QStringList& columnTypes);
+    // The number of connections opened so far
+    static int openCount;
+
+    QVector<QSparqlResultRow> rows;
+    int latency;
+    int dataReadyInterval;
+};
+
+// Delivers the rows of an asynchronous query from the event loop, or reads
+// them one at a time for a synchronous query
+class SyntheticResult : public QSparqlResult, public QSparqlResultExtension
+{
+    Q_OBJECT
+public:
+    SyntheticResult(const SyntheticDriver* driver, const QString& query,
+                    QSparqlQuery::StatementType type, bool sync);
+
+    QSparqlResultRow current() const;
+    QSparqlBinding binding(int i) const;
+    QVariant value(int i) const;
+    int size() const;
+    bool next();
+    int fetchRowBlock(int maxRows, QSparqlRowBlock *block);
+    bool isFinished() const;
+    bool hasFeature(QSparqlResult::Feature feature) const;
+    void waitForFinished();
+    qint64 resultMemoryUsage() const;
+
+private Q_SLOTS:
+    void deliver();
+
+private:
+    bool isCurrentValid() const;
+
+    QVector<QSparqlResultRow> rows;
+    int available;
+    int dataReadyInterval;
+    bool sync;
+    bool finished_;
+};
+
+void registerSyntheticDriver();
+
+#endif // SYNTHETICDRIVER_H